@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/CommandRecorderTests.dir/CommandRecorderTests.cpp.o"
+  "CMakeFiles/CommandRecorderTests.dir/CommandRecorderTests.cpp.o.d"
+  "CommandRecorderTests"
+  "CommandRecorderTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/CommandRecorderTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/DrawPacketsBench.dir/bench/DrawPacketsBench.cpp.o"
+  "CMakeFiles/DrawPacketsBench.dir/bench/DrawPacketsBench.cpp.o.d"
+  "DrawPacketsBench"
+  "DrawPacketsBench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DrawPacketsBench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/DrawPacketsTests.dir/DrawPacketsTests.cpp.o"
+  "CMakeFiles/DrawPacketsTests.dir/DrawPacketsTests.cpp.o.d"
+  "DrawPacketsTests"
+  "DrawPacketsTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DrawPacketsTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/FrameDirtyCountTests.dir/FrameDirtyCountTests.cpp.o"
+  "CMakeFiles/FrameDirtyCountTests.dir/FrameDirtyCountTests.cpp.o.d"
+  "FrameDirtyCountTests"
+  "FrameDirtyCountTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/FrameDirtyCountTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/FrustumCullingBench.dir/bench/FrustumCullingBench.cpp.o"
+  "CMakeFiles/FrustumCullingBench.dir/bench/FrustumCullingBench.cpp.o.d"
+  "FrustumCullingBench"
+  "FrustumCullingBench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/FrustumCullingBench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/GeneratorBench.dir/bench/GeneratorBench.cpp.o"
+  "CMakeFiles/GeneratorBench.dir/bench/GeneratorBench.cpp.o.d"
+  "GeneratorBench"
+  "GeneratorBench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/GeneratorBench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/IndexPoolsTests.dir/IndexPoolsTests.cpp.o"
+  "CMakeFiles/IndexPoolsTests.dir/IndexPoolsTests.cpp.o.d"
+  "IndexPoolsTests"
+  "IndexPoolsTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/IndexPoolsTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/JobSystemBench.dir/bench/JobSystemBench.cpp.o"
+  "CMakeFiles/JobSystemBench.dir/bench/JobSystemBench.cpp.o.d"
+  "JobSystemBench"
+  "JobSystemBench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/JobSystemBench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
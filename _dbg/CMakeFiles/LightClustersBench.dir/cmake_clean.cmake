@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LightClustersBench.dir/bench/LightClustersBench.cpp.o"
+  "CMakeFiles/LightClustersBench.dir/bench/LightClustersBench.cpp.o.d"
+  "LightClustersBench"
+  "LightClustersBench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LightClustersBench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LightSelectionBench.dir/bench/LightSelectionBench.cpp.o"
+  "CMakeFiles/LightSelectionBench.dir/bench/LightSelectionBench.cpp.o.d"
+  "LightSelectionBench"
+  "LightSelectionBench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LightSelectionBench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,66 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/root/repo/tests/CMakeLists.txt"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCXXSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFileCXX.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "CMakeFiles/sasha-modules.dir/DependInfo.cmake"
+  "CMakeFiles/MeshOptimizerTests.dir/DependInfo.cmake"
+  "CMakeFiles/MeshletTests.dir/DependInfo.cmake"
+  "CMakeFiles/VertexCodecTests.dir/DependInfo.cmake"
+  "CMakeFiles/IndexPoolsTests.dir/DependInfo.cmake"
+  "CMakeFiles/DrawPacketsTests.dir/DependInfo.cmake"
+  "CMakeFiles/FrameDirtyCountTests.dir/DependInfo.cmake"
+  "CMakeFiles/TransformHierarchyTests.dir/DependInfo.cmake"
+  "CMakeFiles/CommandRecorderTests.dir/DependInfo.cmake"
+  "CMakeFiles/MeshletBench.dir/DependInfo.cmake"
+  "CMakeFiles/GeneratorBench.dir/DependInfo.cmake"
+  "CMakeFiles/FrustumCullingBench.dir/DependInfo.cmake"
+  "CMakeFiles/DrawPacketsBench.dir/DependInfo.cmake"
+  "CMakeFiles/JobSystemBench.dir/DependInfo.cmake"
+  "CMakeFiles/LightClustersBench.dir/DependInfo.cmake"
+  "CMakeFiles/LightSelectionBench.dir/DependInfo.cmake"
+  "CMakeFiles/TransformHierarchyBench.dir/DependInfo.cmake"
+  )
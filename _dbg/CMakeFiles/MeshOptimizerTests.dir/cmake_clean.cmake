@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MeshOptimizerTests.dir/MeshOptimizerTests.cpp.o"
+  "CMakeFiles/MeshOptimizerTests.dir/MeshOptimizerTests.cpp.o.d"
+  "MeshOptimizerTests"
+  "MeshOptimizerTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MeshOptimizerTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MeshletBench.dir/bench/MeshletBench.cpp.o"
+  "CMakeFiles/MeshletBench.dir/bench/MeshletBench.cpp.o.d"
+  "MeshletBench"
+  "MeshletBench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MeshletBench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
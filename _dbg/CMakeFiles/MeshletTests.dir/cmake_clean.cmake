@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MeshletTests.dir/MeshletTests.cpp.o"
+  "CMakeFiles/MeshletTests.dir/MeshletTests.cpp.o.d"
+  "MeshletTests"
+  "MeshletTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MeshletTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
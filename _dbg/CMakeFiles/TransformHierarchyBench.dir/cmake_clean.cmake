@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/TransformHierarchyBench.dir/bench/TransformHierarchyBench.cpp.o"
+  "CMakeFiles/TransformHierarchyBench.dir/bench/TransformHierarchyBench.cpp.o.d"
+  "TransformHierarchyBench"
+  "TransformHierarchyBench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/TransformHierarchyBench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
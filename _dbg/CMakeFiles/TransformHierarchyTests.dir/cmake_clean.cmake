@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/TransformHierarchyTests.dir/TransformHierarchyTests.cpp.o"
+  "CMakeFiles/TransformHierarchyTests.dir/TransformHierarchyTests.cpp.o.d"
+  "TransformHierarchyTests"
+  "TransformHierarchyTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/TransformHierarchyTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
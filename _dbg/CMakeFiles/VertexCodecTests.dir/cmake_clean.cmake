@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/VertexCodecTests.dir/VertexCodecTests.cpp.o"
+  "CMakeFiles/VertexCodecTests.dir/VertexCodecTests.cpp.o.d"
+  "VertexCodecTests"
+  "VertexCodecTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/VertexCodecTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,29 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/source/renderer/geometry/GeometryGenerator.cpp" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/GeometryGenerator.cpp.o" "gcc" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/GeometryGenerator.cpp.o.d"
+  "/root/repo/source/renderer/geometry/IndexPools.cpp" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/IndexPools.cpp.o" "gcc" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/IndexPools.cpp.o.d"
+  "/root/repo/source/renderer/geometry/MeshOptimizer.cpp" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/MeshOptimizer.cpp.o" "gcc" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/MeshOptimizer.cpp.o.d"
+  "/root/repo/source/renderer/geometry/Meshlet.cpp" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/Meshlet.cpp.o" "gcc" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/Meshlet.cpp.o.d"
+  "/root/repo/source/renderer/geometry/VertexCodec.cpp" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/VertexCodec.cpp.o" "gcc" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/VertexCodec.cpp.o.d"
+  "/root/repo/source/renderer/scene/DrawPackets.cpp" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/DrawPackets.cpp.o" "gcc" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/DrawPackets.cpp.o.d"
+  "/root/repo/source/renderer/scene/FrustumCulling.cpp" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/FrustumCulling.cpp.o" "gcc" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/FrustumCulling.cpp.o.d"
+  "/root/repo/source/renderer/scene/LightClusters.cpp" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/LightClusters.cpp.o" "gcc" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/LightClusters.cpp.o.d"
+  "/root/repo/source/renderer/scene/LightSelection.cpp" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/LightSelection.cpp.o" "gcc" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/LightSelection.cpp.o.d"
+  "/root/repo/source/renderer/scene/TransformHierarchy.cpp" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/TransformHierarchy.cpp.o" "gcc" "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/TransformHierarchy.cpp.o.d"
+  "/root/repo/source/utility/JobSystem.cpp" "CMakeFiles/sasha-modules.dir/root/repo/source/utility/JobSystem.cpp.o" "gcc" "CMakeFiles/sasha-modules.dir/root/repo/source/utility/JobSystem.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
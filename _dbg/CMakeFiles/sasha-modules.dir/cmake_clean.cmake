@@ -0,0 +1,31 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/GeometryGenerator.cpp.o"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/GeometryGenerator.cpp.o.d"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/IndexPools.cpp.o"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/IndexPools.cpp.o.d"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/MeshOptimizer.cpp.o"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/MeshOptimizer.cpp.o.d"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/Meshlet.cpp.o"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/Meshlet.cpp.o.d"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/VertexCodec.cpp.o"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/geometry/VertexCodec.cpp.o.d"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/DrawPackets.cpp.o"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/DrawPackets.cpp.o.d"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/FrustumCulling.cpp.o"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/FrustumCulling.cpp.o.d"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/LightClusters.cpp.o"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/LightClusters.cpp.o.d"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/LightSelection.cpp.o"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/LightSelection.cpp.o.d"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/TransformHierarchy.cpp.o"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/renderer/scene/TransformHierarchy.cpp.o.d"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/utility/JobSystem.cpp.o"
+  "CMakeFiles/sasha-modules.dir/root/repo/source/utility/JobSystem.cpp.o.d"
+  "libsasha-modules.a"
+  "libsasha-modules.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/sasha-modules.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
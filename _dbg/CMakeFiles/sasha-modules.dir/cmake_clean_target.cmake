@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libsasha-modules.a"
+)
@@ -0,0 +1,22 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/tests
+# Build directory: /root/repo/_dbg
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test([=[MeshOptimizerTests]=] "/root/repo/_dbg/MeshOptimizerTests")
+set_tests_properties([=[MeshOptimizerTests]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;55;add_test;/root/repo/tests/CMakeLists.txt;63;sasha_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test([=[MeshletTests]=] "/root/repo/_dbg/MeshletTests")
+set_tests_properties([=[MeshletTests]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;55;add_test;/root/repo/tests/CMakeLists.txt;64;sasha_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test([=[VertexCodecTests]=] "/root/repo/_dbg/VertexCodecTests")
+set_tests_properties([=[VertexCodecTests]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;55;add_test;/root/repo/tests/CMakeLists.txt;65;sasha_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test([=[IndexPoolsTests]=] "/root/repo/_dbg/IndexPoolsTests")
+set_tests_properties([=[IndexPoolsTests]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;55;add_test;/root/repo/tests/CMakeLists.txt;66;sasha_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test([=[DrawPacketsTests]=] "/root/repo/_dbg/DrawPacketsTests")
+set_tests_properties([=[DrawPacketsTests]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;55;add_test;/root/repo/tests/CMakeLists.txt;67;sasha_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test([=[FrameDirtyCountTests]=] "/root/repo/_dbg/FrameDirtyCountTests")
+set_tests_properties([=[FrameDirtyCountTests]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;55;add_test;/root/repo/tests/CMakeLists.txt;68;sasha_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test([=[TransformHierarchyTests]=] "/root/repo/_dbg/TransformHierarchyTests")
+set_tests_properties([=[TransformHierarchyTests]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;55;add_test;/root/repo/tests/CMakeLists.txt;69;sasha_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test([=[CommandRecorderTests]=] "/root/repo/_dbg/CommandRecorderTests")
+set_tests_properties([=[CommandRecorderTests]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;55;add_test;/root/repo/tests/CMakeLists.txt;70;sasha_test;/root/repo/tests/CMakeLists.txt;0;")
@@ -16,5 +16,9 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE prevInstance, PSTR cmdLine, in
 	{
 		MessageBox(0, e.ToString().c_str(), 0, 0);
 	}
+	catch (std::exception& e)
+	{
+		MessageBoxA(0, e.what(), 0, 0);
+	}
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+#include "Entity.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+using ComponentID = std::uint32_t;
+// Bit i is set when component i is part of an archetype
+using ComponentMask = std::uint64_t;
+
+struct ComponentInfo
+{
+	size_t _size = 0u;
+	size_t _alignment = 0u;
+};
+
+// Hands out one id per component type on first use. Components live in raw chunk memory and are moved with memcpy,
+// so they have to be trivially copyable
+class ComponentRegistry
+{
+public:
+	static constexpr ComponentID kMaxComponents = 64u;
+
+	template<typename T>
+	static ComponentID GetID()
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Components are moved with memcpy");
+		static const ComponentID id = Register(sizeof(T), alignof(T));
+		return id;
+	}
+
+	template<typename... Ts>
+	static ComponentMask GetMask()
+	{
+		return (ComponentMask{ 0 } | ... | (ComponentMask{ 1 } << GetID<Ts>()));
+	}
+
+	static const ComponentInfo& GetInfo(ComponentID id) noexcept;
+
+private:
+	static ComponentID Register(size_t size, size_t alignment);
+};
+
+// Fixed size block holding the entity handles and one array per component for up to Archetype::GetChunkCapacity() entities
+struct alignas(64) Chunk
+{
+	static constexpr size_t kSize = 16u * 1024u;
+
+	std::byte _data[kSize];
+};
+
+class Archetype;
+
+// Where the components of an entity are
+struct EntityLocation
+{
+	Archetype* _archetype = nullptr;
+	std::uint32_t _chunk = 0u;
+	std::uint32_t _row = 0u;
+};
+
+// Every entity with exactly the same set of components. Rows stay dense: every chunk but the last one is full,
+// freeing a row moves the archetype's last row into it
+class Archetype
+{
+public:
+	explicit Archetype(ComponentMask mask);
+
+	Archetype(const Archetype&) = delete;
+	Archetype& operator=(const Archetype&) = delete;
+
+	ComponentMask GetMask() const noexcept { return _mask; }
+	bool Has(ComponentID id) const noexcept { return ((_mask >> id) & 1u) != 0u; }
+
+	size_t GetChunkCapacity() const noexcept { return _chunkCapacity; }
+	size_t GetChunkCount() const noexcept { return _chunks.size(); }
+	size_t GetEntityCount() const noexcept { return _entityCount; }
+	// Rows in use in the chunk, only the last chunk can be partly filled
+	std::uint32_t GetCount(size_t chunk) const noexcept { return _counts[chunk]; }
+
+	Entity* GetEntities(size_t chunk) noexcept;
+	// Start of the component's array in the chunk, nullptr when the archetype doesn't have the component
+	std::byte* GetColumn(size_t chunk, ComponentID id) noexcept;
+
+	// Appends a row for entity, its components are left for the caller to write
+	EntityLocation Allocate(Entity entity);
+	// Removes the row, returns the entity moved into it or an invalid one when the row was the last
+	Entity Free(std::uint32_t chunk, std::uint32_t row) noexcept;
+	// Copies the components both archetypes have from a row of this one to a row of destination
+	void CopyShared(std::uint32_t chunk, std::uint32_t row, Archetype& destination, std::uint32_t destinationChunk, std::uint32_t destinationRow) noexcept;
+
+private:
+	static constexpr std::uint32_t kNoColumn = ~0u;
+
+	// One component array of the chunks, rows are moved column by column
+	struct Column
+	{
+		ComponentID _id = 0u;
+		std::uint32_t _offset = 0u;
+		std::uint32_t _size = 0u;
+	};
+
+	ComponentMask _mask = 0u;
+	std::vector<Column> _columns;
+	// Byte offset of each component's array in a chunk, kNoColumn for components the archetype doesn't have
+	std::array<std::uint32_t, ComponentRegistry::kMaxComponents> _offsets;
+	size_t _chunkCapacity = 0u;
+
+	std::vector<std::unique_ptr<Chunk>> _chunks;
+	std::vector<std::uint32_t> _counts;
+	size_t _entityCount = 0u;
+	// Last chunk that emptied, kept so an archetype hovering around a chunk boundary doesn't allocate every time
+	std::unique_ptr<Chunk> _spare;
+};
@@ -0,0 +1,14 @@
+#pragma once
+#include <cstdint>
+
+// Generational handle: the index slot is reused once the entity is destroyed, the generation tells old handles apart
+struct Entity
+{
+	static constexpr std::uint32_t kInvalidIndex = ~0u;
+
+	std::uint32_t _index = kInvalidIndex;
+	std::uint32_t _generation = 0u;
+
+	bool IsValid() const noexcept { return _index != kInvalidIndex; }
+	friend bool operator==(const Entity&, const Entity&) = default;
+};
@@ -0,0 +1,208 @@
+#pragma once
+#include "Archetype.h"
+#include <bit>
+#include <cassert>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+// The entities of one chunk, components are accessed as arrays indexed by row
+class ChunkView
+{
+public:
+	ChunkView(Archetype& archetype, size_t chunk) noexcept
+		: _archetype(&archetype)
+		, _chunk(chunk)
+	{
+	}
+
+	size_t GetCount() const noexcept { return _archetype->GetCount(_chunk); }
+	const Entity* GetEntities() const noexcept { return _archetype->GetEntities(_chunk); }
+
+	// nullptr when the chunk's archetype doesn't have the component, which only happens for components the query didn't require
+	template<typename T>
+	T* Get() const noexcept
+	{
+		return reinterpret_cast<T*>(_archetype->GetColumn(_chunk, ComponentRegistry::GetID<T>()));
+	}
+
+private:
+	Archetype* _archetype;
+	size_t _chunk;
+};
+
+// The archetypes having at least the required components, matched once when either is created. Creating or destroying
+// entities only changes the chunks, never the list. Entities must not be created, destroyed or change components while
+// a query is being iterated
+class Query
+{
+public:
+	explicit Query(ComponentMask required) noexcept
+		: _required(required)
+	{
+	}
+
+	ComponentMask GetRequired() const noexcept { return _required; }
+	size_t GetEntityCount() const noexcept;
+
+	// Every chunk in use, archetype by archetype
+	template<typename Fn>
+	void ForEachChunk(Fn&& fn) const;
+	// fn(Entity, Ts&...) for every entity, Ts have to be required by the query
+	template<typename... Ts, typename Fn>
+	void ForEach(Fn&& fn) const;
+	// Replaces chunks with a view of every chunk in use, so they can be split across threads
+	void GetChunks(std::vector<ChunkView>& chunks) const;
+
+private:
+	friend class World;
+
+	void Match(Archetype& archetype);
+
+private:
+	ComponentMask _required;
+	std::vector<Archetype*> _archetypes;
+};
+
+// Owns the entities and their components, stored per archetype in 16 KB chunks of component arrays
+class World
+{
+public:
+	World() = default;
+	World(const World&) = delete;
+	World& operator=(const World&) = delete;
+
+	template<typename... Ts>
+	Entity Create(const Ts&... components);
+	// Frees the entity's row and slot, handles to it stop being alive
+	void Destroy(Entity entity);
+	bool IsAlive(Entity entity) const noexcept;
+	size_t GetEntityCount() const noexcept { return _entityCount; }
+
+	// nullptr when the entity isn't alive or doesn't have the component. Only valid until the next structural change
+	template<typename T>
+	T* Get(Entity entity) noexcept;
+	template<typename T>
+	const T* Get(Entity entity) const noexcept;
+	template<typename T>
+	bool Has(Entity entity) const noexcept;
+	// Moves the entity to the archetype with T added, or overwrites T when it already has it
+	template<typename T>
+	void Add(Entity entity, const T& component);
+	template<typename T>
+	void Remove(Entity entity);
+
+	// Created on first use and kept as long as the world, callers can hold on to it
+	template<typename... Ts>
+	Query& GetQuery();
+
+private:
+	Archetype& GetArchetype(ComponentMask mask);
+	Query& GetQuery(ComponentMask required);
+	Entity AllocateEntity();
+	// Frees the row at location, the entity moved into it gets its new location
+	void FreeRow(const EntityLocation& location) noexcept;
+	// Moves the entity to the archetype of mask, the components both have are kept
+	void Move(Entity entity, ComponentMask mask);
+	std::byte* GetComponent(Entity entity, ComponentID id) const noexcept;
+
+private:
+	// Archetypes never move, queries and locations point at them
+	std::vector<std::unique_ptr<Archetype>> _archetypes;
+	std::unordered_map<ComponentMask, Archetype*> _archetypesByMask;
+	std::vector<std::unique_ptr<Query>> _queries;
+
+	// Indexed by Entity::_index, a slot's generation is bumped when its entity is destroyed
+	std::vector<EntityLocation> _locations;
+	std::vector<std::uint32_t> _generations;
+	std::vector<std::uint32_t> _freeIndices;
+	size_t _entityCount = 0u;
+};
+
+template<typename Fn>
+void Query::ForEachChunk(Fn&& fn) const
+{
+	for (Archetype* archetype : _archetypes)
+		for (size_t c = 0; c < archetype->GetChunkCount(); c++)
+			fn(ChunkView(*archetype, c));
+}
+
+template<typename... Ts, typename Fn>
+void Query::ForEach(Fn&& fn) const
+{
+	assert((ComponentRegistry::GetMask<Ts...>() & ~_required) == 0u);
+
+	ForEachChunk([&fn](const ChunkView& chunk)
+		{
+			const Entity* entities = chunk.GetEntities();
+			const std::tuple<Ts*...> columns{ chunk.Get<Ts>()... };
+			const size_t count = chunk.GetCount();
+			for (size_t i = 0; i < count; i++)
+				fn(entities[i], std::get<Ts*>(columns)[i]...);
+		});
+}
+
+template<typename... Ts>
+Entity World::Create(const Ts&... components)
+{
+	const ComponentMask mask = ComponentRegistry::GetMask<Ts...>();
+	assert(std::popcount(mask) == static_cast<int>(sizeof...(Ts)) && "Components of an entity must have distinct types");
+
+	Archetype& archetype = GetArchetype(mask);
+	const Entity entity = AllocateEntity();
+	const EntityLocation location = archetype.Allocate(entity);
+	_locations[entity._index] = location;
+
+	(new (archetype.GetColumn(location._chunk, ComponentRegistry::GetID<Ts>()) + location._row * sizeof(Ts)) Ts(components), ...);
+	return entity;
+}
+
+template<typename T>
+T* World::Get(Entity entity) noexcept
+{
+	return reinterpret_cast<T*>(GetComponent(entity, ComponentRegistry::GetID<T>()));
+}
+
+template<typename T>
+const T* World::Get(Entity entity) const noexcept
+{
+	return reinterpret_cast<const T*>(GetComponent(entity, ComponentRegistry::GetID<T>()));
+}
+
+template<typename T>
+bool World::Has(Entity entity) const noexcept
+{
+	return GetComponent(entity, ComponentRegistry::GetID<T>()) != nullptr;
+}
+
+template<typename T>
+void World::Add(Entity entity, const T& component)
+{
+	assert(IsAlive(entity));
+
+	const ComponentID id = ComponentRegistry::GetID<T>();
+	const EntityLocation& location = _locations[entity._index];
+	if (!location._archetype->Has(id))
+		Move(entity, location._archetype->GetMask() | (ComponentMask{ 1 } << id));
+
+	new (GetComponent(entity, id)) T(component);
+}
+
+template<typename T>
+void World::Remove(Entity entity)
+{
+	assert(IsAlive(entity));
+
+	const ComponentID id = ComponentRegistry::GetID<T>();
+	const EntityLocation& location = _locations[entity._index];
+	if (location._archetype->Has(id))
+		Move(entity, location._archetype->GetMask() & ~(ComponentMask{ 1 } << id));
+}
+
+template<typename... Ts>
+Query& World::GetQuery()
+{
+	return GetQuery(ComponentRegistry::GetMask<Ts...>());
+}
@@ -24,6 +24,11 @@ public:
 	float AspectRatio() const noexcept;
 	void SetAppSize(int w, int h) noexcept;
 
+	// State changes issued by the last DrawFrame
+	const DrawStateCounters& GetDrawCounters() const noexcept;
+	// Bytes the last Update copied into the current frame resource
+	const UploadCounters& GetUploadCounters() const noexcept;
+
 private:
 	void BuildInputLayout();
 
@@ -33,28 +38,38 @@ private:
 	void BuildTextures();
 	
 	void BuildScene();
+	// Adds or removes instances at runtime, before the frame's jobs start
+	void EditScene();
 
 	void BuildFrameResources();
 	void BuildCbvDescriptorHeap();
 	void BuildConstantBuffers();
+	void BuildConstantBufferViews(UINT frameIndex);
+	// Grows the current frame resource's item buffers, and the CBV heap, once the scene outgrew them
+	void GrowFrameResources();
 	void BuildRootSignature();
 	void BuildPSO();
 	
 	void BeginFrame();
 	void DrawFrame();
+	void BuildDrawCommands();
 	void EndFrame();
 
 	void UpdateCamera(const Timer& t);
 	void UpdateModels(const Timer& t);
+	void UpdateLights(const Timer& t);
 	void UpdateObjCB(const Timer& t);
 	void UpdatePassCB(const Timer& t);
 	void UpdateMatCB(const Timer& t);
+	void UpdateLightBuffers(const Timer& t);
 
 private:
 	int _appWidth;
 	int _appHeight;
 	HWND _wndHandle;
 	bool _isWireFrame = false;
+	// Lights picked per item instead of per cluster, cheaper on low end GPUs
+	bool _perObjectLights = false;
 
 	HANDLE _eventHandle;
 
@@ -68,35 +83,62 @@ private:
 	std::unique_ptr<CommandQueue> _cmdQueue;
 	std::unique_ptr<CommandList> _cmdList;
 
+	// Lists below _minDrawsPerList draws aren't worth a thread
+	static constexpr size_t _maxRecordWorkers = 8u;
+	static constexpr size_t _minDrawsPerList = 64u;
+	std::vector<std::unique_ptr<CommandList>> _workerCmdLists;
+	std::vector<CommandRecorder<ID3D12GraphicsCommandList>> _workerRecorders;
+	std::vector<DrawCommand> _drawCommands;
+	std::vector<DrawRange> _drawRanges;
+	size_t _drawListCount = 0u;
+
 	std::unique_ptr<DescriptorHeap> _rtvHeap;
 	std::unique_ptr<DescriptorHeap> _dsvHeap;
 
 	ComPtr<ID3DBlob> _vertexShader;
 	ComPtr<ID3DBlob> _pixelShader;
+	ComPtr<ID3DBlob> _alphaTestedPixelShader;
 	std::vector<D3D12_INPUT_ELEMENT_DESC> _inputLayoutDesc{};
+	VertexFormat _vertexFormat = VertexFormat::Full;
+	TexCoordEncoding _texCoordEncoding = TexCoordEncoding::Half;
 
 	GeometryLibrary _geoLib;
 	Scene _scene;
+	// Cylinders of the ring, each carries its sphere as a child
+	std::vector<Entity> _pillars;
+	static constexpr float _pillarTravel = 0.5f;
+	// Field of pillars F4 adds and removes while running
+	std::vector<Entity> _crowd;
+	static constexpr int _crowdSide = 16;
 	
-	static constexpr int _frameResourceCount = 3;
+	static constexpr int _frameResourceCount = d3dUtil::NumFrameResources;
 	std::vector<std::unique_ptr<FrameResource>> _frameResources;
 	FrameResource* _currFrameResource = nullptr;
 	int _frameResourceIndex = 0u;
+	// Items the frame resources and each frame resource's range of per draw CBVs have room for, doubles when the scene outgrows it
+	UINT _itemCapacity = 0u;
 
 	PassBuffer _mainPassCB;
 	UINT _passCbvOffset = 0u;
 	UINT _matCbvOffset = 0u;
 	std::unique_ptr<DescriptorHeap> _cbvHeap;
+	// Replaced heaps stay alive until the GPU passed the fence of the last frame that could still use them
+	std::vector<std::pair<UINT64, std::unique_ptr<DescriptorHeap>>> _retiredCbvHeaps;
 
 	std::unique_ptr<DescriptorHeap> _srvHeap;
 
 	static constexpr float _sunSpeed = 2.5f;
 	float _lightTheta = 1.25f * XM_PI;
 	float _lightPhi = 0.1f;
+	// The spot light steered by the arrow keys, an index into the scene's lights
+	size_t _sunLight = 0u;
 
 	std::unique_ptr<PSOCache> _psoCache;
-	GraphicsPipelineRecipe _solid;
+	// Indexed by DrawState::_pipeline, wireframe replaces all of them while it's on
+	std::array<GraphicsPipelineRecipe, static_cast<size_t>(RenderLayer::Count)> _pipelines;
 	GraphicsPipelineRecipe _wireframe;
+	DrawStateCounters _drawCounters;
+	UploadCounters _uploadCounters;
 	RenderTargetDesc _rtDesc;
 
 	ComPtr<ID3D12RootSignature> _rootSignature;
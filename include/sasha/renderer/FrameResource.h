@@ -3,16 +3,39 @@
 #include "geometry/Mesh.h"
 #include "geometry/Material.h"
 
+// Bytes copied into the upload buffers of one frame resource by one update
+struct UploadCounters
+{
+	size_t _drawBytes = 0u;
+	size_t _instanceBytes = 0u;
+	size_t _instanceIndexBytes = 0u;
+	size_t _materialBytes = 0u;
+	size_t _passBytes = 0u;
+	size_t _lightBytes = 0u;
+
+	size_t GetTotal() const noexcept { return _drawBytes + _instanceBytes + _instanceIndexBytes + _materialBytes + _passBytes + _lightBytes; }
+};
+
 struct FrameResource
 {
-	FrameResource(ID3D12Device* device, UINT passCount = 1u, UINT cbCount = 1u, UINT matCount = 1u);
+	FrameResource(ID3D12Device* device, UINT passCount = 1u, UINT cbCount = 1u, UINT matCount = 1u, UINT instanceCount = 1u, UINT workerCount = 0u,
+		UINT lightCount = 1u, UINT clusterDataCount = 1u);
 	FrameResource(const FrameResource&) = delete;
 	FrameResource& operator=(const FrameResource&) = delete;
 	~FrameResource() = default;
 
 	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> _cmdAlloc;
+	// One per recording thread, an allocator can only back one list being recorded at a time
+	std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> _workerCmdAllocs;
 	std::unique_ptr<d3dUtil::UploadBuffer<PassBuffer>> _pass = nullptr;
 	std::unique_ptr<d3dUtil::UploadBuffer<ConstantBuffer>> _cb = nullptr;
 	std::unique_ptr<d3dUtil::UploadBuffer<MaterialConstant>> _mat = nullptr;
+	// Structured buffers bound as root SRVs. The instances stay at their item's slot and are only rewritten when dirty,
+	// the indices list the visible items grouped by batch and are rebuilt every frame
+	std::unique_ptr<d3dUtil::UploadBuffer<InstanceData>> _instances = nullptr;
+	std::unique_ptr<d3dUtil::UploadBuffer<UINT>> _instanceIndices = nullptr;
+	// Point and spot lights and the cluster lists indexing them, see LightClusters. Both grow with the scene's lights
+	std::unique_ptr<d3dUtil::UploadBuffer<Light>> _lights = nullptr;
+	std::unique_ptr<d3dUtil::UploadBuffer<UINT>> _lightClusters = nullptr;
 	UINT64 _fence = 0u;
 };
@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+
+// Submission order of the frame, each layer has its own pipeline state
+enum class RenderLayer : std::uint8_t
+{
+	Opaque = 0,
+	AlphaTested,
+	Transparent,
+	Count,
+};
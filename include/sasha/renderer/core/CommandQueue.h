@@ -1,5 +1,6 @@
 #pragma once
 #include "../../utility/d3dIncludes.h"
+#include <span>
 
 class CommandQueue
 {
@@ -11,6 +12,8 @@ public:
 	~CommandQueue();
 
 	void ExecuteCmdList(ID3D12GraphicsCommandList* cmdList) const;
+	// Closes the lists and submits them in a single call, the GPU runs them in span order
+	void ExecuteCmdList(std::span<ID3D12GraphicsCommandList* const> cmdLists) const;
 	void Signal() const;
 	void Flush() const;
 
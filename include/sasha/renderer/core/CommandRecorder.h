@@ -0,0 +1,227 @@
+#pragma once
+#include <d3d12.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+enum class RecordedCall : std::uint8_t
+{
+	PipelineState = 0,
+	RootSignature,
+	RootDescriptorTable,
+	// Root constant buffer and shader resource views
+	RootDescriptor,
+	DescriptorHeaps,
+	VertexBuffers,
+	IndexBuffer,
+	PrimitiveTopology,
+	Count,
+};
+
+struct CommandRecorderCounters
+{
+	std::array<size_t, static_cast<size_t>(RecordedCall::Count)> _issued{};
+	std::array<size_t, static_cast<size_t>(RecordedCall::Count)> _elided{};
+
+	size_t GetIssued(RecordedCall call) const noexcept { return _issued[static_cast<size_t>(call)]; }
+	size_t GetElided(RecordedCall call) const noexcept { return _elided[static_cast<size_t>(call)]; }
+};
+
+// Shadows the state bound on a command list and drops the calls that would bind what is already there.
+// CommandListT is ID3D12GraphicsCommandList in the renderer, any type with the same methods works.
+// Draws, barriers and anything not shadowed go straight through Get()
+template <typename CommandListT>
+class CommandRecorder
+{
+public:
+	static constexpr UINT kMaxRootParameters = 64u;
+	static constexpr UINT kMaxVertexBuffers = D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT;
+
+	CommandRecorder() = default;
+	explicit CommandRecorder(CommandListT* cmdList, ID3D12PipelineState* pso = nullptr) noexcept
+	{
+		Reset(cmdList, pso);
+	}
+
+	// Call after the command list itself was reset with pso: everything else starts unbound. The counters are kept
+	void Reset(CommandListT* cmdList, ID3D12PipelineState* pso = nullptr) noexcept
+	{
+		_cmdList = cmdList;
+		_pso = pso;
+		_rootSignature = nullptr;
+		_heaps = {};
+		_heapCount = 0u;
+		_vertexBuffers = {};
+		_boundVertexBuffers = 0u;
+		_indexBuffer = {};
+		_indexBufferBound = false;
+		_topology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+		ClearRootArguments();
+	}
+
+	void ResetCounters() noexcept { _counters = {}; }
+	const CommandRecorderCounters& GetCounters() const noexcept { return _counters; }
+	CommandListT* Get() const noexcept { return _cmdList; }
+
+	void SetPipelineState(ID3D12PipelineState* pso)
+	{
+		if (!Record(RecordedCall::PipelineState, pso != _pso))
+			return;
+		_pso = pso;
+		_cmdList->SetPipelineState(pso);
+	}
+
+	// Binding a different root signature invalidates every root argument
+	void SetGraphicsRootSignature(ID3D12RootSignature* rootSignature)
+	{
+		if (!Record(RecordedCall::RootSignature, rootSignature != _rootSignature))
+			return;
+		_rootSignature = rootSignature;
+		ClearRootArguments();
+		_cmdList->SetGraphicsRootSignature(rootSignature);
+	}
+
+	// Tables point into the bound heaps, so changing the heaps invalidates them
+	void SetDescriptorHeaps(UINT count, ID3D12DescriptorHeap* const* heaps)
+	{
+		bool changed = count != _heapCount || count > _heaps.size();
+		for (UINT i = 0; !changed && i < count; i++)
+			changed = heaps[i] != _heaps[i];
+
+		if (!Record(RecordedCall::DescriptorHeaps, changed))
+			return;
+
+		_heapCount = count;
+		for (UINT i = 0; i < count && i < _heaps.size(); i++)
+			_heaps[i] = heaps[i];
+		for (auto& argument : _rootArguments)
+			if (argument._type == RootArgumentType::Table)
+				argument = {};
+
+		_cmdList->SetDescriptorHeaps(count, heaps);
+	}
+
+	void SetGraphicsRootDescriptorTable(UINT index, D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor)
+	{
+		if (!RecordRootArgument(index, RootArgumentType::Table, baseDescriptor.ptr))
+			return;
+		_cmdList->SetGraphicsRootDescriptorTable(index, baseDescriptor);
+	}
+
+	void SetGraphicsRootConstantBufferView(UINT index, D3D12_GPU_VIRTUAL_ADDRESS address)
+	{
+		if (!RecordRootArgument(index, RootArgumentType::Cbv, address))
+			return;
+		_cmdList->SetGraphicsRootConstantBufferView(index, address);
+	}
+
+	void SetGraphicsRootShaderResourceView(UINT index, D3D12_GPU_VIRTUAL_ADDRESS address)
+	{
+		if (!RecordRootArgument(index, RootArgumentType::Srv, address))
+			return;
+		_cmdList->SetGraphicsRootShaderResourceView(index, address);
+	}
+
+	void IASetVertexBuffers(UINT startSlot, UINT count, const D3D12_VERTEX_BUFFER_VIEW* views)
+	{
+		bool changed = startSlot + count > kMaxVertexBuffers;
+		for (UINT i = 0; !changed && i < count; i++)
+		{
+			const UINT slot = startSlot + i;
+			changed = !(_boundVertexBuffers & (1u << slot)) || !Equal(views[i], _vertexBuffers[slot]);
+		}
+
+		if (!Record(RecordedCall::VertexBuffers, changed))
+			return;
+
+		for (UINT i = 0; i < count && startSlot + i < kMaxVertexBuffers; i++)
+		{
+			_vertexBuffers[startSlot + i] = views[i];
+			_boundVertexBuffers |= 1u << (startSlot + i);
+		}
+		_cmdList->IASetVertexBuffers(startSlot, count, views);
+	}
+
+	void IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* view)
+	{
+		const bool changed = !_indexBufferBound || !Equal(*view, _indexBuffer);
+		if (!Record(RecordedCall::IndexBuffer, changed))
+			return;
+		_indexBuffer = *view;
+		_indexBufferBound = true;
+		_cmdList->IASetIndexBuffer(view);
+	}
+
+	void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology)
+	{
+		if (!Record(RecordedCall::PrimitiveTopology, topology != _topology))
+			return;
+		_topology = topology;
+		_cmdList->IASetPrimitiveTopology(topology);
+	}
+
+private:
+	enum class RootArgumentType : std::uint8_t
+	{
+		Unbound = 0,
+		Table,
+		Cbv,
+		Srv,
+	};
+
+	struct RootArgument
+	{
+		RootArgumentType _type = RootArgumentType::Unbound;
+		std::uint64_t _value = 0u;
+	};
+
+	bool Record(RecordedCall call, bool changed) noexcept
+	{
+		auto& counter = changed ? _counters._issued : _counters._elided;
+		counter[static_cast<size_t>(call)]++;
+		return changed;
+	}
+
+	bool RecordRootArgument(UINT index, RootArgumentType type, std::uint64_t value) noexcept
+	{
+		const auto call = type == RootArgumentType::Table ? RecordedCall::RootDescriptorTable : RecordedCall::RootDescriptor;
+		if (index >= kMaxRootParameters)
+			return Record(call, true);
+
+		auto& argument = _rootArguments[index];
+		if (!Record(call, argument._type != type || argument._value != value))
+			return false;
+
+		argument = { type, value };
+		return true;
+	}
+
+	void ClearRootArguments() noexcept
+	{
+		_rootArguments.fill({});
+	}
+
+	// Views are plain structs with no padding, comparing their bytes compares every field
+	template <typename View>
+	static bool Equal(const View& a, const View& b) noexcept
+	{
+		return std::memcmp(&a, &b, sizeof(View)) == 0;
+	}
+
+private:
+	CommandListT* _cmdList = nullptr;
+	CommandRecorderCounters _counters;
+
+	ID3D12PipelineState* _pso = nullptr;
+	ID3D12RootSignature* _rootSignature = nullptr;
+	std::array<ID3D12DescriptorHeap*, 2> _heaps{};
+	UINT _heapCount = 0u;
+	std::array<RootArgument, kMaxRootParameters> _rootArguments{};
+
+	std::array<D3D12_VERTEX_BUFFER_VIEW, kMaxVertexBuffers> _vertexBuffers{};
+	std::uint32_t _boundVertexBuffers = 0u;
+	D3D12_INDEX_BUFFER_VIEW _indexBuffer{};
+	bool _indexBufferBound = false;
+	D3D12_PRIMITIVE_TOPOLOGY _topology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+};
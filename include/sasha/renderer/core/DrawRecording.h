@@ -0,0 +1,126 @@
+#pragma once
+#include "CommandRecorder.h"
+#include <algorithm>
+#include <span>
+
+struct RootArgumentBinding
+{
+	enum class Type : std::uint8_t
+	{
+		Table,
+		Cbv,
+		Srv,
+	};
+
+	UINT _index = 0u;
+	Type _type = Type::Cbv;
+	// GPU descriptor handle for tables, GPU virtual address otherwise
+	std::uint64_t _value = 0u;
+};
+
+// Everything one draw binds, resolved on the main thread so the recording threads only touch their command list
+struct DrawCommand
+{
+	static constexpr UINT kMaxRootArguments = 4u;
+
+	ID3D12PipelineState* _pso = nullptr;
+	D3D12_VERTEX_BUFFER_VIEW _vertexBuffer{};
+	D3D12_INDEX_BUFFER_VIEW _indexBuffer{};
+	D3D12_PRIMITIVE_TOPOLOGY _topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+	std::array<RootArgumentBinding, kMaxRootArguments> _rootArguments{};
+	UINT _rootArgumentCount = 0u;
+
+	UINT _indexCount = 0u;
+	UINT _instanceCount = 0u;
+	UINT _startIndexLocation = 0u;
+	INT _baseVertexLocation = 0;
+};
+
+// State shared by every draw of the frame. Command lists don't inherit anything, so each one binds it before its first draw
+struct DrawListSetup
+{
+	static constexpr UINT kMaxRootArguments = 8u;
+
+	D3D12_VIEWPORT _viewport{};
+	D3D12_RECT _scissorRect{};
+	D3D12_CPU_DESCRIPTOR_HANDLE _renderTarget{};
+	D3D12_CPU_DESCRIPTOR_HANDLE _depthStencil{};
+
+	ID3D12RootSignature* _rootSignature = nullptr;
+	std::array<ID3D12DescriptorHeap*, 2> _heaps{};
+	UINT _heapCount = 0u;
+	std::array<RootArgumentBinding, kMaxRootArguments> _rootArguments{};
+	UINT _rootArgumentCount = 0u;
+};
+
+// Draws [_begin, _end) of the frame, recorded into one command list
+struct DrawRange
+{
+	size_t _begin = 0u;
+	size_t _end = 0u;
+};
+
+class DrawRecording
+{
+public:
+	// Splits the draws into contiguous ranges of at least minDrawsPerList, at most ranges.size() of them, balanced by count.
+	// Submitting the lists in range order keeps the draw order of a single list. Returns the number of ranges written
+	static size_t Partition(size_t drawCount, size_t minDrawsPerList, std::span<DrawRange> ranges) noexcept
+	{
+		if (drawCount == 0u || ranges.empty())
+			return 0u;
+
+		minDrawsPerList = std::max<size_t>(minDrawsPerList, 1u);
+		const size_t rangeCount = std::clamp<size_t>(drawCount / minDrawsPerList, 1u, ranges.size());
+		for (size_t r = 0; r < rangeCount; r++)
+			ranges[r] = { drawCount * r / rangeCount, drawCount * (r + 1u) / rangeCount };
+
+		return rangeCount;
+	}
+
+	// Binds the setup then records the draws, every bind goes through the recorder so repeats are dropped
+	template<typename CommandListT>
+	static void Record(CommandRecorder<CommandListT>& recorder, const DrawListSetup& setup, std::span<const DrawCommand> draws)
+	{
+		auto* cmdList = recorder.Get();
+		cmdList->RSSetViewports(1u, &setup._viewport);
+		cmdList->RSSetScissorRects(1u, &setup._scissorRect);
+		cmdList->OMSetRenderTargets(1u, &setup._renderTarget, true, &setup._depthStencil);
+
+		if (setup._heapCount > 0u)
+			recorder.SetDescriptorHeaps(setup._heapCount, setup._heaps.data());
+		recorder.SetGraphicsRootSignature(setup._rootSignature);
+		for (UINT i = 0; i < setup._rootArgumentCount; i++)
+			Bind(recorder, setup._rootArguments[i]);
+
+		for (const auto& draw : draws)
+		{
+			recorder.SetPipelineState(draw._pso);
+			recorder.IASetVertexBuffers(0u, 1u, &draw._vertexBuffer);
+			recorder.IASetIndexBuffer(&draw._indexBuffer);
+			recorder.IASetPrimitiveTopology(draw._topology);
+			for (UINT i = 0; i < draw._rootArgumentCount; i++)
+				Bind(recorder, draw._rootArguments[i]);
+
+			cmdList->DrawIndexedInstanced(draw._indexCount, draw._instanceCount, draw._startIndexLocation, draw._baseVertexLocation, 0u);
+		}
+	}
+
+private:
+	template<typename CommandListT>
+	static void Bind(CommandRecorder<CommandListT>& recorder, const RootArgumentBinding& argument)
+	{
+		switch (argument._type)
+		{
+		case RootArgumentBinding::Type::Table:
+			recorder.SetGraphicsRootDescriptorTable(argument._index, D3D12_GPU_DESCRIPTOR_HANDLE{ argument._value });
+			break;
+		case RootArgumentBinding::Type::Cbv:
+			recorder.SetGraphicsRootConstantBufferView(argument._index, argument._value);
+			break;
+		case RootArgumentBinding::Type::Srv:
+			recorder.SetGraphicsRootShaderResourceView(argument._index, argument._value);
+			break;
+		}
+	}
+};
@@ -10,6 +10,8 @@ public:
 
 	void AddDescriptorTable(D3D12_DESCRIPTOR_RANGE_TYPE type, UINT numDesc, UINT shaderReg, UINT regSpace = 0u) noexcept;
 	void AddCBV(UINT shaderReg, UINT regSpace = 0u) noexcept;
+	// Root descriptor, only valid for buffers such as structured buffers
+	void AddSRV(UINT shaderReg, UINT regSpace = 0u) noexcept;
 	void AddRootConstant() noexcept;
 
 private:
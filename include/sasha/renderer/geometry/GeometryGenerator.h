@@ -16,6 +16,7 @@
 
 #include <cstdint>
 #include <DirectXMath.h>
+#include <span>
 #include <vector>
 #include <string>
 
@@ -76,6 +77,18 @@ public:
 		std::vector<uint16> mIndices16;
 	};
 
+	// Exact vertex and index counts of a generated mesh
+	struct MeshSize
+	{
+		size_t VertexCount = 0;
+		size_t IndexCount = 0;
+	};
+
+	static MeshSize GetSphereSize(uint32 sliceCount, uint32 stackCount);
+	static MeshSize GetGeosphereSize(uint32 numSubdivisions);
+	static MeshSize GetCylinderSize(uint32 sliceCount, uint32 stackCount);
+	static MeshSize GetGridSize(uint32 m, uint32 n);
+
 	///<summary>
 	/// Creates a box centered at the origin with the given dimensions, where each
 	/// face has m rows and n columns of vertices.
@@ -107,16 +120,35 @@ public:
 	///</summary>
 	MeshData CreateGrid(float width, float depth, uint32 m, uint32 n);
 
+	///<summary>
+	/// Same meshes as above, written into caller owned storage such as an upload heap or an arena.
+	/// The spans must hold exactly the counts returned by the matching Get*Size.  Rows are generated
+	/// in parallel, the output is bit-identical to the serial version.
+	///</summary>
+	void CreateSphere(float radius, uint32 sliceCount, uint32 stackCount, std::span<Vertex> vertices, std::span<uint32> indices);
+	void CreateGeosphere(float radius, uint32 numSubdivisions, std::span<Vertex> vertices, std::span<uint32> indices);
+	void CreateCylinder(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount, std::span<Vertex> vertices, std::span<uint32> indices);
+	void CreateGrid(float width, float depth, uint32 m, uint32 n, std::span<Vertex> vertices, std::span<uint32> indices);
+
 	///<summary>
 	/// Creates a quad aligned with the screen.  This is useful for postprocessing and screen effects.
 	///</summary>
 	MeshData CreateQuad(float x, float y, float w, float h, float depth);
 
+	///<summary>
+	/// Loads a text model (VertexList/TriangleList format).  The sections are parsed in
+	/// parallel; malformed input throws std::runtime_error naming the offending line.
+	///</summary>
 	MeshData ReadFile(const std::string& filename);
 
 private:
 	void Subdivide(MeshData& meshData);
 	Vertex MidPoint(const Vertex& v0, const Vertex& v1);
-	void BuildCylinderTopCap(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount, MeshData& meshData);
-	void BuildCylinderBottomCap(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount, MeshData& meshData);
+	MeshData BuildGeosphereTopology(uint32 numSubdivisions);
+	void ProjectGeosphere(float radius, std::span<const Vertex> source, std::span<Vertex> vertices);
+	// Caps write their ring and center vertex to vertices, baseIndex is the index of vertices[0] in the whole mesh
+	void BuildCylinderTopCap(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount,
+		uint32 baseIndex, std::span<Vertex> vertices, std::span<uint32> indices);
+	void BuildCylinderBottomCap(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount,
+		uint32 baseIndex, std::span<Vertex> vertices, std::span<uint32> indices);
 };
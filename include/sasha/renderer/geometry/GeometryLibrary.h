@@ -2,15 +2,76 @@
 #include "Mesh.h"
 #include "Material.h"
 #include "Texture.h"
+#include "IndexPools.h"
 #include "GeometryGenerator.h"
+#include "MeshOptimizer.h"
+#include "Meshlet.h"
+#include <span>
+
+// Optional processing applied to a mesh before it is appended to the shared buffers
+struct MeshImportOptions
+{
+    // Merges duplicate vertices before any other pass, the default tolerances only catch exact copies.
+    // Off by default so pre-baked input isn't reprocessed on every launch, MeshCache welds when it bakes
+    bool _weldVertices = false;
+    WeldTolerances _weldTolerances;
+
+    bool _optimizeVertexCache = false;
+    VertexCacheModel _cacheModel = VertexCacheModel::Fifo;
+    std::uint32_t _cacheSize = 16u;
+
+    // Sorts triangle clusters front to back, runs after the cache pass and may cost up to _overdrawThreshold in ACMR
+    bool _optimizeOverdraw = false;
+    float _overdrawThreshold = 1.05f;
+
+    // Renumbers vertices in first use order and drops unreferenced ones, runs last
+    bool _optimizeVertexFetch = false;
+
+    // Triangle ratio of each extra level of detail relative to the full mesh, e.g. { 0.5f, 0.25f, 0.125f }.
+    // Levels are simplified from the processed mesh and index into its vertices
+    std::vector<float> _lodTriangleRatios;
+
+    // Splits the mesh and each of its levels of detail into meshlets for cluster culling
+    bool _buildMeshlets = false;
+};
+
+struct MeshImportReport
+{
+    size_t _weldedVertices = 0u;
+    VertexCacheStats _cacheBefore;
+    VertexCacheStats _cacheAfter;
+    OverdrawStats _overdrawBefore;
+    OverdrawStats _overdrawAfter;
+    VertexFetchStats _fetchBefore;
+    VertexFetchStats _fetchAfter;
+};
+
+struct MeshLod
+{
+    SubMeshID _submesh = 0;
+    // Largest simplification error of the level in mesh units, 0 for the full mesh
+    float _error = 0.f;
+};
+
+// Levels of a mesh from finest to coarsest, level 0 is the mesh itself
+struct MeshLodChain
+{
+    std::vector<MeshLod> _levels;
+};
 
 class GeometryLibrary
 {
 public:
-    void AddGeometry(const std::string& name, GeometryGenerator::MeshData& mesh);
+    void AddGeometry(const std::string& name, GeometryGenerator::MeshData& mesh, const MeshImportOptions& options = {});
+    void AddGeometry(const std::string& name, std::span<const Vertex> vertices, std::span<const std::uint32_t> indices, const MeshImportOptions& options = {});
     void AddMaterial(const std::string& name, std::unique_ptr<Material>&& mat);
     void AddTexture(const std::string& name, std::unique_ptr<Texture>&& tex);
 
+    // Format of the GPU vertex buffer, Compact quantizes every mesh to its own bounds at upload
+    void SetVertexFormat(VertexFormat format, TexCoordEncoding texEncoding = TexCoordEncoding::Half) noexcept;
+    VertexFormat GetVertexFormat() const noexcept;
+    TexCoordEncoding GetTexCoordEncoding() const noexcept;
+
     void Upload(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList);
 
     [[nodiscard]] const MeshGeometry& GetMesh() const noexcept;
@@ -18,6 +79,10 @@ public:
 
     const SubmeshGeometry& GetSubmesh(const std::string& name) const;
     const SubmeshGeometry& GetSubmesh(SubMeshID id) const;
+    const MeshImportReport& GetImportReport(SubMeshID id) const;
+    const MeshLodChain& GetLodChain(SubMeshID id) const;
+    // Meshlets of every submesh, their vertex references index the shared vertex buffer directly
+    const MeshletTable& GetMeshlets() const noexcept;
 
     const Material& GetMaterial(const std::string& name) const;
     Material& GetMaterial(const std::string& name);
@@ -32,18 +97,32 @@ public:
     SubMeshID GetSubmeshID(const std::string& name) const;
     MaterialID GetMaterialID(const std::string& name) const;
     
+    size_t GetSubmeshCount() const noexcept;
     size_t GetMaterialCount() const noexcept;
     size_t GetTextureCount() const noexcept;
 
+private:
+    void OptimizeMesh(GeometryGenerator::MeshData& mesh, const MeshImportOptions& options, MeshImportReport& report) const;
+    // Runs the pass matching options._cacheModel and keeps its order only if it lowers ACMR, fills the cache stats of report
+    static void OptimizeVertexCache(std::vector<std::uint32_t>& indices, size_t vertexCount, const MeshImportOptions& options, MeshImportReport& report);
+    SubMeshID AddSubmesh(const std::string& name, UINT baseVertex, std::span<const std::uint32_t> indices, const MeshBounds& bounds, const MeshImportReport& report);
+    void AddMeshlets(SubMeshID id, std::span<const std::uint32_t> indices, std::span<const GeometryGenerator::Vertex> vertices);
+    void BuildLods(const std::string& name, SubMeshID base, const GeometryGenerator::MeshData& mesh, const MeshBounds& bounds, const MeshImportOptions& options);
+
 private:
     std::vector<Vertex> _vertices;
-    std::vector<std::uint16_t> _indices;
+    VertexFormat _vertexFormat = VertexFormat::Full;
+    TexCoordEncoding _texCoordEncoding = TexCoordEncoding::Half;
+    IndexPools _indexPools;
 
     std::unordered_map<std::string, SubMeshID> _nameToSubmesh;
     std::unordered_map<std::string, MaterialID> _nameToMaterial;
     std::unordered_map<std::string, TextureID> _nameToTexture;
 
     std::vector<SubmeshGeometry> _submeshes;
+    std::vector<MeshImportReport> _importReports;
+    std::vector<MeshLodChain> _lodChains;
+    MeshletTable _meshlets;
     std::vector<std::unique_ptr<Material>> _materials;
     std::vector <std::unique_ptr<Texture>> _textures;
 
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+enum class IndexWidth : std::uint8_t
+{
+	Bits16 = 0,
+	Bits32,
+};
+
+// Where a mesh's indices landed, _start counts in indices of the pool matching _width
+struct IndexRange
+{
+	IndexWidth _width = IndexWidth::Bits16;
+	std::uint32_t _start = 0u;
+	std::uint32_t _count = 0u;
+};
+
+// Two index pools so small meshes keep 16 bit indices while large ones still load.
+// Indices are relative to the mesh's base vertex, so only meshes with more than 65536 vertices need the 32 bit pool
+class IndexPools
+{
+public:
+	IndexRange Append(std::span<const std::uint32_t> indices);
+
+	// Widens the range back to 32 bit indices
+	std::vector<std::uint32_t> Read(const IndexRange& range) const;
+
+	const std::vector<std::uint16_t>& GetIndices16() const noexcept { return _indices16; }
+	const std::vector<std::uint32_t>& GetIndices32() const noexcept { return _indices32; }
+
+private:
+	std::vector<std::uint16_t> _indices16;
+	std::vector<std::uint32_t> _indices32;
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include "../../utility/d3dUtil.h"
+#include "../RenderLayer.h"
 
 struct MaterialConstant
 {
@@ -11,9 +12,15 @@ struct MaterialConstant
 
 struct Material
 {
+	// Call after changing _matProperties, the constants are then copied into each frame resource once
+	void MarkDirty() noexcept { _dirty.Mark(); }
+
 	std::string name = "";
 	int _matCBIndex = -1;
 	int _diffuseSrvHeapIndex = -1;
-	int _numDirtyFlags = 3;
+	// Frame resources still holding stale constants
+	d3dUtil::DirtyCount _dirty;
+	// Decides the pipeline state and the submission order of every item using the material
+	RenderLayer _layer = RenderLayer::Opaque;
 	MaterialConstant _matProperties;
 };
@@ -1,6 +1,7 @@
 #pragma once
 #include "../../utility/d3dUtil.h"
 #include "Material.h"
+#include "VertexCodec.h"
 
 using MeshID = uint16_t;
 using SubMeshID = uint16_t;
@@ -14,10 +15,24 @@ struct Vertex
 	DirectX::XMFLOAT2 Tex;
 };
 
+// Per draw constants, one draw covers every instance of a batch
 struct ConstantBuffer
+{
+	DirectX::XMFLOAT4 posScale = { 1.0f, 1.0f, 1.0f, 0.0f };
+	DirectX::XMFLOAT4 posBias = { 0.0f, 0.0f, 0.0f, 0.0f };
+	// First element of the draw in the instance buffer, SV_InstanceID doesn't include StartInstanceLocation
+	UINT instanceOffset = 0u;
+};
+
+// Element of the per frame instance buffer, one per render item at its _cbObjIndex
+struct InstanceData
 {
 	DirectX::XMFLOAT4X4 world = d3dUtil::Identity4x4();
 	DirectX::XMFLOAT4X4 texTrans = d3dUtil::Identity4x4();
+	// Lights of the item when PassBuffer::PerObjectLights is set, indices into the local lights like the cluster lists
+	DirectX::XMUINT4 lights = { 0u, 0u, 0u, 0u };
+	UINT lightCount = 0u;
+	DirectX::XMUINT3 instancePad = { 0u, 0u, 0u };
 };
 
 enum class LightType : uint32_t
@@ -55,14 +70,18 @@ struct PassBuffer
 	float DeltaTime = 0.0f;
 
 	DirectX::XMFLOAT4 AmbientLight = { 0.0f, 0.0f, 0.0f, 1.0f };
-	Light Lights[16];
-};
 
-struct ObjectInstance
-{
-	std::string meshName;       
-	DirectX::XMFLOAT4X4 transform;
-	std::string matName;
+	// Froxel grid the pixel shader looks its lights up in, see ClusterGrid
+	DirectX::XMUINT3 ClusterDims = { 0u, 0u, 0u };
+	UINT DirLightCount = 0u;
+	float ClusterSliceScale = 0.0f;
+	float ClusterSliceBias = 0.0f;
+	// Non zero when the pixel shaders read each item's own lights instead of the clusters
+	UINT PerObjectLights = 0u;
+	float cbPerObjectPad2 = 0.0f;
+
+	// Directional lights only, point and spot lights go through the clusters
+	Light Lights[16];
 };
 
 struct SubmeshGeometry
@@ -70,45 +89,82 @@ struct SubmeshGeometry
 	UINT _indexCount = 0;
 	UINT _startIndexLocation = 0;
 	INT _baseVertexLocation = 0;
+	// Picks the index pool, _startIndexLocation counts in that pool's indices
+	DXGI_FORMAT _indexFormat = DXGI_FORMAT_R16_UINT;
+
+	// Range in GeometryLibrary's meshlet table, empty unless meshlets were built on import
+	UINT _firstMeshlet = 0;
+	UINT _meshletCount = 0;
+
+	// Object space bounds of the vertex range, levels of detail share their base mesh's bounds
+	DirectX::BoundingBox _aabb;
+	DirectX::BoundingSphere _sphere;
+
+	// Bounds the positions were quantized to, the identity for full float vertices
+	QuantizationBounds _quantization;
+};
+
+// One index buffer of a single width, submeshes pick the pool matching their _indexFormat
+struct IndexPool
+{
+	template <typename IndexContainer>
+	void Create(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const IndexContainer& indices)
+	{
+		_byteSize = static_cast<UINT>(indices.size() * sizeof(typename IndexContainer::value_type));
+		if (_byteSize == 0u)
+			return;
+
+		ThrowIfFailed(D3DCreateBlob(_byteSize, &_cpu));
+		CopyMemory(_cpu->GetBufferPointer(), indices.data(), _byteSize);
+
+		_gpu = d3dUtil::CreateBuffer(device, cmdList, _uploader, indices.data(), _byteSize);
+	}
+
+	Microsoft::WRL::ComPtr<ID3DBlob> _cpu = nullptr;
+	Microsoft::WRL::ComPtr<ID3D12Resource> _gpu = nullptr;
+	Microsoft::WRL::ComPtr<ID3D12Resource> _uploader = nullptr;
+
+	DXGI_FORMAT _format = DXGI_FORMAT_R16_UINT;
+	UINT _byteSize = 0;
 };
 
 struct MeshGeometry
 {
-	template <typename VertexContainer, typename IndexContainer>
-	MeshGeometry(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const VertexContainer& vertices, const IndexContainer& indices)
-		: _vertexStride(sizeof(Vertex))
+	template <typename VertexContainer, typename IndexContainer16, typename IndexContainer32>
+	MeshGeometry(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const VertexContainer& vertices,
+		const IndexContainer16& indices16, const IndexContainer32& indices32)
+		: _vertexStride(sizeof(typename VertexContainer::value_type))
 		, _vertexByteSize(static_cast<UINT>(vertices.size()* _vertexStride))
-		, _indexByteSize(static_cast<UINT>(indices.size() * sizeof(std::uint16_t)))
 	{
+		static_assert(sizeof(typename IndexContainer16::value_type) == 2u && sizeof(typename IndexContainer32::value_type) == 4u);
+
 		ThrowIfFailed(D3DCreateBlob(_vertexByteSize, &_vertexCPU));
 		CopyMemory(_vertexCPU->GetBufferPointer(), vertices.data(), _vertexByteSize);
 
-		ThrowIfFailed(D3DCreateBlob(_indexByteSize, &_indexCPU));
-		CopyMemory(_indexCPU->GetBufferPointer(), indices.data(), _indexByteSize);
-
 		/*_vertexGPU = std::make_unique<d3dUtil::UploadBuffer<Vertex>>(device, static_cast<UINT>(vertices.size()), false);
 		for (size_t i = 0; i < vertices.size(); i++)
 			_vertexGPU->CopyData(static_cast<UINT>(i), vertices[i]);*/
 		_vertexGPU = d3dUtil::CreateBuffer(device, cmdList, _vertexUploader, vertices.data(), _vertexByteSize);
-		_indexGPU = d3dUtil::CreateBuffer(device, cmdList, _indexUploader, indices.data(), _indexByteSize);
+
+		_indexPools[0]._format = DXGI_FORMAT_R16_UINT;
+		_indexPools[0].Create(device, cmdList, indices16);
+		_indexPools[1]._format = DXGI_FORMAT_R32_UINT;
+		_indexPools[1].Create(device, cmdList, indices32);
 	}
 
 	std::string Name;
 
 	Microsoft::WRL::ComPtr<ID3DBlob> _vertexCPU = nullptr;
-	Microsoft::WRL::ComPtr<ID3DBlob> _indexCPU = nullptr;
 
 	//std::unique_ptr<d3dUtil::UploadBuffer<Vertex>> _vertexGPU;
 	Microsoft::WRL::ComPtr<ID3D12Resource> _vertexGPU = nullptr;
-	Microsoft::WRL::ComPtr<ID3D12Resource> _indexGPU = nullptr;
-
 	Microsoft::WRL::ComPtr<ID3D12Resource> _vertexUploader = nullptr;
-	Microsoft::WRL::ComPtr<ID3D12Resource> _indexUploader = nullptr;
+
+	// 16 bit pool first, then 32 bit
+	IndexPool _indexPools[2];
 
 	UINT _vertexStride = 0;
 	UINT _vertexByteSize = 0;
-	DXGI_FORMAT _indexFormat = DXGI_FORMAT_R16_UINT;
-	UINT _indexByteSize = 0;
 
 	D3D12_VERTEX_BUFFER_VIEW VertexBufferView() const noexcept
 	{
@@ -120,12 +176,15 @@ struct MeshGeometry
 		return vbv;
 	}
 
-	D3D12_INDEX_BUFFER_VIEW IndexBufferView() const noexcept
+	D3D12_INDEX_BUFFER_VIEW IndexBufferView(DXGI_FORMAT format = DXGI_FORMAT_R16_UINT) const noexcept
 	{
+		const auto& pool = _indexPools[format == DXGI_FORMAT_R32_UINT ? 1 : 0];
+		assert(pool._gpu);
+
 		D3D12_INDEX_BUFFER_VIEW ibv;
-		ibv.BufferLocation = _indexGPU->GetGPUVirtualAddress();
-		ibv.Format = _indexFormat;
-		ibv.SizeInBytes = _indexByteSize;
+		ibv.BufferLocation = pool._gpu->GetGPUVirtualAddress();
+		ibv.Format = pool._format;
+		ibv.SizeInBytes = pool._byteSize;
 
 		return ibv;
 	}
@@ -133,6 +192,7 @@ struct MeshGeometry
 	void DisposeUploaders() noexcept
 	{
 		_vertexUploader = nullptr;
-		_indexUploader = nullptr;
+		for (auto& pool : _indexPools)
+			pool._uploader = nullptr;
 	}
 };
\ No newline at end of file
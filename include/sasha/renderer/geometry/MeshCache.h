@@ -0,0 +1,65 @@
+#pragma once
+#include "Mesh.h"
+#include "GeometryGenerator.h"
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <wrl/wrappers/corewrappers.h>
+
+// On-disk layout of a baked mesh: header, vertex array, uint32 index array.
+// Both arrays are stored exactly as GeometryLibrary consumes them so a load is a single mapping.
+// Exact duplicate vertices are welded when baking, so importing a mapping doesn't need the weld pass
+struct MeshFileHeader
+{
+	static constexpr std::uint32_t Magic = 0x48534D53; // "SMSH"
+	static constexpr std::uint32_t Version = 2u;
+
+	std::uint32_t _magic = Magic;
+	std::uint32_t _version = Version;
+	std::uint32_t _vertexStride = sizeof(Vertex);
+	std::uint32_t _vertexCount = 0u;
+	std::uint32_t _indexCount = 0u;
+	// Vertices the bake removed from the source
+	std::uint32_t _weldedVertices = 0u;
+
+	// Snapshot of the source text file used to detect a stale cache
+	std::uint64_t _sourceSize = 0u;
+	std::int64_t _sourceWriteTime = 0;
+};
+
+class MappedMesh
+{
+public:
+	// Throws when the file can't be mapped or its size doesn't match its header, the handles are released either way
+	explicit MappedMesh(const std::filesystem::path& path);
+
+	MappedMesh(const MappedMesh&) = delete;
+	MappedMesh& operator=(const MappedMesh&) = delete;
+
+	const MeshFileHeader& GetHeader() const noexcept;
+	std::span<const Vertex> GetVertices() const noexcept;
+	std::span<const std::uint32_t> GetIndices() const noexcept;
+
+private:
+	struct ViewUnmapper
+	{
+		void operator()(const BYTE* view) const noexcept { UnmapViewOfFile(view); }
+	};
+
+	// Declared in acquisition order so they are released view first, even when the constructor throws half way
+	Microsoft::WRL::Wrappers::FileHandle _file;
+	Microsoft::WRL::Wrappers::HandleT<Microsoft::WRL::Wrappers::HandleTraits::HANDLENullTraits> _mapping;
+	std::unique_ptr<const BYTE, ViewUnmapper> _view;
+	UINT64 _viewSize = 0u;
+};
+
+class MeshCache
+{
+public:
+	// Returns a mapping of the baked version of a text model, converting and welding it first if the cache is missing or stale
+	static std::unique_ptr<MappedMesh> Load(const std::filesystem::path& source);
+
+	static std::filesystem::path GetCachePath(const std::filesystem::path& source);
+	static bool IsStale(const std::filesystem::path& source, const std::filesystem::path& cache);
+	static void Write(const std::filesystem::path& source, const std::filesystem::path& cache, const GeometryGenerator::MeshData& mesh, size_t weldedVertices = 0u);
+};
@@ -0,0 +1,99 @@
+#pragma once
+#include "GeometryGenerator.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+enum class VertexCacheModel
+{
+	Fifo,
+	Lru,
+};
+
+struct VertexCacheStats
+{
+	// Average cache miss ratio: transformed vertices per triangle (0.5 is optimal for large regular meshes, 3 is worst)
+	float _acmr = 0.f;
+	// Average transformed vertices per vertex: transformed vertices per referenced vertex (1 is optimal)
+	float _atvr = 0.f;
+	size_t _transformCount = 0u;
+};
+
+struct VertexFetchStats
+{
+	size_t _bytesFetched = 0u;
+	// Bytes fetched over the size of the referenced vertices (1 is optimal)
+	float _overfetch = 0.f;
+};
+
+struct OverdrawStats
+{
+	size_t _pixelsCovered = 0u;
+	size_t _pixelsShaded = 0u;
+	// Shaded over covered pixels, averaged over the analyzed view directions (1 is optimal)
+	float _overdraw = 0.f;
+};
+
+// Axis aligned box and bounding sphere of a mesh, in mesh units
+struct MeshBounds
+{
+	DirectX::XMFLOAT3 _min = { 0.f, 0.f, 0.f };
+	DirectX::XMFLOAT3 _max = { 0.f, 0.f, 0.f };
+	DirectX::XMFLOAT3 _sphereCenter = { 0.f, 0.f, 0.f };
+	float _sphereRadius = 0.f;
+};
+
+// Largest per component difference for two vertices to be welded, 0 only welds exact duplicates
+struct WeldTolerances
+{
+	float _position = 0.f;
+	float _normal = 0.f;
+	float _texCoord = 0.f;
+};
+
+class MeshOptimizer
+{
+public:
+	// Simulates a post-transform cache of the given size over the index stream
+	static VertexCacheStats AnalyzeVertexCache(std::span<const std::uint32_t> indices, size_t vertexCount,
+		std::uint32_t cacheSize = 16u, VertexCacheModel model = VertexCacheModel::Fifo);
+
+	// Reorders triangles in place for post-transform cache reuse (Tom Forsyth's linear-speed algorithm, tuned for LRU caches)
+	static void OptimizeVertexCache(std::span<std::uint32_t> indices, size_t vertexCount);
+
+	// Reorders triangles in place for a FIFO cache of the given size (Sander et al. "Tipsify"), faster than Forsyth
+	static void OptimizeVertexCacheFifo(std::span<std::uint32_t> indices, size_t vertexCount, std::uint32_t cacheSize = 16u);
+
+	// Splits the cache optimized triangle order into clusters and sorts them so outward facing clusters draw first.
+	// threshold bounds the ACMR increase, e.g. 1.05 allows clusters to be 5% worse than the input order. The input order is
+	// kept when the sorted clusters would break that bound
+	static void OptimizeOverdraw(std::span<std::uint32_t> indices, std::span<const GeometryGenerator::Vertex> vertices,
+		float threshold = 1.05f, std::uint32_t cacheSize = 16u);
+
+	// Renumbers vertices in first use order so vertex fetch walks memory linearly, unreferenced vertices are dropped.
+	// Returns the new vertex count
+	static size_t OptimizeVertexFetch(GeometryGenerator::MeshData& mesh);
+
+	// Merges vertices whose position, normal and texcoord all lie within the tolerances, found through a spatial hash on the
+	// positions so it runs in linear time. A vertex merges into the first earlier vertex it matches, which keeps its tangent.
+	// Indices are remapped in place and the kept vertices are compacted in order. Returns the number of vertices removed
+	static size_t WeldVertices(GeometryGenerator::MeshData& mesh, const WeldTolerances& tolerances = {});
+
+	// Tight box plus a Ritter sphere (or the box centered sphere when that one is smaller), in three passes over the positions.
+	// stride is the distance in bytes between positions so any vertex layout can be passed directly
+	static MeshBounds ComputeBounds(const DirectX::XMFLOAT3* positions, size_t count, size_t stride);
+
+	// Simulates a small cache of 64 byte lines over the vertex reads of the index stream
+	static VertexFetchStats AnalyzeVertexFetch(std::span<const std::uint32_t> indices, size_t vertexCount, size_t vertexSize);
+
+	// Edge collapse simplification driven by quadric error metrics (Garland & Heckbert). Vertices only ever collapse onto
+	// existing vertices so the result indexes the same vertex buffer. Vertices on open borders or attribute seams stay put.
+	// Stops at targetIndexCount or when nothing else can collapse; resultError receives the largest collapse error
+	// as a distance in mesh units
+	static std::vector<std::uint32_t> Simplify(std::span<const std::uint32_t> indices, std::span<const GeometryGenerator::Vertex> vertices,
+		size_t targetIndexCount, float* resultError = nullptr);
+
+	// Rasterizes the mesh in submission order with a depth test from the six axis directions
+	static OverdrawStats AnalyzeOverdraw(std::span<const std::uint32_t> indices, std::span<const GeometryGenerator::Vertex> vertices);
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include "GeometryGenerator.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Meshlets split a mesh into small clusters that can be culled on their own.
+// The limits match what mesh shaders prefer: 64 vertices and 124 triangles keep a meshlet's output under 16 KB.
+// The table is a flat structure of arrays: one array per attribute, indexed by meshlet
+struct MeshletTable
+{
+	static constexpr std::uint32_t MaxVertices = 64u;
+	static constexpr std::uint32_t MaxTriangles = 124u;
+
+	// Builds meshlets by scanning the triangles in order, run it after vertex cache optimization so they come out compact
+	static MeshletTable Build(std::span<const std::uint32_t> indices, std::span<const GeometryGenerator::Vertex> vertices);
+
+	// Appends other, its vertex references are offset by baseVertex. Returns the index of its first meshlet
+	std::uint32_t Append(const MeshletTable& other, std::uint32_t baseVertex = 0u);
+
+	// Cone test, true when every triangle of the meshlet faces away from eye
+	bool IsBackfacing(size_t meshlet, const DirectX::XMFLOAT3& eye) const noexcept;
+
+	size_t GetCount() const noexcept { return _vertexCounts.size(); }
+
+	// Per meshlet: ranges into _vertices and _triangles
+	std::vector<std::uint32_t> _vertexOffsets;
+	std::vector<std::uint32_t> _triangleOffsets;
+	std::vector<std::uint8_t> _vertexCounts;
+	std::vector<std::uint8_t> _triangleCounts;
+
+	// Per meshlet: bounding sphere as center and radius
+	std::vector<DirectX::XMFLOAT4> _spheres;
+	// Per meshlet: normal cone axis and cutoff, the cutoff is 1 when the cone is too wide to ever cull
+	std::vector<DirectX::XMFLOAT4> _cones;
+	std::vector<DirectX::XMFLOAT3> _coneApexes;
+
+	// Vertex indices of the mesh referenced by each meshlet
+	std::vector<std::uint32_t> _vertices;
+	// Three local 8 bit indices per triangle, into the meshlet's slice of _vertices
+	std::vector<std::uint8_t> _triangles;
+};
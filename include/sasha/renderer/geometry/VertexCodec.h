@@ -0,0 +1,62 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstdint>
+
+enum class VertexFormat
+{
+	// Vertex: 32 bytes of floats
+	Full,
+	// CompactVertex: 16 bytes, quantized
+	Compact,
+};
+
+enum class TexCoordEncoding
+{
+	// R16G16_FLOAT, any range, ~3 significant digits
+	Half,
+	// R16G16_UNORM, clamped to [0, 1] with a uniform 1/65535 step
+	Unorm16,
+};
+
+// R16G16B16A16_UNORM position quantized to the bounds of its mesh, R16G16_SNORM octahedral normal, 16 bit texcoords
+struct CompactVertex
+{
+	std::uint16_t Pos[4];
+	std::int16_t Normal[2];
+	std::uint16_t Tex[2];
+};
+static_assert(sizeof(CompactVertex) == 16u);
+
+// Positions are stored as (p - _min) / _extent, the vertex shader undoes it with gPosScale / gPosBias
+struct QuantizationBounds
+{
+	DirectX::XMFLOAT3 _min = { 0.f, 0.f, 0.f };
+	DirectX::XMFLOAT3 _extent = { 1.f, 1.f, 1.f };
+
+	static QuantizationBounds FromMinMax(const DirectX::XMFLOAT3& boundsMin, const DirectX::XMFLOAT3& boundsMax) noexcept;
+};
+
+// CPU side encode/decode kernels, the decoders match what the input assembler and defaultVS.hlsl do.
+// Worst case errors: position about extent / 131070 per axis, normal under 0.0001 rad, half texcoord 2^-11 relative
+class VertexCodec
+{
+public:
+	static void EncodePosition(const DirectX::XMFLOAT3& p, const QuantizationBounds& bounds, std::uint16_t out[4]) noexcept;
+	static DirectX::XMFLOAT3 DecodePosition(const std::uint16_t in[4], const QuantizationBounds& bounds) noexcept;
+
+	// Octahedral mapping (Meyer et al.): the unit sphere is projected onto an octahedron which is unfolded into a square
+	static void EncodeNormal(const DirectX::XMFLOAT3& n, std::int16_t out[2]) noexcept;
+	static DirectX::XMFLOAT3 DecodeNormal(const std::int16_t in[2]) noexcept;
+
+	// IEEE binary16 with round to nearest even
+	static std::uint16_t EncodeHalf(float f) noexcept;
+	static float DecodeHalf(std::uint16_t h) noexcept;
+
+	static std::uint16_t EncodeUnorm16(float f) noexcept;
+	static float DecodeUnorm16(std::uint16_t u) noexcept;
+
+	static CompactVertex Encode(const DirectX::XMFLOAT3& pos, const DirectX::XMFLOAT3& normal, const DirectX::XMFLOAT2& tex,
+		const QuantizationBounds& bounds, TexCoordEncoding texEncoding) noexcept;
+	static void Decode(const CompactVertex& v, const QuantizationBounds& bounds, TexCoordEncoding texEncoding,
+		DirectX::XMFLOAT3& pos, DirectX::XMFLOAT3& normal, DirectX::XMFLOAT2& tex) noexcept;
+};
@@ -0,0 +1,97 @@
+#pragma once
+#include "../geometry/Mesh.h"
+#include "TextureAnimation.h"
+#include "TransformHierarchy.h"
+
+// Components of the scene's entities, stored by World in chunks so they have to stay trivially copyable
+
+// World matrix of the entity's hierarchy node, written by Scene::UpdateTransforms
+struct Transform
+{
+	DirectX::XMFLOAT4X4 _world = d3dUtil::Identity4x4();
+};
+
+// World space box of the base submesh, _scale is the largest axis scale of the world matrix.
+// _dirty is set when the world matrix changed and cleared once Scene::UpdateBounds transformed the bounds again
+struct WorldBounds
+{
+	DirectX::BoundingBox _aabb;
+	float _scale = 1.f;
+	bool _dirty = true;
+};
+
+// World space bounding sphere of the base submesh, center in xyz and radius in w. Kept apart from WorldBounds so a
+// chunk's spheres are one packed array the culling kernel reads directly
+struct WorldSphere
+{
+	DirectX::XMFLOAT4 _sphere = { 0.f, 0.f, 0.f, 0.f };
+};
+
+// Submesh the entity was created with, its bounds are the entity's
+struct MeshRef
+{
+	SubMeshID _submesh = -1;
+};
+
+// Level of detail picked from the base submesh's chain by Scene::SelectLods, _submesh is the one drawn
+struct Lod
+{
+	SubMeshID _submesh = -1;
+	std::uint8_t _level = 0u;
+};
+
+struct MaterialRef
+{
+	MaterialID _material = -1;
+};
+
+// How the entity is submitted, the layer comes from its material. There is one pipeline state per layer
+struct DrawState
+{
+	RenderLayer _layer = RenderLayer::Opaque;
+	std::uint8_t _pipeline = 0u;
+	D3D12_PRIMITIVE_TOPOLOGY _topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+};
+
+struct TexTransform
+{
+	DirectX::XMFLOAT4X4 _transform = d3dUtil::Identity4x4();
+};
+
+// Texture animation track of the entity itself, takes precedence over its material's
+struct TexAnim
+{
+	UvTrackID _track = 0u;
+};
+
+// Animated track the entity's texture transform follows, its own or its material's. Entities bound to a constant
+// track or to none don't have it, their transform was set once
+struct UvBinding
+{
+	UvTrackID _track = 0u;
+};
+
+// Strongest local lights, set by Scene::SelectItemLights when lights are picked per entity instead of per cluster
+struct SelectedLights
+{
+	DirectX::XMUINT4 _lights = { 0u, 0u, 0u, 0u };
+	UINT _count = 0u;
+};
+
+// Slot of the entity in the instance buffers. Slots stay dense, RemoveInstance moves the last one into the freed slot
+struct InstanceSlot
+{
+	std::uint32_t _slot = ~0u;
+};
+
+// Frame resources still holding an old copy of the entity's instance data, marked by whatever changes that data
+struct InstanceDirty
+{
+	d3dUtil::DirtyCount _dirty;
+};
+
+// The entity's node in Scene's TransformHierarchy, which owns its local transform
+struct HierarchyNode
+{
+	NodeID _node = TransformHierarchy::kNoNode;
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include "../RenderLayer.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// State changes of one frame's submission, counted where the command list actually changes state
+struct DrawStateCounters
+{
+	size_t _draws = 0u;
+	size_t _pipelineChanges = 0u;
+	size_t _descriptorTableChanges = 0u;
+	size_t _vertexBufferChanges = 0u;
+	size_t _indexBufferChanges = 0u;
+};
+
+// A packet is one visible item packed in 64 bits, its key above its item index. Keys sort as plain integers and the
+// layer comes first so the layers are submitted in order:
+//  Opaque and alpha tested: [layer:2][pipeline][material][submesh][depth], grouped by state then front to back
+//  Transparent:             [layer:2][~depth][pipeline][material][submesh], back to front first so blending stays correct
+// The fields are only as wide as one frame's ID ranges need, which usually leaves a key of 3 or 4 radix digits
+struct DrawKeyLayout
+{
+	static constexpr std::uint32_t kMaxDepthBits = 24u;
+
+	// Each count is one past the largest ID of its field. The depth gets up to kMaxDepthBits, fewer when the other fields
+	// and the item index leave less room, which only reorders packets of the same state at nearly the same depth
+	static DrawKeyLayout FromCounts(size_t pipelineCount, size_t materialCount, size_t submeshCount, size_t itemCount) noexcept;
+
+	// depth is the view depth normalized to [0, 1] between the near and far planes, values outside are clamped
+	std::uint64_t MakePacket(RenderLayer layer, std::uint8_t pipeline, std::uint16_t material, std::uint16_t submesh, float depth, std::uint32_t item) const noexcept;
+
+	std::uint32_t GetItem(std::uint64_t packet) const noexcept;
+	RenderLayer GetLayer(std::uint64_t packet) const noexcept;
+	// Layer, pipeline, material and submesh without the depth, packets with the same state can share a draw
+	std::uint64_t GetState(std::uint64_t packet) const noexcept;
+
+	std::uint32_t GetStateBits() const noexcept { return _pipelineBits + _materialBits + _submeshBits; }
+	std::uint32_t GetKeyBits() const noexcept { return 2u + GetStateBits() + _depthBits; }
+
+	std::uint32_t _pipelineBits = 0u;
+	std::uint32_t _materialBits = 0u;
+	std::uint32_t _submeshBits = 0u;
+	std::uint32_t _depthBits = kMaxDepthBits;
+	std::uint32_t _itemBits = 0u;
+};
+
+class DrawPackets
+{
+public:
+	// Stable LSD radix sort on the keys, up to 12 bits per pass. The item indices below the keys are never looked at, so
+	// packets with equal keys keep their order. Passes where every key has the same digit are skipped.
+	// scratch must hold packets.size() entries
+	static void RadixSort(std::span<std::uint64_t> packets, std::span<std::uint64_t> scratch, const DrawKeyLayout& layout) noexcept;
+};
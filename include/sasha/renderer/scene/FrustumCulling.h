@@ -0,0 +1,40 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Planes point inward: p is inside when dot(plane.xyz, p) + plane.w >= 0 for all six
+struct Frustum
+{
+	// Left, right, bottom, top, near, far
+	DirectX::XMFLOAT4 _planes[6];
+
+	// Gribb & Hartmann extraction from a row vector view projection with D3D's [0, 1] depth range, planes come out normalized
+	static Frustum FromViewProj(DirectX::FXMMATRIX viewProj) noexcept;
+};
+
+// World space bounding spheres as a structure of arrays, so the kernel loads the same component of four spheres at once
+struct CullingSpheres
+{
+	void Resize(size_t count);
+	void Set(size_t index, const DirectX::XMFLOAT3& center, float radius) noexcept;
+	size_t GetCount() const noexcept { return _radius.size(); }
+
+	std::vector<float> _centerX;
+	std::vector<float> _centerY;
+	std::vector<float> _centerZ;
+	std::vector<float> _radius;
+};
+
+class FrustumCulling
+{
+public:
+	// Tests four spheres per iteration and writes the indices of those touching the frustum to visible, in increasing order.
+	// visible must hold spheres.GetCount() entries. Returns the number of visible spheres
+	static size_t CullSpheres(const Frustum& frustum, const CullingSpheres& spheres, std::span<std::uint32_t> visible) noexcept;
+	// Same test on spheres packed as center in xyz and radius in w, four of them are transposed per iteration.
+	// visible must hold spheres.size() entries
+	static size_t CullSpheres(const Frustum& frustum, std::span<const DirectX::XMFLOAT4> spheres, std::span<std::uint32_t> visible) noexcept;
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include <DirectXMath.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Froxel grid over the view frustum: screen space tiles, split in depth into slices whose thickness grows with distance.
+// A view depth z lands in slice floor(log2(z) * _sliceScale + _sliceBias), the pixel shader computes the same
+struct ClusterGrid
+{
+	static constexpr std::uint32_t kTilesX = 16u;
+	static constexpr std::uint32_t kTilesY = 9u;
+	static constexpr std::uint32_t kSlices = 24u;
+	static constexpr std::uint32_t kClusterCount = kTilesX * kTilesY * kSlices;
+
+	float _nearZ = 1.f;
+	float _farZ = 1000.f;
+	float _tanHalfFovX = 1.f;
+	float _tanHalfFovY = 1.f;
+	float _sliceScale = 0.f;
+	float _sliceBias = 0.f;
+	// View depth where each slice starts, the last entry is the far plane
+	std::array<float, kSlices + 1u> _sliceStarts{};
+
+	static ClusterGrid FromLens(float fovY, float aspect, float nearZ, float farZ) noexcept;
+};
+
+// Point and spot lights as bounding spheres, as a structure of arrays so the kernel bins four lights at once.
+// Spot lights are bounded by their whole range, their cone isn't used for binning
+struct ClusterLights
+{
+	void Resize(size_t count);
+	void Set(size_t index, const DirectX::XMFLOAT3& center, float radius, bool spot) noexcept;
+	size_t GetCount() const noexcept { return _radius.size(); }
+
+	std::vector<float> _centerX;
+	std::vector<float> _centerY;
+	std::vector<float> _centerZ;
+	std::vector<float> _radius;
+	std::vector<std::uint8_t> _spot;
+};
+
+// Light index lists per cluster, packed into one buffer for the pixel shader:
+//  [offset, count] for each of ClusterGrid::kClusterCount clusters, then the lists. Offsets index the whole buffer.
+// List entries are indices into the ClusterLights the grid was built from, spot lights have kSpotLightBit set
+class LightClusters
+{
+public:
+	static constexpr std::uint32_t kSpotLightBit = 1u << 31;
+
+	// Bins every light into the clusters its bounds overlap, view is the camera's row vector view matrix.
+	// Lights are boxed four at a time, then each thread builds the lists of a range of slices.
+	// Lists are in increasing light order, so the result doesn't depend on the thread count
+	void Build(const ClusterGrid& grid, const DirectX::XMFLOAT4X4& view, const ClusterLights& lights);
+
+	std::span<const std::uint32_t> GetData() const noexcept { return _data; }
+	size_t GetLightIndexCount() const noexcept { return _data.size() - 2u * ClusterGrid::kClusterCount; }
+
+private:
+	// Inclusive cluster range of each light, empty (_minZ > _maxZ) when the light is out of view
+	std::vector<std::int32_t> _minX;
+	std::vector<std::int32_t> _maxX;
+	std::vector<std::int32_t> _minY;
+	std::vector<std::int32_t> _maxY;
+	std::vector<std::int32_t> _minZ;
+	std::vector<std::int32_t> _maxZ;
+
+	// Lights touching each slice
+	std::array<std::vector<std::uint32_t>, ClusterGrid::kSlices> _sliceLights;
+	std::vector<std::uint32_t> _data;
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include "FrustumCulling.h"
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Point and spot lights as spheres with the linear falloff of CalcAttenuation, as a structure of arrays
+// so the kernel scores four lights at once
+struct SelectionLights
+{
+	void Resize(size_t count);
+	// intensity weighs the light against the others, the largest channel of its strength for instance
+	void Set(size_t index, const DirectX::XMFLOAT3& center, float falloffStart, float falloffEnd, float intensity, bool spot) noexcept;
+	size_t GetCount() const noexcept { return _falloffEnd.size(); }
+
+	std::vector<float> _centerX;
+	std::vector<float> _centerY;
+	std::vector<float> _centerZ;
+	std::vector<float> _falloffStart;
+	std::vector<float> _falloffEnd;
+	std::vector<float> _intensity;
+	std::vector<std::uint8_t> _spot;
+};
+
+// The kMaxLightsPerObject strongest lights of every object, a cheaper alternative to LightClusters for forward shading.
+// A light scores its attenuation at the object's bounding sphere, times its intensity, lights out of reach aren't kept
+class LightSelection
+{
+public:
+	static constexpr std::uint32_t kMaxLightsPerObject = 4u;
+	// Same tag LightClusters uses, the shaders share the lookup
+	static constexpr std::uint32_t kSpotLightBit = 1u << 31;
+
+	// Each thread scores every light against a range of objects, ties keep the light with the lower index
+	void Select(const CullingSpheres& objects, const SelectionLights& lights);
+	// The same for one sphere, center in xyz and radius in w. Writes the light indices strongest first, spot lights
+	// tagged, and returns how many were kept
+	static std::uint32_t SelectSphere(const DirectX::XMFLOAT4& sphere, const SelectionLights& lights, std::span<std::uint32_t, kMaxLightsPerObject> selected) noexcept;
+
+	// Light indices of an object, strongest first, spot lights have kSpotLightBit set
+	std::span<const std::uint32_t> GetLights(size_t object) const noexcept
+	{
+		return { _lights.data() + object * kMaxLightsPerObject, _counts[object] };
+	}
+
+private:
+	std::vector<std::uint32_t> _lights;
+	std::vector<std::uint8_t> _counts;
+};
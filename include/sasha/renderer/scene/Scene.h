@@ -1,20 +1,167 @@
 #pragma once
-#include "RenderItem.h"
+#include "Camera.h"
+#include "FrustumCulling.h"
+#include "DrawPackets.h"
+#include "TextureAnimation.h"
+#include "LightClusters.h"
+#include "LightSelection.h"
+#include "TransformHierarchy.h"
+#include "Components.h"
 #include "../geometry/GeometryLibrary.h"
+#include "../../ecs/World.h"
 
+// What BuildDrawPackets needs of a visible entity, gathered from its components by CullItems
+struct VisibleItem
+{
+	SubMeshID _submesh = -1;
+	MaterialID _material = -1;
+	RenderLayer _layer = RenderLayer::Opaque;
+	std::uint8_t _pipeline = 0u;
+	D3D12_PRIMITIVE_TOPOLOGY _topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+	std::uint32_t _slot = 0u;
+	// Of the bounding sphere's center along the camera's forward axis
+	float _viewDepth = 0.f;
+};
+
+// Consecutive packets sharing a pipeline, material, submesh and topology, drawn with a single DrawIndexedInstanced
+struct DrawBatch
+{
+	SubMeshID _submeshId = -1;
+	MaterialID _materialId = -1;
+	RenderLayer _layer = RenderLayer::Opaque;
+	std::uint8_t _pipeline = 0u;
+	D3D12_PRIMITIVE_TOPOLOGY _primitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+
+	// Range of the batch in Scene::GetBatchedSlots() and in the instance buffer
+	UINT _firstInstance = 0u;
+	UINT _instanceCount = 0u;
+};
+
+// Instances are entities of the scene's World. Every stage runs a query cached at construction over the components
+// it reads and writes, the renderer reads the instance data the same way through GetInstances()
 class Scene
 {
 public:
-	void AddInstance(const std::string& meshName, const std::string& matName, const DirectX::XMFLOAT4X4& transform = d3dUtil::Identity4x4());
-	void AddLight(const Light& light);
-	void BuildRenderItems(GeometryLibrary& geoLib);
+	Scene();
+
+	// Creates an entity drawing the mesh with the material in the last instance slot, the names are resolved
+	// right away. transform is relative to parent, which moves the entity along with it, or to the world when parent is
+	// invalid. The entity is placed on the next UpdateTransforms
+	Entity AddInstance(const GeometryLibrary& geoLib, const std::string& meshName, const std::string& matName, const DirectX::XMFLOAT4X4& transform = d3dUtil::Identity4x4(), Entity parent = {});
+	// Destroys the entity and its children. The entities in the last instance slots move into the freed ones so the slots
+	// stay compact, handles to the other entities stay valid. Like AddInstance, only call it between frames
+	void RemoveInstance(Entity instance);
+	// Returns the index of the light in GetLights()
+	size_t AddLight(const Light& light, LightType type = LightType::Point);
+
+	// Tracks are created on GetTextureAnimation() and apply to existing and later instances alike.
+	// An instance's own track takes precedence over its material's
+	TextureAnimation& GetTextureAnimation() noexcept;
+	void AnimateMaterial(const GeometryLibrary& geoLib, const std::string& matName, UvTrackID track);
+	void AnimateInstance(Entity instance, UvTrackID track);
+
+	// Transform relative to the entity's parent, the entity and its children move on the next UpdateTransforms
+	void SetLocal(Entity instance, const LocalTransform& local);
+	LocalTransform GetLocal(Entity instance) const;
+
+	World& GetWorld() noexcept;
+
+	// Recomputes the world matrices of the entities moved since the last call and of their children, marks their bounds and
+	// instance data dirty. Run before UpdateBounds
+	void UpdateTransforms();
 
-	std::vector<std::unique_ptr<RenderItem>>& GetRenderItems();
+	// Evaluates the texture animation tracks at time and sets the texture transform of the entities bound to animated ones
+	void UpdateTextureAnimation(float time);
+
+	// Transforms the submesh bounds of every entity whose world matrix changed since the last call, chunks run in parallel
+	void UpdateBounds(const GeometryLibrary& geoLib);
+	// Picks the coarsest level of detail whose simplification error projects under the pixel threshold, needs current bounds.
+	// Entities only move to a coarser level once its error is _lodHysteresis below the threshold so they don't flicker
+	void SelectLods(const GeometryLibrary& geoLib, const Camera& camera, float viewportHeight);
+	void SetLodPixelError(float pixels, float hysteresis = 0.25f) noexcept;
+	// Tests each chunk's world spheres against the camera frustum and gathers the draw state of the visible entities.
+	// Needs current bounds, run after SelectLods since the level of detail picks the submesh
+	void CullItems(const Camera& camera);
+	// Keys the visible items by layer, state and view depth, radix sorts them and merges runs of equal state into
+	// instanced draws
+	void BuildDrawPackets(const GeometryLibrary& geoLib, const Camera& camera);
+	// Splits the lights into directional and local ones and bins the local ones into the camera's froxel grid
+	void BuildLightClusters(const Camera& camera);
+	// The alternative to clusters: keeps the strongest local lights of every entity and marks the ones whose lights changed dirty.
+	// Needs current bounds
+	void SelectItemLights();
+
+	// Entities with instance data: InstanceSlot, InstanceDirty, Transform, TexTransform and SelectedLights
+	Query& GetInstances() noexcept;
+	// Instance slots in use, [0, GetInstanceCount())
+	size_t GetInstanceCount() const noexcept;
+	// Entities that passed the last CullItems, chunk by chunk
+	const std::vector<VisibleItem>& GetVisibleItems() const noexcept;
+	const std::vector<DrawBatch>& GetBatches() const noexcept;
+	// Instance slots in submission order, instance i of the frame reads the instance data at GetBatchedSlots()[i]
+	const std::vector<std::uint32_t>& GetBatchedSlots() const noexcept;
 	std::vector<Light>& GetLights();
+	const std::vector<LightType>& GetLightTypes() const noexcept;
+
+	// Results of the last BuildLightClusters or SelectItemLights, the light lists index GetLocalLights()
+	const ClusterGrid& GetClusterGrid() const noexcept;
+	const LightClusters& GetLightClusters() const noexcept;
+	const std::vector<Light>& GetDirectionalLights() const noexcept;
+	const std::vector<Light>& GetLocalLights() const noexcept;
+
+private:
+	// Splits _lights into _directionalLights and _localLights
+	void SplitLights();
+
+	// Moves the entity in the last slot into the freed one
+	void FreeSlot(std::uint32_t slot);
+	// Sets the entity's texture transform from the track, kNoUvTrack resets it. Animated tracks are followed by UpdateTextureAnimation
+	void BindUvTrack(Entity instance, UvTrackID track);
 
 private:
 	std::vector<Light> _lights;
+	std::vector<LightType> _lightTypes;
+
+	ClusterGrid _clusterGrid;
+	ClusterLights _clusterLights;
+	LightClusters _lightClusters;
+	std::vector<Light> _directionalLights;
+	std::vector<Light> _localLights;
+	std::vector<LightType> _localLightTypes;
+	SelectionLights _selectionLights;
+
+	World _world;
+	TransformHierarchy _hierarchy;
+	// Indexed by NodeID
+	std::vector<Entity> _nodeEntities;
+	std::vector<NodeID> _removedNodes;
+	// Indexed by InstanceSlot::_slot
+	std::vector<Entity> _slotEntities;
+
+	// Cached by the world, one per stage
+	Query* _bounded = nullptr;
+	Query* _lodded = nullptr;
+	Query* _drawn = nullptr;
+	Query* _lit = nullptr;
+	Query* _animated = nullptr;
+	Query* _instances = nullptr;
+	std::vector<ChunkView> _chunks;
+	// SelectItemLights runs alongside the culling and LOD jobs
+	std::vector<ChunkView> _litChunks;
+
+	static constexpr UvTrackID kNoUvTrack = ~UvTrackID{ 0 };
+	TextureAnimation _textureAnimation;
+	// Indexed by MaterialID
+	std::vector<UvTrackID> _materialUvTracks;
+
+	// Rows of the current chunk that passed the frustum test
+	std::vector<std::uint32_t> _visibleRows;
+	std::vector<VisibleItem> _visibleItems;
+	std::vector<std::uint64_t> _packets;
+	std::vector<std::uint64_t> _packetScratch;
+	std::vector<std::uint32_t> _batchedSlots;
+	std::vector<DrawBatch> _batches;
 
-	std::vector<ObjectInstance> _instances;
-	std::vector<std::unique_ptr<RenderItem>> _renderItems;
+	float _lodPixelError = 1.f;
+	float _lodHysteresis = 0.25f;
 };
@@ -0,0 +1,67 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+using UvTrackID = std::uint32_t;
+
+// One sample of a keyframed track, the transform is scale, then rotation, then offset
+struct UvKeyframe
+{
+	float _time = 0.f;
+	DirectX::XMFLOAT2 _offset = { 0.f, 0.f };
+	float _rotation = 0.f;
+	DirectX::XMFLOAT2 _scale = { 1.f, 1.f };
+};
+
+// Texture coordinate transforms driven by time. Procedural tracks (scroll, rotate, scale) share one set of columns
+// so a single loop evaluates all of them, keyframed tracks are sampled from one flat key array.
+// Transforms use the row vector convention of the vertex shader: uv' = uv * M
+class TextureAnimation
+{
+public:
+	UvTrackID AddScroll(const DirectX::XMFLOAT2& velocity);
+	// Turns around pivot in texture space, the origin by default
+	UvTrackID AddRotation(float radiansPerSecond, const DirectX::XMFLOAT2& pivot = { 0.f, 0.f });
+	// Constant tiling, never changes once evaluated
+	UvTrackID AddScale(const DirectX::XMFLOAT2& scale);
+	// keys must be sorted by time. Looping tracks wrap at the last key's time, others hold it
+	UvTrackID AddKeyframes(std::span<const UvKeyframe> keys, bool loop = true);
+
+	size_t GetTrackCount() const noexcept { return _transforms.size(); }
+	// Whether the track's transform depends on time, constant tracks only need to be applied once
+	bool IsAnimated(UvTrackID track) const noexcept { return _animated[track] != 0u; }
+
+	// Evaluates every track at time (seconds), then GetTransform returns the results
+	void Evaluate(float time);
+	const DirectX::XMFLOAT4X4& GetTransform(UvTrackID track) const noexcept { return _transforms[track]; }
+
+private:
+	UvTrackID AddProcedural(const DirectX::XMFLOAT2& scale, float angularVelocity, const DirectX::XMFLOAT2& pivot, const DirectX::XMFLOAT2& velocity);
+
+	static DirectX::XMFLOAT4X4 Compose(float scaleU, float scaleV, float angle, float pivotU, float pivotV, float offsetU, float offsetV) noexcept;
+
+private:
+	// Per track
+	std::vector<std::uint8_t> _animated;
+	std::vector<DirectX::XMFLOAT4X4> _transforms;
+
+	// Procedural tracks
+	std::vector<UvTrackID> _proceduralTracks;
+	std::vector<float> _scaleU;
+	std::vector<float> _scaleV;
+	std::vector<float> _angularVelocity;
+	std::vector<float> _pivotU;
+	std::vector<float> _pivotV;
+	std::vector<float> _velocityU;
+	std::vector<float> _velocityV;
+
+	// Keyframed tracks, keys [_firstKey, _firstKey + _keyCount) of _keys
+	std::vector<UvTrackID> _keyframedTracks;
+	std::vector<std::uint32_t> _firstKey;
+	std::vector<std::uint32_t> _keyCount;
+	std::vector<std::uint8_t> _loop;
+	std::vector<UvKeyframe> _keys;
+};
@@ -0,0 +1,147 @@
+#pragma once
+#include "../../utility/JobSystem.h"
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+using NodeID = std::uint32_t;
+
+// Transform relative to the parent node: scale, then rotation (a unit quaternion), then translation
+struct LocalTransform
+{
+	DirectX::XMFLOAT3 _translation = { 0.f, 0.f, 0.f };
+	DirectX::XMFLOAT4 _rotation = { 0.f, 0.f, 0.f, 1.f };
+	DirectX::XMFLOAT3 _scale = { 1.f, 1.f, 1.f };
+
+	// The matrix must not shear, a matrix that doesn't decompose keeps its translation only
+	static LocalTransform FromMatrix(const DirectX::XMFLOAT4X4& matrix) noexcept;
+};
+
+// Parent-relative transforms resolved to world matrices. Nodes are stored breadth first as a structure of arrays:
+// every level of depth is a contiguous range and the children of a node are contiguous in the next level, so the
+// descendants of any run of nodes form one range per level. Update only recomputes the nodes set since the last
+// call and their descendants, level by level, with each level split across threads.
+// Added nodes wait in an unsorted tail and removed ones leave holes. Once they make up a fraction of the nodes, Update
+// starts a job that rebuilds the order into spare arrays while the frame goes on, and the next call changing the
+// hierarchy swaps them in, so adding and removing cost amortized constant time without a frame paying for the sort.
+// Matrices use the row vector convention of the shaders: world = local * parentWorld
+class TransformHierarchy
+{
+public:
+	static constexpr NodeID kNoNode = ~0u;
+
+	TransformHierarchy() = default;
+	// Waits for the sort job
+	~TransformHierarchy();
+	TransformHierarchy(const TransformHierarchy&) = delete;
+	TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+	// parent has to be alive, kNoNode makes a root. Ids of removed nodes are reused. The new node's world matrix
+	// is valid after the next Update
+	NodeID Add(const LocalTransform& local, NodeID parent = kNoNode);
+	// Removes the node and all its descendants and appends their ids to removed, parents before children
+	void Remove(NodeID node, std::vector<NodeID>& removed);
+	bool IsAlive(NodeID node) const noexcept { return node < _slots.size() && _slots[node] != kNoNode; }
+
+	void SetLocal(NodeID node, const LocalTransform& local);
+	LocalTransform GetLocal(NodeID node) const noexcept;
+	NodeID GetParent(NodeID node) const noexcept { return _parentNodes[node]; }
+	// As of the last Update
+	const DirectX::XMFLOAT4X4& GetWorld(NodeID node) const noexcept { return _worlds[_slots[node]]; }
+
+	size_t GetNodeCount() const noexcept { return _nodeCount; }
+	// Depth of the deepest sorted node plus one, as of the last Update
+	size_t GetLevelCount() const noexcept { return _levels.empty() ? 0u : _levels.size() - 1u; }
+
+	// Recomputes the world matrix of every changed node and its descendants, then starts sorting the tail and holes
+	// away when they grew too large. The queries stay valid while the sort runs
+	void Update();
+	// Nodes whose world matrix the last Update recomputed, parents before children
+	std::span<const NodeID> GetChanged() const noexcept { return _changed; }
+
+private:
+	// Nodes [_begin, _end) of one level, _offset is where they go in _changed
+	struct SlotRange
+	{
+		std::uint32_t _begin = 0u;
+		std::uint32_t _end = 0u;
+		std::uint32_t _offset = 0u;
+	};
+
+	// What Sort builds: the arrays that move with the slots, in breadth first order of the live nodes
+	struct SortedLayout
+	{
+		std::vector<DirectX::XMFLOAT3> _translations;
+		std::vector<DirectX::XMFLOAT4> _rotations;
+		std::vector<DirectX::XMFLOAT3> _scales;
+		std::vector<DirectX::XMFLOAT4X4> _worlds;
+		std::vector<std::uint32_t> _parents;
+		std::vector<NodeID> _nodes;
+		std::vector<std::uint32_t> _stamps;
+		std::vector<std::uint32_t> _firstChildren;
+		std::vector<std::uint32_t> _levels;
+		std::vector<std::uint32_t> _slots;
+
+		// Scratch of the job: first tail child of every slot, next tail sibling of every tail slot
+		std::vector<std::uint32_t> _tailHeads;
+		std::vector<std::uint32_t> _tailNext;
+	};
+
+	// Runs on the sort job: rebuilds the order into sorted, which empties the tail and fills the holes. Only reads
+	// the hierarchy, which nothing changes until ApplySort
+	void Sort(SortedLayout& sorted) const;
+	// Waits for a pending sort and swaps its layout in, called before anything changes the hierarchy
+	void ApplySort();
+	// Appends [begin, end) to ranges, merging it with the last range when they touch
+	static void AppendRange(std::vector<SlotRange>& ranges, std::uint32_t begin, std::uint32_t end);
+	void UpdateLevel(std::span<const SlotRange> ranges);
+	// Tail nodes come after their parents, so one pass in slot order sees every parent final
+	void UpdateTail();
+	void ComputeWorld(std::uint32_t slot) noexcept;
+
+private:
+	// Per slot, sorted breadth first up to _sortedCount, then the tail in the order nodes were added
+	std::vector<DirectX::XMFLOAT3> _translations;
+	std::vector<DirectX::XMFLOAT4> _rotations;
+	std::vector<DirectX::XMFLOAT3> _scales;
+	std::vector<DirectX::XMFLOAT4X4> _worlds;
+	// Slot of the parent, kNoNode for roots
+	std::vector<std::uint32_t> _parents;
+	// kNoNode for the holes removed nodes left
+	std::vector<NodeID> _nodes;
+	// The Update that last recomputed the slot, tail nodes compare it with their parent's
+	std::vector<std::uint32_t> _stamps;
+	std::uint32_t _stamp = 0u;
+
+	// Sorted slots only: slot of the first child, children end where the next slot's begin. One extra entry past
+	// the last sorted slot. Children in the tail aren't part of it
+	std::vector<std::uint32_t> _firstChildren;
+	// First slot of every level, plus the sorted slot count
+	std::vector<std::uint32_t> _levels;
+	size_t _sortedCount = 0u;
+	size_t _holeCount = 0u;
+
+	// Per node, ids never change while slots move with every Sort. Children are linked so subtrees can be found
+	// wherever their nodes are
+	std::vector<std::uint32_t> _slots;
+	std::vector<NodeID> _parentNodes;
+	std::vector<NodeID> _firstChildNodes;
+	std::vector<NodeID> _nextSiblings;
+	std::vector<NodeID> _previousSiblings;
+	std::vector<std::uint8_t> _dirty;
+	std::vector<NodeID> _freeNodes;
+	size_t _nodeCount = 0u;
+
+	std::vector<NodeID> _dirtyNodes;
+	std::vector<std::uint32_t> _dirtySlots;
+	std::vector<SlotRange> _ranges;
+	std::vector<SlotRange> _nextRanges;
+	std::vector<NodeID> _changed;
+
+	// Filled by the sort job, afterwards it holds the previous arrays so the next sort reuses their memory
+	SortedLayout _sorted;
+	JobCounter _sortJob;
+	bool _sortPending = false;
+};
@@ -3,6 +3,8 @@
 #include "renderer/core/SwapChain.h"
 #include "renderer/core/CommandQueue.h"
 #include "renderer/core/CommandList.h"
+#include "renderer/core/CommandRecorder.h"
+#include "renderer/core/DrawRecording.h"
 #include "renderer/core/RootSignature.h"
 
 #include "renderer/pipeline/PSOCache.h"
@@ -12,4 +14,5 @@
 
 #include "renderer/DescriptorHeap.h"
 
-#include "renderer/geometry/Texture.h"
\ No newline at end of file
+#include "renderer/geometry/Texture.h"
+#include "renderer/geometry/MeshCache.h"
\ No newline at end of file
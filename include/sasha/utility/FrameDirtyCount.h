@@ -0,0 +1,31 @@
+#pragma once
+
+// Number of frame resources still holding stale copies of some data. Frame resources are filled round robin, so
+// after a change the next FrameResourceCount updates each write one of them, the ones in flight included.
+// A change made while the previous one is still going around restarts the count, no resource keeps either version
+template<int FrameResourceCount>
+class FrameDirtyCount
+{
+public:
+	static_assert(FrameResourceCount > 0, "At least one frame resource");
+
+	// Call after changing the data, every frame resource needs it again
+	void Mark() noexcept { _count = FrameResourceCount; }
+
+	bool IsDirty() const noexcept { return _count > 0; }
+	int GetCount() const noexcept { return _count; }
+
+	// Called once per update of the current frame resource: whether the data has to be copied into it.
+	// The copy is then counted as done
+	bool Consume() noexcept
+	{
+		if (_count <= 0)
+			return false;
+		_count--;
+		return true;
+	}
+
+private:
+	// New data starts dirty, no frame resource holds it yet
+	int _count = FrameResourceCount;
+};
@@ -0,0 +1,148 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class JobSystem;
+
+// Small callable with its captures stored inline, allocated from a per thread ring so scheduling never touches the heap
+struct Job
+{
+	static constexpr size_t kDataSize = 48u;
+
+	// Null while the slot is free, cleared once the job ran. Atomic since the owning thread polls it when its ring wraps
+	std::atomic<void (*)(void* data)> _run = nullptr;
+	class JobCounter* _counter = nullptr;
+	alignas(std::max_align_t) std::byte _data[kDataSize];
+};
+
+// Number of unfinished jobs scheduled against it. Jobs can be made to wait on a counter, they're only queued once it
+// reaches zero, so a stage can depend on the previous ones without a thread blocking in between
+class JobCounter
+{
+public:
+	JobCounter() = default;
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+
+	bool IsDone() const noexcept { return _pending.load(std::memory_order_acquire) == 0u; }
+
+private:
+	friend class JobSystem;
+
+	std::atomic<std::uint32_t> _pending = 0u;
+	std::mutex _mutex;
+	// Set while jobs are pending, dependents scheduled meanwhile are held back until the last one finished
+	bool _open = false;
+	std::vector<Job*> _dependents;
+};
+
+// Chase-Lev work stealing deque (Lê et al. "Correct and Efficient Work-Stealing for Weak Memory Models") with a fixed
+// capacity. The owning thread pushes and pops at the bottom, the others steal from the top
+class JobDeque
+{
+public:
+	static constexpr size_t kCapacity = 4096u;
+
+	// Owner only. Fails when full, the caller then runs the job itself
+	bool Push(Job* job) noexcept;
+	// Owner only, newest job first so the working set stays hot
+	Job* Pop() noexcept;
+	// Any thread, oldest job first
+	Job* Steal() noexcept;
+
+private:
+	alignas(64) std::atomic<std::int64_t> _top = 0;
+	alignas(64) std::atomic<std::int64_t> _bottom = 0;
+	std::array<std::atomic<Job*>, kCapacity> _jobs{};
+};
+
+// One deque per thread: the workers plus the thread that drives the frame, which only runs jobs while it waits.
+// Jobs may be scheduled from that thread and from other jobs. They must not throw, parallel::ForRange forwards exceptions itself
+class JobSystem
+{
+public:
+	// Jobs a thread may have scheduled and not yet finished before its ring wraps onto them, past that Run works
+	// through queued jobs until a slot frees
+	static constexpr size_t kJobPoolSize = 4096u;
+
+	// workerCount threads are started, the calling thread becomes the main thread of the system. Only the workers and
+	// that thread may schedule or wait, they're the ones with a deque and a job ring
+	explicit JobSystem(size_t workerCount);
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// Engine wide instance with one worker per extra hardware thread and at least one, started on first use
+	static JobSystem& Get();
+
+	// Workers plus the main thread
+	size_t GetThreadCount() const noexcept { return _deques.size(); }
+
+	// Queues fn to run on any thread, counter drops back once it returned. With a dependency, the job is only queued
+	// once that counter is done
+	template<typename Fn>
+	void Run(JobCounter& counter, Fn&& fn, JobCounter* dependency = nullptr);
+
+	// Runs queued jobs on the calling thread until the counter is done
+	void Wait(const JobCounter& counter);
+
+private:
+	struct ThreadState
+	{
+		JobDeque _deque;
+		std::unique_ptr<Job[]> _pool = std::make_unique<Job[]>(kJobPoolSize);
+		size_t _poolIndex = 0u;
+	};
+
+	size_t GetThreadIndex() const noexcept;
+	Job* Allocate();
+	void Schedule(Job* job, JobCounter& counter, JobCounter* dependency);
+	void Push(Job* job);
+	Job* FindJob() noexcept;
+	void Execute(Job* job);
+	void WorkerLoop(size_t index);
+
+private:
+	std::vector<std::unique_ptr<ThreadState>> _deques;
+	std::vector<std::thread> _workers;
+	// Owner of index 0, any other thread outside the workers would share its deque and ring
+	std::thread::id _mainThread = std::this_thread::get_id();
+	std::atomic<bool> _running = true;
+	// Bumped on every push so sleeping workers can't miss a job queued between their last look and their wait
+	std::atomic<std::uint32_t> _jobSignal = 0u;
+	// Workers asleep on _wake, pushes only take _sleepMutex when there is one
+	std::atomic<std::uint32_t> _sleeping = 0u;
+	std::mutex _sleepMutex;
+	std::condition_variable _wake;
+};
+
+template<typename Fn>
+void JobSystem::Run(JobCounter& counter, Fn&& fn, JobCounter* dependency)
+{
+	using Callable = std::decay_t<Fn>;
+	static_assert(sizeof(Callable) <= Job::kDataSize, "Job captures don't fit inline, capture by reference instead");
+	static_assert(alignof(Callable) <= alignof(std::max_align_t), "Job captures are over aligned");
+
+	Job* job = Allocate();
+	new (job->_data) Callable(std::forward<Fn>(fn));
+	job->_run.store([](void* data)
+		{
+			auto* callable = std::launder(reinterpret_cast<Callable*>(data));
+			(*callable)();
+			callable->~Callable();
+		}, std::memory_order_relaxed);
+	job->_counter = &counter;
+
+	Schedule(job, counter, dependency);
+}
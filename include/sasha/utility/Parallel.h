@@ -0,0 +1,75 @@
+#pragma once
+#include "JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace parallel
+{
+	namespace detail
+	{
+		inline std::atomic<size_t> s_workerLimit = 0u;
+	}
+
+	// Caps how many ranges ForRange splits into, 0 lifts the cap. Used to measure scaling and to leave cores to other work
+	inline void SetWorkerLimit(size_t limit) noexcept
+	{
+		detail::s_workerLimit.store(limit, std::memory_order_relaxed);
+	}
+
+	inline size_t GetWorkerCount() noexcept
+	{
+		// Queried once, glibc reads it from /sys on every call which costs more than a small ForRange
+		static const size_t count = std::max<size_t>(1u, std::thread::hardware_concurrency());
+		const size_t limit = detail::s_workerLimit.load(std::memory_order_relaxed);
+		return limit == 0u ? count : std::min(count, limit);
+	}
+
+	// Splits [0, count) into contiguous ranges of at least minGrain items and calls fn(begin, end) on each.
+	// Ranges run as jobs, the caller helps until all of them finished, so it can be called from inside other jobs.
+	// If any range throws, the exception of the lowest range is rethrown.
+	template<typename Fn>
+	void ForRange(size_t count, size_t minGrain, Fn&& fn)
+	{
+		if (count == 0u)
+			return;
+
+		minGrain = std::max<size_t>(minGrain, 1u);
+		size_t rangeCount = std::min<size_t>(GetWorkerCount(), (count + minGrain - 1u) / minGrain);
+		if (rangeCount <= 1u)
+		{
+			fn(size_t{ 0 }, count);
+			return;
+		}
+
+		std::vector<std::exception_ptr> errors(rangeCount);
+		auto runRange = [&](size_t r)
+		{
+			size_t begin = count * r / rangeCount;
+			size_t end = count * (r + 1u) / rangeCount;
+			try
+			{
+				fn(begin, end);
+			}
+			catch (...)
+			{
+				errors[r] = std::current_exception();
+			}
+		};
+
+		auto& jobSystem = JobSystem::Get();
+		JobCounter counter;
+		for (size_t r = 1; r < rangeCount; r++)
+			jobSystem.Run(counter, [&runRange, r]() { runRange(r); });
+
+		runRange(0u);
+		jobSystem.Wait(counter);
+
+		for (auto& e : errors)
+			if (e)
+				std::rethrow_exception(e);
+	}
+}
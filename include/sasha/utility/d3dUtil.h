@@ -1,9 +1,13 @@
 #pragma once
 #include "d3dIncludes.h"
+#include "FrameDirtyCount.h"
 
 namespace d3dUtil
 {
 	constexpr float PI = 3.14159265f;
+	// Frames the CPU may record ahead of the GPU, each has its own copy of the per frame buffers
+	constexpr int NumFrameResources = 3;
+	using DirtyCount = FrameDirtyCount<NumFrameResources>;
 
 	inline DirectX::XMFLOAT4X4 Identity4x4()
 	{
@@ -53,7 +57,8 @@ namespace d3dUtil
 	{
 	public:
 		UploadBuffer(ID3D12Device* device, UINT elementCount, bool isConstantBuffer = false)
-			: _isConstantBuffer(isConstantBuffer)
+			: _elementCount(elementCount)
+			, _isConstantBuffer(isConstantBuffer)
 		{
 			_byteSize = sizeof(T);
 
@@ -94,14 +99,34 @@ namespace d3dUtil
 			return _uploadBuffer.Get();
 		}
 
+		UINT GetElementCount() const noexcept
+		{
+			return _elementCount;
+		}
+
 		void CopyData(UINT elementCount, const T& data)
 		{
 			memcpy(&_mappedData[elementCount * _byteSize], &data, sizeof(T));
 		}
 
+		// Consecutive elements in one copy, constant buffers pad each element so they go through CopyData
+		void CopyRange(UINT firstElement, const T* data, UINT count)
+		{
+			assert(!_isConstantBuffer && firstElement + count <= _elementCount);
+			memcpy(&_mappedData[firstElement * _byteSize], data, sizeof(T) * count);
+		}
+
+		// Copies the first count elements of source, for when a buffer is replaced by a larger one
+		void CopyElements(const UploadBuffer& source, UINT count)
+		{
+			assert(count <= _elementCount && count <= source._elementCount && _byteSize == source._byteSize);
+			memcpy(_mappedData, source._mappedData, static_cast<size_t>(count) * _byteSize);
+		}
+
 	private:
 		Microsoft::WRL::ComPtr<ID3D12Resource> _uploadBuffer;
 		BYTE* _mappedData = nullptr;
+		UINT _elementCount = 0u;
 		UINT _byteSize = 0u;
 		bool _isConstantBuffer = false;
 	};
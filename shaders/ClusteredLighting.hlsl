@@ -0,0 +1,79 @@
+//***************************************************************************************
+// ClusteredLighting.hlsl
+//
+// Point and spot lights binned into a froxel grid on the CPU, see LightClusters, or picked
+// per item, see LightSelection. Include after cbPass, it reads the grid description from it.
+//***************************************************************************************
+
+// Point and spot lights of the frame
+StructuredBuffer<Light> gLocalLights : register(t3);
+// [offset, count] per cluster, then the light lists. Entries index gLocalLights, the top bit marks spot lights
+StructuredBuffer<uint> gLightClusters : register(t4);
+
+#define SpotLightBit 0x80000000u
+
+// pixel is the SV_POSITION of the pixel, viewZ its view space depth
+uint GetClusterIndex(float2 pixel, float viewZ)
+{
+    uint2 tile = min(uint2(pixel * gInvRenderTargetSize * gClusterDims.xy), gClusterDims.xy - 1u);
+    // Slices get thicker with distance, the same mapping ClusterGrid uses
+    uint slice = (uint)clamp(log2(max(viewZ, 1e-4f)) * gClusterSliceScale + gClusterSliceBias, 0.0f, (float)(gClusterDims.z - 1u));
+
+    return (slice * gClusterDims.y + tile.y) * gClusterDims.x + tile.x;
+}
+
+float3 ComputeDirectionalLights(Material mat, float3 normal, float3 toEye, float3 shadowFactor)
+{
+    float3 result = 0.0f;
+
+    for (uint i = 0; i < gDirLightCount; ++i)
+    {
+        result += shadowFactor[min(i, 2u)] * ComputeDirectionalLight(gLights[i], mat, normal, toEye);
+    }
+
+    return result;
+}
+
+// entry is a light list entry, an index into gLocalLights with SpotLightBit set for spot lights
+float3 ComputeLocalLight(uint entry, Material mat, float3 pos, float3 normal, float3 toEye)
+{
+    Light L = gLocalLights[entry & ~SpotLightBit];
+    if (entry & SpotLightBit)
+        return ComputeSpotLight(L, mat, pos, normal, toEye);
+
+    return ComputePointLight(L, mat, pos, normal, toEye);
+}
+
+float4 ComputeClusteredLighting(Material mat, float2 pixel,
+                                float3 pos, float3 normal, float3 toEye,
+                                float3 shadowFactor)
+{
+    float3 result = ComputeDirectionalLights(mat, normal, toEye, shadowFactor);
+
+    float viewZ = mul(float4(pos, 1.0f), gView).z;
+    uint cluster = GetClusterIndex(pixel, viewZ);
+    uint offset = gLightClusters[2u * cluster];
+    uint count = gLightClusters[2u * cluster + 1u];
+
+    for (uint j = 0; j < count; ++j)
+    {
+        result += ComputeLocalLight(gLightClusters[offset + j], mat, pos, normal, toEye);
+    }
+
+    return float4(result, 0.0f);
+}
+
+// lights and lightCount come from the item's instance data, strongest light first
+float4 ComputeObjectLighting(Material mat, uint4 lights, uint lightCount,
+                             float3 pos, float3 normal, float3 toEye,
+                             float3 shadowFactor)
+{
+    float3 result = ComputeDirectionalLights(mat, normal, toEye, shadowFactor);
+
+    for (uint j = 0; j < lightCount; ++j)
+    {
+        result += ComputeLocalLight(lights[j], mat, pos, normal, toEye);
+    }
+
+    return float4(result, 0.0f);
+}
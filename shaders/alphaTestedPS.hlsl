@@ -9,10 +9,13 @@ SamplerState gsamLinearClamp : register(s3);
 SamplerState gsamAnisotropicWrap : register(s4);
 SamplerState gsamAnisotropicClamp : register(s5);
 
-cbuffer cbPerObject : register(b0)
+cbuffer cbPerDraw : register(b0)
 {
-    float4x4 gWorld;
-    float4x4 gTexTransform;
+    // Dequantization of compact positions, identity for full float vertices
+    float4 gPosScale;
+    float4 gPosBias;
+    // First instance of the draw in gInstanceIndices
+    uint gInstanceOffset;
 };
 
 cbuffer cbMaterial : register(b1)
@@ -41,19 +44,31 @@ cbuffer cbPass : register(b2)
     float gDeltaTime;
     float4 gAmbientLight;
 
-    // Indices [0, NUM_DIR_LIGHTS) are directional lights;
-    // indices [NUM_DIR_LIGHTS, NUM_DIR_LIGHTS+NUM_POINT_LIGHTS) are point lights;
-    // indices [NUM_DIR_LIGHTS+NUM_POINT_LIGHTS, NUM_DIR_LIGHTS+NUM_POINT_LIGHT+NUM_SPOT_LIGHTS)
-    // are spot lights for a maximum of MaxLights per object.
+    // Froxel grid the point and spot lights are binned into, see ClusteredLighting.hlsl
+    uint3 gClusterDims;
+    uint gDirLightCount;
+    float gClusterSliceScale;
+    float gClusterSliceBias;
+    // Non zero when the lights come from each item's instance data instead of the clusters
+    uint gPerObjectLights;
+    float cbPerObjectPad2;
+
+    // Indices [0, gDirLightCount) are directional lights, point and spot lights
+    // are read from gLocalLights through the clusters or the item's own list.
     Light gLights[MaxLights];
 };
 
+#include "ClusteredLighting.hlsl"
+
 struct VertexIn
 {
     float4 PosH : SV_POSITION;
     float3 PosW : POSITION;
     float3 Normal : NORMAL;
     float2 TexC : TEXCOORD;
+    // Lights picked for the item, see InstanceData
+    nointerpolation uint4 Lights : LIGHTS;
+    nointerpolation uint LightCount : LIGHTCOUNT;
 };
 
 float4 main(VertexIn vin) : SV_TARGET
@@ -69,7 +84,11 @@ float4 main(VertexIn vin) : SV_TARGET
     float3 shadowFactor = 1.f;
     
     // Diffuse and Specular Light
-    float4 directLight = ComputeLighting(gLights, mat, vin.PosW, vin.Normal, toEyeW, shadowFactor);
+    float4 directLight;
+    if (gPerObjectLights != 0u)
+        directLight = ComputeObjectLighting(mat, vin.Lights, vin.LightCount, vin.PosW, vin.Normal, toEyeW, shadowFactor);
+    else
+        directLight = ComputeClusteredLighting(mat, vin.PosH.xy, vin.PosW, vin.Normal, toEyeW, shadowFactor);
     
     // Ambient Light
     float4 ambient = gAmbientLight * diffuseAlbedo; // Al x md
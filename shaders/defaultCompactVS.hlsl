@@ -0,0 +1,4 @@
+// Vertex shader for the CompactVertex layout, see VertexCodec.h
+
+#define COMPACT_VERTEX
+#include "defaultVS.hlsl"
@@ -4,12 +4,30 @@
 
 // Constant data that varies per frame.
 
-cbuffer cbPerObject : register(b0)
+cbuffer cbPerDraw : register(b0)
 {
-    float4x4 gWorld;
-    float4x4 gTexTransform;
+    // Dequantization of compact positions, identity for full float vertices
+    float4 gPosScale;
+    float4 gPosBias;
+    // First instance of the draw in gInstanceIndices
+    uint gInstanceOffset;
 };
 
+// Matches InstanceData, one per render item
+struct InstanceData
+{
+    float4x4 World;
+    float4x4 TexTransform;
+    // Indices into gLocalLights, read when gPerObjectLights is set
+    uint4 Lights;
+    uint LightCount;
+    uint3 InstancePad;
+};
+
+StructuredBuffer<InstanceData> gInstances : register(t1);
+// Visible items of the frame grouped by draw, index gInstances
+StructuredBuffer<uint> gInstanceIndices : register(t2);
+
 cbuffer cbMaterial : register(b1)
 {
     float4 gDiffuseAlbedo;
@@ -37,19 +55,45 @@ cbuffer cbPass : register(b2)
     float gDeltaTime;
     float4 gAmbientLight;
 
-    // Indices [0, NUM_DIR_LIGHTS) are directional lights;
-    // indices [NUM_DIR_LIGHTS, NUM_DIR_LIGHTS+NUM_POINT_LIGHTS) are point lights;
-    // indices [NUM_DIR_LIGHTS+NUM_POINT_LIGHTS, NUM_DIR_LIGHTS+NUM_POINT_LIGHT+NUM_SPOT_LIGHTS)
-    // are spot lights for a maximum of MaxLights per object.
+    // Froxel grid the point and spot lights are binned into, see ClusteredLighting.hlsl
+    uint3 gClusterDims;
+    uint gDirLightCount;
+    float gClusterSliceScale;
+    float gClusterSliceBias;
+    // Non zero when the lights come from each item's instance data instead of the clusters
+    uint gPerObjectLights;
+    float cbPerObjectPad2;
+
+    // Indices [0, gDirLightCount) are directional lights, point and spot lights
+    // are read from gLocalLights through the clusters or the item's own list.
     Light gLights[MaxLights];
 };
  
+#ifdef COMPACT_VERTEX
+// CompactVertex: the input assembler already expanded the UNORM / SNORM / FLOAT16 channels to floats
+struct VertexIn
+{
+    float4 PosL : POSITION;
+    float2 Normal : NORMAL;
+    float2 TexC : TEXCOORD;
+};
+
+// Octahedral normal back onto the unit sphere, mirrors VertexCodec::DecodeNormal
+float3 DecodeOctahedral(float2 e)
+{
+    float3 n = float3(e, 1.0f - abs(e.x) - abs(e.y));
+    if (n.z < 0.0f)
+        n.xy = (1.0f - abs(n.yx)) * (n.xy >= 0.0f ? 1.0f : -1.0f);
+    return normalize(n);
+}
+#else
 struct VertexIn
 {
     float3 PosL : POSITION;
     float3 Normal : NORMAL;
     float2 TexC : TEXCOORD;
 };
+#endif
 
 struct VertexOut
 {
@@ -57,14 +101,26 @@ struct VertexOut
     float3 PosW : POSITION;
     float3 Normal : NORMAL;
     float2 TexC : TEXCOORD;
+    // Lights picked for the item, see InstanceData
+    nointerpolation uint4 Lights : LIGHTS;
+    nointerpolation uint LightCount : LIGHTCOUNT;
 };
 
-VertexOut main(VertexIn vin)
+VertexOut main(VertexIn vin, uint instanceID : SV_InstanceID)
 {
     VertexOut vout;
+    InstanceData instance = gInstances[gInstanceIndices[gInstanceOffset + instanceID]];
 	
+#ifdef COMPACT_VERTEX
+    float3 posL = vin.PosL.xyz * gPosScale.xyz + gPosBias.xyz;
+    float3 normalL = DecodeOctahedral(vin.Normal);
+#else
+    float3 posL = vin.PosL * gPosScale.xyz + gPosBias.xyz;
+    float3 normalL = vin.Normal;
+#endif
+
     // Transform to world space
-    float4 posW = mul(float4(vin.PosL, 1.0f), gWorld);
+    float4 posW = mul(float4(posL, 1.0f), instance.World);
     vout.PosW = posW.xyz;
     
 	// Transform to homogeneous clip space.
@@ -74,11 +130,14 @@ VertexOut main(VertexIn vin)
     // Separating in 2 parts :
     //  - Separating by the property of the object
     //  - Separating by the property of the material
-    float4 texC = mul(float4(vin.TexC, 0.f, 1.f), gTexTransform);
+    float4 texC = mul(float4(vin.TexC, 0.f, 1.f), instance.TexTransform);
     vout.TexC = mul(texC, gMatTransform).xy;
 	
     // Transform normals of uniformaly scaled objects to world space
-    vout.Normal = mul(vin.Normal, (float3x3)gWorld);
+    vout.Normal = mul(normalL, (float3x3)instance.World);
+
+    vout.Lights = instance.Lights;
+    vout.LightCount = instance.LightCount;
     
     return vout;
 }
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "../../include/sasha/ecs/Archetype.h"
+#include <cassert>
+#include <cstring>
+#include <mutex>
+
+namespace
+{
+	struct Registry
+	{
+		std::mutex _mutex;
+		std::array<ComponentInfo, ComponentRegistry::kMaxComponents> _infos{};
+		ComponentID _count = 0u;
+	};
+
+	Registry& GetRegistry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	size_t AlignUp(size_t offset, size_t alignment) noexcept
+	{
+		return (offset + alignment - 1u) & ~(alignment - 1u);
+	}
+}
+
+const ComponentInfo& ComponentRegistry::GetInfo(ComponentID id) noexcept
+{
+	// Ids are only handed out once their info is written, by the thread safe initialization in GetID
+	assert(id < kMaxComponents);
+	return GetRegistry()._infos[id];
+}
+
+ComponentID ComponentRegistry::Register(size_t size, size_t alignment)
+{
+	auto& registry = GetRegistry();
+	std::unique_lock lock(registry._mutex);
+	assert(registry._count < kMaxComponents && "Too many component types for a ComponentMask");
+	assert(alignment <= alignof(Chunk) && "Component is aligned beyond a chunk");
+
+	registry._infos[registry._count] = { size, alignment };
+	return registry._count++;
+}
+
+Archetype::Archetype(ComponentMask mask)
+	: _mask(mask)
+{
+	_offsets.fill(kNoColumn);
+	for (ComponentID id = 0; id < ComponentRegistry::kMaxComponents; id++)
+		if (Has(id))
+			_columns.push_back({ id, 0u, static_cast<std::uint32_t>(ComponentRegistry::GetInfo(id)._size) });
+
+	// Entity handles first, then the component arrays in id order, each aligned for its type
+	auto layoutSize = [this](size_t capacity)
+		{
+			size_t offset = sizeof(Entity) * capacity;
+			for (const auto& column : _columns)
+				offset = AlignUp(offset, ComponentRegistry::GetInfo(column._id)._alignment) + column._size * capacity;
+			return offset;
+		};
+
+	size_t rowSize = sizeof(Entity);
+	for (const auto& column : _columns)
+		rowSize += column._size;
+
+	_chunkCapacity = Chunk::kSize / rowSize;
+	while (_chunkCapacity > 0u && layoutSize(_chunkCapacity) > Chunk::kSize)
+		_chunkCapacity--;
+	assert(_chunkCapacity > 0u && "The components of one entity don't fit a chunk");
+
+	size_t offset = sizeof(Entity) * _chunkCapacity;
+	for (auto& column : _columns)
+	{
+		offset = AlignUp(offset, ComponentRegistry::GetInfo(column._id)._alignment);
+		column._offset = static_cast<std::uint32_t>(offset);
+		_offsets[column._id] = column._offset;
+		offset += column._size * _chunkCapacity;
+	}
+}
+
+Entity* Archetype::GetEntities(size_t chunk) noexcept
+{
+	return reinterpret_cast<Entity*>(_chunks[chunk]->_data);
+}
+
+std::byte* Archetype::GetColumn(size_t chunk, ComponentID id) noexcept
+{
+	if (_offsets[id] == kNoColumn)
+		return nullptr;
+	return _chunks[chunk]->_data + _offsets[id];
+}
+
+EntityLocation Archetype::Allocate(Entity entity)
+{
+	if (_chunks.empty() || _counts.back() == _chunkCapacity)
+	{
+		_chunks.push_back(_spare ? std::move(_spare) : std::make_unique_for_overwrite<Chunk>());
+		_counts.push_back(0u);
+	}
+
+	const auto chunk = static_cast<std::uint32_t>(_chunks.size() - 1u);
+	const std::uint32_t row = _counts.back()++;
+	GetEntities(chunk)[row] = entity;
+	_entityCount++;
+
+	return { this, chunk, row };
+}
+
+Entity Archetype::Free(std::uint32_t chunk, std::uint32_t row) noexcept
+{
+	assert(chunk < _chunks.size() && row < _counts[chunk]);
+
+	const auto lastChunk = static_cast<std::uint32_t>(_chunks.size() - 1u);
+	const std::uint32_t lastRow = _counts.back() - 1u;
+
+	Entity moved;
+	if (chunk != lastChunk || row != lastRow)
+	{
+		std::byte* to = _chunks[chunk]->_data;
+		const std::byte* from = _chunks[lastChunk]->_data;
+		for (const auto& column : _columns)
+			std::memcpy(to + column._offset + row * column._size, from + column._offset + lastRow * column._size, column._size);
+		moved = GetEntities(lastChunk)[lastRow];
+		GetEntities(chunk)[row] = moved;
+	}
+
+	_entityCount--;
+	if (--_counts.back() == 0u)
+	{
+		_spare = std::move(_chunks.back());
+		_chunks.pop_back();
+		_counts.pop_back();
+	}
+	return moved;
+}
+
+void Archetype::CopyShared(std::uint32_t chunk, std::uint32_t row, Archetype& destination, std::uint32_t destinationChunk, std::uint32_t destinationRow) noexcept
+{
+	const std::byte* from = _chunks[chunk]->_data;
+	for (const auto& column : _columns)
+	{
+		if (!destination.Has(column._id))
+			continue;
+
+		std::memcpy(destination.GetColumn(destinationChunk, column._id) + destinationRow * column._size, from + column._offset + row * column._size, column._size);
+	}
+}
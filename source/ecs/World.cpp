@@ -0,0 +1,110 @@
+#include "../../include/sasha/ecs/World.h"
+
+size_t Query::GetEntityCount() const noexcept
+{
+	size_t count = 0u;
+	for (const Archetype* archetype : _archetypes)
+		count += archetype->GetEntityCount();
+	return count;
+}
+
+void Query::GetChunks(std::vector<ChunkView>& chunks) const
+{
+	chunks.clear();
+	ForEachChunk([&chunks](const ChunkView& chunk) { chunks.push_back(chunk); });
+}
+
+void Query::Match(Archetype& archetype)
+{
+	if ((archetype.GetMask() & _required) == _required)
+		_archetypes.push_back(&archetype);
+}
+
+void World::Destroy(Entity entity)
+{
+	assert(IsAlive(entity));
+	if (!IsAlive(entity))
+		return;
+
+	FreeRow(_locations[entity._index]);
+	_locations[entity._index] = {};
+	_generations[entity._index]++;
+	_freeIndices.push_back(entity._index);
+	_entityCount--;
+}
+
+bool World::IsAlive(Entity entity) const noexcept
+{
+	return entity._index < _locations.size() && _generations[entity._index] == entity._generation && _locations[entity._index]._archetype;
+}
+
+Archetype& World::GetArchetype(ComponentMask mask)
+{
+	if (auto it = _archetypesByMask.find(mask); it != _archetypesByMask.end())
+		return *it->second;
+
+	auto& archetype = *_archetypes.emplace_back(std::make_unique<Archetype>(mask));
+	_archetypesByMask.emplace(mask, &archetype);
+	for (auto& query : _queries)
+		query->Match(archetype);
+	return archetype;
+}
+
+Query& World::GetQuery(ComponentMask required)
+{
+	for (auto& query : _queries)
+		if (query->GetRequired() == required)
+			return *query;
+
+	auto& query = *_queries.emplace_back(std::make_unique<Query>(required));
+	for (auto& archetype : _archetypes)
+		query.Match(*archetype);
+	return query;
+}
+
+Entity World::AllocateEntity()
+{
+	std::uint32_t index;
+	if (!_freeIndices.empty())
+	{
+		index = _freeIndices.back();
+		_freeIndices.pop_back();
+	}
+	else
+	{
+		index = static_cast<std::uint32_t>(_locations.size());
+		_locations.emplace_back();
+		_generations.push_back(0u);
+	}
+
+	_entityCount++;
+	return { index, _generations[index] };
+}
+
+void World::FreeRow(const EntityLocation& location) noexcept
+{
+	const Entity moved = location._archetype->Free(location._chunk, location._row);
+	if (moved.IsValid())
+		_locations[moved._index] = location;
+}
+
+void World::Move(Entity entity, ComponentMask mask)
+{
+	Archetype& destination = GetArchetype(mask);
+	const EntityLocation source = _locations[entity._index];
+	const EntityLocation location = destination.Allocate(entity);
+
+	source._archetype->CopyShared(source._chunk, source._row, destination, location._chunk, location._row);
+	FreeRow(source);
+	_locations[entity._index] = location;
+}
+
+std::byte* World::GetComponent(Entity entity, ComponentID id) const noexcept
+{
+	if (!IsAlive(entity))
+		return nullptr;
+
+	const EntityLocation& location = _locations[entity._index];
+	std::byte* column = location._archetype->GetColumn(location._chunk, id);
+	return column ? column + location._row * ComponentRegistry::GetInfo(id)._size : nullptr;
+}
@@ -4,6 +4,8 @@
 #include <numbers>
 #include <ranges>
 #include <cmath>
+#include "../../include/sasha/utility/JobSystem.h"
+#include "../../include/sasha/utility/Parallel.h"
 
 D3DRenderer::D3DRenderer(HWND wh, int w, int h)
 	: _wndHandle(wh)
@@ -34,6 +36,16 @@ void D3DRenderer::d3dInit()
 	_cmdList = std::make_unique<CommandList>(_device->Get());
 	_cmdList->Get()->Close();
 
+	// The draws are split over these lists and recorded in parallel, the main list only holds the barriers and clears
+	size_t recordWorkerCount = std::min<size_t>(parallel::GetWorkerCount(), _maxRecordWorkers);
+	for (size_t i = 0; i < recordWorkerCount; i++)
+	{
+		_workerCmdLists.push_back(std::make_unique<CommandList>(_device->Get()));
+		_workerCmdLists.back()->Get()->Close();
+	}
+	_workerRecorders.resize(recordWorkerCount);
+	_drawRanges.resize(recordWorkerCount);
+
 	_swapChain = std::make_unique<SwapChain>(_wndHandle, _device.get(), _cmdQueue.get(), _appHeight, _appWidth);
 
 	// Creating descriptor heaps for the rtv and dsv which will contain rtvs and dsv descriptor that will be bind to the GPU pipeline
@@ -81,7 +93,34 @@ void D3DRenderer::RenderFrame(Timer& t)
 
 void D3DRenderer::Update(Timer& t)
 {
-	UpdateCamera(t);
+	// Camera and models write disjoint data, culling needs both. Only the constant buffer writes touch the frame resource,
+	// so everything before them overlaps the wait for the GPU to release it
+	EditScene();
+
+	auto& jobSystem = JobSystem::Get();
+	JobCounter input, scene, constants;
+
+	jobSystem.Run(input, [this, &t]()
+		{
+			UpdateCamera(t);
+			// Refreshes the cached view now, the jobs after this one read it concurrently
+			_camera.GetView();
+		});
+	jobSystem.Run(input, [this, &t]()
+		{
+			UpdateModels(t);
+			_scene.UpdateTransforms();
+			_scene.UpdateBounds(_geoLib);
+		});
+	// Culling and per entity light selection both change what the object constants hold, so they share a counter.
+	// The level of detail picks the submesh culling gathers for the packets
+	jobSystem.Run(scene, [this]()
+		{
+			_scene.SelectLods(_geoLib, _camera, static_cast<float>(_appHeight));
+			_scene.CullItems(_camera);
+			_scene.BuildDrawPackets(_geoLib, _camera);
+		}, &input);
+	jobSystem.Run(scene, [this, &t]() { UpdateLights(t); }, &input);
 
 	_frameResourceIndex = (_frameResourceIndex + 1) % _frameResourceCount;
 	_currFrameResource = _frameResources[_frameResourceIndex].get();
@@ -91,12 +130,15 @@ void D3DRenderer::Update(Timer& t)
 		_cmdQueue->GetFence()->SetEventOnCompletion(_currFrameResource->_fence, _eventHandle);
 		WaitForSingleObject(_eventHandle, INFINITE);
 	}
+	GrowFrameResources();
 
-	UpdateModels(t);
-	
-	UpdateObjCB(t);
-	UpdatePassCB(t);
-	UpdateMatCB(t);
+	jobSystem.Run(constants, [this, &t]() { UpdateObjCB(t); }, &scene);
+	jobSystem.Run(constants, [this, &t]() { UpdatePassCB(t); }, &scene);
+	jobSystem.Run(constants, [this, &t]() { UpdateMatCB(t); });
+	jobSystem.Run(constants, [this, &t]() { UpdateLightBuffers(t); }, &scene);
+
+	// The constant buffer jobs wait on the scene jobs, so this covers every job of the frame
+	jobSystem.Wait(constants);
 }
 
 float D3DRenderer::AspectRatio() const noexcept
@@ -110,26 +152,51 @@ void D3DRenderer::SetAppSize(int w, int h) noexcept
 	_appWidth = w;	
 }
 
+const DrawStateCounters& D3DRenderer::GetDrawCounters() const noexcept
+{
+	return _drawCounters;
+}
+
+const UploadCounters& D3DRenderer::GetUploadCounters() const noexcept
+{
+	return _uploadCounters;
+}
+
 void D3DRenderer::BuildInputLayout()
 {
 	// Getting and compiling the shaders
 	std::filesystem::path shaderPath = std::filesystem::current_path() / ".." / "shaders";
 
-	auto defaultVsPath = shaderPath / "defaultVS.cso";
+	auto defaultVsPath = shaderPath / (_vertexFormat == VertexFormat::Compact ? "defaultCompactVS.cso" : "defaultVS.cso");
 	auto defaultPsPath = shaderPath / "defaultPS.cso";
 
 	auto alphaTestedPs = shaderPath / "alphaTestedPS.cso";
 
 	ThrowIfFailed(D3DReadFileToBlob(defaultVsPath.c_str(), &_vertexShader));
 	ThrowIfFailed(D3DReadFileToBlob(defaultPsPath.c_str(), &_pixelShader));
+	ThrowIfFailed(D3DReadFileToBlob(alphaTestedPs.c_str(), &_alphaTestedPixelShader));
 
 	// Creating the input layout
-	_inputLayoutDesc =
+	if (_vertexFormat == VertexFormat::Compact)
 	{
-		{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-		{"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-		{"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-	};
+		// Matches CompactVertex, the input assembler expands every channel back to floats
+		auto texFormat = _texCoordEncoding == TexCoordEncoding::Half ? DXGI_FORMAT_R16G16_FLOAT : DXGI_FORMAT_R16G16_UNORM;
+		_inputLayoutDesc =
+		{
+			{"POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+			{"NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+			{"TEXCOORD", 0, texFormat, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		};
+	}
+	else
+	{
+		_inputLayoutDesc =
+		{
+			{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+			{"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+			{"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		};
+	}
 }
 
 void D3DRenderer::BuildGeometry()
@@ -141,15 +208,27 @@ void D3DRenderer::BuildGeometry()
 	auto cylinder = g.CreateCylinder(0.5f, 0.3f, 3.f, 10, 10);
 	auto grid = g.CreateGrid(160.f, 160.f, 100, 100);
 	std::filesystem::path skullPath = std::filesystem::current_path() / ".." / "assets" / "models" / "skull.txt";
-	auto skull = g.ReadFile(skullPath.string());
+	// The skull is baked to a binary cache on first launch and memory mapped afterwards
+	auto skull = MeshCache::Load(skullPath);
+
+	MeshImportOptions options;
+	options._optimizeVertexCache = true;
+	options._optimizeOverdraw = true;
+	options._optimizeVertexFetch = true;
+	options._buildMeshlets = true;
 
-	_geoLib.AddGeometry("box", box);
-	_geoLib.AddGeometry("sphere", geoSphere);
-	_geoLib.AddGeometry("cylinder", cylinder);
-	_geoLib.AddGeometry("grid", grid);
-	_geoLib.AddGeometry("skull", skull);
+	_geoLib.AddGeometry("box", box, options);
+	_geoLib.AddGeometry("sphere", geoSphere, options);
+	_geoLib.AddGeometry("cylinder", cylinder, options);
+	_geoLib.AddGeometry("grid", grid, options);
+
+	// The skull is the only dense mesh, give it a level of detail chain
+	auto skullOptions = options;
+	skullOptions._lodTriangleRatios = { 0.5f, 0.25f, 0.125f };
+	_geoLib.AddGeometry("skull", skull->GetVertices(), skull->GetIndices(), skullOptions);
 
 	// Once all are added:
+	_geoLib.SetVertexFormat(_vertexFormat, _texCoordEncoding);
 	_geoLib.Upload(_device->Get(), _cmdList->Get());
 }
 
@@ -166,6 +245,8 @@ void D3DRenderer::BuildMaterial()
 	boxMat->_matProperties._diffuseAlbedo = { 1.f, 1.f, 1.f, 1.0f };
 	boxMat->_matProperties._fresnelR0 = { 0.5f, 0.5f, 0.5f };
 	boxMat->_matProperties._roughness = 0.25f;
+	// The wire fence texture is mostly holes
+	boxMat->_layer = RenderLayer::AlphaTested;
 
 	auto sphereMat = std::make_unique<Material>();
 	sphereMat->name = "sphereMat";
@@ -217,8 +298,17 @@ void D3DRenderer::BuildLights()
 		light.FalloffEnd = 4.0f;
 		light.Position = { 12.f * cosf(theta), 5.f, 12.f * sinf(theta) };
 
-		_scene.AddLight(light);
+		_scene.AddLight(light, LightType::Point);
 	}
+
+	// Its direction is set every frame by UpdateLights
+	Light sun;
+	sun.Strength = { .3f, .4f, 1.f };
+	sun.FalloffStart = 2.0f;
+	sun.FalloffEnd = 1000.0f;
+	sun.Position = { 0.f, 10.f, 0.f };
+	sun.SpotPower = 8.0f;
+	_sunLight = _scene.AddLight(sun, LightType::Spot);
 }
 
 void D3DRenderer::BuildTextures()
@@ -264,40 +354,84 @@ void D3DRenderer::BuildTextures()
 
 void D3DRenderer::BuildScene()
 {
-	_scene.AddInstance("grid", "hillMat");
+	_scene.AddInstance(_geoLib, "grid", "hillMat");
 	for (float theta = 0; theta < 2.f * d3dUtil::PI; theta += (d3dUtil::PI / 18.f))
 	{
-		_scene.AddInstance("cylinder", "cylinderMat", d3dUtil::GetTranslation(12.f * cosf(theta), 1.5f, 12.f * sinf(theta)));
-		_scene.AddInstance("sphere", "sphereMat", d3dUtil::GetTranslation(12.f * cosf(theta), 3.5f, 12.f * sinf(theta)));
+		const Entity pillar = _scene.AddInstance(_geoLib, "cylinder", "cylinderMat", d3dUtil::GetTranslation(12.f * cosf(theta), 1.5f, 12.f * sinf(theta)));
+		_scene.AddInstance(_geoLib, "sphere", "sphereMat", d3dUtil::GetTranslation(0.f, 2.f, 0.f), pillar);
+		_pillars.push_back(pillar);
 	}
-	_scene.AddInstance("box", "boxMat", d3dUtil::GetTranslation(0.f, 2.5f, 0.f));
-	_scene.AddInstance("sphere", "lightSphereMat", d3dUtil::MatToFloat4x4(XMMatrixMultiply(XMMatrixScaling(2.f, 2.f, 2.f), XMMatrixTranslation(0.f, 2.f, 0.f))));
+	_scene.AddInstance(_geoLib, "box", "boxMat", d3dUtil::GetTranslation(0.f, 2.5f, 0.f));
+	_scene.AddInstance(_geoLib, "sphere", "lightSphereMat", d3dUtil::MatToFloat4x4(XMMatrixMultiply(XMMatrixScaling(2.f, 2.f, 2.f), XMMatrixTranslation(0.f, 2.f, 0.f))));
+
+	auto& textureAnimation = _scene.GetTextureAnimation();
+	_scene.AnimateMaterial(_geoLib, "hillMat", textureAnimation.AddScale({ 25.f, 25.f }));
+	const UvTrackID spin = textureAnimation.AddRotation(1.f);
+	_scene.AnimateMaterial(_geoLib, "sphereMat", spin);
+	_scene.AnimateMaterial(_geoLib, "lightSphereMat", spin);
+}
+
+void D3DRenderer::EditScene()
+{
+	if (!_kbd->IsKeyPressed(VK_F4) || !_kbd->WasKeyPressedThisFrame(VK_F4))
+		return;
 
-	_scene.BuildRenderItems(_geoLib);
+	// Removing a pillar removes its sphere along with it
+	if (!_crowd.empty())
+	{
+		for (const Entity pillar : _crowd)
+			_scene.RemoveInstance(pillar);
+		_crowd.clear();
+		return;
+	}
+
+	for (int x = 0; x < _crowdSide; x++)
+	{
+		for (int z = 0; z < _crowdSide; z++)
+		{
+			const XMMATRIX world = XMMatrixMultiply(XMMatrixScaling(0.5f, 0.5f, 0.5f), XMMatrixTranslation(20.f + 2.5f * x, 0.75f, 20.f + 2.5f * z));
+			const Entity pillar = _scene.AddInstance(_geoLib, "cylinder", "cylinderMat", d3dUtil::MatToFloat4x4(world));
+			_scene.AddInstance(_geoLib, "sphere", "sphereMat", d3dUtil::GetTranslation(0.f, 2.f, 0.f), pillar);
+			_crowd.push_back(pillar);
+		}
+	}
 }
 
 void D3DRenderer::BuildFrameResources()
 {
 	// Build the Frame Resources
+	// Every item can be its own batch and every item can be visible, so both the per draw constants and the instances are sized by the item count
+	// Instances added later grow them, see GrowFrameResources
+	_itemCapacity = std::max<UINT>(1u, static_cast<UINT>(_scene.GetInstanceCount()));
+	// The light buffers start at one list entry per cluster and light, UpdateLightBuffers grows them when that falls short
+	UINT lightCount = std::max<UINT>(1u, static_cast<UINT>(_scene.GetLights().size()));
+	UINT clusterDataCount = 2u * ClusterGrid::kClusterCount + ClusterGrid::kClusterCount;
 	for (int i = 0; i < _frameResourceCount; i++)
-		_frameResources.push_back(std::make_unique<FrameResource>(_device->Get(), 1u, static_cast<UINT>(_scene.GetRenderItems().size()), static_cast<UINT>(_geoLib.GetMaterialCount())));
+		_frameResources.push_back(std::make_unique<FrameResource>(_device->Get(), 1u, _itemCapacity, static_cast<UINT>(_geoLib.GetMaterialCount()), _itemCapacity, static_cast<UINT>(_workerCmdLists.size()),
+			lightCount, clusterDataCount));
 }
 
 void D3DRenderer::BuildCbvDescriptorHeap()
 {
 	// Creating the constant buffer descriptor heap
 	// Making a heap capable of holding 3n + 3 descriptors
-	// 3n so each object can have their own frame resource on each frame resource
+	// 3n so each frame resource has a range of n per draw constant buffers, n being the item capacity
 	// + 3 so each frame resource has access to it's global constant buffer that's non unique to each object
-	UINT descriptorHeapCount = static_cast<UINT>(((_scene.GetRenderItems().size() + 1 + _geoLib.GetMaterialCount()) * _frameResourceCount));
+	UINT descriptorHeapCount = static_cast<UINT>(((_itemCapacity + 1 + _geoLib.GetMaterialCount()) * _frameResourceCount));
 	// Getting the index at which the global constant buffers are, right after all the unique constant buffers
-	_matCbvOffset = static_cast<UINT>(_frameResourceCount * _scene.GetRenderItems().size());
+	_matCbvOffset = static_cast<UINT>(_frameResourceCount * _itemCapacity);
 	_passCbvOffset = static_cast<UINT>(_matCbvOffset + _frameResourceCount * _geoLib.GetMaterialCount());
 
 	_cbvHeap = std::make_unique<DescriptorHeap>(_device->Get(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, descriptorHeapCount, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE);
 }
 
 void D3DRenderer::BuildConstantBuffers()
+{
+	for (UINT i = 0; i < _frameResourceCount; i++)
+		BuildConstantBufferViews(i);
+}
+
+void D3DRenderer::BuildConstantBufferViews(UINT frameIndex)
 {
 	// Building the constant buffers at the place of each descriptor inside the heap created earlier
 	// Getting the size of both cbs padded ceiled to a multiple of 256 for padding reasons on the shader and GPU side
@@ -305,53 +439,85 @@ void D3DRenderer::BuildConstantBuffers()
 	UINT passSize = d3dUtil::CalcConstantBufferSize(sizeof(PassBuffer));
 	UINT matSize = d3dUtil::CalcConstantBufferSize(sizeof(MaterialConstant));
 
-	for (UINT i = 0; i < _frameResourceCount; i++)
+	const UINT i = frameIndex;
+	// Get the constant buffer from the frame resource, it can still be smaller than the capacity until it's grown
+	auto objCB = _frameResources[i]->_cb->GetResource();
+	const UINT objCount = std::min<UINT>(_frameResources[i]->_cb->GetElementCount(), _itemCapacity);
+	for (UINT j = 0; j < objCount; j++)
 	{
-		// Get the constant buffer from the current frame resource
-		auto objCB = _frameResources[i]->_cb->GetResource();
-		for (UINT j = 0; j < _scene.GetRenderItems().size(); j++)
-		{
-			// For each object, get the virtual address of the constant buffer and increment to access the jth object's cb
-			D3D12_GPU_VIRTUAL_ADDRESS cbAddress = objCB->GetGPUVirtualAddress();
-			cbAddress += j * cbSize;
-			
-			// Get the index on the heap that contains the constant buffer for every object and get a handle to the right position of the constant buffer
-			int heapIndex = (int)(i * _scene.GetRenderItems().size() + j);
-
-			// Create constant buffer view
-			D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc{};
-			cbvDesc.BufferLocation = cbAddress;
-			cbvDesc.SizeInBytes = cbSize;
-
-			_device->Get()->CreateConstantBufferView(&cbvDesc, _cbvHeap->GetCPUStart(heapIndex));
-		}
+		// For each object, get the virtual address of the constant buffer and increment to access the jth object's cb
+		D3D12_GPU_VIRTUAL_ADDRESS cbAddress = objCB->GetGPUVirtualAddress();
+		cbAddress += j * cbSize;
 
-		auto matCB = _frameResources[i]->_mat->GetResource();
-		for (UINT j = 0; j < _geoLib.GetMaterialCount(); j++)
-		{
-			D3D12_GPU_VIRTUAL_ADDRESS cbAddress = matCB->GetGPUVirtualAddress();
-			cbAddress += j * matSize;
+		// Get the index on the heap that contains the constant buffer for every object and get a handle to the right position of the constant buffer
+		int heapIndex = (int)(i * _itemCapacity + j);
 
-			int heapIndex = (int)(_matCbvOffset + i * _geoLib.GetMaterialCount() + j);
+		// Create constant buffer view
+		D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc{};
+		cbvDesc.BufferLocation = cbAddress;
+		cbvDesc.SizeInBytes = cbSize;
 
-			D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc{};
-			cbvDesc.BufferLocation = cbAddress;
-			cbvDesc.SizeInBytes = matSize;
+		_device->Get()->CreateConstantBufferView(&cbvDesc, _cbvHeap->GetCPUStart(heapIndex));
+	}
 
-			_device->Get()->CreateConstantBufferView(&cbvDesc, _cbvHeap->GetCPUStart(heapIndex));
-		}
-		// Do something similar for the global constant buffers that are shared between objects in the same frame resource
-		auto passCB = _frameResources[i]->_pass->GetResource();
-		D3D12_GPU_VIRTUAL_ADDRESS cbAddress = passCB->GetGPUVirtualAddress();
+	auto matCB = _frameResources[i]->_mat->GetResource();
+	for (UINT j = 0; j < _geoLib.GetMaterialCount(); j++)
+	{
+		D3D12_GPU_VIRTUAL_ADDRESS cbAddress = matCB->GetGPUVirtualAddress();
+		cbAddress += j * matSize;
 
-		int heapIndex = _passCbvOffset + i;
+		int heapIndex = (int)(_matCbvOffset + i * _geoLib.GetMaterialCount() + j);
 
 		D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc{};
 		cbvDesc.BufferLocation = cbAddress;
-		cbvDesc.SizeInBytes = passSize;
+		cbvDesc.SizeInBytes = matSize;
 
 		_device->Get()->CreateConstantBufferView(&cbvDesc, _cbvHeap->GetCPUStart(heapIndex));
 	}
+	// Do something similar for the global constant buffers that are shared between objects in the same frame resource
+	auto passCB = _frameResources[i]->_pass->GetResource();
+	D3D12_GPU_VIRTUAL_ADDRESS cbAddress = passCB->GetGPUVirtualAddress();
+
+	int heapIndex = _passCbvOffset + i;
+
+	D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc{};
+	cbvDesc.BufferLocation = cbAddress;
+	cbvDesc.SizeInBytes = passSize;
+
+	_device->Get()->CreateConstantBufferView(&cbvDesc, _cbvHeap->GetCPUStart(heapIndex));
+}
+
+void D3DRenderer::GrowFrameResources()
+{
+	const UINT64 completedFence = _cmdQueue->GetFence()->GetCompletedValue();
+	std::erase_if(_retiredCbvHeaps, [completedFence](const auto& retired) { return retired.first <= completedFence; });
+
+	const UINT itemCount = static_cast<UINT>(_scene.GetInstanceCount());
+	if (itemCount > _itemCapacity)
+	{
+		_itemCapacity = std::max<UINT>(itemCount, 2u * _itemCapacity);
+		if (_usingDescriptorTables)
+		{
+			// Every frame in flight indexes the old heap with the old ranges, a new one leaves them untouched
+			_retiredCbvHeaps.push_back({ _cmdQueue->GetCurrFence(), std::move(_cbvHeap) });
+			BuildCbvDescriptorHeap();
+			BuildConstantBuffers();
+		}
+	}
+
+	// The GPU is done with this frame resource, so its buffers can be replaced right away. The per draw constants and the
+	// indices are rewritten every frame, the instances only when their item is dirty so they're carried over
+	auto& frame = *_currFrameResource;
+	if (frame._instances->GetElementCount() >= _itemCapacity)
+		return;
+
+	auto instances = std::make_unique<d3dUtil::UploadBuffer<InstanceData>>(_device->Get(), _itemCapacity);
+	instances->CopyElements(*frame._instances, frame._instances->GetElementCount());
+	frame._instances = std::move(instances);
+	frame._instanceIndices = std::make_unique<d3dUtil::UploadBuffer<UINT>>(_device->Get(), _itemCapacity);
+	frame._cb = std::make_unique<d3dUtil::UploadBuffer<ConstantBuffer>>(_device->Get(), _itemCapacity, true);
+	if (_usingDescriptorTables)
+		BuildConstantBufferViews(_frameResourceIndex);
 }
 
 void D3DRenderer::BuildRootSignature()
@@ -363,6 +529,10 @@ void D3DRenderer::BuildRootSignature()
 		rootBuilder.AddDescriptorTable(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1u, 0u);
 		rootBuilder.AddDescriptorTable(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1u, 1u);
 		rootBuilder.AddDescriptorTable(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1u, 2u);
+		rootBuilder.AddSRV(1);
+		rootBuilder.AddSRV(2);
+		rootBuilder.AddSRV(3);
+		rootBuilder.AddSRV(4);
 	}
 	else
 	{
@@ -370,6 +540,10 @@ void D3DRenderer::BuildRootSignature()
 		rootBuilder.AddCBV(0);
 		rootBuilder.AddCBV(1);
 		rootBuilder.AddCBV(2);
+		rootBuilder.AddSRV(1);
+		rootBuilder.AddSRV(2);
+		rootBuilder.AddSRV(3);
+		rootBuilder.AddSRV(4);
 	}
 
 	_rootSignature = rootBuilder.Build(_device->Get(), Texture::GetStaticSampler());
@@ -393,12 +567,30 @@ void D3DRenderer::BuildPSO()
 	_rtDesc = rtDesc;
 
 	GraphicsPipelineRecipe recipe = GraphicsPipelineRecipe::MakeDefault(_inputLayoutDesc, vs, ps);
-	_solid = recipe;
-	_psoCache->GetOrCreate(_rootSignature.Get(), recipe, rtDesc);
+	_pipelines[static_cast<size_t>(RenderLayer::Opaque)] = recipe;
+
+	// Clipped texels leave holes, so the back faces have to show through
+	auto& alphaTested = _pipelines[static_cast<size_t>(RenderLayer::AlphaTested)];
+	alphaTested = recipe;
+	alphaTested._ps = { _alphaTestedPixelShader->GetBufferPointer(), _alphaTestedPixelShader->GetBufferSize() };
+	alphaTested._rasterizerDesc.CullMode = D3D12_CULL_MODE_NONE;
+
+	// Blended on top of the opaque layers in back to front order, without writing depth
+	auto& transparent = _pipelines[static_cast<size_t>(RenderLayer::Transparent)];
+	transparent = recipe;
+	auto& blend = transparent._blendDesc.RenderTarget[0];
+	blend.BlendEnable = true;
+	blend.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+	blend.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+	blend.BlendOp = D3D12_BLEND_OP_ADD;
+	transparent._depthStentilDesc.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
 
 	recipe._rasterizerDesc.FillMode = D3D12_FILL_MODE_WIREFRAME;
 	_wireframe = recipe;
-	_psoCache->GetOrCreate(_rootSignature.Get(), recipe, rtDesc);
+
+	for (const auto& pipeline : _pipelines)
+		_psoCache->GetOrCreate(_rootSignature.Get(), pipeline, rtDesc);
+	_psoCache->GetOrCreate(_rootSignature.Get(), _wireframe, rtDesc);
 }
 
 void D3DRenderer::OnResize()
@@ -420,92 +612,144 @@ void D3DRenderer::BeginFrame()
 	auto& _currCmdAlloc = _currFrameResource->_cmdAlloc;
 
 	ThrowIfFailed(_currFrameResource->_cmdAlloc->Reset());
+	for (auto& alloc : _currFrameResource->_workerCmdAllocs)
+		ThrowIfFailed(alloc->Reset());
 
-	GraphicsPipelineRecipe recipe = _isWireFrame ? _wireframe : _solid;
-	auto* pso = _psoCache->GetOrCreate(_rootSignature.Get(), recipe, _rtDesc);
-
-	_cmdList->Reset(_currCmdAlloc.Get(), pso);
+	// The draw lists set the pipeline of each batch
+	_cmdList->Reset(_currCmdAlloc.Get(), nullptr);
 	
 	_cmdList->ChangeResourceState(_swapChain->GetCurrBackBuffer(), D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
 }
 
 void D3DRenderer::DrawFrame()
 {
-	_cmdList->Get()->RSSetViewports(1, _swapChain->GetViewport());
-	_cmdList->Get()->RSSetScissorRects(1, _swapChain->GetRect());
-
 	_cmdList->Get()->ClearRenderTargetView(_swapChain->GetCurrBackBufferView(*_rtvHeap.get()), Colors::SteelBlue, 0, nullptr);
 	_cmdList->Get()->ClearDepthStencilView(_swapChain->GetDSView(*_dsvHeap.get()), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.f, 0, 0, nullptr);
 
-	auto currBackBufferView = _swapChain->GetCurrBackBufferView(*_rtvHeap.get());
-	auto dsv = _swapChain->GetDSView(*_dsvHeap.get());
-	_cmdList->Get()->OMSetRenderTargets(1, &currBackBufferView, true, &dsv);
-
-	if (_usingDescriptorTables)
-	{
-		ID3D12DescriptorHeap* descriptorHeaps[] = { _cbvHeap->Get() };
-		_cmdList->Get()->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
-	}
+	BuildDrawCommands();
 
-	_cmdList->Get()->SetGraphicsRootSignature(_rootSignature.Get());
+	DrawListSetup setup;
+	setup._viewport = *_swapChain->GetViewport();
+	setup._scissorRect = *_swapChain->GetRect();
+	setup._renderTarget = _swapChain->GetCurrBackBufferView(*_rtvHeap.get());
+	setup._depthStencil = _swapChain->GetDSView(*_dsvHeap.get());
+	setup._rootSignature = _rootSignature.Get();
+	setup._heaps[0] = _usingDescriptorTables ? _cbvHeap->Get() : _srvHeap->Get();
+	setup._heapCount = 1u;
 
 	if (_usingDescriptorTables)
 	{
 		int passCbvIndex = _passCbvOffset + _frameResourceIndex;
-		_cmdList->Get()->SetGraphicsRootDescriptorTable(2, _cbvHeap->GetGPUStart(passCbvIndex));
+		setup._rootArguments[setup._rootArgumentCount++] = { 2u, RootArgumentBinding::Type::Table, _cbvHeap->GetGPUStart(passCbvIndex).ptr };
 	}
 	else
 	{
-		ID3D12DescriptorHeap* descriptorsHeap[] = { _srvHeap->Get() };
-		_cmdList->Get()->SetDescriptorHeaps(_countof(descriptorsHeap), descriptorsHeap);
-
 		auto passAddress = _currFrameResource->_pass->GetResource()->GetGPUVirtualAddress();
-		_cmdList->Get()->SetGraphicsRootConstantBufferView(3, passAddress);
+		setup._rootArguments[setup._rootArgumentCount++] = { 3u, RootArgumentBinding::Type::Cbv, passAddress };
 	}
 
+	// The instance buffers are shared by every draw of the frame, each draw offsets into the indices through its per draw constants
+	const UINT instancesIndex = _usingDescriptorTables ? 3u : 4u;
+	auto instancesAddress = _currFrameResource->_instances->GetResource()->GetGPUVirtualAddress();
+	auto instanceIndicesAddress = _currFrameResource->_instanceIndices->GetResource()->GetGPUVirtualAddress();
+	setup._rootArguments[setup._rootArgumentCount++] = { instancesIndex, RootArgumentBinding::Type::Srv, instancesAddress };
+	setup._rootArguments[setup._rootArgumentCount++] = { instancesIndex + 1u, RootArgumentBinding::Type::Srv, instanceIndicesAddress };
+
+	// Point and spot lights with the cluster lists the pixel shaders look them up in
+	auto lightsAddress = _currFrameResource->_lights->GetResource()->GetGPUVirtualAddress();
+	auto lightClustersAddress = _currFrameResource->_lightClusters->GetResource()->GetGPUVirtualAddress();
+	setup._rootArguments[setup._rootArgumentCount++] = { instancesIndex + 2u, RootArgumentBinding::Type::Srv, lightsAddress };
+	setup._rootArguments[setup._rootArgumentCount++] = { instancesIndex + 3u, RootArgumentBinding::Type::Srv, lightClustersAddress };
+
+	// Each thread records whole ranges into its own list and allocator, the lists are submitted in range order
+	_drawListCount = DrawRecording::Partition(_drawCommands.size(), _minDrawsPerList, _drawRanges);
+	parallel::ForRange(_drawListCount, 1u, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				const auto& range = _drawRanges[i];
+				auto& cmdList = _workerCmdLists[i];
+				cmdList->Reset(_currFrameResource->_workerCmdAllocs[i].Get(), nullptr);
+
+				auto& recorder = _workerRecorders[i];
+				recorder.Reset(cmdList->Get());
+				recorder.ResetCounters();
+				DrawRecording::Record(recorder, setup, std::span(_drawCommands).subspan(range._begin, range._end - range._begin));
+			}
+		});
+
+	_drawCounters = {};
+	_drawCounters._draws = _drawCommands.size();
+	for (size_t i = 0; i < _drawListCount; i++)
+	{
+		const auto& counters = _workerRecorders[i].GetCounters();
+		_drawCounters._pipelineChanges += counters.GetIssued(RecordedCall::PipelineState);
+		_drawCounters._descriptorTableChanges += counters.GetIssued(RecordedCall::RootDescriptorTable);
+		_drawCounters._vertexBufferChanges += counters.GetIssued(RecordedCall::VertexBuffers);
+		_drawCounters._indexBufferChanges += counters.GetIssued(RecordedCall::IndexBuffer);
+	}
+}
+
+void D3DRenderer::BuildDrawCommands()
+{
 	auto objCBSize = d3dUtil::CalcConstantBufferSize(sizeof(ConstantBuffer));
 	auto matCBSize = d3dUtil::CalcConstantBufferSize(sizeof(MaterialConstant));
+	const auto& vbv = _geoLib.GetMesh().VertexBufferView();
 
-	for (const auto& ri : _scene.GetRenderItems())
+	const auto& batches = _scene.GetBatches();
+	_drawCommands.resize(batches.size());
+	for (UINT b = 0; b < batches.size(); b++)
 	{
-		const auto& vbv = _geoLib.GetMesh().VertexBufferView();
-		const auto& ibv = _geoLib.GetMesh().IndexBufferView();
-
-		const auto& mat = _geoLib.GetMaterial(ri->_materialId);
-		const auto& submesh = _geoLib.GetSubmesh(ri->_submeshId);
-
-		_cmdList->Get()->IASetVertexBuffers(0, 1, &vbv);
-		_cmdList->Get()->IASetIndexBuffer(&ibv);
-		_cmdList->Get()->IASetPrimitiveTopology(ri->_primitiveType);
-
+		const auto& batch = batches[b];
+		const auto& mat = _geoLib.GetMaterial(batch._materialId);
+		const auto& submesh = _geoLib.GetSubmesh(batch._submeshId);
+
+		auto& draw = _drawCommands[b];
+		const auto& recipe = _isWireFrame ? _wireframe : _pipelines[batch._pipeline];
+		draw._pso = _psoCache->GetOrCreate(_rootSignature.Get(), recipe, _rtDesc);
+		draw._vertexBuffer = vbv;
+		draw._indexBuffer = _geoLib.GetMesh().IndexBufferView(submesh._indexFormat);
+		draw._topology = batch._primitiveType;
+
+		// Per draw constants are written at the batch index by UpdateObjCB
 		if (_usingDescriptorTables)
 		{
-			UINT cbvIndex = _frameResourceIndex * static_cast<UINT>(_scene.GetRenderItems().size()) + ri->_cbObjIndex;
+			UINT cbvIndex = _frameResourceIndex * _itemCapacity + b;
 			UINT matIndex = _frameResourceIndex * static_cast<UINT>(_geoLib.GetMaterialCount()) + _matCbvOffset + mat._matCBIndex;
 
-			_cmdList->Get()->SetGraphicsRootDescriptorTable(0, _cbvHeap->GetGPUStart(cbvIndex));
-			_cmdList->Get()->SetGraphicsRootDescriptorTable(1, _cbvHeap->GetGPUStart(matIndex));
+			draw._rootArguments[0] = { 0u, RootArgumentBinding::Type::Table, _cbvHeap->GetGPUStart(cbvIndex).ptr };
+			draw._rootArguments[1] = { 1u, RootArgumentBinding::Type::Table, _cbvHeap->GetGPUStart(matIndex).ptr };
+			draw._rootArgumentCount = 2u;
 		}
 		else
 		{
-			auto cbvAddress = _currFrameResource->_cb->GetResource()->GetGPUVirtualAddress() + ri->_cbObjIndex * objCBSize;
+			auto cbvAddress = _currFrameResource->_cb->GetResource()->GetGPUVirtualAddress() + b * objCBSize;
 			auto matAddress = _currFrameResource->_mat->GetResource()->GetGPUVirtualAddress() + mat._matCBIndex * matCBSize;
 			auto texAddress = _srvHeap->GetGPUStart(mat._diffuseSrvHeapIndex);
 
-			_cmdList->Get()->SetGraphicsRootDescriptorTable(0, texAddress);
-			_cmdList->Get()->SetGraphicsRootConstantBufferView(1, cbvAddress);
-			_cmdList->Get()->SetGraphicsRootConstantBufferView(2, matAddress);
+			draw._rootArguments[0] = { 0u, RootArgumentBinding::Type::Table, texAddress.ptr };
+			draw._rootArguments[1] = { 1u, RootArgumentBinding::Type::Cbv, cbvAddress };
+			draw._rootArguments[2] = { 2u, RootArgumentBinding::Type::Cbv, matAddress };
+			draw._rootArgumentCount = 3u;
 		}
 
-		_cmdList->Get()->DrawIndexedInstanced(submesh._indexCount, 1u, submesh._startIndexLocation, submesh._baseVertexLocation, 0u);
+		draw._indexCount = submesh._indexCount;
+		draw._instanceCount = batch._instanceCount;
+		draw._startIndexLocation = submesh._startIndexLocation;
+		draw._baseVertexLocation = submesh._baseVertexLocation;
 	}
 }
 
 void D3DRenderer::EndFrame()
 {
-	_cmdList->ChangeResourceState(_swapChain->GetCurrBackBuffer(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
-
-	_cmdQueue->ExecuteCmdList(_cmdList->Get());
+	// The back buffer goes back to present after the last draw, so on the last list submitted
+	auto& lastList = _drawListCount > 0u ? *_workerCmdLists[_drawListCount - 1u] : *_cmdList;
+	lastList.ChangeResourceState(_swapChain->GetCurrBackBuffer(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
+
+	std::vector<ID3D12GraphicsCommandList*> cmdLists = { _cmdList->Get() };
+	for (size_t i = 0; i < _drawListCount; i++)
+		cmdLists.push_back(_workerCmdLists[i]->Get());
+	_cmdQueue->ExecuteCmdList(cmdLists);
 	_swapChain->Present();
 
 	_currFrameResource->_fence = ++_cmdQueue->GetCurrFence();
@@ -538,6 +782,10 @@ void D3DRenderer::UpdateCamera(const Timer& t)
 	else if (_kbd->IsKeyPressed(VK_F2) && _kbd->WasKeyPressedThisFrame(VK_F2))
 		_isWireFrame = !_isWireFrame;
 
+	// Lighting Path
+	if (_kbd->IsKeyPressed(VK_F3) && _kbd->WasKeyPressedThisFrame(VK_F3))
+		_perObjectLights = !_perObjectLights;
+
 	// Light Controll
 	if (_kbd->IsKeyPressed(VK_UP))
 		_lightPhi -= _sunSpeed * dt;
@@ -553,23 +801,75 @@ void D3DRenderer::UpdateCamera(const Timer& t)
 
 void D3DRenderer::UpdateModels(const Timer& t)
 {
+	_scene.UpdateTextureAnimation(t.TotalTime());
+
+	// The pillars sink into the ground and rise again one after the other, their spheres follow through the hierarchy
+	for (size_t i = 0; i < _pillars.size(); i++)
+	{
+		LocalTransform local = _scene.GetLocal(_pillars[i]);
+		local._translation.y = 1.5f - _pillarTravel * (0.5f + 0.5f * sinf(t.TotalTime() + 0.5f * static_cast<float>(i)));
+		_scene.SetLocal(_pillars[i], local);
+	}
+}
+
+void D3DRenderer::UpdateLights(const Timer& t)
+{
+	XMVECTOR lightDir = -DirectX::XMVectorSet(
+		1.f * sinf(_lightPhi) * cosf(_lightTheta),
+		1.f * cosf(_lightPhi),
+		1.f * sinf(_lightPhi) * sinf(_lightTheta),
+		1.0f);
+	XMStoreFloat3(&_scene.GetLights()[_sunLight].Direction, lightDir);
+
+	if (_perObjectLights)
+		_scene.SelectItemLights();
+	else
+		_scene.BuildLightClusters(_camera);
 }
 
 void D3DRenderer::UpdateObjCB(const Timer& t)
 {
 	auto currObjCB = _currFrameResource->_cb.get();
-	for (auto& e : _scene.GetRenderItems())
+	auto currInstances = _currFrameResource->_instances.get();
+	auto currInstanceIndices = _currFrameResource->_instanceIndices.get();
+
+	// Visible or not, a dirty entity has to reach every frame resource, otherwise one of them keeps the old data
+	size_t instanceBytes = 0u;
+	_scene.GetInstances().ForEach<InstanceSlot, InstanceDirty, Transform, TexTransform, SelectedLights>(
+		[&](Entity, const InstanceSlot& slot, InstanceDirty& dirty, const Transform& transform, const TexTransform& tex, const SelectedLights& lights)
+		{
+			if (!dirty._dirty.Consume())
+				return;
+
+			InstanceData instance;
+			XMStoreFloat4x4(&instance.world, XMMatrixTranspose(XMLoadFloat4x4(&transform._world)));
+			XMStoreFloat4x4(&instance.texTrans, XMMatrixTranspose(XMLoadFloat4x4(&tex._transform)));
+			instance.lights = lights._lights;
+			instance.lightCount = lights._count;
+			currInstances->CopyData(slot._slot, instance);
+			instanceBytes += sizeof(InstanceData);
+		});
+
+	// Batches and the visible set change every frame, their data is always written
+	const auto& batchedSlots = _scene.GetBatchedSlots();
+	const auto& batches = _scene.GetBatches();
+	for (UINT b = 0; b < batches.size(); b++)
 	{
-		XMMATRIX world = XMLoadFloat4x4(&e->_world);
+		const auto& batch = batches[b];
+
 		ConstantBuffer cb;
-		XMStoreFloat4x4(&cb.world, XMMatrixTranspose(world));
-		auto name = _geoLib.GetMaterial(e->_materialId).name;
-		if(name == "sphereMat" || name == "lightSphereMat")
-			XMStoreFloat4x4(&cb.texTrans, XMMatrixTranspose(XMMatrixMultiply(XMMatrixIdentity(), XMMatrixRotationZ(t.TotalTime()))));
-		else if(name == "hillMat")
-			XMStoreFloat4x4(&cb.texTrans, XMMatrixTranspose(XMMatrixScaling(25, 25, 25)));
-		currObjCB->CopyData(e->_cbObjIndex, cb);
+		const auto& quantization = _geoLib.GetSubmesh(batch._submeshId)._quantization;
+		cb.posScale = { quantization._extent.x, quantization._extent.y, quantization._extent.z, 0.f };
+		cb.posBias = { quantization._min.x, quantization._min.y, quantization._min.z, 0.f };
+		cb.instanceOffset = batch._firstInstance;
+		currObjCB->CopyData(b, cb);
 	}
+	for (UINT i = 0; i < batchedSlots.size(); i++)
+		currInstanceIndices->CopyData(i, batchedSlots[i]);
+
+	_uploadCounters._drawBytes = batches.size() * sizeof(ConstantBuffer);
+	_uploadCounters._instanceBytes = instanceBytes;
+	_uploadCounters._instanceIndexBytes = batchedSlots.size() * sizeof(UINT);
 }
 
 void D3DRenderer::UpdatePassCB(const Timer& t)
@@ -628,31 +928,33 @@ void D3DRenderer::UpdatePassCB(const Timer& t)
 		_mainPassCB.Lights[i].SpotPower = 32.0f;
 	}*/
 
-	int i = 0;
-	for (; i < _scene.GetLights().size(); i++)
-		_mainPassCB.Lights[i] = _scene.GetLights().at(i);
+	// Point and spot lights are looked up in the clusters, only directional lights stay in the pass constants
+	const auto& directionalLights = _scene.GetDirectionalLights();
+	const UINT dirLightCount = static_cast<UINT>(std::min<size_t>(directionalLights.size(), std::size(_mainPassCB.Lights)));
+	for (UINT i = 0; i < dirLightCount; i++)
+		_mainPassCB.Lights[i] = directionalLights[i];
+	_mainPassCB.DirLightCount = dirLightCount;
 
-	XMVECTOR lightDir = -DirectX::XMVectorSet(
-		1.f * sinf(_lightPhi) * cosf(_lightTheta),
-		1.f * cosf(_lightPhi),
-		1.f * sinf(_lightPhi) * sinf(_lightTheta),
-		1.0f);
-	XMStoreFloat3(&_mainPassCB.Lights[i].Direction, lightDir);
-	_mainPassCB.Lights[i].Strength = { .3f, .4f, 1.f };
-	_mainPassCB.Lights[i].FalloffStart = 2.0f;
-	_mainPassCB.Lights[i].FalloffEnd = 1000.0f;
-	_mainPassCB.Lights[i].Position = { 0.f, 10.f, 0.f };
-	_mainPassCB.Lights[i].SpotPower = 8.0f;
+	const auto& grid = _scene.GetClusterGrid();
+	_mainPassCB.ClusterDims = { ClusterGrid::kTilesX, ClusterGrid::kTilesY, ClusterGrid::kSlices };
+	_mainPassCB.ClusterSliceScale = grid._sliceScale;
+	_mainPassCB.ClusterSliceBias = grid._sliceBias;
+	_mainPassCB.PerObjectLights = _perObjectLights ? 1u : 0u;
 
 	_currFrameResource->_pass->CopyData(0, _mainPassCB);
+	_uploadCounters._passBytes = sizeof(PassBuffer);
 }
 
 void D3DRenderer::UpdateMatCB(const Timer& t)
 {
 	auto currMatCB = _currFrameResource->_mat.get();
-	for (auto& e : _scene.GetRenderItems())
+	size_t materialBytes = 0u;
+	for (size_t i = 0; i < _geoLib.GetMaterialCount(); i++)
 	{
-		auto& mat = _geoLib.GetMaterial(e->_materialId);
+		auto& mat = _geoLib.GetMaterial(static_cast<MaterialID>(i));
+		if (!mat._dirty.Consume())
+			continue;
+
 		XMMATRIX transform = XMLoadFloat4x4(&mat._matProperties._transform);
 		MaterialConstant cb;
 		cb._diffuseAlbedo = mat._matProperties._diffuseAlbedo;
@@ -661,5 +963,32 @@ void D3DRenderer::UpdateMatCB(const Timer& t)
 		XMStoreFloat4x4(&cb._transform, XMMatrixTranspose(transform));
 
 		currMatCB->CopyData(mat._matCBIndex, cb);
+		materialBytes += sizeof(MaterialConstant);
 	}
+
+	_uploadCounters._materialBytes = materialBytes;
+}
+
+void D3DRenderer::UpdateLightBuffers(const Timer& t)
+{
+	const auto& localLights = _scene.GetLocalLights();
+	// The clusters aren't rebuilt while lights are picked per item, the shaders don't read them then
+	const auto clusterData = _perObjectLights ? std::span<const std::uint32_t>() : _scene.GetLightClusters().GetData();
+	const UINT lightCount = static_cast<UINT>(localLights.size());
+	const UINT clusterDataCount = static_cast<UINT>(clusterData.size());
+
+	// The GPU is done with this frame resource, so a buffer the lights outgrew can be replaced right away
+	auto& lights = _currFrameResource->_lights;
+	if (lights->GetElementCount() < lightCount)
+		lights = std::make_unique<d3dUtil::UploadBuffer<Light>>(_device->Get(), std::max<UINT>(lightCount, 2u * lights->GetElementCount()));
+	auto& lightClusters = _currFrameResource->_lightClusters;
+	if (lightClusters->GetElementCount() < clusterDataCount)
+		lightClusters = std::make_unique<d3dUtil::UploadBuffer<UINT>>(_device->Get(), std::max<UINT>(clusterDataCount, 2u * lightClusters->GetElementCount()));
+
+	if (lightCount > 0u)
+		lights->CopyRange(0u, localLights.data(), lightCount);
+	if (clusterDataCount > 0u)
+		lightClusters->CopyRange(0u, clusterData.data(), clusterDataCount);
+
+	_uploadCounters._lightBytes = lightCount * sizeof(Light) + clusterDataCount * sizeof(UINT);
 }
@@ -1,13 +1,22 @@
 #include "../../include/sasha/renderer/FrameResource.h"
 
-FrameResource::FrameResource(ID3D12Device* device, UINT passCount, UINT cbCount, UINT matCount)
+FrameResource::FrameResource(ID3D12Device* device, UINT passCount, UINT cbCount, UINT matCount, UINT instanceCount, UINT workerCount,
+	UINT lightCount, UINT clusterDataCount)
 {
 	ThrowIfFailed(device->CreateCommandAllocator(
 		D3D12_COMMAND_LIST_TYPE_DIRECT,
 		IID_PPV_ARGS(_cmdAlloc.GetAddressOf())
 	));
 
+	_workerCmdAllocs.resize(workerCount);
+	for (auto& alloc : _workerCmdAllocs)
+		ThrowIfFailed(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(alloc.GetAddressOf())));
+
 	_pass = std::make_unique<d3dUtil::UploadBuffer<PassBuffer>>(device, passCount, true);
 	_cb = std::make_unique<d3dUtil::UploadBuffer<ConstantBuffer>>(device, cbCount, true);
 	_mat = std::make_unique<d3dUtil::UploadBuffer<MaterialConstant>>(device, matCount, true);
+	_instances = std::make_unique<d3dUtil::UploadBuffer<InstanceData>>(device, instanceCount);
+	_instanceIndices = std::make_unique<d3dUtil::UploadBuffer<UINT>>(device, instanceCount);
+	_lights = std::make_unique<d3dUtil::UploadBuffer<Light>>(device, lightCount);
+	_lightClusters = std::make_unique<d3dUtil::UploadBuffer<UINT>>(device, clusterDataCount);
 }
\ No newline at end of file
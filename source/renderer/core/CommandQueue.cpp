@@ -44,6 +44,18 @@ void CommandQueue::ExecuteCmdList(ID3D12GraphicsCommandList* cmdList) const
 	_cmdQueue->ExecuteCommandLists(_countof(cmdLists), cmdLists);
 }
 
+void CommandQueue::ExecuteCmdList(std::span<ID3D12GraphicsCommandList* const> cmdLists) const
+{
+	std::vector<ID3D12CommandList*> lists;
+	lists.reserve(cmdLists.size());
+	for (auto* cmdList : cmdLists)
+	{
+		ThrowIfFailed(cmdList->Close());
+		lists.push_back(cmdList);
+	}
+	_cmdQueue->ExecuteCommandLists(static_cast<UINT>(lists.size()), lists.data());
+}
+
 void CommandQueue::Signal() const
 {
 	ThrowIfFailed(_cmdQueue->Signal(_fence.Get(), _currFence));
@@ -58,6 +58,13 @@ void RootSignature::AddCBV(UINT shaderReg, UINT regSpace) noexcept
 	_slotParameters.push_back(param);
 }
 
+void RootSignature::AddSRV(UINT shaderReg, UINT regSpace) noexcept
+{
+	CD3DX12_ROOT_PARAMETER param;
+	param.InitAsShaderResourceView(shaderReg, regSpace);
+	_slotParameters.push_back(param);
+}
+
 void RootSignature::AddRootConstant() noexcept
 {
 }
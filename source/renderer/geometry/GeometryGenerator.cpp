@@ -3,12 +3,328 @@
 //***************************************************************************************
 
 #include "../../../include/sasha/renderer/geometry/GeometryGenerator.h"
+#include "../../../include/sasha/utility/Parallel.h"
 #include <algorithm>
 #include <fstream>
 #include <cassert>
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
 
 using namespace DirectX;
 
+namespace
+{
+	bool IsBlank(char c) noexcept
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	std::string_view Trim(std::string_view line) noexcept
+	{
+		while (!line.empty() && IsBlank(line.front()))
+			line.remove_prefix(1);
+		while (!line.empty() && IsBlank(line.back()))
+			line.remove_suffix(1);
+		return line;
+	}
+
+	// Body of a "{ ... }" block, excluding the braces
+	struct ModelTextSection
+	{
+		const char* _begin = nullptr;
+		const char* _end = nullptr;
+		size_t _firstLine = 0u;
+	};
+
+	struct ModelTextChunk
+	{
+		enum class Kind { Vertex, Triangle };
+
+		const char* _begin = nullptr;
+		const char* _end = nullptr;
+		Kind _kind = Kind::Vertex;
+
+		size_t _lineCount = 0u;
+		size_t _recordCount = 0u;
+
+		size_t _firstLine = 0u;
+		size_t _firstRecord = 0u;
+	};
+
+	// Sequential reader for the header lines and section boundaries of the text model format
+	class ModelTextReader
+	{
+	public:
+		ModelTextReader(const std::string& filename, std::string_view text)
+			: _filename(filename)
+			, _text(text)
+		{}
+
+		[[noreturn]] void Fail(size_t line, const std::string& what) const
+		{
+			throw std::runtime_error(_filename + "(" + std::to_string(line) + "): " + what);
+		}
+
+		size_t ReadCount(std::string_view key)
+		{
+			auto line = NextLine();
+			auto colon = line.find(':');
+			if (colon == std::string_view::npos || Trim(line.substr(0, colon)) != key)
+				Fail(_line, "expected '" + std::string(key) + ": <count>'");
+
+			auto value = Trim(line.substr(colon + 1));
+			size_t count = 0u;
+			auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), count);
+			if (ec != std::errc{} || ptr != value.data() + value.size())
+				Fail(_line, "invalid " + std::string(key));
+
+			return count;
+		}
+
+		// Only checks the leading keyword so "VertexList (pos, normal)" matches "VertexList"
+		void ExpectLine(std::string_view keyword)
+		{
+			auto line = NextLine();
+			if (line.substr(0, keyword.size()) != keyword)
+				Fail(_line, "expected '" + std::string(keyword) + "'");
+		}
+
+		ModelTextSection ReadSection()
+		{
+			ModelTextSection section;
+			section._begin = _text.data() + _pos;
+			section._firstLine = _line + 1u;
+
+			auto close = _text.find('}', _pos);
+			if (close == std::string_view::npos)
+				Fail(section._firstLine, "missing closing '}'");
+
+			section._end = _text.data() + close;
+			_line += std::count(section._begin, section._end, '\n');
+			_pos = close + 1u;
+			return section;
+		}
+
+	private:
+		// Returns the next non empty line, trimmed
+		std::string_view NextLine()
+		{
+			while (_pos < _text.size())
+			{
+				auto end = _text.find('\n', _pos);
+				if (end == std::string_view::npos)
+					end = _text.size();
+
+				auto line = Trim(_text.substr(_pos, end - _pos));
+				_pos = end + 1u;
+				_line++;
+
+				if (!line.empty())
+					return line;
+			}
+
+			Fail(_line, "unexpected end of file");
+		}
+
+	private:
+		const std::string& _filename;
+		std::string_view _text;
+		size_t _pos = 0u;
+		size_t _line = 0u;
+	};
+
+	void SplitSection(const ModelTextSection& section, ModelTextChunk::Kind kind, std::vector<ModelTextChunk>& chunks)
+	{
+		// Big enough to amortize the per chunk bookkeeping, small enough to balance across cores
+		constexpr size_t chunkBytes = 64u * 1024u;
+
+		const char* begin = section._begin;
+		while (begin < section._end)
+		{
+			const char* end = begin + std::min<size_t>(chunkBytes, section._end - begin);
+			end = std::find(end, section._end, '\n');
+			if (end != section._end)
+				++end;
+
+			ModelTextChunk chunk;
+			chunk._begin = begin;
+			chunk._end = end;
+			chunk._kind = kind;
+			chunks.push_back(chunk);
+
+			begin = end;
+		}
+	}
+
+	void CountRecords(ModelTextChunk& chunk) noexcept
+	{
+		bool hasContent = false;
+		for (const char* c = chunk._begin; c < chunk._end; c++)
+		{
+			if (*c == '\n')
+			{
+				chunk._lineCount++;
+				chunk._recordCount += hasContent;
+				hasContent = false;
+			}
+			else if (!IsBlank(*c))
+				hasContent = true;
+		}
+		chunk._recordCount += hasContent;
+	}
+
+	size_t AssignOffsets(std::vector<ModelTextChunk>& chunks, ModelTextChunk::Kind kind, const ModelTextSection& section) noexcept
+	{
+		size_t line = section._firstLine;
+		size_t record = 0u;
+		for (auto& chunk : chunks)
+		{
+			if (chunk._kind != kind)
+				continue;
+
+			chunk._firstLine = line;
+			chunk._firstRecord = record;
+			line += chunk._lineCount;
+			record += chunk._recordCount;
+		}
+		return record;
+	}
+
+	template<typename T>
+	const char* ParseValues(const ModelTextReader& reader, size_t line, const char* c, const char* end, T* values, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			while (c < end && IsBlank(*c))
+				++c;
+
+			auto [ptr, ec] = std::from_chars(c, end, values[i]);
+			if (ec != std::errc{})
+				reader.Fail(line, "expected " + std::to_string(count) + " numbers, found " + std::to_string(i));
+			c = ptr;
+		}
+
+		while (c < end && IsBlank(*c))
+			++c;
+		if (c != end)
+			reader.Fail(line, "unexpected trailing characters");
+
+		return c;
+	}
+
+	void ParseRecords(const ModelTextReader& reader, const ModelTextChunk& chunk, GeometryGenerator::MeshData& mesh)
+	{
+		size_t line = chunk._firstLine;
+		size_t record = chunk._firstRecord;
+
+		const char* c = chunk._begin;
+		while (c < chunk._end)
+		{
+			const char* lineEnd = std::find(c, chunk._end, '\n');
+			if (!Trim(std::string_view(c, lineEnd - c)).empty())
+			{
+				if (chunk._kind == ModelTextChunk::Kind::Vertex)
+				{
+					float values[6];
+					ParseValues(reader, line, c, lineEnd, values, 6u);
+
+					auto& v = mesh.Vertices[record];
+					v.Position = XMFLOAT3(values[0], values[1], values[2]);
+					v.Normal = XMFLOAT3(values[3], values[4], values[5]);
+					v.TangentU = XMFLOAT3(0.0f, 0.0f, 0.0f);
+					v.TexC = XMFLOAT2(0.0f, 0.0f);
+				}
+				else
+				{
+					GeometryGenerator::uint32 values[3];
+					ParseValues(reader, line, c, lineEnd, values, 3u);
+
+					for (size_t k = 0; k < 3u; k++)
+					{
+						if (values[k] >= mesh.Vertices.size())
+							reader.Fail(line, "vertex index " + std::to_string(values[k]) + " is out of range");
+						mesh.Indices32[record * 3u + k] = values[k];
+					}
+				}
+				record++;
+			}
+
+			line++;
+			c = lineEnd < chunk._end ? lineEnd + 1 : lineEnd;
+		}
+	}
+
+	// 14 levels turn the icosahedron into 2.7 billion vertices, one more would overflow 32 bit indices
+	constexpr GeometryGenerator::uint32 kMaxSubdivisions = 14u;
+
+	// Open addressing table from an undirected edge to its midpoint vertex.
+	// Sized up front for the worst case so it never rehashes, keys are the two vertex indices packed smallest first
+	class EdgeMidpointTable
+	{
+	public:
+		explicit EdgeMidpointTable(size_t maxEdges)
+		{
+			size_t capacity = 16u;
+			while (capacity < maxEdges * 2u)
+				capacity *= 2u;
+
+			_keys.assign(capacity, kEmpty);
+			_values.resize(capacity);
+			_mask = capacity - 1u;
+		}
+
+		// Returns the slot of the edge, inserted is true when the edge wasn't in the table yet
+		GeometryGenerator::uint32& FindOrInsert(GeometryGenerator::uint32 a, GeometryGenerator::uint32 b, bool& inserted)
+		{
+			std::uint64_t key = a < b
+				? (static_cast<std::uint64_t>(a) << 32) | b
+				: (static_cast<std::uint64_t>(b) << 32) | a;
+
+			for (size_t slot = Hash(key) & _mask; ; slot = (slot + 1u) & _mask)
+			{
+				if (_keys[slot] == key)
+				{
+					inserted = false;
+					return _values[slot];
+				}
+				if (_keys[slot] == kEmpty)
+				{
+					_keys[slot] = key;
+					inserted = true;
+					return _values[slot];
+				}
+			}
+		}
+
+	private:
+		// a < b always holds for real keys, so all ones never collides with one
+		static constexpr std::uint64_t kEmpty = ~0ull;
+
+		static size_t Hash(std::uint64_t key) noexcept
+		{
+			key ^= key >> 33;
+			key *= 0xff51afd7ed558ccdull;
+			key ^= key >> 33;
+			return static_cast<size_t>(key);
+		}
+
+		std::vector<std::uint64_t> _keys;
+		std::vector<GeometryGenerator::uint32> _values;
+		size_t _mask = 0u;
+	};
+
+	// Below this many elements per range, starting a thread costs more than the work
+	constexpr size_t kMinParallelVertices = 16u * 1024u;
+
+	// The generators split their work on whole rows: every row then runs the exact same loop no matter how
+	// the rows are spread over threads, which keeps the output bit-identical to a serial run
+	size_t RowGrain(size_t rowLength) noexcept
+	{
+		return std::max<size_t>(1u, kMinParallelVertices / std::max<size_t>(rowLength, 1u));
+	}
+}
+
 GeometryGenerator::MeshData GeometryGenerator::CreateBox(float width, float height, float depth, uint32 numSubdivisions)
 {
 	MeshData meshData;
@@ -94,7 +410,7 @@ GeometryGenerator::MeshData GeometryGenerator::CreateBox(float width, float heig
 	meshData.Indices32.assign(&i[0], &i[36]);
 
 	// Put a cap on the number of subdivisions.
-	numSubdivisions = std::min<uint32>(numSubdivisions, 6u);
+	numSubdivisions = std::min<uint32>(numSubdivisions, kMaxSubdivisions);
 
 	for (uint32 i = 0; i < numSubdivisions; ++i)
 		Subdivide(meshData);
@@ -102,10 +418,47 @@ GeometryGenerator::MeshData GeometryGenerator::CreateBox(float width, float heig
 	return meshData;
 }
 
+GeometryGenerator::MeshSize GeometryGenerator::GetSphereSize(uint32 sliceCount, uint32 stackCount)
+{
+	// Two poles plus the inner rings, one triangle fan at each pole and two triangles per quad in between
+	return { 2u + size_t(stackCount - 1) * (sliceCount + 1), size_t(stackCount - 1) * sliceCount * 6u };
+}
+
+GeometryGenerator::MeshSize GeometryGenerator::GetGeosphereSize(uint32 numSubdivisions)
+{
+	// Every level quadruples the 20 icosahedron faces, Euler's formula gives the vertices of the closed mesh
+	size_t faces = size_t(20) << (2u * std::min<uint32>(numSubdivisions, kMaxSubdivisions));
+	return { faces / 2u + 2u, faces * 3u };
+}
+
+GeometryGenerator::MeshSize GeometryGenerator::GetCylinderSize(uint32 sliceCount, uint32 stackCount)
+{
+	// Stack rings, then each cap has its own ring and a center vertex
+	return { size_t(stackCount + 1) * (sliceCount + 1) + 2u * (sliceCount + 2), size_t(stackCount) * sliceCount * 6u + 2u * sliceCount * 3u };
+}
+
+GeometryGenerator::MeshSize GeometryGenerator::GetGridSize(uint32 m, uint32 n)
+{
+	return { size_t(m) * n, size_t(m - 1) * (n - 1) * 6u };
+}
+
 GeometryGenerator::MeshData GeometryGenerator::CreateSphere(float radius, uint32 sliceCount, uint32 stackCount)
 {
 	MeshData meshData;
 
+	auto size = GetSphereSize(sliceCount, stackCount);
+	meshData.Vertices.resize(size.VertexCount);
+	meshData.Indices32.resize(size.IndexCount);
+	CreateSphere(radius, sliceCount, stackCount, meshData.Vertices, meshData.Indices32);
+
+	return meshData;
+}
+
+void GeometryGenerator::CreateSphere(float radius, uint32 sliceCount, uint32 stackCount, std::span<Vertex> vertices, std::span<uint32> indices)
+{
+	assert(vertices.size() == GetSphereSize(sliceCount, stackCount).VertexCount);
+	assert(indices.size() == GetSphereSize(sliceCount, stackCount).IndexCount);
+
 	//
 	// Compute the vertices stating at the top pole and moving down the stacks.
 	//
@@ -113,50 +466,52 @@ GeometryGenerator::MeshData GeometryGenerator::CreateSphere(float radius, uint32
 	// Poles: note that there will be texture coordinate distortion as there is
 	// not a unique point on the texture map to assign to the pole when mapping
 	// a rectangular texture onto a sphere.
-	Vertex topVertex(0.0f, +radius, 0.0f, 0.0f, +1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
-	Vertex bottomVertex(0.0f, -radius, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
-
-	meshData.Vertices.push_back(topVertex);
+	vertices.front() = Vertex(0.0f, +radius, 0.0f, 0.0f, +1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+	vertices.back() = Vertex(0.0f, -radius, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
 
 	float phiStep = XM_PI / stackCount;
 	float thetaStep = 2.0f * XM_PI / sliceCount;
 
-	// Compute vertices for each stack ring (do not count the poles as rings).
-	for (uint32 i = 1; i <= stackCount - 1; ++i)
-	{
-		float phi = i * phiStep;
+	uint32 ringVertexCount = sliceCount + 1;
 
-		// Vertices of ring.
-		for (uint32 j = 0; j <= sliceCount; ++j)
+	// Compute vertices for each stack ring (do not count the poles as rings).
+	parallel::ForRange(stackCount - 1, RowGrain(ringVertexCount), [&](size_t begin, size_t end)
 		{
-			float theta = j * thetaStep;
+			for (uint32 i = (uint32)begin + 1; i <= (uint32)end; ++i)
+			{
+				float phi = i * phiStep;
+				Vertex* ring = &vertices[1 + (i - 1) * ringVertexCount];
 
-			Vertex v;
+				// Vertices of ring.
+				for (uint32 j = 0; j <= sliceCount; ++j)
+				{
+					float theta = j * thetaStep;
 
-			// spherical to cartesian
-			v.Position.x = radius * sinf(phi) * cosf(theta);
-			v.Position.y = radius * cosf(phi);
-			v.Position.z = radius * sinf(phi) * sinf(theta);
+					Vertex v;
 
-			// Partial derivative of P with respect to theta
-			v.TangentU.x = -radius * sinf(phi) * sinf(theta);
-			v.TangentU.y = 0.0f;
-			v.TangentU.z = +radius * sinf(phi) * cosf(theta);
+					// spherical to cartesian
+					v.Position.x = radius * sinf(phi) * cosf(theta);
+					v.Position.y = radius * cosf(phi);
+					v.Position.z = radius * sinf(phi) * sinf(theta);
 
-			XMVECTOR T = XMLoadFloat3(&v.TangentU);
-			XMStoreFloat3(&v.TangentU, XMVector3Normalize(T));
+					// Partial derivative of P with respect to theta
+					v.TangentU.x = -radius * sinf(phi) * sinf(theta);
+					v.TangentU.y = 0.0f;
+					v.TangentU.z = +radius * sinf(phi) * cosf(theta);
 
-			XMVECTOR p = XMLoadFloat3(&v.Position);
-			XMStoreFloat3(&v.Normal, XMVector3Normalize(p));
+					XMVECTOR T = XMLoadFloat3(&v.TangentU);
+					XMStoreFloat3(&v.TangentU, XMVector3Normalize(T));
 
-			v.TexC.x = theta / XM_2PI;
-			v.TexC.y = phi / XM_PI;
+					XMVECTOR p = XMLoadFloat3(&v.Position);
+					XMStoreFloat3(&v.Normal, XMVector3Normalize(p));
 
-			meshData.Vertices.push_back(v);
-		}
-	}
+					v.TexC.x = theta / XM_2PI;
+					v.TexC.y = phi / XM_PI;
 
-	meshData.Vertices.push_back(bottomVertex);
+					ring[j] = v;
+				}
+			}
+		});
 
 	//
 	// Compute indices for top stack.  The top stack was written first to the vertex buffer
@@ -165,9 +520,9 @@ GeometryGenerator::MeshData GeometryGenerator::CreateSphere(float radius, uint32
 
 	for (uint32 i = 1; i <= sliceCount; ++i)
 	{
-		meshData.Indices32.push_back(0);
-		meshData.Indices32.push_back(i + 1);
-		meshData.Indices32.push_back(i);
+		indices[(i - 1) * 3 + 0] = 0;
+		indices[(i - 1) * 3 + 1] = i + 1;
+		indices[(i - 1) * 3 + 2] = i;
 	}
 
 	//
@@ -177,20 +532,24 @@ GeometryGenerator::MeshData GeometryGenerator::CreateSphere(float radius, uint32
 	// Offset the indices to the index of the first vertex in the first ring.
 	// This is just skipping the top pole vertex.
 	uint32 baseIndex = 1;
-	uint32 ringVertexCount = sliceCount + 1;
-	for (uint32 i = 0; i < stackCount - 2; ++i)
-	{
-		for (uint32 j = 0; j < sliceCount; ++j)
+	size_t innerStart = size_t(sliceCount) * 3;
+	parallel::ForRange(stackCount - 2, RowGrain(sliceCount * 6), [&](size_t begin, size_t end)
 		{
-			meshData.Indices32.push_back(baseIndex + i * ringVertexCount + j);
-			meshData.Indices32.push_back(baseIndex + i * ringVertexCount + j + 1);
-			meshData.Indices32.push_back(baseIndex + (i + 1) * ringVertexCount + j);
-
-			meshData.Indices32.push_back(baseIndex + (i + 1) * ringVertexCount + j);
-			meshData.Indices32.push_back(baseIndex + i * ringVertexCount + j + 1);
-			meshData.Indices32.push_back(baseIndex + (i + 1) * ringVertexCount + j + 1);
-		}
-	}
+			for (uint32 i = (uint32)begin; i < (uint32)end; ++i)
+			{
+				uint32* quad = &indices[innerStart + size_t(i) * sliceCount * 6];
+				for (uint32 j = 0; j < sliceCount; ++j, quad += 6)
+				{
+					quad[0] = baseIndex + i * ringVertexCount + j;
+					quad[1] = baseIndex + i * ringVertexCount + j + 1;
+					quad[2] = baseIndex + (i + 1) * ringVertexCount + j;
+
+					quad[3] = baseIndex + (i + 1) * ringVertexCount + j;
+					quad[4] = baseIndex + i * ringVertexCount + j + 1;
+					quad[5] = baseIndex + (i + 1) * ringVertexCount + j + 1;
+				}
+			}
+		});
 
 	//
 	// Compute indices for bottom stack.  The bottom stack was written last to the vertex buffer
@@ -198,30 +557,22 @@ GeometryGenerator::MeshData GeometryGenerator::CreateSphere(float radius, uint32
 	//
 
 	// South pole vertex was added last.
-	uint32 southPoleIndex = (uint32)meshData.Vertices.size() - 1;
+	uint32 southPoleIndex = (uint32)vertices.size() - 1;
 
 	// Offset the indices to the index of the first vertex in the last ring.
 	baseIndex = southPoleIndex - ringVertexCount;
 
+	uint32* fan = &indices[indices.size() - size_t(sliceCount) * 3];
 	for (uint32 i = 0; i < sliceCount; ++i)
 	{
-		meshData.Indices32.push_back(southPoleIndex);
-		meshData.Indices32.push_back(baseIndex + i);
-		meshData.Indices32.push_back(baseIndex + i + 1);
+		fan[i * 3 + 0] = southPoleIndex;
+		fan[i * 3 + 1] = baseIndex + i;
+		fan[i * 3 + 2] = baseIndex + i + 1;
 	}
-
-	return meshData;
 }
 
 void GeometryGenerator::Subdivide(MeshData& meshData)
 {
-	// Save a copy of the input geometry.
-	MeshData inputCopy = meshData;
-
-
-	meshData.Vertices.resize(0);
-	meshData.Indices32.resize(0);
-
 	//       v1
 	//       *
 	//      / \
@@ -232,48 +583,58 @@ void GeometryGenerator::Subdivide(MeshData& meshData)
 	// *-----*-----*
 	// v0    m2     v2
 
-	uint32 numTris = (uint32)inputCopy.Indices32.size() / 3;
-	for (uint32 i = 0; i < numTris; ++i)
+	// Vertices are kept in place and every edge gets a single midpoint shared by the triangles on both sides
+	const size_t numTris = meshData.Indices32.size() / 3;
+
+	// A closed mesh has 3/2 edges per triangle, an open one at most 3
+	EdgeMidpointTable midpoints(numTris * 3);
+	meshData.Vertices.reserve(meshData.Vertices.size() + numTris * 3 / 2 + 2);
+
+	auto midpoint = [&](uint32 a, uint32 b)
 	{
-		Vertex v0 = inputCopy.Vertices[inputCopy.Indices32[i * 3 + 0]];
-		Vertex v1 = inputCopy.Vertices[inputCopy.Indices32[i * 3 + 1]];
-		Vertex v2 = inputCopy.Vertices[inputCopy.Indices32[i * 3 + 2]];
+		bool inserted;
+		uint32& index = midpoints.FindOrInsert(a, b, inserted);
+		if (inserted)
+		{
+			Vertex m = MidPoint(meshData.Vertices[a], meshData.Vertices[b]);
+			index = (uint32)meshData.Vertices.size();
+			meshData.Vertices.push_back(m);
+		}
+		return index;
+	};
+
+	std::vector<uint32> indices;
+	indices.reserve(numTris * 12);
+
+	for (size_t i = 0; i < numTris; ++i)
+	{
+		uint32 v0 = meshData.Indices32[i * 3 + 0];
+		uint32 v1 = meshData.Indices32[i * 3 + 1];
+		uint32 v2 = meshData.Indices32[i * 3 + 2];
 
 		//
 		// Generate the midpoints.
 		//
 
-		Vertex m0 = MidPoint(v0, v1);
-		Vertex m1 = MidPoint(v1, v2);
-		Vertex m2 = MidPoint(v0, v2);
+		uint32 m0 = midpoint(v0, v1);
+		uint32 m1 = midpoint(v1, v2);
+		uint32 m2 = midpoint(v0, v2);
 
 		//
 		// Add new geometry.
 		//
 
-		meshData.Vertices.push_back(v0); // 0
-		meshData.Vertices.push_back(v1); // 1
-		meshData.Vertices.push_back(v2); // 2
-		meshData.Vertices.push_back(m0); // 3
-		meshData.Vertices.push_back(m1); // 4
-		meshData.Vertices.push_back(m2); // 5
-
-		meshData.Indices32.push_back(i * 6 + 0);
-		meshData.Indices32.push_back(i * 6 + 3);
-		meshData.Indices32.push_back(i * 6 + 5);
-
-		meshData.Indices32.push_back(i * 6 + 3);
-		meshData.Indices32.push_back(i * 6 + 4);
-		meshData.Indices32.push_back(i * 6 + 5);
-
-		meshData.Indices32.push_back(i * 6 + 5);
-		meshData.Indices32.push_back(i * 6 + 4);
-		meshData.Indices32.push_back(i * 6 + 2);
-
-		meshData.Indices32.push_back(i * 6 + 3);
-		meshData.Indices32.push_back(i * 6 + 1);
-		meshData.Indices32.push_back(i * 6 + 4);
+		uint32 tris[12] =
+		{
+			v0, m0, m2,
+			m0, m1, m2,
+			m2, m1, v2,
+			m0, v1, m1,
+		};
+		indices.insert(indices.end(), std::begin(tris), std::end(tris));
 	}
+
+	meshData.Indices32 = std::move(indices);
 }
 
 GeometryGenerator::Vertex GeometryGenerator::MidPoint(const Vertex& v0, const Vertex& v1)
@@ -307,11 +668,32 @@ GeometryGenerator::Vertex GeometryGenerator::MidPoint(const Vertex& v0, const Ve
 }
 
 GeometryGenerator::MeshData GeometryGenerator::CreateGeosphere(float radius, uint32 numSubdivisions)
+{
+	MeshData meshData = BuildGeosphereTopology(numSubdivisions);
+
+	// Projection only reads the vertex it writes, so it can run in place
+	ProjectGeosphere(radius, meshData.Vertices, meshData.Vertices);
+
+	return meshData;
+}
+
+void GeometryGenerator::CreateGeosphere(float radius, uint32 numSubdivisions, std::span<Vertex> vertices, std::span<uint32> indices)
+{
+	assert(vertices.size() == GetGeosphereSize(numSubdivisions).VertexCount);
+	assert(indices.size() == GetGeosphereSize(numSubdivisions).IndexCount);
+
+	MeshData meshData = BuildGeosphereTopology(numSubdivisions);
+
+	ProjectGeosphere(radius, meshData.Vertices, vertices);
+	std::copy(meshData.Indices32.begin(), meshData.Indices32.end(), indices.begin());
+}
+
+GeometryGenerator::MeshData GeometryGenerator::BuildGeosphereTopology(uint32 numSubdivisions)
 {
 	MeshData meshData;
 
 	// Put a cap on the number of subdivisions.
-	numSubdivisions = std::min<uint32>(numSubdivisions, 6u);
+	numSubdivisions = std::min<uint32>(numSubdivisions, kMaxSubdivisions);
 
 	// Approximate a sphere by tessellating an icosahedron.
 
@@ -342,49 +724,76 @@ GeometryGenerator::MeshData GeometryGenerator::CreateGeosphere(float radius, uin
 	for (uint32 i = 0; i < 12; ++i)
 		meshData.Vertices[i].Position = pos[i];
 
+	// Subdivision stays serial, midpoints are numbered in the order edges are first seen
 	for (uint32 i = 0; i < numSubdivisions; ++i)
 		Subdivide(meshData);
 
+	return meshData;
+}
+
+void GeometryGenerator::ProjectGeosphere(float radius, std::span<const Vertex> source, std::span<Vertex> vertices)
+{
+	assert(source.size() == vertices.size());
+
 	// Project vertices onto sphere and scale.
-	for (uint32 i = 0; i < meshData.Vertices.size(); ++i)
-	{
-		// Project onto unit sphere.
-		XMVECTOR n = XMVector3Normalize(XMLoadFloat3(&meshData.Vertices[i].Position));
+	parallel::ForRange(vertices.size(), kMinParallelVertices, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				Vertex v;
 
-		// Project onto sphere.
-		XMVECTOR p = radius * n;
+				// Project onto unit sphere.
+				XMVECTOR n = XMVector3Normalize(XMLoadFloat3(&source[i].Position));
 
-		XMStoreFloat3(&meshData.Vertices[i].Position, p);
-		XMStoreFloat3(&meshData.Vertices[i].Normal, n);
+				// Project onto sphere.
+				XMVECTOR p = radius * n;
 
-		// Derive texture coordinates from spherical coordinates.
-		float theta = atan2f(meshData.Vertices[i].Position.z, meshData.Vertices[i].Position.x);
+				XMStoreFloat3(&v.Position, p);
+				XMStoreFloat3(&v.Normal, n);
 
-		// Put in [0, 2pi].
-		if (theta < 0.0f)
-			theta += XM_2PI;
+				// Derive texture coordinates from spherical coordinates.
+				float theta = atan2f(v.Position.z, v.Position.x);
 
-		float phi = acosf(meshData.Vertices[i].Position.y / radius);
+				// Put in [0, 2pi].
+				if (theta < 0.0f)
+					theta += XM_2PI;
 
-		meshData.Vertices[i].TexC.x = theta / XM_2PI;
-		meshData.Vertices[i].TexC.y = phi / XM_PI;
+				float phi = acosf(v.Position.y / radius);
 
-		// Partial derivative of P with respect to theta
-		meshData.Vertices[i].TangentU.x = -radius * sinf(phi) * sinf(theta);
-		meshData.Vertices[i].TangentU.y = 0.0f;
-		meshData.Vertices[i].TangentU.z = +radius * sinf(phi) * cosf(theta);
+				v.TexC.x = theta / XM_2PI;
+				v.TexC.y = phi / XM_PI;
 
-		XMVECTOR T = XMLoadFloat3(&meshData.Vertices[i].TangentU);
-		XMStoreFloat3(&meshData.Vertices[i].TangentU, XMVector3Normalize(T));
-	}
+				// Partial derivative of P with respect to theta
+				v.TangentU.x = -radius * sinf(phi) * sinf(theta);
+				v.TangentU.y = 0.0f;
+				v.TangentU.z = +radius * sinf(phi) * cosf(theta);
 
-	return meshData;
+				XMVECTOR T = XMLoadFloat3(&v.TangentU);
+				XMStoreFloat3(&v.TangentU, XMVector3Normalize(T));
+
+				vertices[i] = v;
+			}
+		});
 }
 
 GeometryGenerator::MeshData GeometryGenerator::CreateCylinder(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount)
 {
 	MeshData meshData;
 
+	auto size = GetCylinderSize(sliceCount, stackCount);
+	meshData.Vertices.resize(size.VertexCount);
+	meshData.Indices32.resize(size.IndexCount);
+	CreateCylinder(bottomRadius, topRadius, height, sliceCount, stackCount, meshData.Vertices, meshData.Indices32);
+
+	return meshData;
+}
+
+void GeometryGenerator::CreateCylinder(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount,
+	std::span<Vertex> vertices, std::span<uint32> indices)
+{
+	assert(vertices.size() == GetCylinderSize(sliceCount, stackCount).VertexCount);
+	assert(indices.size() == GetCylinderSize(sliceCount, stackCount).IndexCount);
+
 	//
 	// Build Stacks.
 	// 
@@ -396,90 +805,102 @@ GeometryGenerator::MeshData GeometryGenerator::CreateCylinder(float bottomRadius
 
 	uint32 ringCount = stackCount + 1;
 
-	// Compute vertices for each stack ring starting at the bottom and moving up.
-	for (uint32 i = 0; i < ringCount; ++i)
-	{
-		float y = -0.5f * height + i * stackHeight;
-		float r = bottomRadius + i * radiusStep;
-
-		// vertices of ring
-		float dTheta = 2.0f * XM_PI / sliceCount;
-		for (uint32 j = 0; j <= sliceCount; ++j)
-		{
-			Vertex vertex;
-
-			float c = cosf(j * dTheta);
-			float s = sinf(j * dTheta);
-
-			vertex.Position = XMFLOAT3(r * c, y, r * s);
-
-			vertex.TexC.x = (float)j / sliceCount;
-			vertex.TexC.y = 1.0f - (float)i / stackCount;
-
-			// Cylinder can be parameterized as follows, where we introduce v
-			// parameter that goes in the same direction as the v tex-coord
-			// so that the bitangent goes in the same direction as the v tex-coord.
-			//   Let r0 be the bottom radius and let r1 be the top radius.
-			//   y(v) = h - hv for v in [0,1].
-			//   r(v) = r1 + (r0-r1)v
-			//
-			//   x(t, v) = r(v)*cos(t)
-			//   y(t, v) = h - hv
-			//   z(t, v) = r(v)*sin(t)
-			// 
-			//  dx/dt = -r(v)*sin(t)
-			//  dy/dt = 0
-			//  dz/dt = +r(v)*cos(t)
-			//
-			//  dx/dv = (r0-r1)*cos(t)
-			//  dy/dv = -h
-			//  dz/dv = (r0-r1)*sin(t)
-
-			// This is unit length.
-			vertex.TangentU = XMFLOAT3(-s, 0.0f, c);
-
-			float dr = bottomRadius - topRadius;
-			XMFLOAT3 bitangent(dr * c, -height, dr * s);
-
-			XMVECTOR T = XMLoadFloat3(&vertex.TangentU);
-			XMVECTOR B = XMLoadFloat3(&bitangent);
-			XMVECTOR N = XMVector3Normalize(XMVector3Cross(T, B));
-			XMStoreFloat3(&vertex.Normal, N);
-
-			meshData.Vertices.push_back(vertex);
-		}
-	}
-
 	// Add one because we duplicate the first and last vertex per ring
 	// since the texture coordinates are different.
 	uint32 ringVertexCount = sliceCount + 1;
 
-	// Compute indices for each stack.
-	for (uint32 i = 0; i < stackCount; ++i)
-	{
-		for (uint32 j = 0; j < sliceCount; ++j)
+	// Compute vertices for each stack ring starting at the bottom and moving up.
+	parallel::ForRange(ringCount, RowGrain(ringVertexCount), [&](size_t begin, size_t end)
 		{
-			meshData.Indices32.push_back(i * ringVertexCount + j);
-			meshData.Indices32.push_back((i + 1) * ringVertexCount + j);
-			meshData.Indices32.push_back((i + 1) * ringVertexCount + j + 1);
+			for (uint32 i = (uint32)begin; i < (uint32)end; ++i)
+			{
+				float y = -0.5f * height + i * stackHeight;
+				float r = bottomRadius + i * radiusStep;
+				Vertex* ring = &vertices[size_t(i) * ringVertexCount];
+
+				// vertices of ring
+				float dTheta = 2.0f * XM_PI / sliceCount;
+				for (uint32 j = 0; j <= sliceCount; ++j)
+				{
+					Vertex vertex;
+
+					float c = cosf(j * dTheta);
+					float s = sinf(j * dTheta);
+
+					vertex.Position = XMFLOAT3(r * c, y, r * s);
+
+					vertex.TexC.x = (float)j / sliceCount;
+					vertex.TexC.y = 1.0f - (float)i / stackCount;
+
+					// Cylinder can be parameterized as follows, where we introduce v
+					// parameter that goes in the same direction as the v tex-coord
+					// so that the bitangent goes in the same direction as the v tex-coord.
+					//   Let r0 be the bottom radius and let r1 be the top radius.
+					//   y(v) = h - hv for v in [0,1].
+					//   r(v) = r1 + (r0-r1)v
+					//
+					//   x(t, v) = r(v)*cos(t)
+					//   y(t, v) = h - hv
+					//   z(t, v) = r(v)*sin(t)
+					// 
+					//  dx/dt = -r(v)*sin(t)
+					//  dy/dt = 0
+					//  dz/dt = +r(v)*cos(t)
+					//
+					//  dx/dv = (r0-r1)*cos(t)
+					//  dy/dv = -h
+					//  dz/dv = (r0-r1)*sin(t)
+
+					// This is unit length.
+					vertex.TangentU = XMFLOAT3(-s, 0.0f, c);
+
+					float dr = bottomRadius - topRadius;
+					XMFLOAT3 bitangent(dr * c, -height, dr * s);
+
+					XMVECTOR T = XMLoadFloat3(&vertex.TangentU);
+					XMVECTOR B = XMLoadFloat3(&bitangent);
+					XMVECTOR N = XMVector3Normalize(XMVector3Cross(T, B));
+					XMStoreFloat3(&vertex.Normal, N);
+
+					ring[j] = vertex;
+				}
+			}
+		});
 
-			meshData.Indices32.push_back(i * ringVertexCount + j);
-			meshData.Indices32.push_back((i + 1) * ringVertexCount + j + 1);
-			meshData.Indices32.push_back(i * ringVertexCount + j + 1);
-		}
-	}
-
-	BuildCylinderTopCap(bottomRadius, topRadius, height, sliceCount, stackCount, meshData);
-	BuildCylinderBottomCap(bottomRadius, topRadius, height, sliceCount, stackCount, meshData);
-
-	return meshData;
+	// Compute indices for each stack.
+	parallel::ForRange(stackCount, RowGrain(sliceCount * 6), [&](size_t begin, size_t end)
+		{
+			for (uint32 i = (uint32)begin; i < (uint32)end; ++i)
+			{
+				uint32* quad = &indices[size_t(i) * sliceCount * 6];
+				for (uint32 j = 0; j < sliceCount; ++j, quad += 6)
+				{
+					quad[0] = i * ringVertexCount + j;
+					quad[1] = (i + 1) * ringVertexCount + j;
+					quad[2] = (i + 1) * ringVertexCount + j + 1;
+
+					quad[3] = i * ringVertexCount + j;
+					quad[4] = (i + 1) * ringVertexCount + j + 1;
+					quad[5] = i * ringVertexCount + j + 1;
+				}
+			}
+		});
+
+	// Each cap is a ring plus its center vertex and a fan of sliceCount triangles, top cap first
+	size_t capVertexCount = sliceCount + 2;
+	size_t capIndexCount = size_t(sliceCount) * 3;
+	size_t topVertex = size_t(ringCount) * ringVertexCount;
+	size_t topIndex = size_t(stackCount) * sliceCount * 6;
+
+	BuildCylinderTopCap(bottomRadius, topRadius, height, sliceCount, stackCount, (uint32)topVertex,
+		vertices.subspan(topVertex, capVertexCount), indices.subspan(topIndex, capIndexCount));
+	BuildCylinderBottomCap(bottomRadius, topRadius, height, sliceCount, stackCount, (uint32)(topVertex + capVertexCount),
+		vertices.subspan(topVertex + capVertexCount, capVertexCount), indices.subspan(topIndex + capIndexCount, capIndexCount));
 }
 
 void GeometryGenerator::BuildCylinderTopCap(float bottomRadius, float topRadius, float height,
-	uint32 sliceCount, uint32 stackCount, MeshData& meshData)
+	uint32 sliceCount, uint32 stackCount, uint32 baseIndex, std::span<Vertex> vertices, std::span<uint32> indices)
 {
-	uint32 baseIndex = (uint32)meshData.Vertices.size();
-
 	float y = 0.5f * height;
 	float dTheta = 2.0f * XM_PI / sliceCount;
 
@@ -494,31 +915,30 @@ void GeometryGenerator::BuildCylinderTopCap(float bottomRadius, float topRadius,
 		float u = x / height + 0.5f;
 		float v = z / height + 0.5f;
 
-		meshData.Vertices.push_back(Vertex(x, y, z, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, u, v));
+		vertices[i] = Vertex(x, y, z, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, u, v);
 	}
 
 	// Cap center vertex.
-	meshData.Vertices.push_back(Vertex(0.0f, y, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.5f, 0.5f));
+	vertices[sliceCount + 1] = Vertex(0.0f, y, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.5f, 0.5f);
 
 	// Index of center vertex.
-	uint32 centerIndex = (uint32)meshData.Vertices.size() - 1;
+	uint32 centerIndex = baseIndex + sliceCount + 1;
 
 	for (uint32 i = 0; i < sliceCount; ++i)
 	{
-		meshData.Indices32.push_back(centerIndex);
-		meshData.Indices32.push_back(baseIndex + i + 1);
-		meshData.Indices32.push_back(baseIndex + i);
+		indices[i * 3 + 0] = centerIndex;
+		indices[i * 3 + 1] = baseIndex + i + 1;
+		indices[i * 3 + 2] = baseIndex + i;
 	}
 }
 
 void GeometryGenerator::BuildCylinderBottomCap(float bottomRadius, float topRadius, float height,
-	uint32 sliceCount, uint32 stackCount, MeshData& meshData)
+	uint32 sliceCount, uint32 stackCount, uint32 baseIndex, std::span<Vertex> vertices, std::span<uint32> indices)
 {
 	// 
 	// Build bottom cap.
 	//
 
-	uint32 baseIndex = (uint32)meshData.Vertices.size();
 	float y = -0.5f * height;
 
 	// vertices of ring
@@ -533,20 +953,20 @@ void GeometryGenerator::BuildCylinderBottomCap(float bottomRadius, float topRadi
 		float u = x / height + 0.5f;
 		float v = z / height + 0.5f;
 
-		meshData.Vertices.push_back(Vertex(x, y, z, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, u, v));
+		vertices[i] = Vertex(x, y, z, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, u, v);
 	}
 
 	// Cap center vertex.
-	meshData.Vertices.push_back(Vertex(0.0f, y, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.5f, 0.5f));
+	vertices[sliceCount + 1] = Vertex(0.0f, y, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.5f, 0.5f);
 
 	// Cache the index of center vertex.
-	uint32 centerIndex = (uint32)meshData.Vertices.size() - 1;
+	uint32 centerIndex = baseIndex + sliceCount + 1;
 
 	for (uint32 i = 0; i < sliceCount; ++i)
 	{
-		meshData.Indices32.push_back(centerIndex);
-		meshData.Indices32.push_back(baseIndex + i);
-		meshData.Indices32.push_back(baseIndex + i + 1);
+		indices[i * 3 + 0] = centerIndex;
+		indices[i * 3 + 1] = baseIndex + i;
+		indices[i * 3 + 2] = baseIndex + i + 1;
 	}
 }
 
@@ -554,8 +974,18 @@ GeometryGenerator::MeshData GeometryGenerator::CreateGrid(float width, float dep
 {
 	MeshData meshData;
 
-	uint32 vertexCount = m * n;
-	uint32 faceCount = (m - 1) * (n - 1) * 2;
+	auto size = GetGridSize(m, n);
+	meshData.Vertices.resize(size.VertexCount);
+	meshData.Indices32.resize(size.IndexCount);
+	CreateGrid(width, depth, m, n, meshData.Vertices, meshData.Indices32);
+
+	return meshData;
+}
+
+void GeometryGenerator::CreateGrid(float width, float depth, uint32 m, uint32 n, std::span<Vertex> vertices, std::span<uint32> indices)
+{
+	assert(vertices.size() == GetGridSize(m, n).VertexCount);
+	assert(indices.size() == GetGridSize(m, n).IndexCount);
 
 	//
 	// Create the vertices.
@@ -570,49 +1000,49 @@ GeometryGenerator::MeshData GeometryGenerator::CreateGrid(float width, float dep
 	float du = 1.0f / (n - 1);
 	float dv = 1.0f / (m - 1);
 
-	meshData.Vertices.resize(vertexCount);
-	for (uint32 i = 0; i < m; ++i)
-	{
-		float z = halfDepth - i * dz;
-		for (uint32 j = 0; j < n; ++j)
+	parallel::ForRange(m, RowGrain(n), [&](size_t begin, size_t end)
 		{
-			float x = -halfWidth + j * dx;
-
-			meshData.Vertices[i * n + j].Position = XMFLOAT3(x, 0.0f, z);
-			meshData.Vertices[i * n + j].Normal = XMFLOAT3(0.0f, 1.0f, 0.0f);
-			meshData.Vertices[i * n + j].TangentU = XMFLOAT3(1.0f, 0.0f, 0.0f);
-
-			// Stretch texture over grid.
-			meshData.Vertices[i * n + j].TexC.x = j * du;
-			meshData.Vertices[i * n + j].TexC.y = i * dv;
-		}
-	}
+			for (uint32 i = (uint32)begin; i < (uint32)end; ++i)
+			{
+				float z = halfDepth - i * dz;
+				Vertex* row = &vertices[size_t(i) * n];
+				for (uint32 j = 0; j < n; ++j)
+				{
+					float x = -halfWidth + j * dx;
+
+					row[j].Position = XMFLOAT3(x, 0.0f, z);
+					row[j].Normal = XMFLOAT3(0.0f, 1.0f, 0.0f);
+					row[j].TangentU = XMFLOAT3(1.0f, 0.0f, 0.0f);
+
+					// Stretch texture over grid.
+					row[j].TexC.x = j * du;
+					row[j].TexC.y = i * dv;
+				}
+			}
+		});
 
 	//
 	// Create the indices.
 	//
 
-	meshData.Indices32.resize(faceCount * 3); // 3 indices per face
-
-	// Iterate over each quad and compute indices.
-	uint32 k = 0;
-	for (uint32 i = 0; i < m - 1; ++i)
-	{
-		for (uint32 j = 0; j < n - 1; ++j)
+	// Iterate over each quad and compute indices, 6 per quad.
+	parallel::ForRange(m - 1, RowGrain(size_t(n - 1) * 6), [&](size_t begin, size_t end)
 		{
-			meshData.Indices32[k] = i * n + j;
-			meshData.Indices32[k + 1] = i * n + j + 1;
-			meshData.Indices32[k + 2] = (i + 1) * n + j;
-
-			meshData.Indices32[k + 3] = (i + 1) * n + j;
-			meshData.Indices32[k + 4] = i * n + j + 1;
-			meshData.Indices32[k + 5] = (i + 1) * n + j + 1;
-
-			k += 6; // next quad
-		}
-	}
-
-	return meshData;
+			for (uint32 i = (uint32)begin; i < (uint32)end; ++i)
+			{
+				uint32* quad = &indices[size_t(i) * (n - 1) * 6];
+				for (uint32 j = 0; j < n - 1; ++j, quad += 6)
+				{
+					quad[0] = i * n + j;
+					quad[1] = i * n + j + 1;
+					quad[2] = (i + 1) * n + j;
+
+					quad[3] = (i + 1) * n + j;
+					quad[4] = i * n + j + 1;
+					quad[5] = (i + 1) * n + j + 1;
+				}
+			}
+		});
 }
 
 GeometryGenerator::MeshData GeometryGenerator::CreateQuad(float x, float y, float w, float h, float depth)
@@ -660,32 +1090,56 @@ GeometryGenerator::MeshData GeometryGenerator::CreateQuad(float x, float y, floa
 
 GeometryGenerator::MeshData GeometryGenerator::ReadFile(const std::string& filename)
 {
-	std::ifstream file(filename);
-	assert(file.is_open());
-
-	std::string ignore;
-	
-	size_t vertexCount;
-	size_t triangleCount;
-	file >> ignore >> vertexCount;
-	file >> ignore >> triangleCount;
-	file >> ignore >> ignore >> ignore >> ignore;
-	
+	// Read the whole file at once; the sections are then parsed in parallel chunks split on line boundaries
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		throw std::runtime_error(filename + ": could not open model file");
+
+	std::string text(static_cast<size_t>(file.tellg()), '\0');
+	file.seekg(0);
+	file.read(text.data(), text.size());
+
+	ModelTextReader reader(filename, text);
+
+	size_t vertexCount = reader.ReadCount("VertexCount");
+	size_t triangleCount = reader.ReadCount("TriangleCount");
+
+	reader.ExpectLine("VertexList");
+	reader.ExpectLine("{");
+	auto vertexSection = reader.ReadSection();
+
+	reader.ExpectLine("TriangleList");
+	reader.ExpectLine("{");
+	auto triangleSection = reader.ReadSection();
+
 	MeshData mesh;
 	mesh.Vertices.resize(vertexCount);
 	mesh.Indices32.resize(triangleCount * 3);
-	for (size_t i = 0; i < vertexCount; i++)
-	{
-		file >> mesh.Vertices[i].Position.x >> mesh.Vertices[i].Position.y >> mesh.Vertices[i].Position.z;
-		file >> mesh.Vertices[i].Normal.x >> mesh.Vertices[i].Normal.y >> mesh.Vertices[i].Normal.z;
-	}
 
-	file >> ignore >> ignore >> ignore;
+	std::vector<ModelTextChunk> chunks;
+	SplitSection(vertexSection, ModelTextChunk::Kind::Vertex, chunks);
+	SplitSection(triangleSection, ModelTextChunk::Kind::Triangle, chunks);
 
-	for (size_t i = 0; i < triangleCount; i++)
-	{
-		file >> mesh.Indices32[i * 3] >> mesh.Indices32[i * 3 + 1] >> mesh.Indices32[i * 3 + 2];
-	}
+	// First pass counts the records of every chunk so each one knows where its output starts
+	parallel::ForRange(chunks.size(), 1u, [&](size_t begin, size_t end)
+		{
+			for (size_t c = begin; c < end; c++)
+				CountRecords(chunks[c]);
+		});
+
+	size_t vertexRecords = AssignOffsets(chunks, ModelTextChunk::Kind::Vertex, vertexSection);
+	size_t triangleRecords = AssignOffsets(chunks, ModelTextChunk::Kind::Triangle, triangleSection);
+
+	if (vertexRecords != vertexCount)
+		reader.Fail(vertexSection._firstLine, "VertexCount is " + std::to_string(vertexCount) + " but the VertexList has " + std::to_string(vertexRecords) + " entries");
+	if (triangleRecords != triangleCount)
+		reader.Fail(triangleSection._firstLine, "TriangleCount is " + std::to_string(triangleCount) + " but the TriangleList has " + std::to_string(triangleRecords) + " entries");
+
+	parallel::ForRange(chunks.size(), 1u, [&](size_t begin, size_t end)
+		{
+			for (size_t c = begin; c < end; c++)
+				ParseRecords(reader, chunks[c], mesh);
+		});
 
 	return mesh;
 }
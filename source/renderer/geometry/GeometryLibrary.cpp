@@ -1,21 +1,178 @@
 #include "../../../include/sasha/renderer/geometry/GeometryLibrary.h"
 
-void GeometryLibrary::AddGeometry(const std::string& name, GeometryGenerator::MeshData& mesh)
+void GeometryLibrary::AddGeometry(const std::string& name, GeometryGenerator::MeshData& mesh, const MeshImportOptions& options)
 {
-    SubmeshGeometry sub;
-
-    sub._baseVertexLocation = static_cast<UINT>(_vertices.size());
-    sub._startIndexLocation = static_cast<UINT>(_indices.size());
-    sub._indexCount = static_cast<UINT>(mesh.Indices32.size());
+    MeshImportReport report;
+    OptimizeMesh(mesh, options, report);
 
+    auto baseVertex = static_cast<UINT>(_vertices.size());
     for (const auto& v : mesh.Vertices)
         _vertices.push_back({ v.Position, v.Normal, v.TexC });
 
-    auto& indices16 = mesh.GetIndices16();
-    _indices.insert(_indices.end(), indices16.begin(), indices16.end());
+    auto bounds = mesh.Vertices.empty() ? MeshBounds{} : MeshOptimizer::ComputeBounds(&mesh.Vertices[0].Position, mesh.Vertices.size(), sizeof(GeometryGenerator::Vertex));
+
+    auto id = AddSubmesh(name, baseVertex, mesh.Indices32, bounds, report);
+    if (options._buildMeshlets)
+        AddMeshlets(id, mesh.Indices32, mesh.Vertices);
+    BuildLods(name, id, mesh, bounds, options);
+}
+
+void GeometryLibrary::AddGeometry(const std::string& name, std::span<const Vertex> vertices, std::span<const std::uint32_t> indices, const MeshImportOptions& options)
+{
+    // The processing passes work on MeshData, only pay for the conversion when one of them is enabled
+    if (options._weldVertices || options._optimizeVertexCache || options._optimizeOverdraw || options._optimizeVertexFetch || !options._lodTriangleRatios.empty() || options._buildMeshlets)
+    {
+        GeometryGenerator::MeshData mesh;
+        mesh.Vertices.resize(vertices.size());
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            mesh.Vertices[i].Position = vertices[i].Pos;
+            mesh.Vertices[i].Normal = vertices[i].Normal;
+            mesh.Vertices[i].TexC = vertices[i].Tex;
+        }
+        mesh.Indices32.assign(indices.begin(), indices.end());
+
+        AddGeometry(name, mesh, options);
+        return;
+    }
+
+    auto baseVertex = static_cast<UINT>(_vertices.size());
+    _vertices.insert(_vertices.end(), vertices.begin(), vertices.end());
+
+    auto bounds = vertices.empty() ? MeshBounds{} : MeshOptimizer::ComputeBounds(&vertices[0].Pos, vertices.size(), sizeof(Vertex));
+    AddSubmesh(name, baseVertex, indices, bounds, {});
+}
+
+void GeometryLibrary::OptimizeMesh(GeometryGenerator::MeshData& mesh, const MeshImportOptions& options, MeshImportReport& report) const
+{
+    if (options._weldVertices)
+        report._weldedVertices = MeshOptimizer::WeldVertices(mesh, options._weldTolerances);
+
+    const size_t vertexCount = mesh.Vertices.size();
+
+    if (options._optimizeVertexCache)
+        OptimizeVertexCache(mesh.Indices32, vertexCount, options, report);
+
+    if (options._optimizeOverdraw)
+    {
+        report._overdrawBefore = MeshOptimizer::AnalyzeOverdraw(mesh.Indices32, mesh.Vertices);
+        const auto cacheBefore = MeshOptimizer::AnalyzeVertexCache(mesh.Indices32, vertexCount, options._cacheSize, options._cacheModel);
+
+        auto optimized = mesh.Indices32;
+        MeshOptimizer::OptimizeOverdraw(optimized, mesh.Vertices, options._overdrawThreshold, options._cacheSize);
+
+        report._overdrawAfter = MeshOptimizer::AnalyzeOverdraw(optimized, mesh.Vertices);
+        const auto cacheAfter = MeshOptimizer::AnalyzeVertexCache(optimized, vertexCount, options._cacheSize, options._cacheModel);
+
+        // The clusters are only bounded against the order they were cut from, which can be far from what the cache pass
+        // kept, so the threshold is checked again on the whole result
+        if (report._overdrawAfter._overdraw < report._overdrawBefore._overdraw && cacheAfter._acmr <= options._overdrawThreshold * cacheBefore._acmr)
+            mesh.Indices32 = std::move(optimized);
+        else
+            report._overdrawAfter = report._overdrawBefore;
+
+        if (options._optimizeVertexCache)
+            report._cacheAfter = MeshOptimizer::AnalyzeVertexCache(mesh.Indices32, vertexCount, options._cacheSize, options._cacheModel);
+    }
+
+    // Vertex fetch goes last, both passes above only reorder triangles and would undo it
+    if (options._optimizeVertexFetch)
+    {
+        report._fetchBefore = MeshOptimizer::AnalyzeVertexFetch(mesh.Indices32, vertexCount, sizeof(Vertex));
+        auto newVertexCount = MeshOptimizer::OptimizeVertexFetch(mesh);
+        report._fetchAfter = MeshOptimizer::AnalyzeVertexFetch(mesh.Indices32, newVertexCount, sizeof(Vertex));
+    }
+}
+
+void GeometryLibrary::OptimizeVertexCache(std::vector<std::uint32_t>& indices, size_t vertexCount, const MeshImportOptions& options, MeshImportReport& report)
+{
+    report._cacheBefore = MeshOptimizer::AnalyzeVertexCache(indices, vertexCount, options._cacheSize, options._cacheModel);
+
+    auto optimized = indices;
+    if (options._cacheModel == VertexCacheModel::Fifo)
+        MeshOptimizer::OptimizeVertexCacheFifo(optimized, vertexCount, options._cacheSize);
+    else
+        MeshOptimizer::OptimizeVertexCache(optimized, vertexCount);
+
+    report._cacheAfter = MeshOptimizer::AnalyzeVertexCache(optimized, vertexCount, options._cacheSize, options._cacheModel);
+
+    // Some assets ship already optimized, keep their order if the reorder didn't beat it
+    if (report._cacheAfter._acmr < report._cacheBefore._acmr)
+        indices = std::move(optimized);
+    else
+        report._cacheAfter = report._cacheBefore;
+}
+
+void GeometryLibrary::AddMeshlets(SubMeshID id, std::span<const std::uint32_t> indices, std::span<const GeometryGenerator::Vertex> vertices)
+{
+    auto meshlets = MeshletTable::Build(indices, vertices);
+
+    auto& sub = _submeshes[id];
+    sub._firstMeshlet = _meshlets.Append(meshlets, static_cast<std::uint32_t>(sub._baseVertexLocation));
+    sub._meshletCount = static_cast<UINT>(meshlets.GetCount());
+}
+
+void GeometryLibrary::BuildLods(const std::string& name, SubMeshID base, const GeometryGenerator::MeshData& mesh, const MeshBounds& bounds, const MeshImportOptions& options)
+{
+    if (options._lodTriangleRatios.empty() || mesh.Vertices.empty())
+        return;
+
+    MeshLodChain chain;
+    chain._levels.push_back({ base, 0.f });
+
+    const auto baseVertex = static_cast<UINT>(_submeshes[base]._baseVertexLocation);
+    size_t previousCount = mesh.Indices32.size();
+
+    for (float ratio : options._lodTriangleRatios)
+    {
+        size_t target = static_cast<size_t>(mesh.Indices32.size() / 3u * ratio) * 3u;
+
+        // Simplifying from the full mesh every time keeps the errors independent of the previous levels
+        float error = 0.f;
+        auto indices = MeshOptimizer::Simplify(mesh.Indices32, mesh.Vertices, target, &error);
+
+        // Locked borders and seams can stall the simplifier, a level that barely shrinks isn't worth a draw
+        if (indices.size() * 10u > previousCount * 9u)
+            break;
+        previousCount = indices.size();
+
+        // The simplifier emits triangles in collapse order, so the cache pass reports against that
+        MeshImportReport report;
+        if (options._optimizeVertexCache)
+            OptimizeVertexCache(indices, mesh.Vertices.size(), options, report);
+        else
+            report._cacheBefore = report._cacheAfter = MeshOptimizer::AnalyzeVertexCache(indices, mesh.Vertices.size(), options._cacheSize, options._cacheModel);
 
-    _nameToSubmesh[name] = static_cast<SubMeshID>(_submeshes.size());
+        auto id = AddSubmesh(name + "_lod" + std::to_string(chain._levels.size()), baseVertex, indices, bounds, report);
+        if (options._buildMeshlets)
+            AddMeshlets(id, indices, mesh.Vertices);
+        chain._levels.push_back({ id, error });
+    }
+
+    _lodChains[base] = std::move(chain);
+}
+
+SubMeshID GeometryLibrary::AddSubmesh(const std::string& name, UINT baseVertex, std::span<const std::uint32_t> indices, const MeshBounds& bounds, const MeshImportReport& report)
+{
+    SubmeshGeometry sub;
+
+    sub._baseVertexLocation = baseVertex;
+    sub._indexCount = static_cast<UINT>(indices.size());
+
+    DirectX::BoundingBox::CreateFromPoints(sub._aabb, DirectX::XMLoadFloat3(&bounds._min), DirectX::XMLoadFloat3(&bounds._max));
+    sub._sphere = DirectX::BoundingSphere(bounds._sphereCenter, bounds._sphereRadius);
+
+    const auto range = _indexPools.Append(indices);
+    sub._indexFormat = range._width == IndexWidth::Bits32 ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
+    sub._startIndexLocation = range._start;
+
+    auto id = static_cast<SubMeshID>(_submeshes.size());
+    _nameToSubmesh[name] = id;
     _submeshes.push_back(sub);
+    _importReports.push_back(report);
+    _lodChains.emplace_back();
+
+    return id;
 }
 
 void GeometryLibrary::AddMaterial(const std::string& name, std::unique_ptr<Material>&& mat)
@@ -32,9 +189,68 @@ void GeometryLibrary::AddTexture(const std::string& name, std::unique_ptr<Textur
     _textures.push_back(std::move(tex));
 }
 
+void GeometryLibrary::SetVertexFormat(VertexFormat format, TexCoordEncoding texEncoding) noexcept
+{
+    _vertexFormat = format;
+    _texCoordEncoding = texEncoding;
+}
+
+VertexFormat GeometryLibrary::GetVertexFormat() const noexcept
+{
+    return _vertexFormat;
+}
+
+TexCoordEncoding GeometryLibrary::GetTexCoordEncoding() const noexcept
+{
+    return _texCoordEncoding;
+}
+
 void GeometryLibrary::Upload(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList)
 {
-    _mesh = std::make_unique<MeshGeometry>(device, cmdList, _vertices, _indices);
+    if (_vertexFormat == VertexFormat::Full)
+    {
+        _mesh = std::make_unique<MeshGeometry>(device, cmdList, _vertices, _indexPools.GetIndices16(), _indexPools.GetIndices32());
+        return;
+    }
+
+    // Levels of detail share their base mesh's vertices, so bounds are per vertex range rather than per submesh
+    std::vector<UINT> rangeStarts;
+    for (const auto& sub : _submeshes)
+        rangeStarts.push_back(static_cast<UINT>(sub._baseVertexLocation));
+    rangeStarts.push_back(static_cast<UINT>(_vertices.size()));
+    std::sort(rangeStarts.begin(), rangeStarts.end());
+    rangeStarts.erase(std::unique(rangeStarts.begin(), rangeStarts.end()), rangeStarts.end());
+
+    std::unordered_map<UINT, QuantizationBounds> rangeBounds;
+    std::vector<CompactVertex> compact(_vertices.size());
+
+    for (size_t r = 0; r + 1 < rangeStarts.size(); r++)
+    {
+        const UINT begin = rangeStarts[r];
+        const UINT end = rangeStarts[r + 1];
+
+        auto boundsMin = DirectX::XMLoadFloat3(&_vertices[begin].Pos);
+        auto boundsMax = boundsMin;
+        for (UINT v = begin; v < end; v++)
+        {
+            boundsMin = DirectX::XMVectorMin(boundsMin, DirectX::XMLoadFloat3(&_vertices[v].Pos));
+            boundsMax = DirectX::XMVectorMax(boundsMax, DirectX::XMLoadFloat3(&_vertices[v].Pos));
+        }
+
+        DirectX::XMFLOAT3 lo, hi;
+        DirectX::XMStoreFloat3(&lo, boundsMin);
+        DirectX::XMStoreFloat3(&hi, boundsMax);
+        auto bounds = QuantizationBounds::FromMinMax(lo, hi);
+        rangeBounds[begin] = bounds;
+
+        for (UINT v = begin; v < end; v++)
+            compact[v] = VertexCodec::Encode(_vertices[v].Pos, _vertices[v].Normal, _vertices[v].Tex, bounds, _texCoordEncoding);
+    }
+
+    for (auto& sub : _submeshes)
+        sub._quantization = rangeBounds[static_cast<UINT>(sub._baseVertexLocation)];
+
+    _mesh = std::make_unique<MeshGeometry>(device, cmdList, compact, _indexPools.GetIndices16(), _indexPools.GetIndices32());
 }
 
 const MeshGeometry& GeometryLibrary::GetMesh() const noexcept
@@ -57,6 +273,21 @@ const SubmeshGeometry& GeometryLibrary::GetSubmesh(SubMeshID id) const
     return _submeshes.at(id);
 }
 
+const MeshImportReport& GeometryLibrary::GetImportReport(SubMeshID id) const
+{
+    return _importReports.at(id);
+}
+
+const MeshLodChain& GeometryLibrary::GetLodChain(SubMeshID id) const
+{
+    return _lodChains.at(id);
+}
+
+const MeshletTable& GeometryLibrary::GetMeshlets() const noexcept
+{
+    return _meshlets;
+}
+
 SubMeshID GeometryLibrary::GetSubmeshID(const std::string& name) const
 {
     return _nameToSubmesh.at(name);
@@ -112,6 +343,11 @@ MaterialID GeometryLibrary::GetMaterialID(const std::string& name) const
     return _nameToMaterial.at(name);
 }
 
+size_t GeometryLibrary::GetSubmeshCount() const noexcept
+{
+    return _submeshes.size();
+}
+
 size_t GeometryLibrary::GetMaterialCount() const noexcept
 {
     return _materials.size();
@@ -0,0 +1,32 @@
+#include "../../../include/sasha/renderer/geometry/IndexPools.h"
+#include <algorithm>
+
+IndexRange IndexPools::Append(std::span<const std::uint32_t> indices)
+{
+	IndexRange range;
+	range._count = static_cast<std::uint32_t>(indices.size());
+
+	const auto maxIndex = indices.empty() ? 0u : *std::max_element(indices.begin(), indices.end());
+	if (maxIndex <= 0xffffu)
+	{
+		range._width = IndexWidth::Bits16;
+		range._start = static_cast<std::uint32_t>(_indices16.size());
+		for (auto i : indices)
+			_indices16.push_back(static_cast<std::uint16_t>(i));
+	}
+	else
+	{
+		range._width = IndexWidth::Bits32;
+		range._start = static_cast<std::uint32_t>(_indices32.size());
+		_indices32.insert(_indices32.end(), indices.begin(), indices.end());
+	}
+
+	return range;
+}
+
+std::vector<std::uint32_t> IndexPools::Read(const IndexRange& range) const
+{
+	if (range._width == IndexWidth::Bits16)
+		return { _indices16.begin() + range._start, _indices16.begin() + range._start + range._count };
+	return { _indices32.begin() + range._start, _indices32.begin() + range._start + range._count };
+}
@@ -0,0 +1,134 @@
+#include "../../../include/sasha/renderer/geometry/MeshCache.h"
+#include "../../../include/sasha/renderer/geometry/MeshOptimizer.h"
+
+namespace
+{
+	void ThrowLastError()
+	{
+		ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+	}
+
+	UINT64 ExpectedFileSize(const MeshFileHeader& header)
+	{
+		return sizeof(MeshFileHeader)
+			+ static_cast<UINT64>(header._vertexCount) * sizeof(Vertex)
+			+ static_cast<UINT64>(header._indexCount) * sizeof(std::uint32_t);
+	}
+}
+
+MappedMesh::MappedMesh(const std::filesystem::path& path)
+{
+	_file.Attach(CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+	if (!_file.IsValid())
+		ThrowLastError();
+
+	LARGE_INTEGER size{};
+	if (!GetFileSizeEx(_file.Get(), &size))
+		ThrowLastError();
+	_viewSize = static_cast<UINT64>(size.QuadPart);
+
+	_mapping.Attach(CreateFileMappingW(_file.Get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+	if (!_mapping.IsValid())
+		ThrowLastError();
+
+	_view.reset(static_cast<const BYTE*>(MapViewOfFile(_mapping.Get(), FILE_MAP_READ, 0, 0, 0)));
+	if (!_view)
+		ThrowLastError();
+
+	if (_viewSize < sizeof(MeshFileHeader) || _viewSize != ExpectedFileSize(GetHeader()))
+		ThrowIfFailed(HRESULT_FROM_WIN32(ERROR_INVALID_DATA));
+}
+
+const MeshFileHeader& MappedMesh::GetHeader() const noexcept
+{
+	return *reinterpret_cast<const MeshFileHeader*>(_view.get());
+}
+
+std::span<const Vertex> MappedMesh::GetVertices() const noexcept
+{
+	const auto* vertices = reinterpret_cast<const Vertex*>(_view.get() + sizeof(MeshFileHeader));
+	return { vertices, GetHeader()._vertexCount };
+}
+
+std::span<const std::uint32_t> MappedMesh::GetIndices() const noexcept
+{
+	const auto* indices = reinterpret_cast<const std::uint32_t*>(_view.get() + sizeof(MeshFileHeader) + GetHeader()._vertexCount * sizeof(Vertex));
+	return { indices, GetHeader()._indexCount };
+}
+
+std::unique_ptr<MappedMesh> MeshCache::Load(const std::filesystem::path& source)
+{
+	auto cache = GetCachePath(source);
+
+	if (IsStale(source, cache))
+	{
+		GeometryGenerator g;
+		auto mesh = g.ReadFile(source.string());
+		const size_t welded = MeshOptimizer::WeldVertices(mesh);
+		Write(source, cache, mesh, welded);
+	}
+
+	return std::make_unique<MappedMesh>(cache);
+}
+
+std::filesystem::path MeshCache::GetCachePath(const std::filesystem::path& source)
+{
+	auto cache = source;
+	cache.replace_extension(".smesh");
+	return cache;
+}
+
+bool MeshCache::IsStale(const std::filesystem::path& source, const std::filesystem::path& cache)
+{
+	std::error_code ec;
+	if (!std::filesystem::exists(cache, ec))
+		return true;
+
+	std::ifstream file(cache, std::ios::binary);
+	MeshFileHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		return true;
+
+	if (header._magic != MeshFileHeader::Magic ||
+		header._version != MeshFileHeader::Version ||
+		header._vertexStride != sizeof(Vertex))
+		return true;
+
+	if (std::filesystem::file_size(cache, ec) != ExpectedFileSize(header))
+		return true;
+
+	// A missing source means the baked file is all we have, so keep using it
+	if (!std::filesystem::exists(source, ec))
+		return false;
+
+	return header._sourceSize != std::filesystem::file_size(source) ||
+		header._sourceWriteTime != std::filesystem::last_write_time(source).time_since_epoch().count();
+}
+
+void MeshCache::Write(const std::filesystem::path& source, const std::filesystem::path& cache, const GeometryGenerator::MeshData& mesh, size_t weldedVertices)
+{
+	MeshFileHeader header;
+	header._vertexCount = static_cast<std::uint32_t>(mesh.Vertices.size());
+	header._indexCount = static_cast<std::uint32_t>(mesh.Indices32.size());
+	header._weldedVertices = static_cast<std::uint32_t>(weldedVertices);
+	header._sourceSize = std::filesystem::file_size(source);
+	header._sourceWriteTime = std::filesystem::last_write_time(source).time_since_epoch().count();
+
+	std::vector<Vertex> vertices;
+	vertices.reserve(mesh.Vertices.size());
+	for (const auto& v : mesh.Vertices)
+		vertices.push_back({ v.Position, v.Normal, v.TexC });
+
+	// Write next to the final file and swap it in so a crash never leaves a truncated cache behind
+	auto tmp = cache;
+	tmp += ".tmp";
+	{
+		std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(Vertex));
+		file.write(reinterpret_cast<const char*>(mesh.Indices32.data()), mesh.Indices32.size() * sizeof(std::uint32_t));
+		if (!file)
+			ThrowIfFailed(HRESULT_FROM_WIN32(ERROR_WRITE_FAULT));
+	}
+	std::filesystem::rename(tmp, cache);
+}
@@ -0,0 +1,1181 @@
+#include "../../../include/sasha/renderer/geometry/MeshOptimizer.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace
+{
+	// Size of the LRU cache modelled while scoring, larger than real hardware so the order degrades gracefully
+	constexpr std::uint32_t kScoringCacheSize = 32u;
+	constexpr std::uint32_t kMaxValence = 32u;
+
+	constexpr float kCacheDecayPower = 1.5f;
+	constexpr float kLastTriScore = 0.75f;
+	constexpr float kValenceBoostScale = 2.0f;
+	constexpr float kValenceBoostPower = 0.5f;
+
+	struct ScoreTable
+	{
+		float _cache[kScoringCacheSize + 1];
+		float _valence[kMaxValence + 1];
+
+		ScoreTable()
+		{
+			// Index 0 is "not in cache"
+			_cache[0] = 0.f;
+			for (std::uint32_t i = 0; i < kScoringCacheSize; i++)
+			{
+				// The three most recent vertices belong to the last triangle, which we don't want to reuse immediately
+				if (i < 3u)
+					_cache[i + 1] = kLastTriScore;
+				else
+				{
+					float scaler = 1.f / (kScoringCacheSize - 3u);
+					_cache[i + 1] = std::pow(1.f - (i - 3u) * scaler, kCacheDecayPower);
+				}
+			}
+
+			_valence[0] = 0.f;
+			for (std::uint32_t i = 1; i <= kMaxValence; i++)
+				_valence[i] = kValenceBoostScale * std::pow(static_cast<float>(i), -kValenceBoostPower);
+		}
+
+		float Score(std::int32_t cachePosition, std::uint32_t liveTriangles) const noexcept
+		{
+			if (liveTriangles == 0u)
+				return -1.f;
+
+			return _cache[cachePosition + 1] + _valence[std::min(liveTriangles, kMaxValence)];
+		}
+	};
+
+	const ScoreTable& GetScoreTable()
+	{
+		static const ScoreTable table;
+		return table;
+	}
+
+	// Vertex -> triangle adjacency stored as one flat array indexed through per-vertex offsets
+	struct TriangleAdjacency
+	{
+		TriangleAdjacency(std::span<const std::uint32_t> indices, size_t vertexCount)
+			: _counts(vertexCount, 0u)
+			, _offsets(vertexCount + 1u, 0u)
+			, _triangles(indices.size())
+		{
+			for (auto index : indices)
+				_counts[index]++;
+
+			for (size_t v = 0; v < vertexCount; v++)
+				_offsets[v + 1] = _offsets[v] + _counts[v];
+
+			std::vector<std::uint32_t> fill(_offsets.begin(), _offsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); i++)
+				_triangles[fill[indices[i]]++] = static_cast<std::uint32_t>(i / 3u);
+		}
+
+		std::vector<std::uint32_t> _counts;
+		std::vector<std::uint32_t> _offsets;
+		std::vector<std::uint32_t> _triangles;
+	};
+
+	// FIFO post-transform cache kept as insertion timestamps, a vertex is cached while now - time <= size
+	class FifoCache
+	{
+	public:
+		FifoCache(size_t vertexCount, std::uint32_t size)
+			: _time(vertexCount, 0u)
+			, _size(size)
+			, _now(size + 1u)
+		{}
+
+		// Returns 1 on a miss
+		std::uint32_t Access(std::uint32_t v) noexcept
+		{
+			if (_now - _time[v] <= _size)
+				return 0u;
+
+			_time[v] = _now++;
+			return 1u;
+		}
+
+		std::uint32_t AccessTriangle(const std::uint32_t* tri) noexcept
+		{
+			return Access(tri[0]) + Access(tri[1]) + Access(tri[2]);
+		}
+
+		void Reset() noexcept
+		{
+			_now += _size + 1u;
+		}
+
+	private:
+		std::vector<std::uint32_t> _time;
+		std::uint32_t _size;
+		std::uint32_t _now;
+	};
+
+	struct Float3
+	{
+		float x = 0.f;
+		float y = 0.f;
+		float z = 0.f;
+
+		Float3() = default;
+		Float3(float x, float y, float z) : x(x), y(y), z(z) {}
+		Float3(const DirectX::XMFLOAT3& v) : x(v.x), y(v.y), z(v.z) {}
+
+		float operator[](size_t i) const noexcept { return i == 0 ? x : (i == 1 ? y : z); }
+		Float3 operator+(const Float3& o) const noexcept { return { x + o.x, y + o.y, z + o.z }; }
+		Float3 operator-(const Float3& o) const noexcept { return { x - o.x, y - o.y, z - o.z }; }
+		Float3 operator*(float s) const noexcept { return { x * s, y * s, z * s }; }
+	};
+
+	float Dot(const Float3& a, const Float3& b) noexcept
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	Float3 Cross(const Float3& a, const Float3& b) noexcept
+	{
+		return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+	}
+
+	// Symmetric 4x4 plane quadric, accumulated in double since the skull's planes nearly cancel out
+	struct Quadric
+	{
+		double _a00 = 0.0, _a01 = 0.0, _a02 = 0.0, _a11 = 0.0, _a12 = 0.0, _a22 = 0.0;
+		double _b0 = 0.0, _b1 = 0.0, _b2 = 0.0;
+		double _c = 0.0;
+		double _weight = 0.0;
+
+		void AddPlane(const Float3& n, float d, double weight) noexcept
+		{
+			_a00 += weight * n.x * n.x; _a01 += weight * n.x * n.y; _a02 += weight * n.x * n.z;
+			_a11 += weight * n.y * n.y; _a12 += weight * n.y * n.z; _a22 += weight * n.z * n.z;
+			_b0 += weight * n.x * d; _b1 += weight * n.y * d; _b2 += weight * n.z * d;
+			_c += weight * d * d;
+			_weight += weight;
+		}
+
+		void Add(const Quadric& q) noexcept
+		{
+			_a00 += q._a00; _a01 += q._a01; _a02 += q._a02;
+			_a11 += q._a11; _a12 += q._a12; _a22 += q._a22;
+			_b0 += q._b0; _b1 += q._b1; _b2 += q._b2;
+			_c += q._c;
+			_weight += q._weight;
+		}
+
+		// Weighted sum of squared distances to the accumulated planes
+		double Evaluate(const Float3& p) const noexcept
+		{
+			double x = p.x, y = p.y, z = p.z;
+			double r = _a00 * x * x + _a11 * y * y + _a22 * z * z
+				+ 2.0 * (_a01 * x * y + _a02 * x * z + _a12 * y * z)
+				+ 2.0 * (_b0 * x + _b1 * y + _b2 * z)
+				+ _c;
+			return std::max(r, 0.0);
+		}
+	};
+
+	struct Collapse
+	{
+		float _error;
+		std::uint32_t _from;
+		std::uint32_t _to;
+	};
+
+	struct WeldCell
+	{
+		std::int32_t _x, _y, _z;
+
+		bool operator==(const WeldCell&) const = default;
+	};
+
+	// Open addressing table from a cell to the last vertex kept in it, the other vertices of the cell are chained behind it.
+	// Only cells holding a kept vertex are inserted, so one slot per vertex at half load never fills up
+	class WeldGrid
+	{
+	public:
+		static constexpr std::uint32_t kNone = ~0u;
+
+		explicit WeldGrid(size_t maxCells)
+		{
+			size_t capacity = 16u;
+			while (capacity < maxCells * 2u)
+				capacity *= 2u;
+
+			_heads.assign(capacity, kNone);
+			_mask = capacity - 1u;
+		}
+
+		// cellOf maps a kept vertex back to its cell, storing it per vertex is cheaper than per slot
+		template<typename CellOf>
+		std::uint32_t& Find(const WeldCell& cell, const CellOf& cellOf)
+		{
+			for (size_t slot = Hash(cell) & _mask; ; slot = (slot + 1u) & _mask)
+				if (_heads[slot] == kNone || cellOf(_heads[slot]) == cell)
+					return _heads[slot];
+		}
+
+	private:
+		static size_t Hash(const WeldCell& cell) noexcept
+		{
+			std::uint64_t key = static_cast<std::uint32_t>(cell._x) * 0x9e3779b97f4a7c15ull
+				^ static_cast<std::uint32_t>(cell._y) * 0xc2b2ae3d27d4eb4full
+				^ static_cast<std::uint32_t>(cell._z) * 0x165667b19e3779f9ull;
+			key ^= key >> 32;
+			return static_cast<size_t>(key);
+		}
+
+		std::vector<std::uint32_t> _heads;
+		size_t _mask = 0u;
+	};
+
+	// Exact welding keys on the bit pattern, with -0 folded onto 0 so the two still compare equal
+	std::int32_t ExactCellCoordinate(float v) noexcept
+	{
+		return v == 0.f ? 0 : std::bit_cast<std::int32_t>(v);
+	}
+
+	std::int32_t CellCoordinate(double v) noexcept
+	{
+		return static_cast<std::int32_t>(std::clamp(std::floor(v), -2147483648.0, 2147483647.0));
+	}
+}
+
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(std::span<const std::uint32_t> indices, size_t vertexCount,
+	std::uint32_t cacheSize, VertexCacheModel model)
+{
+	assert(cacheSize > 0u);
+
+	// Fewer than 3 indices make no triangle to average over
+	VertexCacheStats stats;
+	if (indices.size() < 3u)
+		return stats;
+
+	// Cache entries are stored oldest first; a FIFO only appends on a miss while an LRU also moves hits to the back
+	std::vector<std::uint32_t> cache;
+	cache.reserve(cacheSize);
+	std::vector<bool> referenced(vertexCount, false);
+	size_t uniqueCount = 0u;
+
+	for (auto index : indices)
+	{
+		assert(index < vertexCount);
+		if (!referenced[index])
+		{
+			referenced[index] = true;
+			uniqueCount++;
+		}
+
+		auto it = std::find(cache.begin(), cache.end(), index);
+		if (it != cache.end())
+		{
+			if (model == VertexCacheModel::Lru)
+			{
+				cache.erase(it);
+				cache.push_back(index);
+			}
+			continue;
+		}
+
+		stats._transformCount++;
+		if (cache.size() == cacheSize)
+			cache.erase(cache.begin());
+		cache.push_back(index);
+	}
+
+	stats._acmr = static_cast<float>(stats._transformCount) / static_cast<float>(indices.size() / 3u);
+	stats._atvr = static_cast<float>(stats._transformCount) / static_cast<float>(uniqueCount);
+	return stats;
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::span<std::uint32_t> indices, size_t vertexCount)
+{
+	assert(indices.size() % 3u == 0u);
+
+	const size_t triangleCount = indices.size() / 3u;
+	if (triangleCount == 0u)
+		return;
+
+	const auto& table = GetScoreTable();
+
+	TriangleAdjacency adjacency(indices, vertexCount);
+	auto& liveTriangles = adjacency._counts;
+
+	std::vector<std::int32_t> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++)
+		vertexScore[v] = table.Score(-1, liveTriangles[v]);
+
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<std::uint32_t> output;
+	output.reserve(indices.size());
+
+	// One extra slot holds the entries pushed out by the three new vertices of a triangle
+	std::uint32_t cache[kScoringCacheSize + 3];
+	std::uint32_t cacheCount = 0u;
+
+	size_t bestTriangle = 0u;
+	size_t scanCursor = 0u;
+
+	for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+	{
+		if (bestTriangle == triangleCount)
+		{
+			// Nothing in the cache touches a live triangle, restart from the next one in input order
+			// which keeps the whole pass linear even for meshes made of many disconnected pieces
+			while (emitted[scanCursor])
+				scanCursor++;
+			bestTriangle = scanCursor;
+		}
+
+		const std::uint32_t* tri = &indices[bestTriangle * 3];
+		output.insert(output.end(), tri, tri + 3);
+		emitted[bestTriangle] = true;
+
+		// Drop the triangle from its vertices' live lists
+		for (size_t k = 0; k < 3u; k++)
+		{
+			std::uint32_t v = tri[k];
+			auto* begin = adjacency._triangles.data() + adjacency._offsets[v];
+			auto* end = begin + liveTriangles[v];
+			auto* it = std::find(begin, end, static_cast<std::uint32_t>(bestTriangle));
+			std::swap(*it, *(end - 1));
+			liveTriangles[v]--;
+		}
+
+		// Move the triangle's vertices to the front of the cache
+		std::uint32_t newCache[kScoringCacheSize + 3];
+		std::uint32_t newCount = 0u;
+		for (size_t k = 0; k < 3u; k++)
+			newCache[newCount++] = tri[k];
+		for (std::uint32_t i = 0; i < cacheCount; i++)
+		{
+			std::uint32_t v = cache[i];
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+				newCache[newCount++] = v;
+		}
+
+		// Evicted vertices lose their cache bonus
+		for (std::uint32_t i = kScoringCacheSize; i < newCount; i++)
+		{
+			cachePosition[newCache[i]] = -1;
+			vertexScore[newCache[i]] = table.Score(-1, liveTriangles[newCache[i]]);
+		}
+
+		cacheCount = std::min(newCount, kScoringCacheSize);
+		std::copy(newCache, newCache + cacheCount, cache);
+
+		// Rescore everything still cached and pick the best triangle touching it
+		for (std::uint32_t i = 0; i < cacheCount; i++)
+		{
+			cachePosition[cache[i]] = static_cast<std::int32_t>(i);
+			vertexScore[cache[i]] = table.Score(static_cast<std::int32_t>(i), liveTriangles[cache[i]]);
+		}
+
+		bestTriangle = triangleCount;
+		float bestScore = -1.f;
+		for (std::uint32_t i = 0; i < cacheCount; i++)
+		{
+			std::uint32_t v = cache[i];
+			for (std::uint32_t a = 0; a < liveTriangles[v]; a++)
+			{
+				std::uint32_t t = adjacency._triangles[adjacency._offsets[v] + a];
+				float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestTriangle = t;
+				}
+			}
+		}
+	}
+
+	std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void MeshOptimizer::OptimizeVertexCacheFifo(std::span<std::uint32_t> indices, size_t vertexCount, std::uint32_t cacheSize)
+{
+	assert(indices.size() % 3u == 0u);
+
+	const size_t triangleCount = indices.size() / 3u;
+	if (triangleCount == 0u)
+		return;
+
+	TriangleAdjacency adjacency(indices, vertexCount);
+	auto& liveTriangles = adjacency._counts;
+
+	// Time at which each vertex last entered the simulated FIFO; it is still cached while now - time <= cacheSize
+	std::vector<std::uint32_t> cacheTime(vertexCount, 0u);
+	std::uint32_t now = cacheSize + 1u;
+
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<std::uint32_t> deadEnds;
+	std::vector<std::uint32_t> candidates;
+	std::vector<std::uint32_t> output;
+	output.reserve(indices.size());
+
+	size_t inputCursor = 0u;
+	auto nextInputVertex = [&]() -> std::int64_t
+	{
+		while (inputCursor < vertexCount && liveTriangles[inputCursor] == 0u)
+			inputCursor++;
+		return inputCursor < vertexCount ? static_cast<std::int64_t>(inputCursor) : -1;
+	};
+
+	std::int64_t fanning = nextInputVertex();
+	while (fanning >= 0)
+	{
+		// Emit every remaining triangle around the fanning vertex
+		candidates.clear();
+		for (auto a = adjacency._offsets[fanning]; a < adjacency._offsets[fanning + 1]; a++)
+		{
+			std::uint32_t t = adjacency._triangles[a];
+			if (emitted[t])
+				continue;
+			emitted[t] = true;
+
+			for (size_t k = 0; k < 3u; k++)
+			{
+				std::uint32_t v = indices[t * 3 + k];
+				output.push_back(v);
+				deadEnds.push_back(v);
+				candidates.push_back(v);
+				liveTriangles[v]--;
+
+				if (now - cacheTime[v] > cacheSize)
+					cacheTime[v] = now++;
+			}
+		}
+
+		// Prefer the oldest candidate that will still be cached once its own fan is emitted
+		std::int64_t next = -1;
+		std::int64_t bestPriority = -1;
+		for (auto v : candidates)
+		{
+			if (liveTriangles[v] == 0u)
+				continue;
+
+			std::int64_t priority = 0;
+			if (static_cast<std::int64_t>(now - cacheTime[v]) + 2 * liveTriangles[v] <= cacheSize)
+				priority = now - cacheTime[v];
+
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				next = v;
+			}
+		}
+
+		// Dead end: back up through recently emitted vertices, then fall back to input order
+		while (next < 0 && !deadEnds.empty())
+		{
+			std::uint32_t v = deadEnds.back();
+			deadEnds.pop_back();
+			if (liveTriangles[v] > 0u)
+				next = v;
+		}
+		if (next < 0)
+			next = nextInputVertex();
+
+		fanning = next;
+	}
+
+	std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::span<std::uint32_t> indices, std::span<const GeometryGenerator::Vertex> vertices,
+	float threshold, std::uint32_t cacheSize)
+{
+	assert(indices.size() % 3u == 0u);
+
+	const size_t triangleCount = indices.size() / 3u;
+	if (triangleCount == 0u)
+		return;
+
+	// Hard boundaries are where the cache restarts, nothing from the previous triangles is reused there
+	std::vector<size_t> hardBoundaries;
+	size_t inputMisses = 0u;
+	{
+		FifoCache cache(vertices.size(), cacheSize);
+		for (size_t t = 0; t < triangleCount; t++)
+		{
+			const std::uint32_t misses = cache.AccessTriangle(&indices[t * 3]);
+			inputMisses += misses;
+			if (misses == 3u || t == 0u)
+				hardBoundaries.push_back(t);
+		}
+		hardBoundaries.push_back(triangleCount);
+	}
+
+	// Soft boundaries split every hard cluster again as soon as the running ACMR gets within threshold of the cluster's own
+	std::vector<size_t> clusters;
+	FifoCache cache(vertices.size(), cacheSize);
+	for (size_t h = 0; h + 1 < hardBoundaries.size(); h++)
+	{
+		const size_t begin = hardBoundaries[h];
+		const size_t end = hardBoundaries[h + 1];
+
+		cache.Reset();
+		size_t clusterMisses = 0u;
+		for (size_t t = begin; t < end; t++)
+			clusterMisses += cache.AccessTriangle(&indices[t * 3]);
+		const float target = threshold * clusterMisses / static_cast<float>(end - begin);
+
+		const size_t firstCluster = clusters.size();
+		clusters.push_back(begin);
+
+		cache.Reset();
+		size_t runningMisses = 0u;
+		size_t runningTriangles = 0u;
+		for (size_t t = begin; t < end; t++)
+		{
+			runningMisses += cache.AccessTriangle(&indices[t * 3]);
+			runningTriangles++;
+
+			if (runningMisses <= target * runningTriangles)
+			{
+				clusters.push_back(t + 1);
+				cache.Reset();
+				runningMisses = 0u;
+				runningTriangles = 0u;
+			}
+		}
+
+		// Drop the empty cluster at the end, or merge a trailing one that never reached the target into its predecessor
+		if (clusters.back() == end || (runningTriangles > 0u && clusters.size() - firstCluster > 1u))
+			clusters.pop_back();
+	}
+	clusters.push_back(triangleCount);
+
+	const size_t clusterCount = clusters.size() - 1u;
+
+	// Area weighted centroid and normal of every cluster
+	std::vector<Float3> centroids(clusterCount);
+	std::vector<Float3> normals(clusterCount);
+	std::vector<float> areas(clusterCount, 0.f);
+	Float3 meshCentroid;
+	float meshArea = 0.f;
+
+	for (size_t c = 0; c < clusterCount; c++)
+	{
+		for (size_t t = clusters[c]; t < clusters[c + 1]; t++)
+		{
+			Float3 p0 = vertices[indices[t * 3]].Position;
+			Float3 p1 = vertices[indices[t * 3 + 1]].Position;
+			Float3 p2 = vertices[indices[t * 3 + 2]].Position;
+
+			Float3 n = Cross(p1 - p0, p2 - p0);
+			float area = std::sqrt(Dot(n, n));
+
+			centroids[c] = centroids[c] + (p0 + p1 + p2) * (area / 3.f);
+			normals[c] = normals[c] + n;
+			areas[c] += area;
+		}
+
+		meshCentroid = meshCentroid + centroids[c];
+		meshArea += areas[c];
+
+		if (areas[c] > 0.f)
+			centroids[c] = centroids[c] * (1.f / areas[c]);
+	}
+
+	if (meshArea > 0.f)
+		meshCentroid = meshCentroid * (1.f / meshArea);
+
+	// Clusters far out along their own normal are likely to occlude the rest, draw them first
+	std::vector<std::pair<float, size_t>> order(clusterCount);
+	for (size_t c = 0; c < clusterCount; c++)
+	{
+		float length = std::sqrt(Dot(normals[c], normals[c]));
+		float key = length > 0.f ? Dot(centroids[c] - meshCentroid, normals[c]) / length : 0.f;
+		order[c] = { key, c };
+	}
+
+	std::stable_sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+	std::vector<std::uint32_t> output;
+	output.reserve(indices.size());
+	for (const auto& [key, c] : order)
+		output.insert(output.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+
+	// Clusters start from a cold cache, which can cost more than the same triangles did after their predecessors in the
+	// input order, and a trailing cluster merged above may not reach its target. Keep the input when the bound broke
+	cache.Reset();
+	size_t outputMisses = 0u;
+	for (size_t t = 0; t < triangleCount; t++)
+		outputMisses += cache.AccessTriangle(&output[t * 3]);
+	if (outputMisses > threshold * inputMisses)
+		return;
+
+	std::copy(output.begin(), output.end(), indices.begin());
+}
+
+size_t MeshOptimizer::OptimizeVertexFetch(GeometryGenerator::MeshData& mesh)
+{
+	constexpr std::uint32_t unused = std::numeric_limits<std::uint32_t>::max();
+
+	std::vector<std::uint32_t> remap(mesh.Vertices.size(), unused);
+	std::vector<GeometryGenerator::Vertex> vertices;
+	vertices.reserve(mesh.Vertices.size());
+
+	for (auto& index : mesh.Indices32)
+	{
+		if (remap[index] == unused)
+		{
+			remap[index] = static_cast<std::uint32_t>(vertices.size());
+			vertices.push_back(mesh.Vertices[index]);
+		}
+		index = remap[index];
+	}
+
+	mesh.Vertices = std::move(vertices);
+	return mesh.Vertices.size();
+}
+
+size_t MeshOptimizer::WeldVertices(GeometryGenerator::MeshData& mesh, const WeldTolerances& tolerances)
+{
+	auto& vertices = mesh.Vertices;
+	const size_t vertexCount = vertices.size();
+	if (vertexCount == 0u)
+		return 0u;
+
+	const float tolerance = std::max(tolerances._position, 0.f);
+	const bool exact = tolerance == 0.f;
+	// Cells twice the tolerance wide: the tolerance box around a vertex overlaps at most two cells per axis
+	const double invCellSize = exact ? 0.0 : 1.0 / (2.0 * tolerance);
+
+	auto cellAt = [&](const DirectX::XMFLOAT3& p, float offset)
+	{
+		if (exact)
+			return WeldCell{ ExactCellCoordinate(p.x), ExactCellCoordinate(p.y), ExactCellCoordinate(p.z) };
+
+		return WeldCell{ CellCoordinate((p.x + offset) * invCellSize), CellCoordinate((p.y + offset) * invCellSize), CellCoordinate((p.z + offset) * invCellSize) };
+	};
+
+	auto within = [](float a, float b, float t) { return std::abs(a - b) <= t; };
+	auto matches = [&](const GeometryGenerator::Vertex& a, const GeometryGenerator::Vertex& b)
+	{
+		return within(a.Position.x, b.Position.x, tolerance) && within(a.Position.y, b.Position.y, tolerance) && within(a.Position.z, b.Position.z, tolerance)
+			&& within(a.Normal.x, b.Normal.x, tolerances._normal) && within(a.Normal.y, b.Normal.y, tolerances._normal) && within(a.Normal.z, b.Normal.z, tolerances._normal)
+			&& within(a.TexC.x, b.TexC.x, tolerances._texCoord) && within(a.TexC.y, b.TexC.y, tolerances._texCoord);
+	};
+
+	// Kept vertices are compacted to the front as we go, chains and cells are indexed by their new position.
+	// The vertex being visited sits at or after the write position, so it is read before anything overwrites it
+	WeldGrid grid(vertexCount);
+	std::vector<WeldCell> keptCells(vertexCount);
+	std::vector<std::uint32_t> next(vertexCount, WeldGrid::kNone);
+	std::vector<std::uint32_t> remap(vertexCount);
+	auto cellOf = [&](std::uint32_t kept) { return keptCells[kept]; };
+
+	std::uint32_t keptCount = 0u;
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		const auto& vertex = vertices[v];
+		const WeldCell lo = cellAt(vertex.Position, -tolerance);
+		const WeldCell hi = cellAt(vertex.Position, tolerance);
+
+		std::uint32_t match = WeldGrid::kNone;
+		for (std::int64_t x = lo._x; x <= hi._x && match == WeldGrid::kNone; x++)
+			for (std::int64_t y = lo._y; y <= hi._y && match == WeldGrid::kNone; y++)
+				for (std::int64_t z = lo._z; z <= hi._z && match == WeldGrid::kNone; z++)
+				{
+					WeldCell cell{ static_cast<std::int32_t>(x), static_cast<std::int32_t>(y), static_cast<std::int32_t>(z) };
+					for (auto k = grid.Find(cell, cellOf); k != WeldGrid::kNone; k = next[k])
+						if (matches(vertices[k], vertex))
+						{
+							match = k;
+							break;
+						}
+				}
+
+		if (match != WeldGrid::kNone)
+		{
+			remap[v] = match;
+			continue;
+		}
+
+		const WeldCell cell = cellAt(vertex.Position, 0.f);
+		auto& head = grid.Find(cell, cellOf);
+		keptCells[keptCount] = cell;
+		next[keptCount] = head;
+		head = keptCount;
+
+		if (keptCount != v)
+			vertices[keptCount] = vertex;
+		remap[v] = keptCount++;
+	}
+
+	for (auto& index : mesh.Indices32)
+		index = remap[index];
+
+	vertices.resize(keptCount);
+	return vertexCount - keptCount;
+}
+
+MeshBounds MeshOptimizer::ComputeBounds(const DirectX::XMFLOAT3* positions, size_t count, size_t stride)
+{
+	using namespace DirectX;
+
+	MeshBounds bounds;
+	if (count == 0u)
+		return bounds;
+
+	const auto* bytes = reinterpret_cast<const std::byte*>(positions);
+	auto position = [&](size_t i) { return XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(bytes + i * stride)); };
+
+	// First pass: the box, and the points sitting on its six faces (min x, y, z then max x, y, z).
+	// Each axis of the compare masks is splatted so the whole point is selected in one register
+	XMVECTOR boundsMin = position(0);
+	XMVECTOR boundsMax = boundsMin;
+	XMVECTOR extremes[6] = { boundsMin, boundsMin, boundsMin, boundsMin, boundsMin, boundsMin };
+	for (size_t i = 1; i < count; i++)
+	{
+		XMVECTOR p = position(i);
+		XMVECTOR less = XMVectorLess(p, boundsMin);
+		XMVECTOR greater = XMVectorGreater(p, boundsMax);
+
+		extremes[0] = XMVectorSelect(extremes[0], p, XMVectorSplatX(less));
+		extremes[1] = XMVectorSelect(extremes[1], p, XMVectorSplatY(less));
+		extremes[2] = XMVectorSelect(extremes[2], p, XMVectorSplatZ(less));
+		extremes[3] = XMVectorSelect(extremes[3], p, XMVectorSplatX(greater));
+		extremes[4] = XMVectorSelect(extremes[4], p, XMVectorSplatY(greater));
+		extremes[5] = XMVectorSelect(extremes[5], p, XMVectorSplatZ(greater));
+
+		boundsMin = XMVectorMin(boundsMin, p);
+		boundsMax = XMVectorMax(boundsMax, p);
+	}
+
+	XMStoreFloat3(&bounds._min, boundsMin);
+	XMStoreFloat3(&bounds._max, boundsMax);
+
+	// Ritter starts from the most distant pair of extreme points
+	size_t axis = 0u;
+	float spanSq = 0.f;
+	for (size_t a = 0; a < 3u; a++)
+	{
+		float lengthSq = XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(extremes[a + 3u], extremes[a])));
+		if (lengthSq > spanSq)
+		{
+			spanSq = lengthSq;
+			axis = a;
+		}
+	}
+
+	XMVECTOR center = XMVectorScale(XMVectorAdd(extremes[axis], extremes[axis + 3u]), 0.5f);
+	float radius = 0.5f * std::sqrt(spanSq);
+
+	// Second pass grows the sphere just enough to take in every point outside it, and measures the box centered sphere
+	const XMVECTOR boxCenter = XMVectorScale(XMVectorAdd(boundsMin, boundsMax), 0.5f);
+	XMVECTOR boxRadiusSq = XMVectorZero();
+	for (size_t i = 0; i < count; i++)
+	{
+		XMVECTOR p = position(i);
+		boxRadiusSq = XMVectorMax(boxRadiusSq, XMVector3LengthSq(XMVectorSubtract(p, boxCenter)));
+
+		XMVECTOR offset = XMVectorSubtract(p, center);
+		float distanceSq = XMVectorGetX(XMVector3LengthSq(offset));
+		if (distanceSq > radius * radius)
+		{
+			float distance = std::sqrt(distanceSq);
+			float grownRadius = 0.5f * (radius + distance);
+			center = XMVectorAdd(center, XMVectorScale(offset, (grownRadius - radius) / distance));
+			radius = grownRadius;
+		}
+	}
+
+	// Ritter lands within a few percent of the minimal sphere on round meshes, boxy ones favor the box center
+	float boxRadius = std::sqrt(XMVectorGetX(boxRadiusSq));
+	if (boxRadius <= radius)
+	{
+		center = boxCenter;
+		radius = boxRadius;
+	}
+
+	// The center moved in float steps and every step rounds by an ulp of its coordinates, which on a small mesh far from
+	// the origin is more than the radius accounts for. The radius is measured again from the center as stored, with a
+	// few ulps of slack for the distance itself
+	XMStoreFloat3(&bounds._sphereCenter, center);
+	center = XMLoadFloat3(&bounds._sphereCenter);
+	XMVECTOR radiusSq = XMVectorZero();
+	for (size_t i = 0; i < count; i++)
+		radiusSq = XMVectorMax(radiusSq, XMVector3LengthSq(XMVectorSubtract(position(i), center)));
+
+	bounds._sphereRadius = std::sqrt(XMVectorGetX(radiusSq)) * (1.f + 4.f * FLT_EPSILON);
+	return bounds;
+}
+
+VertexFetchStats MeshOptimizer::AnalyzeVertexFetch(std::span<const std::uint32_t> indices, size_t vertexCount, size_t vertexSize)
+{
+	// 4 KB of 64 byte lines, roughly what a vertex fetch unit gets to itself
+	constexpr size_t lineSize = 64u;
+	constexpr std::uint32_t cacheLines = 64u;
+
+	VertexFetchStats stats;
+	if (indices.empty())
+		return stats;
+
+	std::vector<std::uint32_t> lineTime((vertexCount * vertexSize + lineSize - 1u) / lineSize, 0u);
+	std::uint32_t now = cacheLines + 1u;
+
+	std::vector<bool> referenced(vertexCount, false);
+	size_t uniqueCount = 0u;
+
+	for (auto index : indices)
+	{
+		assert(index < vertexCount);
+		if (!referenced[index])
+		{
+			referenced[index] = true;
+			uniqueCount++;
+		}
+
+		size_t first = index * vertexSize / lineSize;
+		size_t last = (index * vertexSize + vertexSize - 1u) / lineSize;
+		for (size_t line = first; line <= last; line++)
+		{
+			if (now - lineTime[line] > cacheLines)
+			{
+				lineTime[line] = now++;
+				stats._bytesFetched += lineSize;
+			}
+		}
+	}
+
+	stats._overfetch = static_cast<float>(stats._bytesFetched) / static_cast<float>(uniqueCount * vertexSize);
+	return stats;
+}
+
+OverdrawStats MeshOptimizer::AnalyzeOverdraw(std::span<const std::uint32_t> indices, std::span<const GeometryGenerator::Vertex> vertices)
+{
+	constexpr int grid = 256;
+
+	OverdrawStats stats;
+	if (indices.empty())
+		return stats;
+
+	Float3 boundsMin(FLT_MAX, FLT_MAX, FLT_MAX);
+	Float3 boundsMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	for (auto index : indices)
+	{
+		const auto& p = vertices[index].Position;
+		boundsMin = { std::min(boundsMin.x, p.x), std::min(boundsMin.y, p.y), std::min(boundsMin.z, p.z) };
+		boundsMax = { std::max(boundsMax.x, p.x), std::max(boundsMax.y, p.y), std::max(boundsMax.z, p.z) };
+	}
+
+	std::vector<float> depth(grid * grid);
+	float overdrawSum = 0.f;
+	int viewCount = 0;
+
+	for (size_t axis = 0; axis < 3u; axis++)
+	{
+		const size_t u = (axis + 1u) % 3u;
+		const size_t v = (axis + 2u) % 3u;
+
+		float extentU = boundsMax[u] - boundsMin[u];
+		float extentV = boundsMax[v] - boundsMin[v];
+		float scaleU = extentU > 0.f ? (grid - 1) / extentU : 0.f;
+		float scaleV = extentV > 0.f ? (grid - 1) / extentV : 0.f;
+
+		for (float sign : { 1.f, -1.f })
+		{
+			std::fill(depth.begin(), depth.end(), FLT_MAX);
+			size_t shaded = 0u;
+
+			for (size_t t = 0; t + 2 < indices.size(); t += 3)
+			{
+				Float3 p[3] = { vertices[indices[t]].Position, vertices[indices[t + 1]].Position, vertices[indices[t + 2]].Position };
+
+				// Looking down +sign along the axis, back faces have their outward normal pointing the same way
+				Float3 n = Cross(p[1] - p[0], p[2] - p[0]);
+				if (n[axis] * sign >= 0.f)
+					continue;
+
+				float x[3], y[3], z[3];
+				for (int k = 0; k < 3; k++)
+				{
+					x[k] = (p[k][u] - boundsMin[u]) * scaleU;
+					y[k] = (p[k][v] - boundsMin[v]) * scaleV;
+					z[k] = p[k][axis] * sign;
+				}
+
+				float area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+				if (area == 0.f)
+					continue;
+				float invArea = 1.f / area;
+
+				int minX = std::max(0, static_cast<int>(std::floor(std::min({ x[0], x[1], x[2] }))));
+				int maxX = std::min(grid - 1, static_cast<int>(std::ceil(std::max({ x[0], x[1], x[2] }))));
+				int minY = std::max(0, static_cast<int>(std::floor(std::min({ y[0], y[1], y[2] }))));
+				int maxY = std::min(grid - 1, static_cast<int>(std::ceil(std::max({ y[0], y[1], y[2] }))));
+
+				for (int py = minY; py <= maxY; py++)
+				{
+					for (int px = minX; px <= maxX; px++)
+					{
+						float sx = px + 0.5f;
+						float sy = py + 0.5f;
+
+						// Barycentrics normalized by the signed area so both screen windings rasterize
+						float w0 = ((x[2] - x[1]) * (sy - y[1]) - (y[2] - y[1]) * (sx - x[1])) * invArea;
+						float w1 = ((x[0] - x[2]) * (sy - y[2]) - (y[0] - y[2]) * (sx - x[2])) * invArea;
+						float w2 = 1.f - w0 - w1;
+						if (w0 < 0.f || w1 < 0.f || w2 < 0.f)
+							continue;
+
+						float d = w0 * z[0] + w1 * z[1] + w2 * z[2];
+						float& stored = depth[py * grid + px];
+						if (d < stored)
+						{
+							stored = d;
+							shaded++;
+						}
+					}
+				}
+			}
+
+			size_t covered = std::count_if(depth.begin(), depth.end(), [](float d) { return d != FLT_MAX; });
+			stats._pixelsCovered += covered;
+			stats._pixelsShaded += shaded;
+
+			if (covered > 0u)
+			{
+				overdrawSum += static_cast<float>(shaded) / static_cast<float>(covered);
+				viewCount++;
+			}
+		}
+	}
+
+	stats._overdraw = viewCount > 0 ? overdrawSum / viewCount : 0.f;
+	return stats;
+}
+
+std::vector<std::uint32_t> MeshOptimizer::Simplify(std::span<const std::uint32_t> indices, std::span<const GeometryGenerator::Vertex> vertices,
+	size_t targetIndexCount, float* resultError)
+{
+	assert(indices.size() % 3u == 0u);
+
+	const size_t vertexCount = vertices.size();
+	std::vector<std::uint32_t> result(indices.begin(), indices.end());
+	float maxError = 0.f;
+
+	auto position = [&](std::uint32_t v) { return Float3(vertices[v].Position); };
+
+	// Wedges sharing a position are welded so collapses see the surface rather than the attribute splits
+	std::vector<std::uint32_t> canonical(vertexCount);
+	std::vector<std::uint32_t> wedgeCount(vertexCount, 0u);
+	{
+		std::vector<bool> referenced(vertexCount, false);
+		for (auto index : indices)
+			referenced[index] = true;
+
+		std::vector<std::uint32_t> sorted(vertexCount);
+		for (std::uint32_t v = 0; v < vertexCount; v++)
+			sorted[v] = v;
+
+		auto less = [&](std::uint32_t a, std::uint32_t b)
+		{
+			const auto& pa = vertices[a].Position;
+			const auto& pb = vertices[b].Position;
+			if (pa.x != pb.x) return pa.x < pb.x;
+			if (pa.y != pb.y) return pa.y < pb.y;
+			return pa.z < pb.z;
+		};
+		std::sort(sorted.begin(), sorted.end(), less);
+
+		for (size_t i = 0; i < vertexCount; )
+		{
+			size_t end = i + 1;
+			while (end < vertexCount && !less(sorted[i], sorted[end]))
+				end++;
+
+			std::uint32_t first = *std::min_element(sorted.begin() + i, sorted.begin() + end);
+			for (size_t j = i; j < end; j++)
+			{
+				canonical[sorted[j]] = first;
+				wedgeCount[first] += referenced[sorted[j]] ? 1u : 0u;
+			}
+			i = end;
+		}
+	}
+
+	// Border and seam vertices are locked, moving them would open cracks or smear attributes across the seam
+	std::vector<bool> locked(vertexCount, false);
+	for (std::uint32_t v = 0; v < vertexCount; v++)
+		locked[v] = wedgeCount[canonical[v]] > 1u;
+	{
+		std::vector<std::uint64_t> edges;
+		edges.reserve(indices.size());
+		for (size_t i = 0; i < indices.size(); i += 3)
+			for (size_t e = 0; e < 3u; e++)
+			{
+				std::uint64_t a = canonical[indices[i + e]];
+				std::uint64_t b = canonical[indices[i + (e + 1) % 3]];
+				edges.push_back((a << 32) | b);
+			}
+		std::sort(edges.begin(), edges.end());
+
+		for (auto edge : edges)
+		{
+			std::uint64_t twin = (edge << 32) | (edge >> 32);
+			if (!std::binary_search(edges.begin(), edges.end(), twin))
+			{
+				locked[edge >> 32] = true;
+				locked[edge & 0xffffffffu] = true;
+			}
+		}
+
+		for (std::uint32_t v = 0; v < vertexCount; v++)
+			locked[v] = locked[v] || locked[canonical[v]];
+	}
+
+	std::vector<Quadric> quadrics(vertexCount);
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		Float3 p0 = position(indices[i]);
+		Float3 n = Cross(position(indices[i + 1]) - p0, position(indices[i + 2]) - p0);
+		float length = std::sqrt(Dot(n, n));
+		if (length == 0.f)
+			continue;
+
+		n = n * (1.f / length);
+		Quadric q;
+		q.AddPlane(n, -Dot(n, p0), 0.5 * length);
+		for (size_t k = 0; k < 3u; k++)
+			quadrics[canonical[indices[i + k]]].Add(q);
+	}
+
+	auto collapseError = [&](std::uint32_t from, std::uint32_t to)
+	{
+		Quadric q = quadrics[canonical[from]];
+		q.Add(quadrics[canonical[to]]);
+		return q._weight > 0.0 ? static_cast<float>(q.Evaluate(position(to)) / q._weight) : 0.f;
+	};
+
+	std::vector<Collapse> collapses;
+	std::vector<std::uint32_t> remap(vertexCount);
+	std::vector<bool> touched(vertexCount);
+
+	// Each pass collapses an independent set of the cheapest edges, then rebuilds adjacency
+	while (result.size() > targetIndexCount)
+	{
+		TriangleAdjacency adjacency(result, vertexCount);
+
+		collapses.clear();
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			for (size_t e = 0; e < 3u; e++)
+			{
+				std::uint32_t a = result[i + e];
+				std::uint32_t b = result[i + (e + 1) % 3];
+
+				// Edges that can collapse are interior and show up once per direction, keep one
+				if (canonical[a] > canonical[b])
+					continue;
+
+				float errorAB = locked[a] ? FLT_MAX : collapseError(a, b);
+				float errorBA = locked[b] ? FLT_MAX : collapseError(b, a);
+				if (errorAB == FLT_MAX && errorBA == FLT_MAX)
+					continue;
+
+				collapses.push_back(errorAB <= errorBA ? Collapse{ errorAB, a, b } : Collapse{ errorBA, b, a });
+			}
+		}
+
+		if (collapses.empty())
+			break;
+
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a._error < b._error; });
+
+		for (std::uint32_t v = 0; v < vertexCount; v++)
+			remap[v] = v;
+		std::fill(touched.begin(), touched.end(), false);
+
+		const size_t trianglesToRemove = (result.size() - targetIndexCount) / 3u;
+		size_t removed = 0u;
+		size_t applied = 0u;
+
+		for (const auto& c : collapses)
+		{
+			if (removed >= trianglesToRemove)
+				break;
+			if (touched[canonical[c._from]] || touched[canonical[c._to]])
+				continue;
+
+			// Reject collapses that fold a remaining triangle over
+			Float3 target = position(c._to);
+			bool flips = false;
+			size_t collapsing = 0u;
+			for (auto o = adjacency._offsets[c._from]; o < adjacency._offsets[c._from + 1]; o++)
+			{
+				const std::uint32_t* tri = &result[adjacency._triangles[o] * 3];
+				const std::uint32_t to = canonical[c._to];
+				if (canonical[tri[0]] == to || canonical[tri[1]] == to || canonical[tri[2]] == to)
+				{
+					collapsing++;
+					continue;
+				}
+
+				Float3 p[3] = { position(tri[0]), position(tri[1]), position(tri[2]) };
+				Float3 before = Cross(p[1] - p[0], p[2] - p[0]);
+				for (size_t k = 0; k < 3u; k++)
+					if (tri[k] == c._from)
+						p[k] = target;
+				Float3 after = Cross(p[1] - p[0], p[2] - p[0]);
+
+				if (Dot(before, after) <= 0.25f * std::sqrt(Dot(before, before) * Dot(after, after)))
+				{
+					flips = true;
+					break;
+				}
+			}
+			if (flips)
+				continue;
+
+			remap[c._from] = c._to;
+			quadrics[canonical[c._to]].Add(quadrics[canonical[c._from]]);
+			maxError = std::max(maxError, c._error);
+
+			// Lock the whole one-ring for the rest of the pass so the flip test above stays valid
+			for (auto o = adjacency._offsets[c._from]; o < adjacency._offsets[c._from + 1]; o++)
+				for (size_t k = 0; k < 3u; k++)
+					touched[canonical[result[adjacency._triangles[o] * 3 + k]]] = true;
+
+			removed += collapsing;
+			applied++;
+		}
+
+		if (applied == 0u)
+			break;
+
+		size_t write = 0u;
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			std::uint32_t a = remap[result[i]];
+			std::uint32_t b = remap[result[i + 1]];
+			std::uint32_t c = remap[result[i + 2]];
+
+			if (canonical[a] == canonical[b] || canonical[b] == canonical[c] || canonical[a] == canonical[c])
+				continue;
+
+			result[write++] = a;
+			result[write++] = b;
+			result[write++] = c;
+		}
+		result.resize(write);
+	}
+
+	if (resultError)
+		*resultError = std::sqrt(maxError);
+
+	return result;
+}
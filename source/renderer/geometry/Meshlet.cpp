@@ -0,0 +1,191 @@
+#include "../../../include/sasha/renderer/geometry/Meshlet.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace
+{
+	constexpr std::uint8_t kNotInMeshlet = 0xff;
+
+	// Below this the normals spread over more than ~84 degrees and the cone would almost never cull
+	constexpr float kMinConeDot = 0.1f;
+
+	void ComputeBounds(MeshletTable& table, std::span<const GeometryGenerator::Vertex> vertices)
+	{
+		const size_t m = table.GetCount() - 1u;
+		const std::uint32_t* local = &table._vertices[table._vertexOffsets[m]];
+		const std::uint8_t* triangles = &table._triangles[table._triangleOffsets[m]];
+
+		auto position = [&](std::uint8_t i) { return XMLoadFloat3(&vertices[local[i]].Position); };
+
+		XMVECTOR boundsMin = position(0);
+		XMVECTOR boundsMax = boundsMin;
+		for (std::uint8_t i = 1; i < table._vertexCounts[m]; i++)
+		{
+			boundsMin = XMVectorMin(boundsMin, position(i));
+			boundsMax = XMVectorMax(boundsMax, position(i));
+		}
+
+		XMVECTOR center = XMVectorScale(XMVectorAdd(boundsMin, boundsMax), 0.5f);
+		XMVECTOR radius = XMVectorZero();
+		for (std::uint8_t i = 0; i < table._vertexCounts[m]; i++)
+			radius = XMVectorMax(radius, XMVector3Length(XMVectorSubtract(position(i), center)));
+
+		XMFLOAT4 sphere;
+		XMStoreFloat4(&sphere, XMVectorSetW(center, XMVectorGetX(radius)));
+		table._spheres.push_back(sphere);
+
+		// Cone axis is the average of the unit face normals, degenerate triangles don't vote
+		XMVECTOR normals[MeshletTable::MaxTriangles];
+		bool valid[MeshletTable::MaxTriangles];
+		XMVECTOR axis = XMVectorZero();
+		for (std::uint8_t t = 0; t < table._triangleCounts[m]; t++)
+		{
+			XMVECTOR p0 = position(triangles[t * 3]);
+			XMVECTOR n = XMVector3Cross(XMVectorSubtract(position(triangles[t * 3 + 1]), p0), XMVectorSubtract(position(triangles[t * 3 + 2]), p0));
+			valid[t] = XMVectorGetX(XMVector3LengthSq(n)) > 0.f;
+			normals[t] = valid[t] ? XMVector3Normalize(n) : XMVectorZero();
+			axis = XMVectorAdd(axis, normals[t]);
+		}
+
+		float axisLength = XMVectorGetX(XMVector3Length(axis));
+		axis = axisLength > 0.f ? XMVectorScale(axis, 1.f / axisLength) : XMVectorSet(0.f, 0.f, 1.f, 0.f);
+
+		float minDot = axisLength > 0.f ? 1.f : -1.f;
+		for (std::uint8_t t = 0; t < table._triangleCounts[m]; t++)
+			if (valid[t])
+				minDot = std::min<float>(minDot, XMVectorGetX(XMVector3Dot(normals[t], axis)));
+
+		XMFLOAT4 cone;
+		XMFLOAT3 apex;
+		XMStoreFloat3(&apex, center);
+		if (minDot <= kMinConeDot)
+		{
+			XMStoreFloat4(&cone, XMVectorSetW(axis, 1.f));
+		}
+		else
+		{
+			// Slide the apex back along the axis until it sits behind every triangle's plane,
+			// then any eye inside the cone's mirror sees all of them from behind
+			float maxT = 0.f;
+			for (std::uint8_t t = 0; t < table._triangleCounts[m]; t++)
+			{
+				if (!valid[t])
+					continue;
+
+				float dc = XMVectorGetX(XMVector3Dot(XMVectorSubtract(center, position(triangles[t * 3])), normals[t]));
+				float dn = XMVectorGetX(XMVector3Dot(axis, normals[t]));
+				maxT = std::max<float>(maxT, dc / dn);
+			}
+
+			XMStoreFloat3(&apex, XMVectorSubtract(center, XMVectorScale(axis, maxT)));
+			XMStoreFloat4(&cone, XMVectorSetW(axis, std::sqrt(1.f - minDot * minDot)));
+		}
+
+		table._cones.push_back(cone);
+		table._coneApexes.push_back(apex);
+	}
+}
+
+MeshletTable MeshletTable::Build(std::span<const std::uint32_t> indices, std::span<const GeometryGenerator::Vertex> vertices)
+{
+	assert(indices.size() % 3u == 0u);
+
+	MeshletTable table;
+	table._vertices.reserve(indices.size() / 2u);
+	table._triangles.reserve(indices.size());
+
+	std::vector<std::uint8_t> localIndex(vertices.size(), kNotInMeshlet);
+	std::uint32_t vertexOffset = 0u;
+	std::uint32_t triangleOffset = 0u;
+
+	auto flush = [&]()
+	{
+		auto vertexCount = static_cast<std::uint32_t>(table._vertices.size()) - vertexOffset;
+		auto triangleCount = (static_cast<std::uint32_t>(table._triangles.size()) - triangleOffset) / 3u;
+		if (triangleCount == 0u)
+			return;
+
+		table._vertexOffsets.push_back(vertexOffset);
+		table._triangleOffsets.push_back(triangleOffset);
+		table._vertexCounts.push_back(static_cast<std::uint8_t>(vertexCount));
+		table._triangleCounts.push_back(static_cast<std::uint8_t>(triangleCount));
+
+		for (size_t i = vertexOffset; i < table._vertices.size(); i++)
+			localIndex[table._vertices[i]] = kNotInMeshlet;
+
+		ComputeBounds(table, vertices);
+
+		vertexOffset = static_cast<std::uint32_t>(table._vertices.size());
+		triangleOffset = static_cast<std::uint32_t>(table._triangles.size());
+	};
+
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		const std::uint32_t a = indices[i];
+		const std::uint32_t b = indices[i + 1];
+		const std::uint32_t c = indices[i + 2];
+
+		std::uint32_t newVertices = (localIndex[a] == kNotInMeshlet)
+			+ (localIndex[b] == kNotInMeshlet && b != a)
+			+ (localIndex[c] == kNotInMeshlet && c != a && c != b);
+
+		auto vertexCount = static_cast<std::uint32_t>(table._vertices.size()) - vertexOffset;
+		auto triangleCount = (static_cast<std::uint32_t>(table._triangles.size()) - triangleOffset) / 3u;
+		if (vertexCount + newVertices > MaxVertices || triangleCount + 1u > MaxTriangles)
+			flush();
+
+		for (auto v : { a, b, c })
+		{
+			if (localIndex[v] == kNotInMeshlet)
+			{
+				localIndex[v] = static_cast<std::uint8_t>(table._vertices.size() - vertexOffset);
+				table._vertices.push_back(v);
+			}
+			table._triangles.push_back(localIndex[v]);
+		}
+	}
+	flush();
+
+	return table;
+}
+
+std::uint32_t MeshletTable::Append(const MeshletTable& other, std::uint32_t baseVertex)
+{
+	const auto first = static_cast<std::uint32_t>(GetCount());
+	const auto vertexBase = static_cast<std::uint32_t>(_vertices.size());
+	const auto triangleBase = static_cast<std::uint32_t>(_triangles.size());
+
+	for (auto offset : other._vertexOffsets)
+		_vertexOffsets.push_back(vertexBase + offset);
+	for (auto offset : other._triangleOffsets)
+		_triangleOffsets.push_back(triangleBase + offset);
+
+	_vertexCounts.insert(_vertexCounts.end(), other._vertexCounts.begin(), other._vertexCounts.end());
+	_triangleCounts.insert(_triangleCounts.end(), other._triangleCounts.begin(), other._triangleCounts.end());
+	_spheres.insert(_spheres.end(), other._spheres.begin(), other._spheres.end());
+	_cones.insert(_cones.end(), other._cones.begin(), other._cones.end());
+	_coneApexes.insert(_coneApexes.end(), other._coneApexes.begin(), other._coneApexes.end());
+
+	for (auto v : other._vertices)
+		_vertices.push_back(baseVertex + v);
+	_triangles.insert(_triangles.end(), other._triangles.begin(), other._triangles.end());
+
+	return first;
+}
+
+bool MeshletTable::IsBackfacing(size_t meshlet, const XMFLOAT3& eye) const noexcept
+{
+	const auto& cone = _cones[meshlet];
+	if (cone.w >= 1.f)
+		return false;
+
+	XMVECTOR view = XMVectorSubtract(XMLoadFloat3(&_coneApexes[meshlet]), XMLoadFloat3(&eye));
+	float length = XMVectorGetX(XMVector3Length(view));
+	if (length == 0.f)
+		return false;
+
+	return XMVectorGetX(XMVector3Dot(view, XMLoadFloat4(&cone))) >= cone.w * length;
+}
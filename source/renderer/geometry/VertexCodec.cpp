@@ -0,0 +1,203 @@
+#include "../../../include/sasha/renderer/geometry/VertexCodec.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace
+{
+	std::uint16_t QuantizeUnorm16(float v) noexcept
+	{
+		return static_cast<std::uint16_t>(std::lround(std::clamp(v, 0.f, 1.f) * 65535.f));
+	}
+
+	std::int16_t QuantizeSnorm16(float v) noexcept
+	{
+		return static_cast<std::int16_t>(std::lround(std::clamp(v, -1.f, 1.f) * 32767.f));
+	}
+
+	// Same as D3D's SNORM conversion: -32768 and -32767 both map to -1
+	float DequantizeSnorm16(std::int16_t v) noexcept
+	{
+		return std::max(v / 32767.f, -1.f);
+	}
+
+	float SignNotZero(float v) noexcept
+	{
+		return v >= 0.f ? 1.f : -1.f;
+	}
+}
+
+QuantizationBounds QuantizationBounds::FromMinMax(const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax) noexcept
+{
+	QuantizationBounds bounds;
+	bounds._min = boundsMin;
+	bounds._extent = { boundsMax.x - boundsMin.x, boundsMax.y - boundsMin.y, boundsMax.z - boundsMin.z };
+	return bounds;
+}
+
+void VertexCodec::EncodePosition(const XMFLOAT3& p, const QuantizationBounds& bounds, std::uint16_t out[4]) noexcept
+{
+	// Flat meshes have a zero extent on one axis, everything lands on _min there
+	auto quantize = [](float v, float lo, float extent) { return extent > 0.f ? QuantizeUnorm16((v - lo) / extent) : std::uint16_t{ 0 }; };
+
+	out[0] = quantize(p.x, bounds._min.x, bounds._extent.x);
+	out[1] = quantize(p.y, bounds._min.y, bounds._extent.y);
+	out[2] = quantize(p.z, bounds._min.z, bounds._extent.z);
+	out[3] = 65535u;
+}
+
+XMFLOAT3 VertexCodec::DecodePosition(const std::uint16_t in[4], const QuantizationBounds& bounds) noexcept
+{
+	return {
+		bounds._min.x + DecodeUnorm16(in[0]) * bounds._extent.x,
+		bounds._min.y + DecodeUnorm16(in[1]) * bounds._extent.y,
+		bounds._min.z + DecodeUnorm16(in[2]) * bounds._extent.z,
+	};
+}
+
+void VertexCodec::EncodeNormal(const XMFLOAT3& n, std::int16_t out[2]) noexcept
+{
+	float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+	if (l1 == 0.f)
+	{
+		out[0] = out[1] = 0;
+		return;
+	}
+
+	float x = n.x / l1;
+	float y = n.y / l1;
+
+	// The lower hemisphere folds over the diagonals onto the outer triangles of the square
+	if (n.z < 0.f)
+	{
+		float fx = (1.f - std::abs(y)) * SignNotZero(x);
+		float fy = (1.f - std::abs(x)) * SignNotZero(y);
+		x = fx;
+		y = fy;
+	}
+
+	out[0] = QuantizeSnorm16(x);
+	out[1] = QuantizeSnorm16(y);
+}
+
+XMFLOAT3 VertexCodec::DecodeNormal(const std::int16_t in[2]) noexcept
+{
+	float x = DequantizeSnorm16(in[0]);
+	float y = DequantizeSnorm16(in[1]);
+	float z = 1.f - std::abs(x) - std::abs(y);
+
+	if (z < 0.f)
+	{
+		float fx = (1.f - std::abs(y)) * SignNotZero(x);
+		float fy = (1.f - std::abs(x)) * SignNotZero(y);
+		x = fx;
+		y = fy;
+	}
+
+	float length = std::sqrt(x * x + y * y + z * z);
+	return { x / length, y / length, z / length };
+}
+
+std::uint16_t VertexCodec::EncodeHalf(float f) noexcept
+{
+	constexpr std::uint32_t infinity = 255u << 23;
+	constexpr std::uint32_t halfMax = (127u + 16u) << 23;
+	constexpr std::uint32_t denormMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+	std::uint32_t u = std::bit_cast<std::uint32_t>(f);
+	const std::uint32_t sign = u & 0x80000000u;
+	u ^= sign;
+
+	std::uint16_t h;
+	if (u >= halfMax)
+	{
+		// Too large becomes infinity, NaN stays a quiet NaN
+		h = u > infinity ? 0x7e00u : 0x7c00u;
+	}
+	else if (u < (113u << 23))
+	{
+		// Denormal half, let the FPU do the rounding by aligning the mantissa with a magic add
+		float shifted = std::bit_cast<float>(u) + std::bit_cast<float>(denormMagic);
+		h = static_cast<std::uint16_t>(std::bit_cast<std::uint32_t>(shifted) - denormMagic);
+	}
+	else
+	{
+		// Rebias the exponent and round to nearest even on the 13 dropped mantissa bits
+		std::uint32_t mantissaOdd = (u >> 13) & 1u;
+		u += (static_cast<std::uint32_t>(15 - 127) << 23) + 0xfffu;
+		u += mantissaOdd;
+		h = static_cast<std::uint16_t>(u >> 13);
+	}
+
+	return static_cast<std::uint16_t>(h | (sign >> 16));
+}
+
+float VertexCodec::DecodeHalf(std::uint16_t h) noexcept
+{
+	constexpr std::uint32_t shiftedExponent = 0x7c00u << 13;
+	constexpr std::uint32_t magic = 113u << 23;
+
+	std::uint32_t u = (h & 0x7fffu) << 13;
+	const std::uint32_t exponent = u & shiftedExponent;
+	u += (127u - 15u) << 23;
+
+	if (exponent == shiftedExponent)
+	{
+		// Infinity or NaN
+		u += (128u - 16u) << 23;
+	}
+	else if (exponent == 0u)
+	{
+		// Zero or denormal, renormalize through the FPU
+		u += 1u << 23;
+		u = std::bit_cast<std::uint32_t>(std::bit_cast<float>(u) - std::bit_cast<float>(magic));
+	}
+
+	u |= static_cast<std::uint32_t>(h & 0x8000u) << 16;
+	return std::bit_cast<float>(u);
+}
+
+std::uint16_t VertexCodec::EncodeUnorm16(float f) noexcept
+{
+	return QuantizeUnorm16(f);
+}
+
+float VertexCodec::DecodeUnorm16(std::uint16_t u) noexcept
+{
+	return u / 65535.f;
+}
+
+CompactVertex VertexCodec::Encode(const XMFLOAT3& pos, const XMFLOAT3& normal, const XMFLOAT2& tex,
+	const QuantizationBounds& bounds, TexCoordEncoding texEncoding) noexcept
+{
+	CompactVertex v;
+	EncodePosition(pos, bounds, v.Pos);
+	EncodeNormal(normal, v.Normal);
+
+	if (texEncoding == TexCoordEncoding::Half)
+	{
+		v.Tex[0] = EncodeHalf(tex.x);
+		v.Tex[1] = EncodeHalf(tex.y);
+	}
+	else
+	{
+		v.Tex[0] = EncodeUnorm16(tex.x);
+		v.Tex[1] = EncodeUnorm16(tex.y);
+	}
+
+	return v;
+}
+
+void VertexCodec::Decode(const CompactVertex& v, const QuantizationBounds& bounds, TexCoordEncoding texEncoding,
+	XMFLOAT3& pos, XMFLOAT3& normal, XMFLOAT2& tex) noexcept
+{
+	pos = DecodePosition(v.Pos, bounds);
+	normal = DecodeNormal(v.Normal);
+
+	if (texEncoding == TexCoordEncoding::Half)
+		tex = { DecodeHalf(v.Tex[0]), DecodeHalf(v.Tex[1]) };
+	else
+		tex = { DecodeUnorm16(v.Tex[0]), DecodeUnorm16(v.Tex[1]) };
+}
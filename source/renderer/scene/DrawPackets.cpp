@@ -0,0 +1,140 @@
+#include "../../../include/sasha/renderer/scene/DrawPackets.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+namespace
+{
+	constexpr std::uint32_t kLayerBits = 2u;
+
+	// Digits of up to 12 bits keep each histogram at 16 KB, so the few a key needs stay in L1
+	constexpr std::uint32_t kMaxRadixBits = 12u;
+	constexpr std::uint32_t kMaxRadixPasses = (64u + kMaxRadixBits - 1u) / kMaxRadixBits;
+
+	std::uint32_t GetFieldBits(size_t count) noexcept
+	{
+		return count > 1u ? static_cast<std::uint32_t>(std::bit_width(count - 1u)) : 0u;
+	}
+
+	std::uint64_t QuantizeDepth(float depth, std::uint32_t bits) noexcept
+	{
+		const std::uint64_t maxDepth = (1ull << bits) - 1u;
+		// Written so NaN ends up at 0
+		if (!(depth > 0.f))
+			return 0u;
+		if (depth >= 1.f)
+			return maxDepth;
+		return static_cast<std::uint64_t>(depth * static_cast<float>(maxDepth));
+	}
+}
+
+DrawKeyLayout DrawKeyLayout::FromCounts(size_t pipelineCount, size_t materialCount, size_t submeshCount, size_t itemCount) noexcept
+{
+	DrawKeyLayout layout;
+	layout._pipelineBits = GetFieldBits(pipelineCount);
+	layout._materialBits = GetFieldBits(materialCount);
+	layout._submeshBits = GetFieldBits(submeshCount);
+	layout._itemBits = GetFieldBits(itemCount);
+
+	const std::uint32_t usedBits = kLayerBits + layout.GetStateBits() + layout._itemBits;
+	assert(usedBits <= 64u);
+	layout._depthBits = std::min(kMaxDepthBits, 64u - usedBits);
+	return layout;
+}
+
+std::uint64_t DrawKeyLayout::MakePacket(RenderLayer layer, std::uint8_t pipeline, std::uint16_t material, std::uint16_t submesh, float depth, std::uint32_t item) const noexcept
+{
+	assert(std::bit_width(pipeline) <= _pipelineBits && std::bit_width(material) <= _materialBits && std::bit_width(submesh) <= _submeshBits);
+	assert(std::bit_width(item) <= _itemBits);
+
+	const std::uint32_t stateBits = GetStateBits();
+	const std::uint64_t state = (static_cast<std::uint64_t>(pipeline) << (_materialBits + _submeshBits))
+		| (static_cast<std::uint64_t>(material) << _submeshBits)
+		| submesh;
+	const std::uint64_t quantizedDepth = QuantizeDepth(depth, _depthBits);
+
+	std::uint64_t key = static_cast<std::uint64_t>(layer) << (stateBits + _depthBits);
+	if (layer == RenderLayer::Transparent)
+		key |= (((1ull << _depthBits) - 1u - quantizedDepth) << stateBits) | state;
+	else
+		key |= (state << _depthBits) | quantizedDepth;
+
+	return (key << _itemBits) | item;
+}
+
+std::uint32_t DrawKeyLayout::GetItem(std::uint64_t packet) const noexcept
+{
+	return static_cast<std::uint32_t>(packet & ((1ull << _itemBits) - 1u));
+}
+
+RenderLayer DrawKeyLayout::GetLayer(std::uint64_t packet) const noexcept
+{
+	return static_cast<RenderLayer>(packet >> (_itemBits + GetStateBits() + _depthBits));
+}
+
+std::uint64_t DrawKeyLayout::GetState(std::uint64_t packet) const noexcept
+{
+	const std::uint32_t stateBits = GetStateBits();
+	const std::uint64_t key = packet >> _itemBits;
+	const std::uint64_t layer = key >> (stateBits + _depthBits);
+	const std::uint64_t stateMask = (1ull << stateBits) - 1u;
+	if (static_cast<RenderLayer>(layer) == RenderLayer::Transparent)
+		return (layer << stateBits) | (key & stateMask);
+	return (layer << stateBits) | ((key >> _depthBits) & stateMask);
+}
+
+void DrawPackets::RadixSort(std::span<std::uint64_t> packets, std::span<std::uint64_t> scratch, const DrawKeyLayout& layout) noexcept
+{
+	const size_t count = packets.size();
+	assert(scratch.size() >= count);
+	if (count < 2u)
+		return;
+
+	// Spread the key over as few passes as possible, with digits of even width
+	const std::uint32_t keyBits = layout.GetKeyBits();
+	const std::uint32_t passCount = (keyBits + kMaxRadixBits - 1u) / kMaxRadixBits;
+	const std::uint32_t radixBits = (keyBits + passCount - 1u) / passCount;
+	const std::uint64_t radixMask = (1ull << radixBits) - 1u;
+
+	// Every pass' histogram in a single read of the packets
+	std::array<std::array<std::uint32_t, 1u << kMaxRadixBits>, kMaxRadixPasses> histograms;
+	for (std::uint32_t pass = 0; pass < passCount; pass++)
+		std::fill_n(histograms[pass].begin(), radixMask + 1u, 0u);
+	for (const std::uint64_t packet : packets)
+	{
+		const std::uint64_t key = packet >> layout._itemBits;
+		for (std::uint32_t pass = 0; pass < passCount; pass++)
+			histograms[pass][(key >> (radixBits * pass)) & radixMask]++;
+	}
+
+	std::uint64_t* src = packets.data();
+	std::uint64_t* dst = scratch.data();
+	for (std::uint32_t pass = 0; pass < passCount; pass++)
+	{
+		const std::uint32_t shift = layout._itemBits + radixBits * pass;
+		auto& histogram = histograms[pass];
+
+		// The layer and the high state bits are often the same for every packet
+		if (histogram[(src[0] >> shift) & radixMask] == count)
+			continue;
+
+		std::uint32_t offset = 0u;
+		for (std::uint64_t digit = 0; digit <= radixMask; digit++)
+		{
+			const std::uint32_t bucketCount = histogram[digit];
+			histogram[digit] = offset;
+			offset += bucketCount;
+		}
+
+		for (size_t i = 0; i < count; i++)
+			dst[histogram[(src[i] >> shift) & radixMask]++] = src[i];
+
+		std::swap(src, dst);
+	}
+
+	if (src != packets.data())
+		std::memcpy(packets.data(), src, count * sizeof(std::uint64_t));
+}
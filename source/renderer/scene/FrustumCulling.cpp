@@ -0,0 +1,177 @@
+#include "../../../include/sasha/renderer/scene/FrustumCulling.h"
+#include <cassert>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#include <xmmintrin.h>
+#define FRUSTUM_CULLING_SSE
+#endif
+
+using namespace DirectX;
+
+namespace
+{
+	// Same operation order as the SSE path so a sphere gets the same answer in the tail as in a batch
+	bool SphereInside(const Frustum& frustum, float x, float y, float z, float radius) noexcept
+	{
+		for (const auto& plane : frustum._planes)
+		{
+			float distance = plane.x * x + plane.w;
+			distance += plane.y * y;
+			distance += plane.z * z;
+			if (!(distance + radius >= 0.f))
+				return false;
+		}
+		return true;
+	}
+
+#ifdef FRUSTUM_CULLING_SSE
+	struct SsePlanes
+	{
+		__m128 _planes[6][4];
+
+		explicit SsePlanes(const Frustum& frustum) noexcept
+		{
+			for (size_t p = 0; p < 6u; p++)
+			{
+				_planes[p][0] = _mm_set1_ps(frustum._planes[p].x);
+				_planes[p][1] = _mm_set1_ps(frustum._planes[p].y);
+				_planes[p][2] = _mm_set1_ps(frustum._planes[p].z);
+				_planes[p][3] = _mm_set1_ps(frustum._planes[p].w);
+			}
+		}
+
+		// Bit i is set when sphere i of the four touches the frustum
+		int Test(__m128 x, __m128 y, __m128 z, __m128 radius) const noexcept
+		{
+			const __m128 zero = _mm_setzero_ps();
+			__m128 inside = _mm_cmpeq_ps(zero, zero);
+			for (size_t p = 0; p < 6u; p++)
+			{
+				__m128 distance = _mm_add_ps(_mm_mul_ps(_planes[p][0], x), _planes[p][3]);
+				distance = _mm_add_ps(distance, _mm_mul_ps(_planes[p][1], y));
+				distance = _mm_add_ps(distance, _mm_mul_ps(_planes[p][2], z));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+			}
+			return _mm_movemask_ps(inside);
+		}
+	};
+
+	// Every lane is written and the count only advances past visible ones, so there is no branch per sphere
+	void AppendVisible(int mask, size_t first, std::span<std::uint32_t> visible, size_t& visibleCount) noexcept
+	{
+		for (std::uint32_t lane = 0; lane < 4u; lane++)
+		{
+			visible[visibleCount] = static_cast<std::uint32_t>(first) + lane;
+			visibleCount += (mask >> lane) & 1;
+		}
+	}
+#endif
+}
+
+Frustum Frustum::FromViewProj(FXMMATRIX viewProj) noexcept
+{
+	XMFLOAT4X4 m;
+	XMStoreFloat4x4(&m, viewProj);
+
+	// Clip space coordinates are v * M, so each bound is a combination of M's columns
+	auto column = [&](int c) { return XMVectorSet(m.m[0][c], m.m[1][c], m.m[2][c], m.m[3][c]); };
+	const XMVECTOR x = column(0);
+	const XMVECTOR y = column(1);
+	const XMVECTOR z = column(2);
+	const XMVECTOR w = column(3);
+
+	const XMVECTOR planes[6] =
+	{
+		XMVectorAdd(w, x),      // -w <= x
+		XMVectorSubtract(w, x), //  x <= w
+		XMVectorAdd(w, y),      // -w <= y
+		XMVectorSubtract(w, y), //  y <= w
+		z,                      //  0 <= z
+		XMVectorSubtract(w, z), //  z <= w
+	};
+
+	Frustum frustum;
+	for (size_t i = 0; i < 6u; i++)
+	{
+		// Normalizing by the normal's length makes plane.w a distance, which the sphere radius is compared against
+		float length = XMVectorGetX(XMVector3Length(planes[i]));
+		XMStoreFloat4(&frustum._planes[i], XMVectorScale(planes[i], length > 0.f ? 1.f / length : 0.f));
+	}
+
+	return frustum;
+}
+
+void CullingSpheres::Resize(size_t count)
+{
+	_centerX.resize(count);
+	_centerY.resize(count);
+	_centerZ.resize(count);
+	_radius.resize(count);
+}
+
+void CullingSpheres::Set(size_t index, const XMFLOAT3& center, float radius) noexcept
+{
+	_centerX[index] = center.x;
+	_centerY[index] = center.y;
+	_centerZ[index] = center.z;
+	_radius[index] = radius;
+}
+
+size_t FrustumCulling::CullSpheres(const Frustum& frustum, const CullingSpheres& spheres, std::span<std::uint32_t> visible) noexcept
+{
+	const size_t count = spheres.GetCount();
+	assert(visible.size() >= count);
+
+	size_t visibleCount = 0u;
+	size_t i = 0u;
+
+#ifdef FRUSTUM_CULLING_SSE
+	const SsePlanes planes(frustum);
+	for (; i + 4u <= count; i += 4u)
+	{
+		const int mask = planes.Test(_mm_loadu_ps(&spheres._centerX[i]), _mm_loadu_ps(&spheres._centerY[i]),
+			_mm_loadu_ps(&spheres._centerZ[i]), _mm_loadu_ps(&spheres._radius[i]));
+		AppendVisible(mask, i, visible, visibleCount);
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		visible[visibleCount] = static_cast<std::uint32_t>(i);
+		visibleCount += SphereInside(frustum, spheres._centerX[i], spheres._centerY[i], spheres._centerZ[i], spheres._radius[i]) ? 1u : 0u;
+	}
+
+	return visibleCount;
+}
+
+size_t FrustumCulling::CullSpheres(const Frustum& frustum, std::span<const XMFLOAT4> spheres, std::span<std::uint32_t> visible) noexcept
+{
+	const size_t count = spheres.size();
+	assert(visible.size() >= count);
+
+	size_t visibleCount = 0u;
+	size_t i = 0u;
+
+#ifdef FRUSTUM_CULLING_SSE
+	const SsePlanes planes(frustum);
+	for (; i + 4u <= count; i += 4u)
+	{
+		// Rows of four spheres become columns of four x, y, z and radii
+		__m128 x = _mm_loadu_ps(&spheres[i].x);
+		__m128 y = _mm_loadu_ps(&spheres[i + 1u].x);
+		__m128 z = _mm_loadu_ps(&spheres[i + 2u].x);
+		__m128 radius = _mm_loadu_ps(&spheres[i + 3u].x);
+		_MM_TRANSPOSE4_PS(x, y, z, radius);
+		AppendVisible(planes.Test(x, y, z, radius), i, visible, visibleCount);
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		visible[visibleCount] = static_cast<std::uint32_t>(i);
+		visibleCount += SphereInside(frustum, spheres[i].x, spheres[i].y, spheres[i].z, spheres[i].w) ? 1u : 0u;
+	}
+
+	return visibleCount;
+}
@@ -0,0 +1,294 @@
+#include "../../../include/sasha/renderer/scene/LightClusters.h"
+#include "../../../include/sasha/utility/Parallel.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define LIGHT_CLUSTERS_SSE
+#endif
+
+using namespace DirectX;
+
+namespace
+{
+	// Slice bounds are widened by this much so a pixel right on a slice boundary still finds the light,
+	// the shader's log2 and the boundaries here round differently
+	constexpr float kSliceEpsilon = 1e-4f;
+	// Lights boxed per job, in groups of four
+	constexpr size_t kMinLightGroupsPerRange = 256u;
+
+	struct ClusterBox
+	{
+		std::int32_t _minX, _maxX, _minY, _maxY, _minZ, _maxZ;
+	};
+
+	std::int32_t SliceOf(const ClusterGrid& grid, float z) noexcept
+	{
+		std::int32_t slice = 0;
+		for (std::uint32_t k = 1; k < ClusterGrid::kSlices; k++)
+			slice += z >= grid._sliceStarts[k] ? 1 : 0;
+		return slice;
+	}
+
+	std::int32_t TileOf(float position, float tileCount) noexcept
+	{
+		return static_cast<std::int32_t>(std::clamp(position * tileCount, 0.f, tileCount - 1.f));
+	}
+
+	// Same operation order as the SSE path so a light gets the same box in the tail as in a group
+	ClusterBox BoxLight(const ClusterGrid& grid, const XMFLOAT4X4& view, float x, float y, float z, float radius) noexcept
+	{
+		const float vx = x * view.m[0][0] + y * view.m[1][0] + z * view.m[2][0] + view.m[3][0];
+		const float vy = x * view.m[0][1] + y * view.m[1][1] + z * view.m[2][1] + view.m[3][1];
+		const float vz = x * view.m[0][2] + y * view.m[1][2] + z * view.m[2][2] + view.m[3][2];
+
+		const float zNear = std::max<float>(vz - radius, grid._nearZ);
+		const float zFar = std::min<float>(vz + radius, grid._farZ);
+
+		// The view space box projects widest at whichever of its depths pulls each side outward
+		const float minX = std::min<float>((vx - radius) / zNear, (vx - radius) / zFar) / grid._tanHalfFovX;
+		const float maxX = std::max<float>((vx + radius) / zNear, (vx + radius) / zFar) / grid._tanHalfFovX;
+		const float minY = std::min<float>((vy - radius) / zNear, (vy - radius) / zFar) / grid._tanHalfFovY;
+		const float maxY = std::max<float>((vy + radius) / zNear, (vy + radius) / zFar) / grid._tanHalfFovY;
+
+		const bool visible = radius > 0.f && vz + radius >= grid._nearZ && vz - radius <= grid._farZ &&
+			minX <= 1.f && maxX >= -1.f && minY <= 1.f && maxY >= -1.f;
+		if (!visible)
+			return { 0, -1, 0, -1, static_cast<std::int32_t>(ClusterGrid::kSlices), -1 };
+
+		// Rows start at the top of the screen, where NDC y is 1
+		const float tilesX = static_cast<float>(ClusterGrid::kTilesX);
+		const float tilesY = static_cast<float>(ClusterGrid::kTilesY);
+		return {
+			TileOf(minX * 0.5f + 0.5f, tilesX),
+			TileOf(maxX * 0.5f + 0.5f, tilesX),
+			TileOf(0.5f - maxY * 0.5f, tilesY),
+			TileOf(0.5f - minY * 0.5f, tilesY),
+			SliceOf(grid, zNear * (1.f - kSliceEpsilon)),
+			SliceOf(grid, zFar * (1.f + kSliceEpsilon)),
+		};
+	}
+}
+
+ClusterGrid ClusterGrid::FromLens(float fovY, float aspect, float nearZ, float farZ) noexcept
+{
+	ClusterGrid grid;
+	grid._nearZ = nearZ;
+	grid._farZ = farZ;
+	grid._tanHalfFovY = std::tan(0.5f * fovY);
+	grid._tanHalfFovX = grid._tanHalfFovY * aspect;
+
+	const float depthRange = std::log2(farZ / nearZ);
+	grid._sliceScale = static_cast<float>(kSlices) / depthRange;
+	grid._sliceBias = -static_cast<float>(kSlices) * std::log2(nearZ) / depthRange;
+	for (std::uint32_t k = 0; k <= kSlices; k++)
+		grid._sliceStarts[k] = nearZ * std::pow(farZ / nearZ, static_cast<float>(k) / kSlices);
+
+	return grid;
+}
+
+void ClusterLights::Resize(size_t count)
+{
+	_centerX.resize(count);
+	_centerY.resize(count);
+	_centerZ.resize(count);
+	_radius.resize(count);
+	_spot.resize(count);
+}
+
+void ClusterLights::Set(size_t index, const XMFLOAT3& center, float radius, bool spot) noexcept
+{
+	_centerX[index] = center.x;
+	_centerY[index] = center.y;
+	_centerZ[index] = center.z;
+	_radius[index] = radius;
+	_spot[index] = spot ? 1u : 0u;
+}
+
+void LightClusters::Build(const ClusterGrid& grid, const XMFLOAT4X4& view, const ClusterLights& lights)
+{
+	const size_t count = lights.GetCount();
+	_minX.resize(count);
+	_maxX.resize(count);
+	_minY.resize(count);
+	_maxY.resize(count);
+	_minZ.resize(count);
+	_maxZ.resize(count);
+
+	// Cluster range of every light
+	const size_t groupCount = (count + 3u) / 4u;
+	parallel::ForRange(groupCount, kMinLightGroupsPerRange, [&](size_t beginGroup, size_t endGroup)
+		{
+			size_t i = beginGroup * 4u;
+			const size_t end = std::min<size_t>(endGroup * 4u, count);
+
+#ifdef LIGHT_CLUSTERS_SSE
+			__m128 m[4][3];
+			for (size_t r = 0; r < 4u; r++)
+				for (size_t c = 0; c < 3u; c++)
+					m[r][c] = _mm_set1_ps(view.m[r][c]);
+
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps(1.f);
+			const __m128 minusOne = _mm_set1_ps(-1.f);
+			const __m128 half = _mm_set1_ps(0.5f);
+			const __m128 nearZ = _mm_set1_ps(grid._nearZ);
+			const __m128 farZ = _mm_set1_ps(grid._farZ);
+			const __m128 tanX = _mm_set1_ps(grid._tanHalfFovX);
+			const __m128 tanY = _mm_set1_ps(grid._tanHalfFovY);
+			const __m128 tilesX = _mm_set1_ps(static_cast<float>(ClusterGrid::kTilesX));
+			const __m128 tilesY = _mm_set1_ps(static_cast<float>(ClusterGrid::kTilesY));
+			const __m128 lastTileX = _mm_set1_ps(static_cast<float>(ClusterGrid::kTilesX) - 1.f);
+			const __m128 lastTileY = _mm_set1_ps(static_cast<float>(ClusterGrid::kTilesY) - 1.f);
+			const __m128 nearScale = _mm_set1_ps(1.f - kSliceEpsilon);
+			const __m128 farScale = _mm_set1_ps(1.f + kSliceEpsilon);
+
+			auto tile = [&](__m128 position, __m128 tileCount, __m128 lastTile)
+				{
+					return _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(position, tileCount), zero), lastTile));
+				};
+			auto slice = [&](__m128 z)
+				{
+					__m128i s = _mm_setzero_si128();
+					for (std::uint32_t k = 1; k < ClusterGrid::kSlices; k++)
+						s = _mm_sub_epi32(s, _mm_castps_si128(_mm_cmpge_ps(z, _mm_set1_ps(grid._sliceStarts[k]))));
+					return s;
+				};
+			auto select = [](__m128i mask, __m128i a, __m128i b)
+				{
+					return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+				};
+
+			for (; i + 4u <= end; i += 4u)
+			{
+				const __m128 x = _mm_loadu_ps(&lights._centerX[i]);
+				const __m128 y = _mm_loadu_ps(&lights._centerY[i]);
+				const __m128 z = _mm_loadu_ps(&lights._centerZ[i]);
+				const __m128 radius = _mm_loadu_ps(&lights._radius[i]);
+
+				const __m128 vx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0][0]), _mm_mul_ps(y, m[1][0])), _mm_mul_ps(z, m[2][0])), m[3][0]);
+				const __m128 vy = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0][1]), _mm_mul_ps(y, m[1][1])), _mm_mul_ps(z, m[2][1])), m[3][1]);
+				const __m128 vz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0][2]), _mm_mul_ps(y, m[1][2])), _mm_mul_ps(z, m[2][2])), m[3][2]);
+
+				const __m128 zNear = _mm_max_ps(_mm_sub_ps(vz, radius), nearZ);
+				const __m128 zFar = _mm_min_ps(_mm_add_ps(vz, radius), farZ);
+
+				const __m128 x0 = _mm_sub_ps(vx, radius);
+				const __m128 x1 = _mm_add_ps(vx, radius);
+				const __m128 y0 = _mm_sub_ps(vy, radius);
+				const __m128 y1 = _mm_add_ps(vy, radius);
+				const __m128 minX = _mm_div_ps(_mm_min_ps(_mm_div_ps(x0, zNear), _mm_div_ps(x0, zFar)), tanX);
+				const __m128 maxX = _mm_div_ps(_mm_max_ps(_mm_div_ps(x1, zNear), _mm_div_ps(x1, zFar)), tanX);
+				const __m128 minY = _mm_div_ps(_mm_min_ps(_mm_div_ps(y0, zNear), _mm_div_ps(y0, zFar)), tanY);
+				const __m128 maxY = _mm_div_ps(_mm_max_ps(_mm_div_ps(y1, zNear), _mm_div_ps(y1, zFar)), tanY);
+
+				__m128 visible = _mm_cmpgt_ps(radius, zero);
+				visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(vz, radius), nearZ));
+				visible = _mm_and_ps(visible, _mm_cmple_ps(_mm_sub_ps(vz, radius), farZ));
+				visible = _mm_and_ps(visible, _mm_and_ps(_mm_cmple_ps(minX, one), _mm_cmpge_ps(maxX, minusOne)));
+				visible = _mm_and_ps(visible, _mm_and_ps(_mm_cmple_ps(minY, one), _mm_cmpge_ps(maxY, minusOne)));
+				const __m128i mask = _mm_castps_si128(visible);
+
+				const __m128i tileX0 = tile(_mm_add_ps(_mm_mul_ps(minX, half), half), tilesX, lastTileX);
+				const __m128i tileX1 = tile(_mm_add_ps(_mm_mul_ps(maxX, half), half), tilesX, lastTileX);
+				const __m128i tileY0 = tile(_mm_sub_ps(half, _mm_mul_ps(maxY, half)), tilesY, lastTileY);
+				const __m128i tileY1 = tile(_mm_sub_ps(half, _mm_mul_ps(minY, half)), tilesY, lastTileY);
+				const __m128i slice0 = slice(_mm_mul_ps(zNear, nearScale));
+				const __m128i slice1 = slice(_mm_mul_ps(zFar, farScale));
+
+				const __m128i zero32 = _mm_setzero_si128();
+				const __m128i minusOne32 = _mm_set1_epi32(-1);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(&_minX[i]), select(mask, tileX0, zero32));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(&_maxX[i]), select(mask, tileX1, minusOne32));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(&_minY[i]), select(mask, tileY0, zero32));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(&_maxY[i]), select(mask, tileY1, minusOne32));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(&_minZ[i]), select(mask, slice0, _mm_set1_epi32(ClusterGrid::kSlices)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(&_maxZ[i]), select(mask, slice1, minusOne32));
+			}
+#endif
+
+			for (; i < end; i++)
+			{
+				const ClusterBox box = BoxLight(grid, view, lights._centerX[i], lights._centerY[i], lights._centerZ[i], lights._radius[i]);
+				_minX[i] = box._minX;
+				_maxX[i] = box._maxX;
+				_minY[i] = box._minY;
+				_maxY[i] = box._maxY;
+				_minZ[i] = box._minZ;
+				_maxZ[i] = box._maxZ;
+			}
+		});
+
+	// Headers first, each thread owns whole slices so it can count and later fill their clusters without synchronizing
+	constexpr std::uint32_t kHeaderSize = 2u * ClusterGrid::kClusterCount;
+	constexpr std::uint32_t kClustersPerSlice = ClusterGrid::kTilesX * ClusterGrid::kTilesY;
+	_data.assign(kHeaderSize, 0u);
+
+	parallel::ForRange(ClusterGrid::kSlices, 1u, [&](size_t beginSlice, size_t endSlice)
+		{
+			for (size_t s = beginSlice; s < endSlice; s++)
+			{
+				auto& sliceLights = _sliceLights[s];
+				sliceLights.clear();
+
+				const auto slice = static_cast<std::int32_t>(s);
+				size_t i = 0u;
+#ifdef LIGHT_CLUSTERS_SSE
+				const __m128i sliceV = _mm_set1_epi32(slice);
+				for (; i + 4u <= count; i += 4u)
+				{
+					const __m128i minZ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&_minZ[i]));
+					const __m128i maxZ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&_maxZ[i]));
+					// minZ <= slice <= maxZ
+					const __m128i outside = _mm_or_si128(_mm_cmpgt_epi32(minZ, sliceV), _mm_cmpgt_epi32(sliceV, maxZ));
+					int mask = ~_mm_movemask_ps(_mm_castsi128_ps(outside)) & 0xF;
+					while (mask)
+					{
+						const int lane = mask & 1 ? 0 : mask & 2 ? 1 : mask & 4 ? 2 : 3;
+						sliceLights.push_back(static_cast<std::uint32_t>(i) + lane);
+						mask &= mask - 1;
+					}
+				}
+#endif
+				for (; i < count; i++)
+					if (_minZ[i] <= slice && slice <= _maxZ[i])
+						sliceLights.push_back(static_cast<std::uint32_t>(i));
+
+				std::uint32_t* counts = &_data[2u * s * kClustersPerSlice];
+				for (std::uint32_t light : sliceLights)
+					for (std::int32_t y = _minY[light]; y <= _maxY[light]; y++)
+						for (std::int32_t x = _minX[light]; x <= _maxX[light]; x++)
+							counts[2u * (y * ClusterGrid::kTilesX + x) + 1u]++;
+			}
+		});
+
+	std::uint32_t offset = kHeaderSize;
+	for (std::uint32_t c = 0; c < ClusterGrid::kClusterCount; c++)
+	{
+		_data[2u * c] = offset;
+		offset += _data[2u * c + 1u];
+		// Counted again while filling
+		_data[2u * c + 1u] = 0u;
+	}
+	_data.resize(offset);
+
+	parallel::ForRange(ClusterGrid::kSlices, 1u, [&](size_t beginSlice, size_t endSlice)
+		{
+			for (size_t s = beginSlice; s < endSlice; s++)
+			{
+				std::uint32_t* headers = &_data[2u * s * kClustersPerSlice];
+				for (std::uint32_t light : _sliceLights[s])
+				{
+					const std::uint32_t entry = light | (lights._spot[light] ? kSpotLightBit : 0u);
+					for (std::int32_t y = _minY[light]; y <= _maxY[light]; y++)
+						for (std::int32_t x = _minX[light]; x <= _maxX[light]; x++)
+						{
+							std::uint32_t* header = &headers[2u * (y * ClusterGrid::kTilesX + x)];
+							_data[header[0] + header[1]++] = entry;
+						}
+				}
+			}
+		});
+}
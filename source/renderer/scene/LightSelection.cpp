@@ -0,0 +1,155 @@
+#include "../../../include/sasha/renderer/scene/LightSelection.h"
+#include "../../../include/sasha/utility/Parallel.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define LIGHT_SELECTION_SSE
+#endif
+
+using namespace DirectX;
+
+namespace
+{
+	// Every object goes through all the lights, so even small ranges are worth a job
+	constexpr size_t kMinObjectsPerRange = 64u;
+	// Keeps lights with FalloffStart == FalloffEnd from dividing by zero
+	constexpr float kMinFalloffRange = 1e-6f;
+
+	// Linear falloff at the point of the sphere closest to the light, the SSE kernel does the same operations in the same order
+	float ScoreLight(float dx, float dy, float dz, float radius, float falloffStart, float falloffEnd, float intensity) noexcept
+	{
+		const float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+		const float d = std::max<float>(distance - radius, 0.f);
+		const float att = (falloffEnd - d) / std::max<float>(falloffEnd - falloffStart, kMinFalloffRange);
+		return std::min<float>(std::max<float>(att, 0.f), 1.f) * intensity;
+	}
+
+	// Strongest lights so far, sorted by decreasing score
+	struct TopLights
+	{
+		float _scores[LightSelection::kMaxLightsPerObject];
+		std::uint32_t _lights[LightSelection::kMaxLightsPerObject];
+		std::uint32_t _count = 0u;
+
+		// Lights have to beat this to be kept, zero until the list is full so lights out of reach never are
+		float GetThreshold() const noexcept
+		{
+			return _count < LightSelection::kMaxLightsPerObject ? 0.f : _scores[_count - 1u];
+		}
+
+		void Insert(float score, std::uint32_t light) noexcept
+		{
+			if (!(score > GetThreshold()))
+				return;
+
+			// Equal scores stay ahead, lights are inserted in increasing order so the lower index wins ties
+			std::uint32_t p = std::min<std::uint32_t>(_count, LightSelection::kMaxLightsPerObject - 1u);
+			while (p > 0u && _scores[p - 1u] < score)
+			{
+				_scores[p] = _scores[p - 1u];
+				_lights[p] = _lights[p - 1u];
+				p--;
+			}
+			_scores[p] = score;
+			_lights[p] = light;
+			_count = std::min<std::uint32_t>(_count + 1u, LightSelection::kMaxLightsPerObject);
+		}
+	};
+}
+
+void SelectionLights::Resize(size_t count)
+{
+	_centerX.resize(count);
+	_centerY.resize(count);
+	_centerZ.resize(count);
+	_falloffStart.resize(count);
+	_falloffEnd.resize(count);
+	_intensity.resize(count);
+	_spot.resize(count);
+}
+
+void SelectionLights::Set(size_t index, const XMFLOAT3& center, float falloffStart, float falloffEnd, float intensity, bool spot) noexcept
+{
+	_centerX[index] = center.x;
+	_centerY[index] = center.y;
+	_centerZ[index] = center.z;
+	_falloffStart[index] = falloffStart;
+	_falloffEnd[index] = falloffEnd;
+	_intensity[index] = intensity;
+	_spot[index] = spot ? 1u : 0u;
+}
+
+void LightSelection::Select(const CullingSpheres& objects, const SelectionLights& lights)
+{
+	const size_t objectCount = objects.GetCount();
+	_lights.resize(objectCount * kMaxLightsPerObject);
+	_counts.resize(objectCount);
+
+	parallel::ForRange(objectCount, kMinObjectsPerRange, [&](size_t begin, size_t end)
+		{
+			for (size_t o = begin; o < end; o++)
+			{
+				const XMFLOAT4 sphere = { objects._centerX[o], objects._centerY[o], objects._centerZ[o], objects._radius[o] };
+				const std::span<std::uint32_t, kMaxLightsPerObject> list(&_lights[o * kMaxLightsPerObject], kMaxLightsPerObject);
+				_counts[o] = static_cast<std::uint8_t>(SelectSphere(sphere, lights, list));
+			}
+		});
+}
+
+std::uint32_t LightSelection::SelectSphere(const XMFLOAT4& sphere, const SelectionLights& lights, std::span<std::uint32_t, kMaxLightsPerObject> selected) noexcept
+{
+	const size_t lightCount = lights.GetCount();
+	const float ox = sphere.x;
+	const float oy = sphere.y;
+	const float oz = sphere.z;
+	const float radius = sphere.w;
+
+	TopLights top;
+	size_t i = 0u;
+#ifdef LIGHT_SELECTION_SSE
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.f);
+	const __m128 minRange = _mm_set1_ps(kMinFalloffRange);
+	const __m128 centerX = _mm_set1_ps(ox);
+	const __m128 centerY = _mm_set1_ps(oy);
+	const __m128 centerZ = _mm_set1_ps(oz);
+	const __m128 radiusV = _mm_set1_ps(radius);
+	for (; i + 4u <= lightCount; i += 4u)
+	{
+		const __m128 dx = _mm_sub_ps(_mm_loadu_ps(&lights._centerX[i]), centerX);
+		const __m128 dy = _mm_sub_ps(_mm_loadu_ps(&lights._centerY[i]), centerY);
+		const __m128 dz = _mm_sub_ps(_mm_loadu_ps(&lights._centerZ[i]), centerZ);
+		const __m128 falloffStart = _mm_loadu_ps(&lights._falloffStart[i]);
+		const __m128 falloffEnd = _mm_loadu_ps(&lights._falloffEnd[i]);
+
+		const __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+		const __m128 d = _mm_max_ps(_mm_sub_ps(distance, radiusV), zero);
+		const __m128 att = _mm_div_ps(_mm_sub_ps(falloffEnd, d), _mm_max_ps(_mm_sub_ps(falloffEnd, falloffStart), minRange));
+		const __m128 score = _mm_mul_ps(_mm_min_ps(_mm_max_ps(att, zero), one), _mm_loadu_ps(&lights._intensity[i]));
+
+		// Most lights don't reach the object or are weaker than the ones it has
+		int mask = _mm_movemask_ps(_mm_cmpgt_ps(score, _mm_set1_ps(top.GetThreshold())));
+		if (mask == 0)
+			continue;
+
+		alignas(16) float scores[4];
+		_mm_store_ps(scores, score);
+		for (std::uint32_t lane = 0; lane < 4u; lane++)
+			if (mask & (1 << lane))
+				top.Insert(scores[lane], static_cast<std::uint32_t>(i) + lane);
+	}
+#endif
+
+	for (; i < lightCount; i++)
+	{
+		const float score = ScoreLight(lights._centerX[i] - ox, lights._centerY[i] - oy, lights._centerZ[i] - oz, radius,
+			lights._falloffStart[i], lights._falloffEnd[i], lights._intensity[i]);
+		top.Insert(score, static_cast<std::uint32_t>(i));
+	}
+
+	for (std::uint32_t k = 0; k < top._count; k++)
+		selected[k] = top._lights[k] | (lights._spot[top._lights[k]] ? kSpotLightBit : 0u);
+	return top._count;
+}
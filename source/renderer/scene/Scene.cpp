@@ -1,43 +1,461 @@
 #include "../../../include/sasha/renderer/scene/Scene.h"
+#include "../../../include/sasha/utility/Parallel.h"
+#include <array>
+#include <cmath>
 
-void Scene::AddInstance(const std::string& meshName, const std::string& matName, const DirectX::XMFLOAT4X4& transform)
+namespace
 {
-	_instances.push_back({ meshName, transform, matName });
+	// Chunks hold around a hundred entities, a few of them make a job
+	constexpr size_t kMinChunksPerRange = 4u;
+	// Copying a moved entity's world matrix is two random lookups
+	constexpr size_t kMinMovedPerRange = 256u;
+
+	// CullSpheres reads a chunk's WorldSphere column as it is
+	static_assert(sizeof(WorldSphere) == sizeof(DirectX::XMFLOAT4) && alignof(WorldSphere) == alignof(DirectX::XMFLOAT4));
 }
 
-void Scene::AddLight(const Light& light)
+Scene::Scene()
+	: _bounded(&_world.GetQuery<Transform, MeshRef, WorldBounds, WorldSphere>())
+	, _lodded(&_world.GetQuery<WorldSphere, WorldBounds, MeshRef, Lod>())
+	, _drawn(&_world.GetQuery<WorldSphere, Lod, MaterialRef, DrawState, InstanceSlot>())
+	, _lit(&_world.GetQuery<WorldSphere, SelectedLights, InstanceDirty>())
+	, _animated(&_world.GetQuery<UvBinding, TexTransform, InstanceDirty>())
+	, _instances(&_world.GetQuery<InstanceSlot, InstanceDirty, Transform, TexTransform, SelectedLights>())
+{
+}
+
+Entity Scene::AddInstance(const GeometryLibrary& geoLib, const std::string& meshName, const std::string& matName, const DirectX::XMFLOAT4X4& transform, Entity parent)
+{
+	assert(!parent.IsValid() || _world.IsAlive(parent));
+	const NodeID parentNode = parent.IsValid() ? _world.Get<HierarchyNode>(parent)->_node : TransformHierarchy::kNoNode;
+	const NodeID node = _hierarchy.Add(LocalTransform::FromMatrix(transform), parentNode);
+
+	// The world matrix is only known once the hierarchy is updated
+	const SubMeshID submesh = geoLib.GetSubmeshID(meshName);
+	const MaterialID material = geoLib.GetMaterialID(matName);
+	// There is one pipeline state per layer
+	const RenderLayer layer = geoLib.GetMaterial(material)._layer;
+	const auto slot = static_cast<std::uint32_t>(_slotEntities.size());
+	const Entity instance = _world.Create(Transform{}, WorldBounds{}, WorldSphere{}, MeshRef{ submesh }, Lod{ submesh, 0u },
+		MaterialRef{ material }, DrawState{ layer, static_cast<std::uint8_t>(layer), D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST },
+		TexTransform{}, SelectedLights{}, InstanceSlot{ slot }, InstanceDirty{}, HierarchyNode{ node });
+	_slotEntities.push_back(instance);
+
+	// Node ids of removed instances are reused
+	if (node >= _nodeEntities.size())
+		_nodeEntities.resize(node + 1u);
+	_nodeEntities[node] = instance;
+
+	if (material < _materialUvTracks.size())
+		BindUvTrack(instance, _materialUvTracks[material]);
+	return instance;
+}
+
+void Scene::RemoveInstance(Entity instance)
+{
+	assert(_world.IsAlive(instance));
+
+	_removedNodes.clear();
+	_hierarchy.Remove(_world.Get<HierarchyNode>(instance)->_node, _removedNodes);
+	for (const NodeID node : _removedNodes)
+	{
+		const Entity removed = _nodeEntities[node];
+		FreeSlot(_world.Get<InstanceSlot>(removed)->_slot);
+		_world.Destroy(removed);
+		_nodeEntities[node] = {};
+	}
+}
+
+size_t Scene::AddLight(const Light& light, LightType type)
 {
 	_lights.push_back(light);
+	_lightTypes.push_back(type);
+	return _lights.size() - 1u;
+}
+
+TextureAnimation& Scene::GetTextureAnimation() noexcept
+{
+	return _textureAnimation;
+}
+
+void Scene::AnimateMaterial(const GeometryLibrary& geoLib, const std::string& matName, UvTrackID track)
+{
+	const MaterialID material = geoLib.GetMaterialID(matName);
+	if (material >= _materialUvTracks.size())
+		_materialUvTracks.resize(material + 1u, kNoUvTrack);
+	_materialUvTracks[material] = track;
+
+	// Binding changes the archetype of entities moving to or from an animated track, so they are collected first
+	std::vector<Entity> bound;
+	_drawn->ForEach<MaterialRef>([&](Entity instance, const MaterialRef& ref)
+		{
+			if (ref._material == material && !_world.Has<TexAnim>(instance))
+				bound.push_back(instance);
+		});
+	for (const Entity instance : bound)
+		BindUvTrack(instance, track);
+}
+
+void Scene::AnimateInstance(Entity instance, UvTrackID track)
+{
+	_world.Add(instance, TexAnim{ track });
+	BindUvTrack(instance, track);
+}
+
+void Scene::SetLocal(Entity instance, const LocalTransform& local)
+{
+	assert(_world.IsAlive(instance));
+	_hierarchy.SetLocal(_world.Get<HierarchyNode>(instance)->_node, local);
+}
+
+LocalTransform Scene::GetLocal(Entity instance) const
+{
+	assert(_world.IsAlive(instance));
+	return _hierarchy.GetLocal(_world.Get<HierarchyNode>(instance)->_node);
+}
+
+World& Scene::GetWorld() noexcept
+{
+	return _world;
+}
+
+void Scene::UpdateTransforms()
+{
+	_hierarchy.Update();
+
+	// Every changed node belongs to its own entity
+	const auto changed = _hierarchy.GetChanged();
+	parallel::ForRange(changed.size(), kMinMovedPerRange, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				const NodeID node = changed[i];
+				const Entity instance = _nodeEntities[node];
+
+				_world.Get<Transform>(instance)->_world = _hierarchy.GetWorld(node);
+				_world.Get<WorldBounds>(instance)->_dirty = true;
+				_world.Get<InstanceDirty>(instance)->_dirty.Mark();
+			}
+		});
+}
+
+void Scene::UpdateTextureAnimation(float time)
+{
+	_textureAnimation.Evaluate(time);
+	_animated->ForEach<UvBinding, TexTransform, InstanceDirty>([this](Entity, const UvBinding& binding, TexTransform& tex, InstanceDirty& dirty)
+		{
+			tex._transform = _textureAnimation.GetTransform(binding._track);
+			dirty._dirty.Mark();
+		});
+}
+
+void Scene::UpdateBounds(const GeometryLibrary& geoLib)
+{
+	using namespace DirectX;
+
+	// Every row only writes its own bounds, so chunks can be split freely
+	_bounded->GetChunks(_chunks);
+	parallel::ForRange(_chunks.size(), kMinChunksPerRange, [&](size_t begin, size_t end)
+		{
+			for (size_t c = begin; c < end; c++)
+			{
+				const auto& chunk = _chunks[c];
+				const auto* transforms = chunk.Get<Transform>();
+				const auto* meshes = chunk.Get<MeshRef>();
+				auto* bounds = chunk.Get<WorldBounds>();
+				auto* spheres = chunk.Get<WorldSphere>();
+
+				for (size_t i = 0; i < chunk.GetCount(); i++)
+				{
+					auto& b = bounds[i];
+					if (!b._dirty)
+						continue;
+
+					const auto& submesh = geoLib.GetSubmesh(meshes[i]._submesh);
+					XMMATRIX world = XMLoadFloat4x4(&transforms[i]._world);
+
+					BoundingSphere sphere;
+					submesh._aabb.Transform(b._aabb, world);
+					submesh._sphere.Transform(sphere, world);
+					spheres[i]._sphere = { sphere.Center.x, sphere.Center.y, sphere.Center.z, sphere.Radius };
+
+					float scaleSq = std::max<float>({
+						XMVectorGetX(XMVector3LengthSq(world.r[0])),
+						XMVectorGetX(XMVector3LengthSq(world.r[1])),
+						XMVectorGetX(XMVector3LengthSq(world.r[2])) });
+					b._scale = std::sqrt(scaleSq);
+					b._dirty = false;
+				}
+			}
+		});
+}
+
+void Scene::SelectLods(const GeometryLibrary& geoLib, const Camera& camera, float viewportHeight)
+{
+	using namespace DirectX;
+
+	// Pixels covered by one unit at distance one
+	const float pixelsPerUnit = 0.5f * viewportHeight / std::tan(0.5f * camera.GetFovY());
+	const XMVECTOR eye = camera.GetPosition();
+
+	_lodded->ForEach<WorldSphere, WorldBounds, MeshRef, Lod>([&](Entity, const WorldSphere& sphere, const WorldBounds& bounds, const MeshRef& mesh, Lod& lod)
+		{
+			const auto& chain = geoLib.GetLodChain(mesh._submesh);
+			if (chain._levels.size() < 2u)
+				return;
+
+			XMVECTOR center = XMLoadFloat4(&sphere._sphere);
+			float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(center, eye))) - sphere._sphere.w;
+			float errorToPixels = bounds._scale * pixelsPerUnit / std::max<float>(distance, camera.GetNearZ());
+
+			size_t level = std::min<size_t>(lod._level, chain._levels.size() - 1u);
+			while (level > 0u && chain._levels[level]._error * errorToPixels > _lodPixelError)
+				level--;
+			while (level + 1u < chain._levels.size() && chain._levels[level + 1u]._error * errorToPixels <= _lodPixelError * (1.f - _lodHysteresis))
+				level++;
+
+			lod._level = static_cast<std::uint8_t>(level);
+			lod._submesh = chain._levels[level]._submesh;
+		});
+}
+
+void Scene::SetLodPixelError(float pixels, float hysteresis) noexcept
+{
+	_lodPixelError = pixels;
+	_lodHysteresis = hysteresis;
+}
+
+void Scene::CullItems(const Camera& camera)
+{
+	using namespace DirectX;
+
+	auto frustum = Frustum::FromViewProj(camera.GetViewProj());
+	const XMFLOAT3 eye = camera.GetPositionF();
+	const XMFLOAT3 forward = camera.GetForwardF();
+
+	// The spheres of a chunk are tested in place, only the survivors' draw state is gathered
+	_visibleItems.clear();
+	_drawn->ForEachChunk([&](const ChunkView& chunk)
+		{
+			const auto* spheres = reinterpret_cast<const XMFLOAT4*>(chunk.Get<WorldSphere>());
+			const auto* lods = chunk.Get<Lod>();
+			const auto* materials = chunk.Get<MaterialRef>();
+			const auto* states = chunk.Get<DrawState>();
+			const auto* slots = chunk.Get<InstanceSlot>();
+
+			_visibleRows.resize(chunk.GetCount());
+			const size_t visibleCount = FrustumCulling::CullSpheres(frustum, { spheres, chunk.GetCount() }, _visibleRows);
+			for (size_t v = 0; v < visibleCount; v++)
+			{
+				const std::uint32_t i = _visibleRows[v];
+				const XMFLOAT4& sphere = spheres[i];
+				const float depth = (sphere.x - eye.x) * forward.x + (sphere.y - eye.y) * forward.y + (sphere.z - eye.z) * forward.z;
+				_visibleItems.push_back({ lods[i]._submesh, materials[i]._material, states[i]._layer, states[i]._pipeline,
+					states[i]._topology, slots[i]._slot, depth });
+			}
+		});
 }
 
-void Scene::BuildRenderItems(GeometryLibrary& geoLib)
+void Scene::BuildDrawPackets(const GeometryLibrary& geoLib, const Camera& camera)
 {
-	_renderItems.clear();
+	const float nearZ = camera.GetNearZ();
+	const float invDepthRange = 1.f / (camera.GetFarZ() - nearZ);
 
-	int index = 0;
-	for (const auto& inst : _instances)
+	// Material and submesh IDs are dense indices into the library and an entity's pipeline is its layer,
+	// so sizing the key fields to those counts ranks them without a pass of its own. Packets index _visibleItems
+	const auto layout = DrawKeyLayout::FromCounts(static_cast<size_t>(RenderLayer::Count), geoLib.GetMaterialCount(), geoLib.GetSubmeshCount(), _visibleItems.size());
+
+	_packets.resize(_visibleItems.size());
+	for (std::uint32_t i = 0; i < _visibleItems.size(); i++)
 	{
-		auto ri = std::make_unique<RenderItem>();
+		const auto& item = _visibleItems[i];
+		_packets[i] = layout.MakePacket(item._layer, item._pipeline, item._material, item._submesh, (item._viewDepth - nearZ) * invDepthRange, i);
+	}
 
-		ri->_cbObjIndex = index++;
-		
-		const auto& submesh = geoLib.GetSubmeshID(inst.meshName);
-		const auto& material = geoLib.GetMaterialID(inst.matName);
-		ri->_submeshId = submesh;
-		ri->_materialId = material;
+	_packetScratch.resize(_packets.size());
+	DrawPackets::RadixSort(_packets, _packetScratch, layout);
 
-		ri->_world = inst.transform;
+	_batchedSlots.resize(_packets.size());
+	_batches.clear();
+	std::uint64_t batchState = 0u;
+	for (UINT i = 0; i < _packets.size(); i++)
+	{
+		const auto& item = _visibleItems[layout.GetItem(_packets[i])];
+		_batchedSlots[i] = item._slot;
 
-		_renderItems.push_back(std::move(ri));
+		// The topology isn't part of the key, items with another one simply start a new draw
+		const std::uint64_t state = layout.GetState(_packets[i]);
+		if (_batches.empty() || state != batchState || item._topology != _batches.back()._primitiveType)
+		{
+			_batches.push_back({ item._submesh, item._material, item._layer, item._pipeline, item._topology, i, 0u });
+			batchState = state;
+		}
+		_batches.back()._instanceCount++;
 	}
 }
 
-std::vector<std::unique_ptr<RenderItem>>& Scene::GetRenderItems() 
+void Scene::BuildLightClusters(const Camera& camera)
 {
-	return _renderItems;
+	using namespace DirectX;
+
+	SplitLights();
+
+	// Local lights reach as far as their falloff end
+	_clusterLights.Resize(_localLights.size());
+	for (size_t i = 0; i < _localLights.size(); i++)
+		_clusterLights.Set(i, _localLights[i].Position, _localLights[i].FalloffEnd, _localLightTypes[i] == LightType::Spot);
+
+	XMFLOAT4X4 view;
+	XMStoreFloat4x4(&view, camera.GetView());
+	_clusterGrid = ClusterGrid::FromLens(camera.GetFovY(), camera.GetAspect(), camera.GetNearZ(), camera.GetFarZ());
+	_lightClusters.Build(_clusterGrid, view, _clusterLights);
+}
+
+void Scene::SelectItemLights()
+{
+	// The instance data holds the lights as a uint4
+	static_assert(LightSelection::kMaxLightsPerObject == 4u);
+
+	SplitLights();
+
+	_selectionLights.Resize(_localLights.size());
+	for (size_t i = 0; i < _localLights.size(); i++)
+	{
+		const auto& light = _localLights[i];
+		const float intensity = std::max<float>({ light.Strength.x, light.Strength.y, light.Strength.z });
+		_selectionLights.Set(i, light.Position, light.FalloffStart, light.FalloffEnd, intensity, _localLightTypes[i] == LightType::Spot);
+	}
+
+	// Each row scores every light against its own sphere, so chunks can be split freely. Only entities whose lights
+	// changed are copied to the frame resources again
+	_lit->GetChunks(_litChunks);
+	parallel::ForRange(_litChunks.size(), kMinChunksPerRange, [&](size_t begin, size_t end)
+		{
+			for (size_t c = begin; c < end; c++)
+			{
+				const auto& chunk = _litChunks[c];
+				const auto* spheres = chunk.Get<WorldSphere>();
+				auto* lights = chunk.Get<SelectedLights>();
+				auto* dirty = chunk.Get<InstanceDirty>();
+
+				for (size_t i = 0; i < chunk.GetCount(); i++)
+				{
+					std::array<std::uint32_t, LightSelection::kMaxLightsPerObject> selected = {};
+					const UINT count = LightSelection::SelectSphere(spheres[i]._sphere, _selectionLights, selected);
+					const DirectX::XMUINT4 packed = { selected[0], selected[1], selected[2], selected[3] };
+
+					auto& current = lights[i];
+					if (count == current._count && packed.x == current._lights.x && packed.y == current._lights.y && packed.z == current._lights.z && packed.w == current._lights.w)
+						continue;
+
+					current._lights = packed;
+					current._count = count;
+					dirty[i]._dirty.Mark();
+				}
+			}
+		});
+}
+
+Query& Scene::GetInstances() noexcept
+{
+	return *_instances;
+}
+
+size_t Scene::GetInstanceCount() const noexcept
+{
+	return _slotEntities.size();
+}
+
+const std::vector<VisibleItem>& Scene::GetVisibleItems() const noexcept
+{
+	return _visibleItems;
+}
+
+const std::vector<DrawBatch>& Scene::GetBatches() const noexcept
+{
+	return _batches;
+}
+
+const std::vector<std::uint32_t>& Scene::GetBatchedSlots() const noexcept
+{
+	return _batchedSlots;
 }
 
 std::vector<Light>& Scene::GetLights()
 {
 	return _lights;
 }
+
+const std::vector<LightType>& Scene::GetLightTypes() const noexcept
+{
+	return _lightTypes;
+}
+
+const ClusterGrid& Scene::GetClusterGrid() const noexcept
+{
+	return _clusterGrid;
+}
+
+const LightClusters& Scene::GetLightClusters() const noexcept
+{
+	return _lightClusters;
+}
+
+const std::vector<Light>& Scene::GetDirectionalLights() const noexcept
+{
+	return _directionalLights;
+}
+
+const std::vector<Light>& Scene::GetLocalLights() const noexcept
+{
+	return _localLights;
+}
+
+void Scene::SplitLights()
+{
+	_directionalLights.clear();
+	_localLights.clear();
+	_localLightTypes.clear();
+	for (size_t i = 0; i < _lights.size(); i++)
+	{
+		if (_lightTypes[i] == LightType::Directional)
+		{
+			_directionalLights.push_back(_lights[i]);
+			continue;
+		}
+
+		_localLights.push_back(_lights[i]);
+		_localLightTypes.push_back(_lightTypes[i]);
+	}
+}
+
+void Scene::FreeSlot(std::uint32_t slot)
+{
+	const auto last = static_cast<std::uint32_t>(_slotEntities.size() - 1u);
+	if (slot != last)
+	{
+		const Entity moved = _slotEntities[last];
+		_slotEntities[slot] = moved;
+		_world.Get<InstanceSlot>(moved)->_slot = slot;
+		// Each frame resource only holds the moved entity's data at its old slot
+		_world.Get<InstanceDirty>(moved)->_dirty.Mark();
+	}
+	_slotEntities.pop_back();
+
+	// They hold slots, the next CullItems and BuildDrawPackets rebuild them
+	_visibleItems.clear();
+	_packets.clear();
+	_batchedSlots.clear();
+	_batches.clear();
+}
+
+void Scene::BindUvTrack(Entity instance, UvTrackID track)
+{
+	// Constant tracks are applied once here, animated ones every UpdateTextureAnimation
+	_world.Get<TexTransform>(instance)->_transform = track == kNoUvTrack ? d3dUtil::Identity4x4() : _textureAnimation.GetTransform(track);
+	_world.Get<InstanceDirty>(instance)->_dirty.Mark();
+	if (track != kNoUvTrack && _textureAnimation.IsAnimated(track))
+		_world.Add(instance, UvBinding{ track });
+	else if (_world.Has<UvBinding>(instance))
+		_world.Remove<UvBinding>(instance);
+}
@@ -0,0 +1,113 @@
+#include "../../../include/sasha/renderer/scene/TextureAnimation.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace DirectX;
+
+UvTrackID TextureAnimation::AddScroll(const XMFLOAT2& velocity)
+{
+	return AddProcedural({ 1.f, 1.f }, 0.f, { 0.f, 0.f }, velocity);
+}
+
+UvTrackID TextureAnimation::AddRotation(float radiansPerSecond, const XMFLOAT2& pivot)
+{
+	return AddProcedural({ 1.f, 1.f }, radiansPerSecond, pivot, { 0.f, 0.f });
+}
+
+UvTrackID TextureAnimation::AddScale(const XMFLOAT2& scale)
+{
+	return AddProcedural(scale, 0.f, { 0.f, 0.f }, { 0.f, 0.f });
+}
+
+UvTrackID TextureAnimation::AddKeyframes(std::span<const UvKeyframe> keys, bool loop)
+{
+	assert(!keys.empty());
+	assert(std::is_sorted(keys.begin(), keys.end(), [](const UvKeyframe& a, const UvKeyframe& b) { return a._time < b._time; }));
+
+	const auto track = static_cast<UvTrackID>(_transforms.size());
+	_animated.push_back(keys.size() > 1u ? 1u : 0u);
+	_transforms.push_back(Compose(keys[0]._scale.x, keys[0]._scale.y, keys[0]._rotation, 0.f, 0.f, keys[0]._offset.x, keys[0]._offset.y));
+
+	_keyframedTracks.push_back(track);
+	_firstKey.push_back(static_cast<std::uint32_t>(_keys.size()));
+	_keyCount.push_back(static_cast<std::uint32_t>(keys.size()));
+	_loop.push_back(loop ? 1u : 0u);
+	_keys.insert(_keys.end(), keys.begin(), keys.end());
+
+	return track;
+}
+
+void TextureAnimation::Evaluate(float time)
+{
+	for (size_t i = 0; i < _proceduralTracks.size(); i++)
+	{
+		_transforms[_proceduralTracks[i]] = Compose(_scaleU[i], _scaleV[i], _angularVelocity[i] * time,
+			_pivotU[i], _pivotV[i], _velocityU[i] * time, _velocityV[i] * time);
+	}
+
+	for (size_t i = 0; i < _keyframedTracks.size(); i++)
+	{
+		const UvKeyframe* keys = _keys.data() + _firstKey[i];
+		const std::uint32_t keyCount = _keyCount[i];
+
+		const float start = keys[0]._time;
+		const float end = keys[keyCount - 1u]._time;
+		float t = time;
+		if (_loop[i] && end > start)
+			t = start + std::fmod(std::max<float>(t - start, 0.f), end - start);
+
+		// First key after t, the sample lies between it and the one before
+		const UvKeyframe* next = std::upper_bound(keys, keys + keyCount, t, [](float value, const UvKeyframe& key) { return value < key._time; });
+		UvKeyframe sample;
+		if (next == keys)
+			sample = keys[0];
+		else if (next == keys + keyCount)
+			sample = keys[keyCount - 1u];
+		else
+		{
+			const UvKeyframe& prev = *(next - 1);
+			const float s = (t - prev._time) / (next->_time - prev._time);
+			auto lerp = [s](float a, float b) { return a + (b - a) * s; };
+			sample._offset = { lerp(prev._offset.x, next->_offset.x), lerp(prev._offset.y, next->_offset.y) };
+			sample._rotation = lerp(prev._rotation, next->_rotation);
+			sample._scale = { lerp(prev._scale.x, next->_scale.x), lerp(prev._scale.y, next->_scale.y) };
+		}
+
+		_transforms[_keyframedTracks[i]] = Compose(sample._scale.x, sample._scale.y, sample._rotation, 0.f, 0.f, sample._offset.x, sample._offset.y);
+	}
+}
+
+UvTrackID TextureAnimation::AddProcedural(const XMFLOAT2& scale, float angularVelocity, const XMFLOAT2& pivot, const XMFLOAT2& velocity)
+{
+	const auto track = static_cast<UvTrackID>(_transforms.size());
+	const bool animated = angularVelocity != 0.f || velocity.x != 0.f || velocity.y != 0.f;
+	_animated.push_back(animated ? 1u : 0u);
+	_transforms.push_back(Compose(scale.x, scale.y, 0.f, pivot.x, pivot.y, 0.f, 0.f));
+
+	_proceduralTracks.push_back(track);
+	_scaleU.push_back(scale.x);
+	_scaleV.push_back(scale.y);
+	_angularVelocity.push_back(angularVelocity);
+	_pivotU.push_back(pivot.x);
+	_pivotV.push_back(pivot.y);
+	_velocityU.push_back(velocity.x);
+	_velocityV.push_back(velocity.y);
+
+	return track;
+}
+
+XMFLOAT4X4 TextureAnimation::Compose(float scaleU, float scaleV, float angle, float pivotU, float pivotV, float offsetU, float offsetV) noexcept
+{
+	// uv' = ((uv * S - pivot) * R + pivot) + offset, R turning counterclockwise like XMMatrixRotationZ
+	const float c = std::cos(angle);
+	const float s = std::sin(angle);
+	const float tu = pivotU - (pivotU * c - pivotV * s) + offsetU;
+	const float tv = pivotV - (pivotU * s + pivotV * c) + offsetV;
+
+	return XMFLOAT4X4(
+		scaleU * c, scaleU * s, 0.f, 0.f,
+		-scaleV * s, scaleV * c, 0.f, 0.f,
+		0.f, 0.f, 1.f, 0.f,
+		tu, tv, 0.f, 1.f);
+}
@@ -0,0 +1,438 @@
+#include "../../../include/sasha/renderer/scene/TransformHierarchy.h"
+#include "../../../include/sasha/utility/Parallel.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace DirectX;
+
+namespace
+{
+	// A node is one matrix multiply, jobs need a few thousand of them to pay off
+	constexpr size_t kMinNodesPerRange = 1024u;
+	// The tail and holes are sorted away once they outnumber both of these
+	constexpr size_t kMinUnsortedSlots = 1024u;
+	constexpr size_t kUnsortedFraction = 8u;
+}
+
+LocalTransform LocalTransform::FromMatrix(const XMFLOAT4X4& matrix) noexcept
+{
+	LocalTransform local;
+	local._translation = { matrix.m[3][0], matrix.m[3][1], matrix.m[3][2] };
+
+	XMVECTOR scale, rotation, translation;
+	if (XMMatrixDecompose(&scale, &rotation, &translation, XMLoadFloat4x4(&matrix)))
+	{
+		XMStoreFloat3(&local._scale, scale);
+		XMStoreFloat4(&local._rotation, rotation);
+	}
+	return local;
+}
+
+TransformHierarchy::~TransformHierarchy()
+{
+	if (_sortPending)
+		JobSystem::Get().Wait(_sortJob);
+}
+
+NodeID TransformHierarchy::Add(const LocalTransform& local, NodeID parent)
+{
+	assert(parent == kNoNode || IsAlive(parent));
+	ApplySort();
+
+	NodeID node;
+	if (!_freeNodes.empty())
+	{
+		node = _freeNodes.back();
+		_freeNodes.pop_back();
+	}
+	else
+	{
+		node = static_cast<NodeID>(_slots.size());
+		_slots.push_back(kNoNode);
+		_parentNodes.push_back(kNoNode);
+		_firstChildNodes.push_back(kNoNode);
+		_nextSiblings.push_back(kNoNode);
+		_previousSiblings.push_back(kNoNode);
+		_dirty.push_back(0u);
+	}
+
+	// Linked in front of its siblings, roots aren't linked since Sort finds them by their slots
+	_parentNodes[node] = parent;
+	_firstChildNodes[node] = kNoNode;
+	_previousSiblings[node] = kNoNode;
+	_nextSiblings[node] = kNoNode;
+	if (parent != kNoNode)
+	{
+		_nextSiblings[node] = _firstChildNodes[parent];
+		if (_nextSiblings[node] != kNoNode)
+			_previousSiblings[_nextSiblings[node]] = node;
+		_firstChildNodes[parent] = node;
+	}
+
+	// Appended to the tail, after its parent whether that one is sorted or in the tail too
+	_slots[node] = static_cast<std::uint32_t>(_nodes.size());
+	_nodes.push_back(node);
+	_parents.push_back(parent == kNoNode ? kNoNode : _slots[parent]);
+	_translations.push_back(local._translation);
+	_rotations.push_back(local._rotation);
+	_scales.push_back(local._scale);
+	_worlds.emplace_back();
+	XMStoreFloat4x4(&_worlds.back(), XMMatrixIdentity());
+	_stamps.push_back(0u);
+
+	// A reused id can still be listed from before its removal
+	if (_dirty[node] == 0u)
+	{
+		_dirty[node] = 1u;
+		_dirtyNodes.push_back(node);
+	}
+	_nodeCount++;
+	return node;
+}
+
+void TransformHierarchy::Remove(NodeID node, std::vector<NodeID>& removed)
+{
+	assert(IsAlive(node));
+	ApplySort();
+
+	// Only the subtree's root has to be unlinked, the links inside the subtree go with it
+	const NodeID parent = _parentNodes[node];
+	if (parent != kNoNode)
+	{
+		if (_previousSiblings[node] != kNoNode)
+			_nextSiblings[_previousSiblings[node]] = _nextSiblings[node];
+		else
+			_firstChildNodes[parent] = _nextSiblings[node];
+		if (_nextSiblings[node] != kNoNode)
+			_previousSiblings[_nextSiblings[node]] = _previousSiblings[node];
+	}
+
+	const size_t first = removed.size();
+	removed.push_back(node);
+	for (size_t i = first; i < removed.size(); i++)
+		for (NodeID child = _firstChildNodes[removed[i]]; child != kNoNode; child = _nextSiblings[child])
+			removed.push_back(child);
+
+	// The slots stay where they are as holes until the next Sort
+	for (size_t i = first; i < removed.size(); i++)
+	{
+		const NodeID n = removed[i];
+		const auto slot = _slots[n];
+		_nodes[slot] = kNoNode;
+		if (slot < _sortedCount)
+			_holeCount++;
+		_slots[n] = kNoNode;
+		_freeNodes.push_back(n);
+	}
+	_nodeCount -= removed.size() - first;
+}
+
+void TransformHierarchy::SetLocal(NodeID node, const LocalTransform& local)
+{
+	assert(IsAlive(node));
+	ApplySort();
+
+	const auto slot = _slots[node];
+	_translations[slot] = local._translation;
+	_rotations[slot] = local._rotation;
+	_scales[slot] = local._scale;
+
+	if (_dirty[node] == 0u)
+	{
+		_dirty[node] = 1u;
+		_dirtyNodes.push_back(node);
+	}
+}
+
+LocalTransform TransformHierarchy::GetLocal(NodeID node) const noexcept
+{
+	const auto slot = _slots[node];
+	return { _translations[slot], _rotations[slot], _scales[slot] };
+}
+
+void TransformHierarchy::Update()
+{
+	ApplySort();
+	_changed.clear();
+
+	_stamp++;
+	_dirtySlots.clear();
+	for (const NodeID node : _dirtyNodes)
+	{
+		_dirty[node] = 0u;
+		const auto slot = _slots[node];
+		// Removed since it was set
+		if (slot == kNoNode)
+			continue;
+
+		if (slot < _sortedCount)
+			_dirtySlots.push_back(slot);
+		else
+			_stamps[slot] = _stamp;
+	}
+	_dirtyNodes.clear();
+	// Slots are in level order, so sorting them also groups them by level
+	std::sort(_dirtySlots.begin(), _dirtySlots.end());
+
+	auto levelOf = [this](std::uint32_t slot)
+		{
+			return static_cast<size_t>(std::upper_bound(_levels.begin(), _levels.end(), slot) - _levels.begin()) - 1u;
+		};
+
+	// _ranges holds the descendants of the nodes changed at the previous level, the dirty nodes of a level are merged in.
+	// Levels with nothing to do are skipped, so a few moving nodes cost as much as their subtrees whatever the depth
+	_ranges.clear();
+	size_t nextDirty = 0u;
+	size_t level = _dirtySlots.empty() ? GetLevelCount() : levelOf(_dirtySlots.front());
+	while (level < GetLevelCount())
+	{
+		const std::uint32_t levelEnd = _levels[level + 1u];
+
+		_nextRanges.clear();
+		size_t r = 0u;
+		while (r < _ranges.size() || (nextDirty < _dirtySlots.size() && _dirtySlots[nextDirty] < levelEnd))
+		{
+			const bool takeDirty = nextDirty < _dirtySlots.size() && _dirtySlots[nextDirty] < levelEnd &&
+				(r == _ranges.size() || _dirtySlots[nextDirty] < _ranges[r]._begin);
+			if (takeDirty)
+			{
+				AppendRange(_nextRanges, _dirtySlots[nextDirty], _dirtySlots[nextDirty] + 1u);
+				nextDirty++;
+			}
+			else
+			{
+				AppendRange(_nextRanges, _ranges[r]._begin, _ranges[r]._end);
+				r++;
+			}
+		}
+
+		auto offset = static_cast<std::uint32_t>(_changed.size());
+		for (auto& range : _nextRanges)
+		{
+			range._offset = offset;
+			offset += range._end - range._begin;
+		}
+		_changed.resize(offset);
+		UpdateLevel(_nextRanges);
+
+		_ranges.clear();
+		for (const auto& range : _nextRanges)
+			AppendRange(_ranges, _firstChildren[range._begin], _firstChildren[range._end]);
+
+		if (!_ranges.empty())
+			level++;
+		else if (nextDirty < _dirtySlots.size())
+			level = levelOf(_dirtySlots[nextDirty]);
+		else
+			break;
+	}
+
+	UpdateTail();
+	// Holes inside the ranges were listed as kNoNode
+	if (_holeCount > 0u)
+		std::erase(_changed, kNoNode);
+
+	// Every update walks the tail and the holes, sorting them away once they reach a fraction of the nodes keeps that
+	// cheap and makes the sort's cost amortized constant per added or removed node. The worlds are final by now, the
+	// job carries them over and the frame reads them meanwhile
+	const size_t unsorted = _nodes.size() - _sortedCount + _holeCount;
+	if (unsorted > std::max<size_t>(kMinUnsortedSlots, _sortedCount / kUnsortedFraction))
+	{
+		_sortPending = true;
+		JobSystem::Get().Run(_sortJob, [this]() { Sort(_sorted); });
+	}
+}
+
+void TransformHierarchy::Sort(SortedLayout& sorted) const
+{
+	const auto sortedCount = static_cast<std::uint32_t>(_sortedCount);
+	const auto slotCount = static_cast<std::uint32_t>(_nodes.size());
+	// Room for the tail that can build up until the next sort swaps in, otherwise the first Add after this one is
+	// swapped in copies every array
+	const size_t capacity = _nodeCount + 2u * std::max<size_t>(kMinUnsortedSlots, _nodeCount / kUnsortedFraction);
+
+	// Tail nodes listed per parent slot in slot order, so they can follow their parent's sorted children
+	auto& tailHeads = sorted._tailHeads;
+	auto& tailNext = sorted._tailNext;
+	tailHeads.assign(slotCount, kNoNode);
+	tailNext.assign(slotCount - sortedCount, kNoNode);
+	std::uint32_t tailRoots = kNoNode;
+	for (std::uint32_t slot = slotCount; slot-- > sortedCount;)
+	{
+		if (_nodes[slot] == kNoNode)
+			continue;
+		auto& head = _parents[slot] == kNoNode ? tailRoots : tailHeads[_parents[slot]];
+		tailNext[slot - sortedCount] = head;
+		head = slot;
+	}
+
+	// Breadth first over the old slots from the roots, which keep their order. A node's children are appended together
+	// so they end up contiguous: the live ones of its sorted range, then its tail ones. The sorted ranges are already
+	// in order, so most of the slots below are read sequentially
+	auto& order = sorted._nodes;
+	auto& parents = sorted._parents;
+	order.clear();
+	order.reserve(capacity);
+	parents.clear();
+	parents.reserve(capacity);
+	auto append = [&](std::uint32_t slot, std::uint32_t parent)
+		{
+			order.push_back(slot);
+			parents.push_back(parent);
+		};
+	auto appendTail = [&](std::uint32_t first, std::uint32_t parent)
+		{
+			for (std::uint32_t slot = first; slot != kNoNode; slot = tailNext[slot - sortedCount])
+				append(slot, parent);
+		};
+
+	const std::uint32_t sortedRoots = _levels.size() > 1u ? _levels[1] : 0u;
+	for (std::uint32_t slot = 0; slot < sortedRoots; slot++)
+		if (_nodes[slot] != kNoNode)
+			append(slot, kNoNode);
+	appendTail(tailRoots, kNoNode);
+
+	auto& firstChildren = sorted._firstChildren;
+	firstChildren.resize(_nodeCount + 1u);
+	sorted._levels.assign(1u, 0u);
+	size_t begin = 0u;
+	while (begin < order.size())
+	{
+		const size_t levelEnd = order.size();
+		for (size_t i = begin; i < levelEnd; i++)
+		{
+			firstChildren[i] = static_cast<std::uint32_t>(order.size());
+			const std::uint32_t slot = order[i];
+			const auto parent = static_cast<std::uint32_t>(i);
+			if (slot < sortedCount)
+				for (std::uint32_t child = _firstChildren[slot]; child < _firstChildren[slot + 1u]; child++)
+					if (_nodes[child] != kNoNode)
+						append(child, parent);
+			appendTail(tailHeads[slot], parent);
+		}
+		sorted._levels.push_back(static_cast<std::uint32_t>(levelEnd));
+		begin = levelEnd;
+	}
+	assert(order.size() == _nodeCount);
+	firstChildren[_nodeCount] = static_cast<std::uint32_t>(_nodeCount);
+
+	auto permute = [&order, capacity](const auto& values, auto& permuted)
+		{
+			permuted.reserve(capacity);
+			permuted.resize(order.size());
+			for (size_t slot = 0; slot < order.size(); slot++)
+				permuted[slot] = values[order[slot]];
+		};
+	permute(_translations, sorted._translations);
+	permute(_rotations, sorted._rotations);
+	permute(_scales, sorted._scales);
+	permute(_worlds, sorted._worlds);
+
+	// Removed nodes keep kNoNode. The order turns from old slots into nodes
+	sorted._slots = _slots;
+	for (size_t slot = 0; slot < order.size(); slot++)
+	{
+		order[slot] = _nodes[order[slot]];
+		sorted._slots[order[slot]] = static_cast<std::uint32_t>(slot);
+	}
+	sorted._stamps.reserve(capacity);
+	sorted._stamps.assign(order.size(), 0u);
+}
+
+void TransformHierarchy::ApplySort()
+{
+	if (!_sortPending)
+		return;
+
+	// Usually done long ago, the job had the rest of the frame
+	JobSystem::Get().Wait(_sortJob);
+	_sortPending = false;
+
+	_translations.swap(_sorted._translations);
+	_rotations.swap(_sorted._rotations);
+	_scales.swap(_sorted._scales);
+	_worlds.swap(_sorted._worlds);
+	_parents.swap(_sorted._parents);
+	_nodes.swap(_sorted._nodes);
+	_stamps.swap(_sorted._stamps);
+	_firstChildren.swap(_sorted._firstChildren);
+	_levels.swap(_sorted._levels);
+	_slots.swap(_sorted._slots);
+	_sortedCount = _nodes.size();
+	_holeCount = 0u;
+}
+
+void TransformHierarchy::AppendRange(std::vector<SlotRange>& ranges, std::uint32_t begin, std::uint32_t end)
+{
+	if (begin == end)
+		return;
+
+	if (!ranges.empty() && begin <= ranges.back()._end)
+		ranges.back()._end = std::max<std::uint32_t>(ranges.back()._end, end);
+	else
+		ranges.push_back({ begin, end, 0u });
+}
+
+void TransformHierarchy::UpdateLevel(std::span<const SlotRange> ranges)
+{
+	// Parents are a level up and already final, every node of the level can be computed independently
+	const std::uint32_t base = ranges.front()._offset;
+	const size_t count = ranges.back()._offset + (ranges.back()._end - ranges.back()._begin) - base;
+
+	auto updateNodes = [&](size_t begin, size_t end)
+		{
+			auto range = std::upper_bound(ranges.begin(), ranges.end(), begin + base,
+				[](size_t offset, const SlotRange& r) { return offset < r._offset; }) - 1;
+
+			for (size_t i = begin; i < end; i++)
+			{
+				if (i + base >= range->_offset + (range->_end - range->_begin))
+					++range;
+
+				const std::uint32_t slot = range->_begin + static_cast<std::uint32_t>(i + base - range->_offset);
+				_changed[i + base] = _nodes[slot];
+				if (_nodes[slot] != kNoNode)
+					ComputeWorld(slot);
+			}
+		};
+
+	// The levels of a deep hierarchy mostly hold a few nodes, those don't go through the job system at all
+	if (count < 2u * kMinNodesPerRange)
+		updateNodes(0u, count);
+	else
+		parallel::ForRange(count, kMinNodesPerRange, updateNodes);
+}
+
+void TransformHierarchy::UpdateTail()
+{
+	for (size_t slot = _sortedCount; slot < _nodes.size(); slot++)
+	{
+		if (_nodes[slot] == kNoNode)
+			continue;
+
+		const std::uint32_t parent = _parents[slot];
+		if (_stamps[slot] != _stamp && (parent == kNoNode || _stamps[parent] != _stamp))
+			continue;
+
+		ComputeWorld(static_cast<std::uint32_t>(slot));
+		_changed.push_back(_nodes[slot]);
+	}
+}
+
+void TransformHierarchy::ComputeWorld(std::uint32_t slot) noexcept
+{
+	const XMFLOAT3& scale = _scales[slot];
+
+	XMMATRIX world = XMMatrixRotationQuaternion(XMLoadFloat4(&_rotations[slot]));
+	world.r[0] = XMVectorScale(world.r[0], scale.x);
+	world.r[1] = XMVectorScale(world.r[1], scale.y);
+	world.r[2] = XMVectorScale(world.r[2], scale.z);
+	world.r[3] = XMVectorSetW(XMLoadFloat3(&_translations[slot]), 1.f);
+
+	const std::uint32_t parent = _parents[slot];
+	if (parent != kNoNode)
+		world = XMMatrixMultiply(world, XMLoadFloat4x4(&_worlds[parent]));
+
+	XMStoreFloat4x4(&_worlds[slot], world);
+	_stamps[slot] = _stamp;
+}
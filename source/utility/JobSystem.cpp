@@ -0,0 +1,245 @@
+#include "../../include/sasha/utility/JobSystem.h"
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	// Index of the calling thread in the system it works for, 0 for the main thread
+	thread_local size_t t_threadIndex = 0u;
+}
+
+bool JobDeque::Push(Job* job) noexcept
+{
+	const std::int64_t bottom = _bottom.load(std::memory_order_relaxed);
+	const std::int64_t top = _top.load(std::memory_order_acquire);
+	if (bottom - top >= static_cast<std::int64_t>(kCapacity))
+		return false;
+
+	_jobs[bottom & (kCapacity - 1u)].store(job, std::memory_order_relaxed);
+	_bottom.store(bottom + 1, std::memory_order_release);
+	return true;
+}
+
+Job* JobDeque::Pop() noexcept
+{
+	const std::int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+	_bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	std::int64_t top = _top.load(std::memory_order_relaxed);
+
+	if (top > bottom)
+	{
+		_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Job* job = _jobs[bottom & (kCapacity - 1u)].load(std::memory_order_relaxed);
+	if (top == bottom)
+	{
+		// Last job, a thief may be taking it at the same time
+		if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			job = nullptr;
+		_bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+Job* JobDeque::Steal() noexcept
+{
+	std::int64_t top = _top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	const std::int64_t bottom = _bottom.load(std::memory_order_acquire);
+	if (top >= bottom)
+		return nullptr;
+
+	Job* job = _jobs[top & (kCapacity - 1u)].load(std::memory_order_relaxed);
+	if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		return nullptr;
+	return job;
+}
+
+JobSystem::JobSystem(size_t workerCount)
+{
+	_deques.reserve(workerCount + 1u);
+	for (size_t i = 0; i <= workerCount; i++)
+		_deques.push_back(std::make_unique<ThreadState>());
+
+	_workers.reserve(workerCount);
+	for (size_t i = 1; i <= workerCount; i++)
+		_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::unique_lock lock(_sleepMutex);
+		_running.store(false, std::memory_order_release);
+	}
+	_wake.notify_all();
+
+	for (auto& worker : _workers)
+		worker.join();
+}
+
+JobSystem& JobSystem::Get()
+{
+	// At least one worker, so a job left running in the background, such as the transform hierarchy's sort, still
+	// moves on while the main thread sleeps on the GPU fence of a single core machine
+	static JobSystem jobSystem(std::max<size_t>(2u, std::thread::hardware_concurrency()) - 1u);
+	return jobSystem;
+}
+
+void JobSystem::Wait(const JobCounter& counter)
+{
+	while (!counter.IsDone())
+	{
+		if (Job* job = FindJob())
+			Execute(job);
+		else
+			std::this_thread::yield();
+	}
+}
+
+size_t JobSystem::GetThreadIndex() const noexcept
+{
+	assert(t_threadIndex < _deques.size());
+	assert((t_threadIndex != 0u || std::this_thread::get_id() == _mainThread) && "Jobs scheduled or waited on from a thread the system doesn't own");
+	return t_threadIndex;
+}
+
+Job* JobSystem::Allocate()
+{
+	auto& state = *_deques[GetThreadIndex()];
+	for (;;)
+	{
+		Job* job = &state._pool[state._poolIndex];
+		if (job->_run.load(std::memory_order_acquire) == nullptr)
+		{
+			state._poolIndex = (state._poolIndex + 1u) & (kJobPoolSize - 1u);
+			return job;
+		}
+
+		// The ring wrapped onto a job that hasn't finished: still queued, held back by a dependency, running on another
+		// thread or further up this thread's stack. One queued job is run, the oldest of this thread first since it's
+		// likely the one in the slot, and a slot still taken after that is skipped
+		if (Job* queued = state._deque.Steal())
+			Execute(queued);
+		else if (Job* other = FindJob())
+			Execute(other);
+		else
+			std::this_thread::yield();
+
+		// Reread, the job run above may have scheduled from this thread and moved the ring on
+		if (state._pool[state._poolIndex]._run.load(std::memory_order_acquire) != nullptr)
+			state._poolIndex = (state._poolIndex + 1u) & (kJobPoolSize - 1u);
+	}
+}
+
+void JobSystem::Schedule(Job* job, JobCounter& counter, JobCounter* dependency)
+{
+	// Below two the last job may be closing the counter right now, the lock orders this after it
+	if (counter._pending.fetch_add(1u, std::memory_order_relaxed) <= 1u)
+	{
+		std::unique_lock lock(counter._mutex);
+		counter._open = true;
+	}
+
+	if (dependency)
+	{
+		// The last job of the dependency closes it under the same lock, so it either sees this job or it already finished
+		std::unique_lock lock(dependency->_mutex);
+		if (dependency->_open)
+		{
+			dependency->_dependents.push_back(job);
+			return;
+		}
+	}
+
+	Push(job);
+}
+
+void JobSystem::Push(Job* job)
+{
+	if (!_deques[GetThreadIndex()]->_deque.Push(job))
+	{
+		Execute(job);
+		return;
+	}
+
+	// Sequentially consistent with the worker going to sleep, so either it sees the new signal or this sees it asleep
+	_jobSignal.fetch_add(1u, std::memory_order_seq_cst);
+	if (_sleeping.load(std::memory_order_seq_cst) > 0u)
+	{
+		// Taken so the notify can't land between the worker's last look at the signal and its wait
+		{ std::unique_lock lock(_sleepMutex); }
+		_wake.notify_one();
+	}
+}
+
+Job* JobSystem::FindJob() noexcept
+{
+	const size_t index = GetThreadIndex();
+	if (Job* job = _deques[index]->_deque.Pop())
+		return job;
+
+	for (size_t i = 1; i < _deques.size(); i++)
+		if (Job* job = _deques[(index + i) % _deques.size()]->_deque.Steal())
+			return job;
+
+	return nullptr;
+}
+
+void JobSystem::Execute(Job* job)
+{
+	JobCounter* counter = job->_counter;
+	job->_run.load(std::memory_order_relaxed)(job->_data);
+	// Frees the slot, the ring of the thread that scheduled it may be waiting on it
+	job->_run.store(nullptr, std::memory_order_release);
+
+	std::uint32_t pending = counter->_pending.load(std::memory_order_relaxed);
+	while (pending > 1u)
+		if (counter->_pending.compare_exchange_weak(pending, pending - 1u, std::memory_order_acq_rel, std::memory_order_relaxed))
+			return;
+
+	// Last job of the counter. Its dependents are released before it reads as done, since whoever waits on it may
+	// destroy it as soon as it does, the final decrement has to be the last access
+	std::vector<Job*> dependents;
+	{
+		std::unique_lock lock(counter->_mutex);
+		if (counter->_pending.load(std::memory_order_relaxed) > 1u)
+		{
+			// More jobs were added meanwhile, they will close it
+			counter->_pending.fetch_sub(1u, std::memory_order_acq_rel);
+			return;
+		}
+		counter->_open = false;
+		dependents.swap(counter->_dependents);
+	}
+	for (Job* dependent : dependents)
+		Push(dependent);
+
+	counter->_pending.fetch_sub(1u, std::memory_order_acq_rel);
+}
+
+void JobSystem::WorkerLoop(size_t index)
+{
+	t_threadIndex = index;
+
+	while (_running.load(std::memory_order_acquire))
+	{
+		const std::uint32_t signal = _jobSignal.load(std::memory_order_acquire);
+		if (Job* job = FindJob())
+		{
+			Execute(job);
+			continue;
+		}
+
+		std::unique_lock lock(_sleepMutex);
+		_sleeping.fetch_add(1u, std::memory_order_seq_cst);
+		_wake.wait(lock, [&]()
+			{
+				return _jobSignal.load(std::memory_order_seq_cst) != signal || !_running.load(std::memory_order_acquire);
+			});
+		_sleeping.fetch_sub(1u, std::memory_order_relaxed);
+	}
+}
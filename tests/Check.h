@@ -0,0 +1,36 @@
+#pragma once
+#include <cmath>
+#include <cstdio>
+
+// Checks for the test executables: a failed check prints where it failed and the test returns non zero at the end,
+// so one run reports every failure instead of the first
+
+namespace check
+{
+	inline int& GetFailureCount() noexcept
+	{
+		static int failures = 0;
+		return failures;
+	}
+
+	inline void Fail(const char* file, int line, const char* expression) noexcept
+	{
+		std::printf("%s:%d: check failed: %s\n", file, line, expression);
+		GetFailureCount()++;
+	}
+
+	// What main returns
+	inline int Result() noexcept
+	{
+		if (GetFailureCount() > 0)
+			std::printf("%d check(s) failed\n", GetFailureCount());
+		return GetFailureCount() > 0 ? 1 : 0;
+	}
+}
+
+#define CHECK(condition) \
+	do { if (!(condition)) check::Fail(__FILE__, __LINE__, #condition); } while (false)
+
+#define CHECK_NEAR(value, expected, tolerance) \
+	do { if (!(std::fabs(static_cast<double>(value) - static_cast<double>(expected)) <= static_cast<double>(tolerance))) \
+		check::Fail(__FILE__, __LINE__, #value " == " #expected " +- " #tolerance); } while (false)
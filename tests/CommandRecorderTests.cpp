@@ -0,0 +1,194 @@
+#include "Check.h"
+#include "CommandTestUtil.h"
+
+namespace
+{
+	using command_test::FakeCommandList;
+	using Recorder = CommandRecorder<FakeCommandList>;
+
+	// Every call that reached the list was counted as issued, and issued plus elided is every call made
+	void CheckCounters(const Recorder& recorder, const FakeCommandList& cmdList, RecordedCall call, size_t issued, size_t elided)
+	{
+		CHECK(cmdList.GetCalls(call) == issued);
+		CHECK(recorder.GetCounters().GetIssued(call) == issued);
+		CHECK(recorder.GetCounters().GetElided(call) == elided);
+	}
+
+	void TestPipelineState()
+	{
+		ID3D12PipelineState a, b;
+		FakeCommandList cmdList;
+		// The list was reset with a, so binding it again is dropped from the start
+		Recorder recorder(&cmdList, &a);
+		recorder.SetPipelineState(&a);
+		recorder.SetPipelineState(&b);
+		recorder.SetPipelineState(&b);
+		recorder.SetPipelineState(&a);
+		CheckCounters(recorder, cmdList, RecordedCall::PipelineState, 2u, 2u);
+	}
+
+	void TestRootSignature()
+	{
+		ID3D12RootSignature a, b;
+		FakeCommandList cmdList;
+		Recorder recorder(&cmdList);
+		recorder.SetGraphicsRootSignature(&a);
+		recorder.SetGraphicsRootSignature(&a);
+		recorder.SetGraphicsRootSignature(&b);
+		CheckCounters(recorder, cmdList, RecordedCall::RootSignature, 2u, 1u);
+	}
+
+	void TestRootArguments()
+	{
+		FakeCommandList cmdList;
+		Recorder recorder(&cmdList);
+		recorder.SetGraphicsRootDescriptorTable(0u, { 0x100u });
+		recorder.SetGraphicsRootDescriptorTable(0u, { 0x100u });
+		recorder.SetGraphicsRootDescriptorTable(0u, { 0x200u });
+		recorder.SetGraphicsRootConstantBufferView(1u, 0x1000u);
+		recorder.SetGraphicsRootConstantBufferView(1u, 0x1000u);
+		// Same address but a different view type is a different binding
+		recorder.SetGraphicsRootShaderResourceView(1u, 0x1000u);
+		recorder.SetGraphicsRootShaderResourceView(1u, 0x1000u);
+		recorder.SetGraphicsRootConstantBufferView(2u, 0x1000u);
+		CheckCounters(recorder, cmdList, RecordedCall::RootDescriptorTable, 2u, 1u);
+		CheckCounters(recorder, cmdList, RecordedCall::RootDescriptor, 3u, 2u);
+
+		// Indices past the shadowed range are never dropped
+		recorder.SetGraphicsRootConstantBufferView(Recorder::kMaxRootParameters, 0x1000u);
+		recorder.SetGraphicsRootConstantBufferView(Recorder::kMaxRootParameters, 0x1000u);
+		CheckCounters(recorder, cmdList, RecordedCall::RootDescriptor, 5u, 2u);
+	}
+
+	void TestRootSignatureInvalidatesArguments()
+	{
+		ID3D12RootSignature a, b;
+		FakeCommandList cmdList;
+		Recorder recorder(&cmdList);
+		recorder.SetGraphicsRootSignature(&a);
+		recorder.SetGraphicsRootDescriptorTable(0u, { 0x100u });
+		recorder.SetGraphicsRootConstantBufferView(1u, 0x1000u);
+
+		// Rebinding the same signature keeps the arguments
+		recorder.SetGraphicsRootSignature(&a);
+		recorder.SetGraphicsRootDescriptorTable(0u, { 0x100u });
+		recorder.SetGraphicsRootConstantBufferView(1u, 0x1000u);
+		CheckCounters(recorder, cmdList, RecordedCall::RootDescriptorTable, 1u, 1u);
+		CheckCounters(recorder, cmdList, RecordedCall::RootDescriptor, 1u, 1u);
+
+		// A different one clears every argument, so the same values go through again
+		recorder.SetGraphicsRootSignature(&b);
+		recorder.SetGraphicsRootDescriptorTable(0u, { 0x100u });
+		recorder.SetGraphicsRootConstantBufferView(1u, 0x1000u);
+		CheckCounters(recorder, cmdList, RecordedCall::RootDescriptorTable, 2u, 1u);
+		CheckCounters(recorder, cmdList, RecordedCall::RootDescriptor, 2u, 1u);
+	}
+
+	void TestDescriptorHeaps()
+	{
+		ID3D12DescriptorHeap srv, sampler, other;
+		ID3D12DescriptorHeap* const both[] = { &srv, &sampler };
+		ID3D12DescriptorHeap* const swapped[] = { &other, &sampler };
+
+		FakeCommandList cmdList;
+		Recorder recorder(&cmdList);
+		recorder.SetDescriptorHeaps(2u, both);
+		recorder.SetDescriptorHeaps(2u, both);
+		recorder.SetDescriptorHeaps(1u, both);
+		recorder.SetDescriptorHeaps(1u, both);
+		recorder.SetDescriptorHeaps(1u, swapped);
+		CheckCounters(recorder, cmdList, RecordedCall::DescriptorHeaps, 3u, 2u);
+	}
+
+	// Tables point into the heaps and go through again after the heaps change, root descriptors don't
+	void TestDescriptorHeapsInvalidateTables()
+	{
+		ID3D12DescriptorHeap a, b;
+		ID3D12DescriptorHeap* const first[] = { &a };
+		ID3D12DescriptorHeap* const second[] = { &b };
+
+		FakeCommandList cmdList;
+		Recorder recorder(&cmdList);
+		recorder.SetDescriptorHeaps(1u, first);
+		recorder.SetGraphicsRootDescriptorTable(0u, { 0x100u });
+		recorder.SetGraphicsRootConstantBufferView(1u, 0x1000u);
+
+		recorder.SetDescriptorHeaps(1u, first);
+		recorder.SetGraphicsRootDescriptorTable(0u, { 0x100u });
+		CheckCounters(recorder, cmdList, RecordedCall::RootDescriptorTable, 1u, 1u);
+
+		recorder.SetDescriptorHeaps(1u, second);
+		recorder.SetGraphicsRootDescriptorTable(0u, { 0x100u });
+		recorder.SetGraphicsRootConstantBufferView(1u, 0x1000u);
+		CheckCounters(recorder, cmdList, RecordedCall::RootDescriptorTable, 2u, 1u);
+		CheckCounters(recorder, cmdList, RecordedCall::RootDescriptor, 1u, 1u);
+	}
+
+	void TestInputAssembler()
+	{
+		const D3D12_VERTEX_BUFFER_VIEW vertices = { 0x1000u, 256u, 32u };
+		const D3D12_VERTEX_BUFFER_VIEW otherVertices = { 0x1000u, 256u, 16u };
+		const D3D12_INDEX_BUFFER_VIEW indices16 = { 0x2000u, 64u, DXGI_FORMAT_R16_UINT };
+		const D3D12_INDEX_BUFFER_VIEW indices32 = { 0x2000u, 64u, DXGI_FORMAT_R32_UINT };
+
+		FakeCommandList cmdList;
+		Recorder recorder(&cmdList);
+		recorder.IASetVertexBuffers(0u, 1u, &vertices);
+		recorder.IASetVertexBuffers(0u, 1u, &vertices);
+		// Another slot has nothing bound yet, and any field changing the view counts
+		recorder.IASetVertexBuffers(1u, 1u, &vertices);
+		recorder.IASetVertexBuffers(0u, 1u, &otherVertices);
+		CheckCounters(recorder, cmdList, RecordedCall::VertexBuffers, 3u, 1u);
+
+		// An index buffer view that is all zeros is still a first bind
+		const D3D12_INDEX_BUFFER_VIEW zero{};
+		recorder.IASetIndexBuffer(&zero);
+		recorder.IASetIndexBuffer(&indices16);
+		recorder.IASetIndexBuffer(&indices16);
+		recorder.IASetIndexBuffer(&indices32);
+		CheckCounters(recorder, cmdList, RecordedCall::IndexBuffer, 3u, 1u);
+
+		recorder.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		recorder.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		recorder.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_LINELIST);
+		CheckCounters(recorder, cmdList, RecordedCall::PrimitiveTopology, 2u, 1u);
+	}
+
+	// Reset forgets the bound state for the next command list but keeps the counters for the frame
+	void TestReset()
+	{
+		ID3D12PipelineState pso;
+		const D3D12_VERTEX_BUFFER_VIEW vertices = { 0x1000u, 256u, 32u };
+
+		FakeCommandList cmdList;
+		Recorder recorder(&cmdList);
+		recorder.SetPipelineState(&pso);
+		recorder.IASetVertexBuffers(0u, 1u, &vertices);
+		recorder.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+		recorder.Reset(&cmdList);
+		recorder.SetPipelineState(&pso);
+		recorder.IASetVertexBuffers(0u, 1u, &vertices);
+		recorder.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		CheckCounters(recorder, cmdList, RecordedCall::PipelineState, 2u, 0u);
+		CheckCounters(recorder, cmdList, RecordedCall::VertexBuffers, 2u, 0u);
+		CheckCounters(recorder, cmdList, RecordedCall::PrimitiveTopology, 2u, 0u);
+
+		recorder.ResetCounters();
+		CHECK(recorder.GetCounters().GetIssued(RecordedCall::PipelineState) == 0u);
+		CHECK(recorder.GetCounters().GetElided(RecordedCall::PipelineState) == 0u);
+	}
+}
+
+int main()
+{
+	TestPipelineState();
+	TestRootSignature();
+	TestRootArguments();
+	TestRootSignatureInvalidatesArguments();
+	TestDescriptorHeaps();
+	TestDescriptorHeapsInvalidateTables();
+	TestInputAssembler();
+	TestReset();
+	return check::Result();
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "../include/sasha/renderer/core/CommandRecorder.h"
+#include "../include/sasha/renderer/core/DrawRecording.h"
+#include <array>
+#include <random>
+#include <vector>
+
+// Helpers shared by the command recording tests and benchmark
+
+namespace command_test
+{
+	// Stands in for ID3D12GraphicsCommandList and counts the calls that reach it
+	struct FakeCommandList
+	{
+		std::array<size_t, static_cast<size_t>(RecordedCall::Count)> _calls{};
+		size_t _draws = 0u;
+
+		size_t GetCalls(RecordedCall call) const noexcept { return _calls[static_cast<size_t>(call)]; }
+		void Count(RecordedCall call) noexcept { _calls[static_cast<size_t>(call)]++; }
+
+		void SetPipelineState(ID3D12PipelineState*) { Count(RecordedCall::PipelineState); }
+		void SetGraphicsRootSignature(ID3D12RootSignature*) { Count(RecordedCall::RootSignature); }
+		void SetDescriptorHeaps(UINT, ID3D12DescriptorHeap* const*) { Count(RecordedCall::DescriptorHeaps); }
+		void SetGraphicsRootDescriptorTable(UINT, D3D12_GPU_DESCRIPTOR_HANDLE) { Count(RecordedCall::RootDescriptorTable); }
+		void SetGraphicsRootConstantBufferView(UINT, D3D12_GPU_VIRTUAL_ADDRESS) { Count(RecordedCall::RootDescriptor); }
+		void SetGraphicsRootShaderResourceView(UINT, D3D12_GPU_VIRTUAL_ADDRESS) { Count(RecordedCall::RootDescriptor); }
+		void IASetVertexBuffers(UINT, UINT, const D3D12_VERTEX_BUFFER_VIEW*) { Count(RecordedCall::VertexBuffers); }
+		void IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW*) { Count(RecordedCall::IndexBuffer); }
+		void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY) { Count(RecordedCall::PrimitiveTopology); }
+
+		void RSSetViewports(UINT, const D3D12_VIEWPORT*) {}
+		void RSSetScissorRects(UINT, const D3D12_RECT*) {}
+		void OMSetRenderTargets(UINT, const D3D12_CPU_DESCRIPTOR_HANDLE*, bool, const D3D12_CPU_DESCRIPTOR_HANDLE*) {}
+		void DrawIndexedInstanced(UINT, UINT, UINT, INT, UINT) { _draws++; }
+	};
+
+	// Frame constants, heaps and root signature like the renderer binds them, the objects are only used as addresses
+	struct FrameObjects
+	{
+		std::array<ID3D12PipelineState, 3> _pipelines;
+		ID3D12RootSignature _rootSignature;
+		ID3D12DescriptorHeap _heap;
+
+		DrawListSetup MakeSetup()
+		{
+			DrawListSetup setup;
+			setup._rootSignature = &_rootSignature;
+			setup._heaps[0] = &_heap;
+			setup._heapCount = 1u;
+			setup._rootArguments[0] = { 2u, RootArgumentBinding::Type::Cbv, 0x90000u };
+			setup._rootArguments[1] = { 3u, RootArgumentBinding::Type::Srv, 0xa0000u };
+			setup._rootArgumentCount = 2u;
+			return setup;
+		}
+	};
+
+	// Draws in the order the draw packets sort them: by layer pipeline, then in runs sharing a mesh and a material,
+	// each with its own object constants
+	inline std::vector<DrawCommand> MakeDraws(FrameObjects& objects, size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::vector<DrawCommand> draws(count);
+		size_t runLeft = 0u;
+		DrawCommand run;
+		for (size_t i = 0; i < count; i++)
+		{
+			if (runLeft == 0u)
+			{
+				const size_t mesh = random() % 64u;
+				run._vertexBuffer = { 0x100000u + 0x10000u * mesh, 0x10000u, 32u };
+				run._indexBuffer = { 0x800000u + 0x4000u * mesh, 0x4000u, mesh % 4u == 0u ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT };
+				run._rootArguments[1] = { 1u, RootArgumentBinding::Type::Table, 0x100u + 0x20u * (random() % 16u) };
+				run._indexCount = 36u + 12u * static_cast<UINT>(mesh);
+				run._instanceCount = 1u + static_cast<UINT>(random() % 3u);
+				runLeft = 1u + random() % 12u;
+			}
+			runLeft--;
+
+			auto& draw = draws[i];
+			draw = run;
+			draw._pso = &objects._pipelines[i * objects._pipelines.size() / count];
+			draw._rootArguments[0] = { 0u, RootArgumentBinding::Type::Cbv, 0x40000u + 256u * i };
+			draw._rootArgumentCount = 2u;
+		}
+		return draws;
+	}
+}
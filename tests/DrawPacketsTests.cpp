@@ -0,0 +1,117 @@
+#include "Check.h"
+#include "../include/sasha/renderer/scene/DrawPackets.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+	constexpr size_t kLayerCount = static_cast<size_t>(RenderLayer::Count);
+
+	void TestLayout()
+	{
+		const auto small = DrawKeyLayout::FromCounts(kLayerCount, 8u, 16u, 1000u);
+		CHECK(small._pipelineBits == 2u && small._materialBits == 3u && small._submeshBits == 4u && small._itemBits == 10u);
+		CHECK(small._depthBits == DrawKeyLayout::kMaxDepthBits);
+		CHECK(small.GetKeyBits() == 35u);
+
+		// A single value takes no bits at all
+		const auto single = DrawKeyLayout::FromCounts(1u, 1u, 1u, 1u);
+		CHECK(single.GetStateBits() == 0u && single._itemBits == 0u);
+
+		// Full width IDs and a million items leave 4 bits of depth
+		const auto wide = DrawKeyLayout::FromCounts(64u, 65536u, 65536u, 1u << 20);
+		CHECK(wide._depthBits == 4u);
+		CHECK(wide.GetKeyBits() + wide._itemBits == 64u);
+	}
+
+	void TestFields()
+	{
+		const auto layout = DrawKeyLayout::FromCounts(kLayerCount, 8u, 16u, 1000u);
+		for (auto layer : { RenderLayer::Opaque, RenderLayer::AlphaTested, RenderLayer::Transparent })
+		{
+			const auto packet = layout.MakePacket(layer, 2u, 7u, 15u, 0.5f, 999u);
+			CHECK(layout.GetItem(packet) == 999u);
+			CHECK(layout.GetLayer(packet) == layer);
+			// The state ignores the depth and the item, but not the layer
+			CHECK(layout.GetState(packet) == layout.GetState(layout.MakePacket(layer, 2u, 7u, 15u, 0.9f, 3u)));
+			CHECK(layout.GetState(packet) != layout.GetState(layout.MakePacket(layer, 2u, 6u, 15u, 0.5f, 999u)));
+			CHECK(layout.GetState(packet) != layout.GetState(layout.MakePacket(layer, 2u, 7u, 14u, 0.5f, 999u)));
+			CHECK(layout.GetState(packet) != layout.GetState(layout.MakePacket(layer, 1u, 7u, 15u, 0.5f, 999u)));
+		}
+		CHECK(layout.GetState(layout.MakePacket(RenderLayer::Opaque, 0u, 1u, 1u, 0.5f, 0u)) !=
+			layout.GetState(layout.MakePacket(RenderLayer::AlphaTested, 0u, 1u, 1u, 0.5f, 0u)));
+	}
+
+	void TestOrder()
+	{
+		const auto layout = DrawKeyLayout::FromCounts(kLayerCount, 8u, 16u, 1000u);
+		auto key = [&](std::uint64_t packet) { return packet >> layout._itemBits; };
+
+		// Layers in order whatever the depth
+		CHECK(key(layout.MakePacket(RenderLayer::Opaque, 0u, 7u, 15u, 1.f, 0u)) < key(layout.MakePacket(RenderLayer::AlphaTested, 0u, 0u, 0u, 0.f, 0u)));
+		CHECK(key(layout.MakePacket(RenderLayer::AlphaTested, 1u, 7u, 15u, 1.f, 0u)) < key(layout.MakePacket(RenderLayer::Transparent, 0u, 0u, 0u, 0.f, 0u)));
+
+		// Opaques group by state, then go front to back
+		CHECK(key(layout.MakePacket(RenderLayer::Opaque, 0u, 1u, 0u, 0.9f, 0u)) < key(layout.MakePacket(RenderLayer::Opaque, 0u, 2u, 0u, 0.1f, 0u)));
+		CHECK(key(layout.MakePacket(RenderLayer::Opaque, 0u, 1u, 0u, 0.1f, 0u)) < key(layout.MakePacket(RenderLayer::Opaque, 0u, 1u, 0u, 0.2f, 0u)));
+
+		// Transparents go back to front whatever their state
+		CHECK(key(layout.MakePacket(RenderLayer::Transparent, 2u, 7u, 15u, 0.9f, 0u)) < key(layout.MakePacket(RenderLayer::Transparent, 2u, 0u, 0u, 0.1f, 0u)));
+
+		// Out of range and NaN depths clamp
+		CHECK(key(layout.MakePacket(RenderLayer::Opaque, 0u, 1u, 0u, -5.f, 0u)) == key(layout.MakePacket(RenderLayer::Opaque, 0u, 1u, 0u, std::nanf(""), 0u)));
+		CHECK(key(layout.MakePacket(RenderLayer::Opaque, 0u, 1u, 0u, 5.f, 0u)) == key(layout.MakePacket(RenderLayer::Opaque, 0u, 1u, 0u, 1.f, 0u)));
+	}
+
+	// The sort must match a stable comparison sort on the keys, so equal keys keep the visible order
+	void CheckSort(size_t pipelineCount, size_t materialCount, size_t submeshCount, size_t count, int depthLevels, std::uint32_t seed)
+	{
+		const auto layout = DrawKeyLayout::FromCounts(pipelineCount, materialCount, submeshCount, count);
+
+		std::mt19937 random(seed);
+		std::uniform_int_distribution<int> layer(0, static_cast<int>(kLayerCount) - 1);
+		std::uniform_int_distribution<size_t> pipeline(0u, pipelineCount - 1u);
+		std::uniform_int_distribution<size_t> material(0u, materialCount - 1u);
+		std::uniform_int_distribution<size_t> submesh(0u, submeshCount - 1u);
+		std::uniform_int_distribution<int> depth(0, depthLevels - 1);
+
+		std::vector<std::uint64_t> packets(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			packets[i] = layout.MakePacket(static_cast<RenderLayer>(layer(random)), static_cast<std::uint8_t>(pipeline(random)),
+				static_cast<std::uint16_t>(material(random)), static_cast<std::uint16_t>(submesh(random)),
+				static_cast<float>(depth(random)) / static_cast<float>(depthLevels), static_cast<std::uint32_t>(i));
+		}
+
+		auto expected = packets;
+		std::stable_sort(expected.begin(), expected.end(), [&](std::uint64_t a, std::uint64_t b) { return a >> layout._itemBits < b >> layout._itemBits; });
+
+		std::vector<std::uint64_t> scratch(count);
+		DrawPackets::RadixSort(packets, scratch, layout);
+		CHECK(packets == expected);
+	}
+
+	void TestSort()
+	{
+		for (size_t count : { 0u, 1u, 2u, 3u, 1000u, 100000u })
+		{
+			CheckSort(kLayerCount, 8u, 16u, count, 1 << 20, 1u);
+			// Few depths make many equal keys
+			CheckSort(kLayerCount, 8u, 16u, count, 4, 2u);
+			CheckSort(64u, 65536u, 65536u, count, 1 << 20, 3u);
+		}
+		// A key of one digit, every pass but the first is skipped
+		CheckSort(1u, 1u, 1u, 5000u, 16, 4u);
+	}
+}
+
+int main()
+{
+	TestLayout();
+	TestFields();
+	TestOrder();
+	TestSort();
+	return check::Result();
+}
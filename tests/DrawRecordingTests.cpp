@@ -0,0 +1,220 @@
+#include "Check.h"
+#include "CommandTestUtil.h"
+#include "../include/sasha/utility/Parallel.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	using command_test::FakeCommandList;
+	using Recorder = CommandRecorder<FakeCommandList>;
+
+	// Every call that reached the list was counted as issued, and issued plus elided is every call made
+	void CheckCounters(const Recorder& recorder, const FakeCommandList& cmdList, RecordedCall call, size_t issued, size_t elided)
+	{
+		CHECK(cmdList.GetCalls(call) == issued);
+		CHECK(recorder.GetCounters().GetIssued(call) == issued);
+		CHECK(recorder.GetCounters().GetElided(call) == elided);
+	}
+
+	// What the GPU sees bound when a draw executes
+	struct DrawState
+	{
+		static constexpr size_t kRootParameters = 8u;
+
+		ID3D12PipelineState* _pso = nullptr;
+		ID3D12RootSignature* _rootSignature = nullptr;
+		ID3D12DescriptorHeap* _heap = nullptr;
+		D3D12_GPU_VIRTUAL_ADDRESS _vertexBuffer = 0u;
+		UINT _vertexStride = 0u;
+		D3D12_GPU_VIRTUAL_ADDRESS _indexBuffer = 0u;
+		DXGI_FORMAT _indexFormat = DXGI_FORMAT_UNKNOWN;
+		D3D12_PRIMITIVE_TOPOLOGY _topology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+		// Per root parameter, the binding type and its value, a command list starts with nothing bound
+		std::array<std::pair<int, std::uint64_t>, kRootParameters> _rootArguments{};
+		UINT _indexCount = 0u;
+		UINT _instanceCount = 0u;
+
+		bool operator==(const DrawState&) const = default;
+	};
+
+	// Forwards to the counting list and tracks the bound state, which it snapshots on every draw
+	struct StateCommandList : FakeCommandList
+	{
+		DrawState _state;
+		std::vector<DrawState> _drawStates;
+
+		void SetPipelineState(ID3D12PipelineState* pso) { FakeCommandList::SetPipelineState(pso); _state._pso = pso; }
+		void SetGraphicsRootSignature(ID3D12RootSignature* rootSignature)
+		{
+			FakeCommandList::SetGraphicsRootSignature(rootSignature);
+			_state._rootSignature = rootSignature;
+			_state._rootArguments = {};
+		}
+		void SetDescriptorHeaps(UINT count, ID3D12DescriptorHeap* const* heaps)
+		{
+			FakeCommandList::SetDescriptorHeaps(count, heaps);
+			_state._heap = heaps[0];
+		}
+		void SetGraphicsRootDescriptorTable(UINT index, D3D12_GPU_DESCRIPTOR_HANDLE handle)
+		{
+			FakeCommandList::SetGraphicsRootDescriptorTable(index, handle);
+			_state._rootArguments[index] = { 1, handle.ptr };
+		}
+		void SetGraphicsRootConstantBufferView(UINT index, D3D12_GPU_VIRTUAL_ADDRESS address)
+		{
+			FakeCommandList::SetGraphicsRootConstantBufferView(index, address);
+			_state._rootArguments[index] = { 2, address };
+		}
+		void SetGraphicsRootShaderResourceView(UINT index, D3D12_GPU_VIRTUAL_ADDRESS address)
+		{
+			FakeCommandList::SetGraphicsRootShaderResourceView(index, address);
+			_state._rootArguments[index] = { 3, address };
+		}
+		void IASetVertexBuffers(UINT slot, UINT count, const D3D12_VERTEX_BUFFER_VIEW* views)
+		{
+			FakeCommandList::IASetVertexBuffers(slot, count, views);
+			_state._vertexBuffer = views[0].BufferLocation;
+			_state._vertexStride = views[0].StrideInBytes;
+		}
+		void IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* view)
+		{
+			FakeCommandList::IASetIndexBuffer(view);
+			_state._indexBuffer = view->BufferLocation;
+			_state._indexFormat = view->Format;
+		}
+		void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology)
+		{
+			FakeCommandList::IASetPrimitiveTopology(topology);
+			_state._topology = topology;
+		}
+		void DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance)
+		{
+			FakeCommandList::DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+			_state._indexCount = indexCount;
+			_state._instanceCount = instanceCount;
+			_drawStates.push_back(_state);
+		}
+	};
+
+	// Draws sharing a pipeline and mesh only bind their own constant buffer
+	void TestRecordDraws()
+	{
+		ID3D12PipelineState opaque, transparent;
+		ID3D12RootSignature rootSignature;
+		ID3D12DescriptorHeap heap;
+
+		DrawListSetup setup;
+		setup._rootSignature = &rootSignature;
+		setup._heaps[0] = &heap;
+		setup._heapCount = 1u;
+		setup._rootArguments[0] = { 2u, RootArgumentBinding::Type::Cbv, 0x9000u };
+		setup._rootArgumentCount = 1u;
+
+		std::vector<DrawCommand> draws(6u);
+		for (size_t i = 0; i < draws.size(); i++)
+		{
+			auto& draw = draws[i];
+			draw._pso = i < 4u ? &opaque : &transparent;
+			draw._vertexBuffer = { 0x1000u, 256u, 32u };
+			draw._indexBuffer = { 0x2000u, 64u, DXGI_FORMAT_R16_UINT };
+			draw._rootArguments[0] = { 0u, RootArgumentBinding::Type::Cbv, 0x4000u + 256u * i };
+			draw._rootArguments[1] = { 1u, RootArgumentBinding::Type::Table, 0x100u };
+			draw._rootArgumentCount = 2u;
+			draw._indexCount = 36u;
+			draw._instanceCount = 1u;
+		}
+
+		FakeCommandList cmdList;
+		Recorder recorder(&cmdList);
+		DrawRecording::Record(recorder, setup, draws);
+		CHECK(cmdList._draws == draws.size());
+		CheckCounters(recorder, cmdList, RecordedCall::PipelineState, 2u, 4u);
+		CheckCounters(recorder, cmdList, RecordedCall::VertexBuffers, 1u, 5u);
+		CheckCounters(recorder, cmdList, RecordedCall::IndexBuffer, 1u, 5u);
+		CheckCounters(recorder, cmdList, RecordedCall::PrimitiveTopology, 1u, 5u);
+		CheckCounters(recorder, cmdList, RecordedCall::RootDescriptorTable, 1u, 5u);
+		// The frame constants plus one per draw
+		CheckCounters(recorder, cmdList, RecordedCall::RootDescriptor, 7u, 0u);
+	}
+
+	void TestPartition()
+	{
+		std::array<DrawRange, 4> ranges;
+		CHECK(DrawRecording::Partition(0u, 16u, ranges) == 0u);
+		CHECK(DrawRecording::Partition(10u, 16u, ranges) == 1u);
+		CHECK(ranges[0]._begin == 0u && ranges[0]._end == 10u);
+
+		// 100 draws of at least 30 per list make 3 lists, covering every draw in order
+		CHECK(DrawRecording::Partition(100u, 30u, ranges) == 3u);
+		CHECK(ranges[0]._begin == 0u && ranges[2]._end == 100u);
+		for (size_t r = 1; r < 3u; r++)
+			CHECK(ranges[r]._begin == ranges[r - 1]._end);
+
+		CHECK(DrawRecording::Partition(1000u, 1u, ranges) == ranges.size());
+		CHECK(ranges[3]._end == 1000u);
+	}
+
+	// A frame split into 1 to 8 lists recorded in parallel: played back in range order, every draw sees the same
+	// state as in a single list. The only extra calls are each list's setup prologue and the first binds of each list,
+	// which a single list elided since the previous draw had bound them already
+	void TestSplitMatchesSingleList()
+	{
+		command_test::FrameObjects objects;
+		const DrawListSetup setup = objects.MakeSetup();
+		const auto draws = command_test::MakeDraws(objects, 20000u, 11u);
+
+		StateCommandList single;
+		CommandRecorder<StateCommandList> singleRecorder(&single);
+		DrawRecording::Record(singleRecorder, setup, draws);
+		CHECK(single._drawStates.size() == draws.size());
+
+		for (size_t listCount = 1; listCount <= 8u; listCount++)
+		{
+			std::array<DrawRange, 8> ranges;
+			CHECK(DrawRecording::Partition(draws.size(), 1u, std::span(ranges).first(listCount)) == listCount);
+
+			std::vector<StateCommandList> lists(listCount);
+			parallel::ForRange(listCount, 1u, [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; i++)
+					{
+						CommandRecorder<StateCommandList> recorder(&lists[i]);
+						DrawRecording::Record(recorder, setup, std::span(draws).subspan(ranges[i]._begin, ranges[i]._end - ranges[i]._begin));
+					}
+				});
+
+			std::vector<DrawState> concatenated;
+			size_t extraPipelines = 0u;
+			size_t extraTables = 0u;
+			size_t extraRootDescriptors = 0u;
+			for (const auto& list : lists)
+			{
+				concatenated.insert(concatenated.end(), list._drawStates.begin(), list._drawStates.end());
+				CHECK(list.GetCalls(RecordedCall::RootSignature) == 1u);
+				CHECK(list.GetCalls(RecordedCall::DescriptorHeaps) == 1u);
+				extraPipelines += list.GetCalls(RecordedCall::PipelineState);
+				extraTables += list.GetCalls(RecordedCall::RootDescriptorTable);
+				extraRootDescriptors += list.GetCalls(RecordedCall::RootDescriptor);
+			}
+			CHECK(concatenated == single._drawStates);
+
+			// Per extra list, at most one pipeline and one table rebound, and the setup's root descriptors again
+			extraPipelines -= single.GetCalls(RecordedCall::PipelineState);
+			extraTables -= single.GetCalls(RecordedCall::RootDescriptorTable);
+			extraRootDescriptors -= single.GetCalls(RecordedCall::RootDescriptor);
+			CHECK(extraPipelines <= listCount - 1u);
+			CHECK(extraTables <= listCount - 1u);
+			CHECK(extraRootDescriptors == (listCount - 1u) * setup._rootArgumentCount);
+		}
+	}
+}
+
+int main()
+{
+	TestRecordDraws();
+	TestPartition();
+	TestSplitMatchesSingleList();
+	return check::Result();
+}
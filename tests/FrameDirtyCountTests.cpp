@@ -0,0 +1,161 @@
+#include "Check.h"
+#include "../include/sasha/utility/FrameDirtyCount.h"
+#include <array>
+#include <random>
+#include <vector>
+
+namespace
+{
+	constexpr int kFrameResourceCount = 3;
+	using DirtyCount = FrameDirtyCount<kFrameResourceCount>;
+
+	// A material as UpdateMatCB sees it: its constants, their copy in each frame resource, and the dirty count
+	struct TrackedMaterial
+	{
+		int _constants = 0;
+		std::array<int, kFrameResourceCount> _frameResources{};
+		DirtyCount _dirty;
+
+		void Change(int constants)
+		{
+			_constants = constants;
+			_dirty.Mark();
+		}
+
+		// Update of the frame resource the CPU moved on to, the GPU draws the frame from it afterwards.
+		// Returns whether the constants were copied
+		bool Update(size_t frame)
+		{
+			if (!_dirty.Consume())
+				return false;
+			_frameResources[frame % kFrameResourceCount] = _constants;
+			return true;
+		}
+
+		bool IsCurrent(size_t frame) const { return _frameResources[frame % kFrameResourceCount] == _constants; }
+	};
+
+	void TestNewDataReachesEveryResource()
+	{
+		TrackedMaterial material;
+		material.Change(1);
+		CHECK(material._dirty.GetCount() == kFrameResourceCount);
+
+		for (size_t frame = 0; frame < 10u; frame++)
+		{
+			CHECK(material.Update(frame) == (frame < kFrameResourceCount));
+			CHECK(material.IsCurrent(frame));
+		}
+		CHECK(!material._dirty.IsDirty());
+		for (int constants : material._frameResources)
+			CHECK(constants == 1);
+
+		// Default constructed data was never copied anywhere
+		DirtyCount fresh;
+		CHECK(fresh.IsDirty());
+		CHECK(fresh.GetCount() == kFrameResourceCount);
+	}
+
+	// The change lands while the two other frame resources are still being drawn with the old constants: each one is
+	// rewritten when the CPU gets back to it, so every frame from then on draws the new constants
+	void TestChangeWhileFramesInFlight()
+	{
+		TrackedMaterial material;
+		material.Change(1);
+		size_t frame = 0;
+		for (; frame < 5u; frame++)
+			material.Update(frame);
+		CHECK(!material._dirty.IsDirty());
+
+		material.Change(2);
+		size_t copies = 0u;
+		for (size_t end = frame + 6u; frame < end; frame++)
+		{
+			copies += material.Update(frame);
+			CHECK(material.IsCurrent(frame));
+		}
+		CHECK(copies == kFrameResourceCount);
+		for (int constants : material._frameResources)
+			CHECK(constants == 2);
+	}
+
+	// A second change before the first went around: the resources already written hold the first version and are
+	// written again, none keeps either of the old ones
+	void TestChangeBeforePreviousReachedAll()
+	{
+		TrackedMaterial material;
+		for (size_t frame = 0; frame < 3u; frame++)
+			material.Update(frame);
+
+		material.Change(1);
+		size_t frame = 3u;
+		material.Update(frame++);
+		material.Update(frame++);
+		CHECK(material._dirty.GetCount() == 1);
+
+		material.Change(2);
+		CHECK(material._dirty.GetCount() == kFrameResourceCount);
+		size_t copies = 0u;
+		for (size_t end = frame + 6u; frame < end; frame++)
+		{
+			copies += material.Update(frame);
+			CHECK(material.IsCurrent(frame));
+		}
+		CHECK(copies == kFrameResourceCount);
+		for (int constants : material._frameResources)
+			CHECK(constants == 2);
+	}
+
+	// Materials changing at random frames, sometimes several times in one frame: every frame is drawn with the
+	// latest constants and the copies stop once nothing changes anymore
+	void TestRandomChanges()
+	{
+		std::vector<TrackedMaterial> materials(16u);
+		std::mt19937 random(11u);
+		std::uniform_int_distribution<int> pick(0, 63);
+
+		int version = 0;
+		size_t frame = 0;
+		for (; frame < 2000u; frame++)
+		{
+			for (int change = pick(random) % 4; change > 0; change--)
+			{
+				const int m = pick(random);
+				if (m < static_cast<int>(materials.size()))
+					materials[m].Change(++version);
+			}
+
+			for (auto& material : materials)
+			{
+				material.Update(frame);
+				CHECK(material.IsCurrent(frame));
+			}
+		}
+
+		// Whatever was still dirty is copied exactly as many times as its count, within the next kFrameResourceCount frames
+		size_t pending = 0u;
+		for (const auto& material : materials)
+			pending += material._dirty.GetCount();
+		size_t copies = 0u;
+		for (size_t end = frame + 10u, settled = frame + kFrameResourceCount; frame < end; frame++)
+			for (auto& material : materials)
+			{
+				const bool copied = material.Update(frame);
+				CHECK(!copied || frame < settled);
+				copies += copied;
+			}
+		CHECK(copies == pending);
+		for (const auto& material : materials)
+			for (int constants : material._frameResources)
+				CHECK(constants == material._constants);
+	}
+}
+
+int main()
+{
+	TestNewDataReachesEveryResource();
+	TestChangeWhileFramesInFlight();
+	TestChangeBeforePreviousReachedAll();
+	TestRandomChanges();
+	return check::Result();
+}
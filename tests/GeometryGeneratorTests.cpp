@@ -0,0 +1,262 @@
+#include "Check.h"
+#include "../include/sasha/renderer/geometry/GeometryGenerator.h"
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// The parser splits sections into chunks of this many bytes, rounded up to the end of a line
+	constexpr size_t kChunkBytes = 64u * 1024u;
+
+	std::string WriteModel(const std::string& name, const std::string& text)
+	{
+		const auto path = std::filesystem::temp_directory_path() / ("sasha_" + name + ".txt");
+		std::ofstream(path, std::ios::binary) << text;
+		return path.string();
+	}
+
+	// The error names the file and line as "file(line): ", and says what went wrong
+	void CheckFails(const std::string& name, const std::string& text, size_t line, const std::string& what)
+	{
+		const std::string path = WriteModel(name, text);
+		std::string message;
+		try
+		{
+			GeometryGenerator().ReadFile(path);
+		}
+		catch (const std::runtime_error& e)
+		{
+			message = e.what();
+		}
+		std::filesystem::remove(path);
+
+		const bool located = message.find(path + "(" + std::to_string(line) + "): ") == 0u;
+		const bool explained = message.find(what) != std::string::npos;
+		if (!located || !explained)
+			std::printf("%s: expected line %zu '%s', got '%s'\n", name.c_str(), line, what.c_str(), message.c_str());
+		CHECK(located);
+		CHECK(explained);
+	}
+
+	// Tabs, carriage returns, blank lines and every float notation from_chars takes
+	void TestSmallModel()
+	{
+		const std::string text =
+			"VertexCount: 4\r\n"
+			"TriangleCount:2\n"
+			"\n"
+			"VertexList (pos, normal)\n"
+			"{\n"
+			"\t0 0 0 0 0 1\n"
+			"\t1.5 -2.25 3e2 0 0 -1\r\n"
+			"\n"
+			"  -0.125\t4 5.0 1 0 0   \n"
+			"\t7 8 9 0 1 0\n"
+			"}\n"
+			"TriangleList\n"
+			"{\n"
+			"\t0 1 2\n"
+			"\t2 3 0\n"
+			"}\n";
+		const std::string path = WriteModel("small", text);
+		const auto mesh = GeometryGenerator().ReadFile(path);
+		std::filesystem::remove(path);
+
+		const float expected[4][6] = {
+			{ 0.f, 0.f, 0.f, 0.f, 0.f, 1.f },
+			{ 1.5f, -2.25f, 300.f, 0.f, 0.f, -1.f },
+			{ -0.125f, 4.f, 5.f, 1.f, 0.f, 0.f },
+			{ 7.f, 8.f, 9.f, 0.f, 1.f, 0.f },
+		};
+		CHECK(mesh.Vertices.size() == 4u);
+		for (size_t v = 0; v < 4u && v < mesh.Vertices.size(); v++)
+		{
+			const auto& vertex = mesh.Vertices[v];
+			CHECK(vertex.Position.x == expected[v][0] && vertex.Position.y == expected[v][1] && vertex.Position.z == expected[v][2]);
+			CHECK(vertex.Normal.x == expected[v][3] && vertex.Normal.y == expected[v][4] && vertex.Normal.z == expected[v][5]);
+		}
+		CHECK(mesh.Indices32 == std::vector<GeometryGenerator::uint32>({ 0, 1, 2, 2, 3, 0 }));
+	}
+
+	std::string SmallModel(const std::string& vertices, const std::string& triangles, size_t vertexCount = 3u, size_t triangleCount = 1u)
+	{
+		return "VertexCount: " + std::to_string(vertexCount) + "\nTriangleCount: " + std::to_string(triangleCount) +
+			"\nVertexList (pos, normal)\n{\n" + vertices + "}\nTriangleList\n{\n" + triangles + "}\n";
+	}
+
+	void TestMalformed()
+	{
+		const std::string vertices = "\t0 0 0 0 0 1\n\t1 0 0 0 0 1\n\t0 1 0 0 0 1\n";
+		const std::string triangle = "\t0 1 2\n";
+
+		CheckFails("count", "VertexCount: three\nTriangleCount: 1\n", 1u, "invalid VertexCount");
+		CheckFails("key", "\nVertexCount: 3\nTriangles: 1\n", 3u, "expected 'TriangleCount: <count>'");
+		CheckFails("keyword", "VertexCount: 3\nTriangleCount: 1\n\nVertices\n", 4u, "expected 'VertexList'");
+		CheckFails("eof", "VertexCount: 3\nTriangleCount: 1\nVertexList\n", 3u, "unexpected end of file");
+		CheckFails("brace", "VertexCount: 3\nTriangleCount: 1\nVertexList\n{\n" + vertices, 5u, "missing closing '}'");
+
+		// Vertices start on line 5 and triangles on line 11
+		CheckFails("short", SmallModel("\t0 0 0 0 0 1\n\t1 0 0 0 0\n\t0 1 0 0 0 1\n", triangle), 6u, "expected 6 numbers, found 5");
+		CheckFails("trailing", SmallModel("\t0 0 0 0 0 1\n\t1 0 0 0 0 1\n\t0 1 0 0 0 1 x\n", triangle), 7u, "unexpected trailing characters");
+		CheckFails("word", SmallModel("\t0 0 0 0 0 1\n\n\t1 0 zero 0 0 1\n\t0 1 0 0 0 1\n", triangle), 7u, "expected 6 numbers, found 2");
+		CheckFails("index", SmallModel(vertices, "\t0 1 3\n"), 11u, "vertex index 3 is out of range");
+		CheckFails("negative", SmallModel(vertices, "\t0 -1 2\n"), 11u, "expected 3 numbers, found 1");
+		CheckFails("vertexCount", SmallModel(vertices, triangle, 4u), 5u, "VertexCount is 4 but the VertexList has 3 entries");
+		CheckFails("triangleCount", SmallModel(vertices, triangle + triangle, 3u, 1u), 11u, "TriangleCount is 1 but the TriangleList has 2 entries");
+
+		bool threw = false;
+		try
+		{
+			GeometryGenerator().ReadFile((std::filesystem::temp_directory_path() / "sasha_missing_model.txt").string());
+		}
+		catch (const std::runtime_error&)
+		{
+			threw = true;
+		}
+		CHECK(threw);
+	}
+
+	// A model spanning several chunks per section, with lines of random width so the chunk ends fall mid line
+	struct LargeModel
+	{
+		std::vector<std::string> _lines;
+		std::vector<float> _values;
+		std::vector<GeometryGenerator::uint32> _indices;
+		size_t _vertexCount = 0u;
+		// Index of the first line of each section body
+		size_t _vertexBegin = 0u;
+		size_t _triangleBegin = 0u;
+
+		explicit LargeModel(size_t vertexCount)
+			: _vertexCount(vertexCount)
+		{
+			std::mt19937 random(41u);
+			std::uniform_real_distribution<float> value(-1000.f, 1000.f);
+			const size_t triangleCount = 2u * vertexCount;
+
+			_lines = { "VertexCount: " + std::to_string(vertexCount), "TriangleCount: " + std::to_string(triangleCount), "VertexList (pos, normal)", "{" };
+			_vertexBegin = _lines.size();
+			for (size_t v = 0; v < vertexCount; v++)
+			{
+				std::string line = "\t";
+				for (int k = 0; k < 6; k++)
+				{
+					// Shortest round trip notation, so the parsed floats must match exactly
+					const float f = value(random) / static_cast<float>(1u << (random() % 12u));
+					char buffer[32];
+					line.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), f).ptr);
+					line += k < 5 ? " " : "";
+					_values.push_back(f);
+				}
+				_lines.push_back(line);
+				// A few blank lines, which count for line numbers but not for records
+				if (random() % 50u == 0u)
+					_lines.push_back("");
+			}
+			_lines.insert(_lines.end(), { "}", "TriangleList", "{" });
+			_triangleBegin = _lines.size();
+			for (size_t t = 0; t < triangleCount; t++)
+			{
+				std::string line = "\t";
+				for (int k = 0; k < 3; k++)
+				{
+					_indices.push_back(static_cast<GeometryGenerator::uint32>(random() % vertexCount));
+					line += std::to_string(_indices.back()) + (k < 2 ? " " : "");
+				}
+				_lines.push_back(line);
+			}
+			_lines.push_back("}");
+		}
+
+		std::string GetText() const
+		{
+			std::string text;
+			for (const auto& line : _lines)
+				text += line + "\n";
+			return text;
+		}
+
+		// Last line of every chunk the parser cuts the section into: each one runs to the end of the line holding the
+		// byte kChunkBytes past its start
+		std::vector<size_t> GetChunkEnds(size_t sectionBegin) const
+		{
+			std::vector<size_t> ends;
+			size_t chunkBegin = 0u;
+			size_t bytes = 0u;
+			for (size_t line = sectionBegin; _lines[line] != "}"; line++)
+			{
+				bytes += _lines[line].size() + 1u;
+				if (bytes > chunkBegin + kChunkBytes)
+				{
+					ends.push_back(line);
+					chunkBegin = bytes;
+				}
+			}
+			return ends;
+		}
+	};
+
+	void TestLargeModel()
+	{
+		const LargeModel model(12000u);
+		const std::string path = WriteModel("large", model.GetText());
+		const auto mesh = GeometryGenerator().ReadFile(path);
+		std::filesystem::remove(path);
+
+		CHECK(mesh.Vertices.size() == model._vertexCount);
+		size_t mismatches = 0u;
+		for (size_t v = 0; v < mesh.Vertices.size(); v++)
+		{
+			const auto& vertex = mesh.Vertices[v];
+			const float* expected = &model._values[v * 6u];
+			mismatches += vertex.Position.x != expected[0] || vertex.Position.y != expected[1] || vertex.Position.z != expected[2]
+				|| vertex.Normal.x != expected[3] || vertex.Normal.y != expected[4] || vertex.Normal.z != expected[5];
+		}
+		CHECK(mismatches == 0u);
+		CHECK(mesh.Indices32 == model._indices);
+	}
+
+	// Errors on the lines around the chunk boundaries report the line they're on, counted across chunks
+	void TestErrorsAcrossChunks()
+	{
+		const LargeModel model(12000u);
+		const auto vertexEnds = model.GetChunkEnds(model._vertexBegin);
+		const auto triangleEnds = model.GetChunkEnds(model._triangleBegin);
+		CHECK(vertexEnds.size() >= 3u && triangleEnds.size() >= 1u);
+
+		// The line straddling a boundary closes its chunk, the next one opens the following chunk
+		std::vector<size_t> lines;
+		for (size_t chunk = 0; chunk < 3u && chunk < vertexEnds.size(); chunk++)
+			lines.insert(lines.end(), { vertexEnds[chunk] - 1u, vertexEnds[chunk], vertexEnds[chunk] + 1u });
+		if (!triangleEnds.empty())
+			lines.insert(lines.end(), { triangleEnds[0], triangleEnds[0] + 1u });
+
+		for (const size_t line : lines)
+		{
+			LargeModel broken = model;
+			auto& text = broken._lines[line];
+			// A blank line carries no record, put the error on the next one
+			const size_t at = text.empty() ? line + 1u : line;
+			const bool vertex = at < model._triangleBegin;
+			broken._lines[at] = vertex ? "\t1 2 3 4 5" : "\t1 2 " + std::to_string(model._vertexCount);
+
+			// Line numbers are 1 based
+			CheckFails("chunk" + std::to_string(at), broken.GetText(), at + 1u,
+				vertex ? "expected 6 numbers, found 5" : "vertex index " + std::to_string(model._vertexCount) + " is out of range");
+		}
+	}
+}
+
+int main()
+{
+	TestSmallModel();
+	TestMalformed();
+	TestLargeModel();
+	TestErrorsAcrossChunks();
+	return check::Result();
+}
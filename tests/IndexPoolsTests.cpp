@@ -0,0 +1,64 @@
+#include "Check.h"
+#include "../include/sasha/renderer/geometry/GeometryGenerator.h"
+#include "../include/sasha/renderer/geometry/IndexPools.h"
+#include "../include/sasha/renderer/geometry/MeshOptimizer.h"
+#include <vector>
+
+namespace
+{
+	using Indices = std::vector<std::uint32_t>;
+
+	// The largest index decides the pool, not the vertex count
+	void TestBoundary()
+	{
+		IndexPools pools;
+		const auto fits = pools.Append(Indices{ 0u, 65534u, 65535u });
+		const auto overflows = pools.Append(Indices{ 0u, 65535u, 65536u });
+		CHECK(fits._width == IndexWidth::Bits16);
+		CHECK(overflows._width == IndexWidth::Bits32);
+		CHECK((pools.Read(fits) == Indices{ 0u, 65534u, 65535u }));
+		CHECK((pools.Read(overflows) == Indices{ 0u, 65535u, 65536u }));
+
+		const auto empty = pools.Append({});
+		CHECK(empty._width == IndexWidth::Bits16);
+		CHECK(empty._count == 0u);
+		CHECK(pools.Read(empty).empty());
+	}
+
+	// A grid past 65535 vertices goes through the import passes, lands in the 32 bit pool and reads back unchanged,
+	// while the small meshes around it keep 16 bit indices and their own offsets
+	void TestLargeMesh()
+	{
+		GeometryGenerator generator;
+		auto large = generator.CreateGrid(100.f, 100.f, 300u, 300u);
+		CHECK(large.Vertices.size() > 65535u);
+		MeshOptimizer::OptimizeVertexCacheFifo(large.Indices32, large.Vertices.size());
+		MeshOptimizer::OptimizeVertexFetch(large);
+		const auto box = generator.CreateBox(1.f, 1.f, 1.f, 2u);
+
+		IndexPools pools;
+		const auto before = pools.Append(box.Indices32);
+		const auto largeRange = pools.Append(large.Indices32);
+		const auto after = pools.Append(box.Indices32);
+
+		CHECK(largeRange._width == IndexWidth::Bits32);
+		CHECK(largeRange._start == 0u);
+		CHECK(largeRange._count == large.Indices32.size());
+		CHECK(pools.Read(largeRange) == large.Indices32);
+		CHECK(pools.GetIndices32().size() == large.Indices32.size());
+
+		CHECK(before._width == IndexWidth::Bits16 && after._width == IndexWidth::Bits16);
+		CHECK(before._start == 0u);
+		CHECK(after._start == box.Indices32.size());
+		CHECK(pools.Read(before) == box.Indices32);
+		CHECK(pools.Read(after) == box.Indices32);
+		CHECK(pools.GetIndices16().size() == 2u * box.Indices32.size());
+	}
+}
+
+int main()
+{
+	TestBoundary();
+	TestLargeMesh();
+	return check::Result();
+}
@@ -0,0 +1,71 @@
+#include "Check.h"
+#include "../include/sasha/utility/JobSystem.h"
+#include <atomic>
+
+namespace
+{
+	constexpr size_t kOverflowCount = 3u * JobSystem::kJobPoolSize + 17u;
+
+	// More jobs from one thread than its ring holds, with no wait in between
+	void TestRingOverflow(size_t workerCount)
+	{
+		JobSystem jobSystem(workerCount);
+		std::atomic<size_t> ran = 0u;
+		JobCounter counter;
+		for (size_t i = 0; i < kOverflowCount; i++)
+			jobSystem.Run(counter, [&ran]() { ran.fetch_add(1u, std::memory_order_relaxed); });
+		jobSystem.Wait(counter);
+
+		CHECK(ran.load() == kOverflowCount);
+	}
+
+	// The ring wraps onto jobs held back by a dependency that's still queued, they only free once it ran
+	void TestRingOverflowOnDependents(size_t workerCount)
+	{
+		JobSystem jobSystem(workerCount);
+		std::atomic<bool> gateRan = false;
+		std::atomic<size_t> ran = 0u;
+		std::atomic<size_t> early = 0u;
+
+		JobCounter gate, dependents;
+		jobSystem.Run(gate, [&gateRan]() { gateRan.store(true, std::memory_order_relaxed); });
+		for (size_t i = 0; i < kOverflowCount; i++)
+			jobSystem.Run(dependents, [&]()
+				{
+					early.fetch_add(gateRan.load(std::memory_order_relaxed) ? 0u : 1u, std::memory_order_relaxed);
+					ran.fetch_add(1u, std::memory_order_relaxed);
+				}, &gate);
+		jobSystem.Wait(dependents);
+
+		CHECK(ran.load() == kOverflowCount);
+		CHECK(early.load() == 0u);
+	}
+
+	// A job that overflows the ring of whichever thread runs it
+	void TestRingOverflowFromJob(size_t workerCount)
+	{
+		JobSystem jobSystem(workerCount);
+		std::atomic<size_t> ran = 0u;
+		JobCounter parent, children;
+		jobSystem.Run(parent, [&]()
+			{
+				for (size_t i = 0; i < kOverflowCount; i++)
+					jobSystem.Run(children, [&ran]() { ran.fetch_add(1u, std::memory_order_relaxed); });
+			});
+		jobSystem.Wait(parent);
+		jobSystem.Wait(children);
+
+		CHECK(ran.load() == kOverflowCount);
+	}
+}
+
+int main()
+{
+	for (const size_t workerCount : { 0u, 1u, 3u })
+	{
+		TestRingOverflow(workerCount);
+		TestRingOverflowOnDependents(workerCount);
+		TestRingOverflowFromJob(workerCount);
+	}
+	return check::Result();
+}
@@ -0,0 +1,479 @@
+#include "Check.h"
+#include "MeshTestUtil.h"
+#include "../include/sasha/renderer/geometry/GeometryGenerator.h"
+#include "../include/sasha/renderer/geometry/MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	using Indices = std::vector<std::uint32_t>;
+	using mesh_test::GetTriangleSet;
+	using mesh_test::ShuffleTriangles;
+
+	void TestHandComputedStats()
+	{
+		// Two triangles sharing an edge: 4 transforms for 2 triangles and 4 vertices
+		const Indices quad = { 0, 1, 2, 0, 2, 3 };
+		for (auto model : { VertexCacheModel::Fifo, VertexCacheModel::Lru })
+		{
+			const auto stats = MeshOptimizer::AnalyzeVertexCache(quad, 4u, 16u, model);
+			CHECK(stats._transformCount == 4u);
+			CHECK_NEAR(stats._acmr, 2.f, 1e-6f);
+			CHECK_NEAR(stats._atvr, 1.f, 1e-6f);
+		}
+
+		// With 3 entries, the hit on 0 in the second triangle keeps it in an LRU cache but not in a FIFO one,
+		// so the third triangle misses 0 again only with a FIFO
+		const Indices fan = { 0, 1, 2, 0, 3, 4, 0, 5, 6 };
+		const auto fifo = MeshOptimizer::AnalyzeVertexCache(fan, 7u, 3u, VertexCacheModel::Fifo);
+		const auto lru = MeshOptimizer::AnalyzeVertexCache(fan, 7u, 3u, VertexCacheModel::Lru);
+		CHECK(fifo._transformCount == 8u);
+		CHECK(lru._transformCount == 7u);
+		CHECK_NEAR(fifo._acmr, 8.f / 3.f, 1e-6f);
+		CHECK_NEAR(lru._acmr, 7.f / 3.f, 1e-6f);
+		CHECK_NEAR(fifo._atvr, 8.f / 7.f, 1e-6f);
+		CHECK_NEAR(lru._atvr, 1.f, 1e-6f);
+	}
+
+	void TestNoTriangle()
+	{
+		for (const Indices& indices : { Indices{}, Indices{ 0 }, Indices{ 0, 1 } })
+		{
+			const auto stats = MeshOptimizer::AnalyzeVertexCache(indices, 2u);
+			CHECK(stats._transformCount == 0u);
+			CHECK(stats._acmr == 0.f);
+			CHECK(stats._atvr == 0.f);
+		}
+
+		Indices empty;
+		MeshOptimizer::OptimizeVertexCache(empty, 0u);
+		MeshOptimizer::OptimizeVertexCacheFifo(empty, 0u);
+		CHECK(empty.empty());
+	}
+
+	// Both passes only reorder triangles and bring a shuffled mesh below maxAcmr for the cache they target
+	void CheckOptimizers(const GeometryGenerator::MeshData& mesh, float maxAcmr)
+	{
+		const size_t vertexCount = mesh.Vertices.size();
+		const Indices shuffled = ShuffleTriangles(mesh.Indices32, 1234u);
+		const auto before = MeshOptimizer::AnalyzeVertexCache(shuffled, vertexCount, 16u, VertexCacheModel::Fifo);
+
+		Indices fifoOrder = shuffled;
+		MeshOptimizer::OptimizeVertexCacheFifo(fifoOrder, vertexCount, 16u);
+		const auto fifo = MeshOptimizer::AnalyzeVertexCache(fifoOrder, vertexCount, 16u, VertexCacheModel::Fifo);
+		CHECK(GetTriangleSet(fifoOrder) == GetTriangleSet(shuffled));
+		CHECK(fifo._acmr < before._acmr);
+		CHECK(fifo._acmr <= maxAcmr);
+		CHECK(fifo._atvr >= 1.f && fifo._atvr < before._atvr);
+
+		const auto lruBefore = MeshOptimizer::AnalyzeVertexCache(shuffled, vertexCount, 32u, VertexCacheModel::Lru);
+		Indices lruOrder = shuffled;
+		MeshOptimizer::OptimizeVertexCache(lruOrder, vertexCount);
+		const auto lru = MeshOptimizer::AnalyzeVertexCache(lruOrder, vertexCount, 32u, VertexCacheModel::Lru);
+		CHECK(GetTriangleSet(lruOrder) == GetTriangleSet(shuffled));
+		CHECK(lru._acmr < lruBefore._acmr);
+		CHECK(lru._acmr <= maxAcmr);
+		CHECK(lru._atvr >= 1.f && lru._atvr < lruBefore._atvr);
+	}
+
+	void TestOptimizeGrid()
+	{
+		// A regular grid tends to 0.5 with an unbounded cache, strips of a 16 entry cache land around 0.7
+		GeometryGenerator generator;
+		CheckOptimizers(generator.CreateGrid(100.f, 100.f, 100u, 100u), 0.8f);
+	}
+
+	void TestOptimizeSkull()
+	{
+		GeometryGenerator generator;
+		const auto skull = generator.ReadFile(SASHA_ASSET_DIR "/models/skull.txt");
+		CHECK(!skull.Indices32.empty());
+		CheckOptimizers(skull, 0.8f);
+	}
+	// A rolling heightfield of n x n quads, every triangle facing up. With a seam, the middle column of vertices is
+	// split into two wedges with different texcoords, the right half of the quads uses the second one
+	GeometryGenerator::MeshData MakeHeightfield(std::uint32_t n, bool seam)
+	{
+		GeometryGenerator::MeshData mesh;
+		auto index = [n](std::uint32_t row, std::uint32_t column) { return row * (n + 1u) + column; };
+		for (std::uint32_t row = 0; row <= n; row++)
+			for (std::uint32_t column = 0; column <= n; column++)
+			{
+				const float x = static_cast<float>(column) - 0.5f * n;
+				const float z = static_cast<float>(row) - 0.5f * n;
+				const float y = 1.5f * std::sin(0.3f * x) * std::cos(0.2f * z);
+				mesh.Vertices.emplace_back(x, y, z, 0.f, 1.f, 0.f, 1.f, 0.f, 0.f,
+					static_cast<float>(column) / n, static_cast<float>(row) / n);
+			}
+
+		const std::uint32_t seamColumn = n / 2u;
+		const auto seamFirst = static_cast<std::uint32_t>(mesh.Vertices.size());
+		if (seam)
+			for (std::uint32_t row = 0; row <= n; row++)
+			{
+				auto wedge = mesh.Vertices[index(row, seamColumn)];
+				wedge.TexC.x += 1.f;
+				mesh.Vertices.push_back(wedge);
+			}
+
+		for (std::uint32_t row = 0; row < n; row++)
+			for (std::uint32_t column = 0; column < n; column++)
+			{
+				auto corner = [&](std::uint32_t r, std::uint32_t c)
+				{
+					return seam && c == seamColumn && column >= seamColumn ? seamFirst + r : index(r, c);
+				};
+				const std::uint32_t a = corner(row, column), b = corner(row, column + 1u);
+				const std::uint32_t c = corner(row + 1u, column), d = corner(row + 1u, column + 1u);
+				mesh.Indices32.insert(mesh.Indices32.end(), { a, c, d, a, d, b });
+			}
+		return mesh;
+	}
+
+	float FacingY(const GeometryGenerator::MeshData& mesh, const std::uint32_t* triangle)
+	{
+		const auto& p0 = mesh.Vertices[triangle[0]].Position;
+		const auto& p1 = mesh.Vertices[triangle[1]].Position;
+		const auto& p2 = mesh.Vertices[triangle[2]].Position;
+		// y of the cross product of the two edges
+		return (p1.z - p0.z) * (p2.x - p0.x) - (p1.x - p0.x) * (p2.z - p0.z);
+	}
+
+	void TestSimplify()
+	{
+		constexpr std::uint32_t n = 32u;
+		const auto mesh = MakeHeightfield(n, true);
+		CHECK(FacingY(mesh, mesh.Indices32.data()) > 0.f);
+
+		const size_t target = mesh.Indices32.size() / 4u;
+		float error = -1.f;
+		const Indices simplified = MeshOptimizer::Simplify(mesh.Indices32, mesh.Vertices, target, &error);
+		CHECK(simplified.size() % 3u == 0u);
+		CHECK(simplified.size() <= target && simplified.size() >= target - target / 50u);
+		CHECK(error > 0.f && error < 1.f);
+
+		// Collapses only move vertices onto others, the border and both wedges of the seam are never the ones moved
+		std::vector<bool> referenced(mesh.Vertices.size(), false);
+		for (auto index : simplified)
+			referenced[index] = true;
+		size_t lost = 0u;
+		for (std::uint32_t v = 0; v < mesh.Vertices.size(); v++)
+		{
+			const std::uint32_t row = v / (n + 1u), column = v % (n + 1u);
+			const bool seamWedge = v >= (n + 1u) * (n + 1u) || column == n / 2u;
+			const bool border = row == 0u || row == n || column == 0u || column == n;
+			lost += (seamWedge || border) && !referenced[v];
+		}
+		CHECK(lost == 0u);
+
+		// Wedges don't mix, each side of the seam still only references its own
+		size_t crossed = 0u;
+		for (size_t i = 0; i < simplified.size(); i += 3)
+		{
+			bool left = false, right = false;
+			for (size_t k = 0; k < 3u; k++)
+			{
+				const std::uint32_t v = simplified[i + k];
+				const bool wedge = v >= (n + 1u) * (n + 1u);
+				left = left || (!wedge && v % (n + 1u) < n / 2u);
+				right = right || wedge || v % (n + 1u) > n / 2u;
+			}
+			crossed += left && right;
+		}
+		CHECK(crossed == 0u);
+
+		size_t flipped = 0u;
+		for (size_t i = 0; i < simplified.size(); i += 3)
+			flipped += !(FacingY(mesh, &simplified[i]) > 0.f);
+		CHECK(flipped == 0u);
+	}
+
+	// Nothing to remove, the input comes back as is
+	void TestSimplifyAboveInput()
+	{
+		const auto mesh = MakeHeightfield(8u, false);
+		for (const size_t target : { mesh.Indices32.size(), mesh.Indices32.size() + 300u })
+		{
+			float error = -1.f;
+			CHECK(MeshOptimizer::Simplify(mesh.Indices32, mesh.Vertices, target, &error) == mesh.Indices32);
+			CHECK(error == 0.f);
+		}
+	}
+	// Every triangle of a heightfield gets its own copies of its corners, nudged by up to jitter on every attribute.
+	// Welding finds the shared corners again, and each triangle still has its corners within the tolerances
+	void CheckWeldSoup(float jitter, const WeldTolerances& tolerances)
+	{
+		const auto base = MakeHeightfield(16u, false);
+		std::mt19937 random(3u);
+		std::uniform_real_distribution<float> nudge(-jitter, jitter);
+
+		GeometryGenerator::MeshData soup;
+		for (auto index : base.Indices32)
+		{
+			auto vertex = base.Vertices[index];
+			vertex.Position = { vertex.Position.x + nudge(random), vertex.Position.y + nudge(random), vertex.Position.z + nudge(random) };
+			vertex.Normal = { vertex.Normal.x + nudge(random), vertex.Normal.y + nudge(random), vertex.Normal.z + nudge(random) };
+			vertex.TexC = { vertex.TexC.x + nudge(random), vertex.TexC.y + nudge(random) };
+			soup.Indices32.push_back(static_cast<std::uint32_t>(soup.Vertices.size()));
+			soup.Vertices.push_back(vertex);
+		}
+
+		GeometryGenerator::MeshData welded = soup;
+		const size_t removed = MeshOptimizer::WeldVertices(welded, tolerances);
+		CHECK(removed == soup.Vertices.size() - base.Vertices.size());
+		CHECK(welded.Vertices.size() == base.Vertices.size());
+		CHECK(welded.Indices32.size() == soup.Indices32.size());
+
+		size_t moved = 0u;
+		for (size_t i = 0; i < welded.Indices32.size(); i++)
+		{
+			const auto& before = soup.Vertices[soup.Indices32[i]];
+			const auto& after = welded.Vertices[welded.Indices32[i]];
+			moved += std::abs(before.Position.x - after.Position.x) > tolerances._position
+				|| std::abs(before.Position.y - after.Position.y) > tolerances._position
+				|| std::abs(before.Position.z - after.Position.z) > tolerances._position
+				|| std::abs(before.Normal.y - after.Normal.y) > tolerances._normal
+				|| std::abs(before.TexC.x - after.TexC.x) > tolerances._texCoord
+				|| std::abs(before.TexC.y - after.TexC.y) > tolerances._texCoord;
+		}
+		CHECK(moved == 0u);
+
+		// Each welded vertex stands for a single corner of the heightfield and there are as many of them, so the
+		// triangles are the heightfield's
+		constexpr std::uint32_t kNone = ~0u;
+		std::vector<std::uint32_t> corner(welded.Vertices.size(), kNone);
+		size_t mixed = 0u;
+		for (size_t i = 0; i < welded.Indices32.size(); i++)
+		{
+			auto& c = corner[welded.Indices32[i]];
+			mixed += c != kNone && c != base.Indices32[i];
+			c = base.Indices32[i];
+		}
+		CHECK(mixed == 0u);
+	}
+
+	void TestWeldVertices()
+	{
+		CheckWeldSoup(0.f, {});
+		CheckWeldSoup(2e-4f, { 1e-3f, 1e-3f, 1e-3f });
+	}
+
+	// A vertex next to copies of itself, each off by a little more or a little less than one tolerance
+	void TestWeldTolerances()
+	{
+		const WeldTolerances tolerances = { 1e-3f, 1e-2f, 1e-2f };
+		const GeometryGenerator::Vertex vertex(5.f, 2.f, -3.f, 0.f, 1.f, 0.f, 1.f, 0.f, 0.f, 0.25f, 0.75f);
+
+		GeometryGenerator::MeshData mesh;
+		mesh.Vertices.assign(7u, vertex);
+		mesh.Vertices[1].Position.x += 0.9f * tolerances._position;
+		mesh.Vertices[2].Position.z -= 1.5f * tolerances._position;
+		mesh.Vertices[3].Normal.x += 0.9f * tolerances._normal;
+		mesh.Vertices[4].Normal.y -= 1.5f * tolerances._normal;
+		mesh.Vertices[5].TexC.y += 0.9f * tolerances._texCoord;
+		mesh.Vertices[6].TexC.x += 1.5f * tolerances._texCoord;
+		mesh.Indices32 = { 0, 1, 2, 3, 4, 5, 6, 5, 4 };
+
+		CHECK(MeshOptimizer::WeldVertices(mesh, tolerances) == 3u);
+		CHECK(mesh.Vertices.size() == 4u);
+		// The ones within merge into the first, the three outside keep their own vertex in order
+		CHECK(mesh.Indices32 == Indices({ 0, 0, 1, 0, 2, 0, 3, 0, 2 }));
+		CHECK(mesh.Vertices[1].Position.z < vertex.Position.z);
+		CHECK(mesh.Vertices[3].TexC.x > vertex.TexC.x);
+	}
+	// Two quads facing +z stacked one unit apart, seen only from the +z side
+	void TestAnalyzeOverdraw()
+	{
+		std::vector<GeometryGenerator::Vertex> vertices;
+		for (float z : { 0.f, 1.f })
+			for (auto [x, y] : { std::pair(0.f, 0.f), std::pair(1.f, 0.f), std::pair(1.f, 1.f), std::pair(0.f, 1.f) })
+				vertices.emplace_back(x, y, z, 0.f, 0.f, 1.f, 1.f, 0.f, 0.f, x, y);
+		const Indices farFirst = { 0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7 };
+		const Indices nearFirst = { 4, 5, 6, 4, 6, 7, 0, 1, 2, 0, 2, 3 };
+
+		const auto worst = MeshOptimizer::AnalyzeOverdraw(farFirst, vertices);
+		const auto best = MeshOptimizer::AnalyzeOverdraw(nearFirst, vertices);
+		CHECK(best._pixelsCovered > 0u && best._pixelsCovered == worst._pixelsCovered);
+		CHECK(worst._pixelsShaded == 2u * worst._pixelsCovered);
+		CHECK_NEAR(worst._overdraw, 2.f, 1e-6f);
+		CHECK_NEAR(best._overdraw, 1.f, 1e-6f);
+
+		// The quad further out along its normal is drawn first
+		Indices optimized = farFirst;
+		MeshOptimizer::OptimizeOverdraw(optimized, vertices);
+		CHECK(optimized == nearFirst);
+	}
+
+	// Clusters of the cache optimized order are only reordered, and none is cut so short its ACMR passes the threshold
+	void TestOptimizeOverdraw()
+	{
+		GeometryGenerator generator;
+		const auto skull = generator.ReadFile(SASHA_ASSET_DIR "/models/skull.txt");
+		Indices cacheOrder = ShuffleTriangles(skull.Indices32, 99u);
+		MeshOptimizer::OptimizeVertexCacheFifo(cacheOrder, skull.Vertices.size(), 16u);
+		const auto before = MeshOptimizer::AnalyzeVertexCache(cacheOrder, skull.Vertices.size(), 16u, VertexCacheModel::Fifo);
+		const float overdrawBefore = MeshOptimizer::AnalyzeOverdraw(cacheOrder, skull.Vertices)._overdraw;
+
+		for (const float threshold : { 1.f, 1.05f, 1.5f, 3.f })
+		{
+			Indices optimized = cacheOrder;
+			MeshOptimizer::OptimizeOverdraw(optimized, skull.Vertices, threshold, 16u);
+			CHECK(GetTriangleSet(optimized) == GetTriangleSet(cacheOrder));
+
+			const auto after = MeshOptimizer::AnalyzeVertexCache(optimized, skull.Vertices.size(), 16u, VertexCacheModel::Fifo);
+			CHECK(after._acmr <= threshold * before._acmr * (1.f + 1e-5f));
+			CHECK(MeshOptimizer::AnalyzeOverdraw(optimized, skull.Vertices)._overdraw <= overdrawBefore);
+		}
+	}
+
+	// A grid of 16 byte vertices, far larger than the fetch cache
+	void TestAnalyzeVertexFetch()
+	{
+		constexpr size_t kVertexSize = 16u;
+		auto mesh = MakeHeightfield(63u, false);
+		MeshOptimizer::OptimizeVertexFetch(mesh);
+		CHECK(mesh.Vertices.size() * kVertexSize == 64u * 1024u);
+
+		// Every line is read once and stays until the triangles of the next row are done with it
+		const auto ordered = MeshOptimizer::AnalyzeVertexFetch(mesh.Indices32, mesh.Vertices.size(), kVertexSize);
+		CHECK(ordered._bytesFetched == mesh.Vertices.size() * kVertexSize);
+		CHECK_NEAR(ordered._overfetch, 1.f, 1e-6f);
+
+		// Vertices scattered over the buffer pull in a whole line for each and lose it before the next row
+		std::vector<std::uint32_t> scatter(mesh.Vertices.size());
+		for (std::uint32_t v = 0; v < scatter.size(); v++)
+			scatter[v] = v;
+		std::shuffle(scatter.begin(), scatter.end(), std::mt19937(5u));
+		Indices scattered = mesh.Indices32;
+		for (auto& index : scattered)
+			index = scatter[index];
+		CHECK(MeshOptimizer::AnalyzeVertexFetch(scattered, mesh.Vertices.size(), kVertexSize)._overfetch > 2.f);
+	}
+	// Every point is inside the box, which touches the cloud on all six sides, and inside the sphere, which is never
+	// bigger than the one around the box
+	void CheckBounds(std::span<const GeometryGenerator::Vertex> vertices, const MeshBounds& bounds)
+	{
+		DirectX::XMFLOAT3 lo = vertices[0].Position, hi = lo;
+		size_t outsideBox = 0u;
+		size_t outsideSphere = 0u;
+		for (const auto& vertex : vertices)
+		{
+			const auto& p = vertex.Position;
+			lo = { std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z) };
+			hi = { std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z) };
+			outsideBox += p.x < bounds._min.x || p.y < bounds._min.y || p.z < bounds._min.z
+				|| p.x > bounds._max.x || p.y > bounds._max.y || p.z > bounds._max.z;
+
+			const double dx = p.x - bounds._sphereCenter.x, dy = p.y - bounds._sphereCenter.y, dz = p.z - bounds._sphereCenter.z;
+			outsideSphere += std::sqrt(dx * dx + dy * dy + dz * dz) > bounds._sphereRadius * (1.0 + 1e-6) + 1e-6;
+		}
+		CHECK(outsideBox == 0u);
+		CHECK(outsideSphere == 0u);
+		CHECK(lo.x == bounds._min.x && lo.y == bounds._min.y && lo.z == bounds._min.z);
+		CHECK(hi.x == bounds._max.x && hi.y == bounds._max.y && hi.z == bounds._max.z);
+
+		const float dx = hi.x - lo.x, dy = hi.y - lo.y, dz = hi.z - lo.z;
+		CHECK(bounds._sphereRadius <= 0.5f * std::sqrt(dx * dx + dy * dy + dz * dz) * 1.0001f + 1e-6f);
+	}
+
+	// Clouds of every shape the sphere has trouble with: boxes, shells, far outliers, flat and degenerate ones,
+	// read through the full vertex stride like the geometry library does
+	void TestComputeBounds()
+	{
+		std::mt19937 random(17u);
+		std::uniform_real_distribution<float> uniform(-1.f, 1.f);
+		std::normal_distribution<float> normal(0.f, 1.f);
+
+		for (int cloud = 0; cloud < 200; cloud++)
+		{
+			const size_t count = cloud < 10 ? static_cast<size_t>(cloud) + 1u : 1u + random() % 5000u;
+			const int shape = cloud % 5;
+			const float scale = std::pow(10.f, uniform(random) * 3.f);
+			const DirectX::XMFLOAT3 offset = { 100.f * uniform(random), 100.f * uniform(random), 100.f * uniform(random) };
+
+			std::vector<GeometryGenerator::Vertex> vertices(count);
+			for (auto& vertex : vertices)
+			{
+				DirectX::XMFLOAT3 p = { uniform(random), uniform(random), uniform(random) };
+				if (shape == 1)
+				{
+					// Shell of a sphere
+					p = { normal(random), normal(random), normal(random) };
+					const float length = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+					p = { p.x / length, p.y / length, p.z / length };
+				}
+				else if (shape == 2 && random() % 100u == 0u)
+					p = { 20.f * p.x, 20.f * p.y, 20.f * p.z };
+				else if (shape == 3)
+					p.z = 0.f;
+				else if (shape == 4)
+					p = { p.x, 2.f * p.x, -p.x };
+				vertex.Position = { offset.x + scale * p.x, offset.y + scale * p.y, offset.z + scale * p.z };
+			}
+
+			CheckBounds(vertices, MeshOptimizer::ComputeBounds(&vertices[0].Position, count, sizeof(GeometryGenerator::Vertex)));
+		}
+
+		// Every point the same
+		std::vector<GeometryGenerator::Vertex> same(5u);
+		for (auto& vertex : same)
+			vertex.Position = { 3.f, -2.f, 1.f };
+		const auto point = MeshOptimizer::ComputeBounds(&same[0].Position, same.size(), sizeof(GeometryGenerator::Vertex));
+		CheckBounds(same, point);
+		CHECK(point._sphereRadius == 0.f);
+	}
+
+	// Submeshes packed into one vertex buffer, each bounded on its own range only
+	void TestSubmeshBounds()
+	{
+		std::mt19937 random(23u);
+		std::uniform_real_distribution<float> uniform(-1.f, 1.f);
+
+		std::vector<GeometryGenerator::Vertex> vertices;
+		std::vector<std::pair<size_t, size_t>> submeshes;
+		for (int submesh = 0; submesh < 8; submesh++)
+		{
+			const size_t first = vertices.size();
+			const size_t count = 10u + random() % 500u;
+			const float center = 50.f * submesh;
+			for (size_t i = 0; i < count; i++)
+			{
+				GeometryGenerator::Vertex vertex;
+				vertex.Position = { center + uniform(random), uniform(random), 1.f + submesh * uniform(random) };
+				vertices.push_back(vertex);
+			}
+			submeshes.emplace_back(first, count);
+		}
+
+		for (const auto& [first, count] : submeshes)
+		{
+			const auto range = std::span(vertices).subspan(first, count);
+			const auto bounds = MeshOptimizer::ComputeBounds(&range[0].Position, count, sizeof(GeometryGenerator::Vertex));
+			CheckBounds(range, bounds);
+			// Nowhere near the neighbors 50 units away
+			CHECK(bounds._sphereRadius < 2.f * std::max(1.f, bounds._max.z - bounds._min.z));
+		}
+	}
+}
+
+int main()
+{
+	TestHandComputedStats();
+	TestNoTriangle();
+	TestOptimizeGrid();
+	TestOptimizeSkull();
+	TestSimplify();
+	TestSimplifyAboveInput();
+	TestWeldVertices();
+	TestWeldTolerances();
+	TestAnalyzeOverdraw();
+	TestOptimizeOverdraw();
+	TestAnalyzeVertexFetch();
+	TestComputeBounds();
+	TestSubmeshBounds();
+	return check::Result();
+}
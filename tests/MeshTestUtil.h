@@ -0,0 +1,45 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+// Helpers shared by the mesh tests
+
+namespace mesh_test
+{
+	using Triangle = std::array<std::uint32_t, 3>;
+
+	// Rotated to start at its smallest index, which keeps the winding
+	inline Triangle Canonical(Triangle triangle)
+	{
+		std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		return triangle;
+	}
+
+	// Sorted canonical triangles, equal when two index buffers draw the same triangles the same number of times
+	inline std::vector<Triangle> GetTriangleSet(std::span<const std::uint32_t> indices)
+	{
+		std::vector<Triangle> triangles;
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+			triangles.push_back(Canonical({ indices[i], indices[i + 1], indices[i + 2] }));
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	inline std::vector<std::uint32_t> ShuffleTriangles(std::span<const std::uint32_t> indices, unsigned seed)
+	{
+		std::vector<size_t> order(indices.size() / 3u);
+		for (size_t t = 0; t < order.size(); t++)
+			order[t] = t;
+		std::shuffle(order.begin(), order.end(), std::mt19937(seed));
+
+		std::vector<std::uint32_t> shuffled;
+		shuffled.reserve(indices.size());
+		for (size_t t : order)
+			shuffled.insert(shuffled.end(), indices.begin() + 3 * t, indices.begin() + 3 * t + 3);
+		return shuffled;
+	}
+}
@@ -0,0 +1,157 @@
+#include "Check.h"
+#include "MeshTestUtil.h"
+#include "../include/sasha/renderer/geometry/GeometryGenerator.h"
+#include "../include/sasha/renderer/geometry/Meshlet.h"
+#include "../include/sasha/renderer/geometry/MeshOptimizer.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+	using namespace DirectX;
+
+	XMFLOAT3 Subtract(const XMFLOAT3& a, const XMFLOAT3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+	float Dot(const XMFLOAT3& a, const XMFLOAT3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+	XMFLOAT3 Cross(const XMFLOAT3& a, const XMFLOAT3& b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+
+	const XMFLOAT3& GetPosition(const MeshletTable& table, const GeometryGenerator::MeshData& mesh, size_t meshlet, std::uint8_t local)
+	{
+		return mesh.Vertices[table._vertices[table._vertexOffsets[meshlet] + local]].Position;
+	}
+
+	// Every triangle lands in exactly one meshlet within the limits, and the local indices resolve to its vertices
+	void CheckCoverage(const MeshletTable& table, const GeometryGenerator::MeshData& mesh)
+	{
+		std::vector<std::uint32_t> resolved;
+		for (size_t m = 0; m < table.GetCount(); m++)
+		{
+			const std::uint32_t vertexCount = table._vertexCounts[m];
+			const std::uint32_t triangleCount = table._triangleCounts[m];
+			CHECK(vertexCount > 0u && vertexCount <= MeshletTable::MaxVertices);
+			CHECK(triangleCount > 0u && triangleCount <= MeshletTable::MaxTriangles);
+
+			// A meshlet references each of its vertices once
+			std::vector<std::uint32_t> vertices(table._vertices.begin() + table._vertexOffsets[m], table._vertices.begin() + table._vertexOffsets[m] + vertexCount);
+			std::sort(vertices.begin(), vertices.end());
+			CHECK(std::adjacent_find(vertices.begin(), vertices.end()) == vertices.end());
+
+			for (std::uint32_t i = 0; i < triangleCount * 3u; i++)
+			{
+				const std::uint8_t local = table._triangles[table._triangleOffsets[m] + i];
+				CHECK(local < vertexCount);
+				resolved.push_back(table._vertices[table._vertexOffsets[m] + local]);
+			}
+		}
+
+		CHECK(table._triangles.size() == mesh.Indices32.size());
+		CHECK(mesh_test::GetTriangleSet(resolved) == mesh_test::GetTriangleSet(mesh.Indices32));
+	}
+
+	void CheckSpheres(const MeshletTable& table, const GeometryGenerator::MeshData& mesh)
+	{
+		for (size_t m = 0; m < table.GetCount(); m++)
+		{
+			const XMFLOAT4& sphere = table._spheres[m];
+			const XMFLOAT3 center = { sphere.x, sphere.y, sphere.z };
+			for (std::uint8_t v = 0; v < table._vertexCounts[m]; v++)
+			{
+				const XMFLOAT3 offset = Subtract(GetPosition(table, mesh, m, v), center);
+				CHECK(std::sqrt(Dot(offset, offset)) <= sphere.w * 1.0001f + 1e-5f);
+			}
+		}
+	}
+
+	// A culled meshlet must not have a single triangle facing the eye
+	size_t CheckCones(const MeshletTable& table, const GeometryGenerator::MeshData& mesh, float extent)
+	{
+		std::mt19937 random(7u);
+		std::uniform_real_distribution<float> coordinate(-extent, extent);
+
+		size_t culled = 0u;
+		for (int e = 0; e < 200; e++)
+		{
+			const XMFLOAT3 eye = { coordinate(random), coordinate(random), coordinate(random) };
+			for (size_t m = 0; m < table.GetCount(); m++)
+			{
+				if (!table.IsBackfacing(m, eye))
+					continue;
+				culled++;
+
+				for (std::uint32_t t = 0; t < table._triangleCounts[m]; t++)
+				{
+					const std::uint8_t* local = &table._triangles[table._triangleOffsets[m] + t * 3u];
+					const XMFLOAT3& p0 = GetPosition(table, mesh, m, local[0]);
+					const XMFLOAT3 normal = Cross(Subtract(GetPosition(table, mesh, m, local[1]), p0), Subtract(GetPosition(table, mesh, m, local[2]), p0));
+					CHECK(Dot(Subtract(p0, eye), normal) >= -1e-4f * std::sqrt(Dot(normal, normal)));
+				}
+			}
+		}
+		return culled;
+	}
+
+	// Meshlets spanning opposite faces have cones too wide to cull anything, so only larger meshes are expected to cull
+	void CheckMesh(GeometryGenerator::MeshData mesh, float extent, bool expectCulling)
+	{
+		MeshOptimizer::OptimizeVertexCacheFifo(mesh.Indices32, mesh.Vertices.size());
+		const auto table = MeshletTable::Build(mesh.Indices32, mesh.Vertices);
+		CHECK(table.GetCount() > 0u);
+		CheckCoverage(table, mesh);
+		CheckSpheres(table, mesh);
+		const size_t culled = CheckCones(table, mesh, extent);
+		CHECK((culled > 0u) == expectCulling);
+	}
+
+	void TestMeshes()
+	{
+		GeometryGenerator generator;
+		CheckMesh(generator.ReadFile(SASHA_ASSET_DIR "/models/skull.txt"), 50.f, true);
+		CheckMesh(generator.CreateGeosphere(1.f, 3u), 5.f, true);
+		CheckMesh(generator.CreateGrid(10.f, 10.f, 40u, 40u), 20.f, true);
+		// 48 triangles on 54 vertices fit one meshlet
+		CheckMesh(generator.CreateBox(1.f, 1.f, 1.f, 1u), 5.f, false);
+	}
+
+	// Every normal of a flat grid is the same, so its cones are tight: seen from one side everything culls, from the other nothing
+	void TestFlatCones()
+	{
+		GeometryGenerator generator;
+		const auto grid = generator.CreateGrid(10.f, 10.f, 20u, 20u);
+		const auto table = MeshletTable::Build(grid.Indices32, grid.Vertices);
+
+		size_t above = 0u, below = 0u;
+		for (size_t m = 0; m < table.GetCount(); m++)
+		{
+			above += table.IsBackfacing(m, { 0.f, 10.f, 0.f });
+			below += table.IsBackfacing(m, { 0.f, -10.f, 0.f });
+		}
+		CHECK(above + below == table.GetCount());
+		CHECK(above == 0u || below == 0u);
+	}
+
+	void TestEmptyAndAppend()
+	{
+		CHECK(MeshletTable::Build({}, {}).GetCount() == 0u);
+
+		GeometryGenerator generator;
+		const auto box = generator.CreateBox(1.f, 1.f, 1.f, 0u);
+		const auto first = MeshletTable::Build(box.Indices32, box.Vertices);
+
+		MeshletTable table = first;
+		const std::uint32_t appended = table.Append(first, 100u);
+		CHECK(appended == first.GetCount());
+		CHECK(table.GetCount() == 2u * first.GetCount());
+		for (size_t i = 0; i < first._vertices.size(); i++)
+			CHECK(table._vertices[first._vertices.size() + i] == first._vertices[i] + 100u);
+		CHECK(table._vertexOffsets[appended] == first._vertices.size());
+		CHECK(table._triangleOffsets[appended] == first._triangles.size());
+	}
+}
+
+int main()
+{
+	TestMeshes();
+	TestFlatCones();
+	TestEmptyAndAppend();
+	return check::Result();
+}
@@ -0,0 +1,172 @@
+#include "Check.h"
+#include "../include/sasha/renderer/scene/TransformHierarchy.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+	XMMATRIX LocalMatrix(const LocalTransform& local)
+	{
+		return XMMatrixMultiply(XMMatrixMultiply(
+			XMMatrixScaling(local._scale.x, local._scale.y, local._scale.z),
+			XMMatrixRotationQuaternion(XMLoadFloat4(&local._rotation))),
+			XMMatrixTranslation(local._translation.x, local._translation.y, local._translation.z));
+	}
+
+	// Walks up to the root through the parents, independent of the slot layout
+	XMMATRIX ReferenceWorld(const TransformHierarchy& hierarchy, NodeID node)
+	{
+		XMMATRIX world = LocalMatrix(hierarchy.GetLocal(node));
+		for (NodeID parent = hierarchy.GetParent(node); parent != TransformHierarchy::kNoNode; parent = hierarchy.GetParent(parent))
+			world = XMMatrixMultiply(world, LocalMatrix(hierarchy.GetLocal(parent)));
+		return world;
+	}
+
+	bool MatchesReference(const TransformHierarchy& hierarchy, NodeID node)
+	{
+		XMFLOAT4X4 expected;
+		XMStoreFloat4x4(&expected, ReferenceWorld(hierarchy, node));
+		const XMFLOAT4X4& world = hierarchy.GetWorld(node);
+		for (int r = 0; r < 4; r++)
+			for (int c = 0; c < 4; c++)
+				if (std::fabs(world.m[r][c] - expected.m[r][c]) > 1e-3f)
+					return false;
+		return true;
+	}
+
+	LocalTransform RandomLocal(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> offset(-2.f, 2.f);
+		std::normal_distribution<float> component(0.f, 1.f);
+		std::uniform_real_distribution<float> scale(0.8f, 1.2f);
+
+		// Normalized gaussian components are a uniformly distributed rotation
+		float q[4] = { component(random), component(random), component(random), component(random) };
+		const float length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+
+		LocalTransform local;
+		local._translation = { offset(random), offset(random), offset(random) };
+		local._rotation = { q[0] / length, q[1] / length, q[2] / length, q[3] / length };
+		local._scale = { scale(random), scale(random), scale(random) };
+		return local;
+	}
+
+	void TestChain()
+	{
+		TransformHierarchy hierarchy;
+		LocalTransform offset;
+		offset._translation = { 1.f, 0.f, 0.f };
+
+		NodeID node = hierarchy.Add(offset);
+		const NodeID root = node;
+		for (int i = 0; i < 9; i++)
+			node = hierarchy.Add(offset, node);
+		hierarchy.Update();
+
+		CHECK(hierarchy.GetNodeCount() == 10u);
+		CHECK(hierarchy.GetChanged().size() == 10u);
+		CHECK_NEAR(hierarchy.GetWorld(node).m[3][0], 10.f, 1e-5f);
+
+		// Only the moved node and its descendants are recomputed
+		hierarchy.Update();
+		CHECK(hierarchy.GetChanged().empty());
+		offset._translation = { 3.f, 0.f, 0.f };
+		hierarchy.SetLocal(root, offset);
+		hierarchy.Update();
+		CHECK(hierarchy.GetChanged().size() == 10u);
+		CHECK(hierarchy.GetChanged().front() == root);
+		CHECK_NEAR(hierarchy.GetWorld(node).m[3][0], 12.f, 1e-5f);
+
+		std::vector<NodeID> removed;
+		hierarchy.Remove(hierarchy.GetParent(node), removed);
+		CHECK(removed.size() == 2u && removed.back() == node);
+		CHECK(!hierarchy.IsAlive(node));
+		CHECK(hierarchy.GetNodeCount() == 8u);
+	}
+
+	// Random frames of adds, removes and moves, enough for several sorts to run while the next frame edits the
+	// hierarchy: every live node matches its reference and every moved node is reported, after its parent
+	void TestRandomFrames()
+	{
+		TransformHierarchy hierarchy;
+		std::mt19937 random(7u);
+		std::uniform_int_distribution<int> percent(0, 99);
+
+		std::vector<NodeID> alive;
+		std::vector<NodeID> removed;
+		std::vector<NodeID> moved;
+		// Per node, where it is in GetChanged(), or -1
+		std::vector<int> position;
+		for (int frame = 0; frame < 300; frame++)
+		{
+			moved.clear();
+			const int edits = frame < 50 ? 200 : 60;
+			for (int e = 0; e < edits; e++)
+			{
+				const int op = percent(random);
+				if (op < 45 || alive.empty())
+				{
+					// Roots, or children of any live node so the levels grow deep
+					const NodeID parent = alive.empty() || op < 10 ? TransformHierarchy::kNoNode : alive[random() % alive.size()];
+					const NodeID node = hierarchy.Add(RandomLocal(random), parent);
+					alive.push_back(node);
+					moved.push_back(node);
+				}
+				else if (op < 70)
+				{
+					const NodeID node = alive[random() % alive.size()];
+					hierarchy.SetLocal(node, RandomLocal(random));
+					moved.push_back(node);
+				}
+				else if (op < 80)
+				{
+					removed.clear();
+					hierarchy.Remove(alive[random() % alive.size()], removed);
+					std::erase_if(alive, [&](NodeID node) { return !hierarchy.IsAlive(node); });
+				}
+			}
+			hierarchy.Update();
+
+			CHECK(hierarchy.GetNodeCount() == alive.size());
+			size_t mismatches = 0u;
+			for (const NodeID node : alive)
+				mismatches += !MatchesReference(hierarchy, node);
+			CHECK(mismatches == 0u);
+
+			const auto changed = hierarchy.GetChanged();
+			position.assign(position.size(), -1);
+			for (size_t i = 0; i < changed.size(); i++)
+			{
+				if (changed[i] >= position.size())
+					position.resize(changed[i] + 1u, -1);
+				position[changed[i]] = static_cast<int>(i);
+			}
+
+			size_t missing = 0u;
+			for (const NodeID node : moved)
+				missing += hierarchy.IsAlive(node) && (node >= position.size() || position[node] < 0);
+			CHECK(missing == 0u);
+			size_t misordered = 0u;
+			for (const NodeID node : changed)
+			{
+				const NodeID parent = hierarchy.GetParent(node);
+				misordered += parent != TransformHierarchy::kNoNode && parent < position.size() && position[parent] > position[node];
+			}
+			CHECK(misordered == 0u);
+		}
+		CHECK(hierarchy.GetNodeCount() > 2000u);
+		// Levels only exist once a sort was swapped in
+		CHECK(hierarchy.GetLevelCount() > 1u);
+	}
+}
+
+int main()
+{
+	TestChain();
+	TestRandomFrames();
+	return check::Result();
+}
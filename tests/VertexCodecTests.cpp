@@ -0,0 +1,184 @@
+#include "Check.h"
+#include "../include/sasha/renderer/geometry/VertexCodec.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+// Error bounds are the ones documented on VertexCodec, plus float rounding where the decode itself computes in float
+
+namespace
+{
+	using namespace DirectX;
+
+	void TestPositions()
+	{
+		const XMFLOAT3 boundsMin = { -3.f, 2.f, -100.f };
+		const XMFLOAT3 boundsMax = { 5.f, 2.f, 250.f };
+		const auto bounds = QuantizationBounds::FromMinMax(boundsMin, boundsMax);
+
+		// Half a quantization step per axis plus the float rounding of the decode, the flat y axis must come back exactly
+		auto ulp = [](float f) { return std::nextafter(f, std::numeric_limits<float>::infinity()) - f; };
+		const float toleranceX = 8.f / 131070.f + 2.f * ulp(5.f);
+		const float toleranceZ = 350.f / 131070.f + 2.f * ulp(250.f);
+
+		std::mt19937 random(3u);
+		std::uniform_real_distribution<float> unit(0.f, 1.f);
+		for (int i = 0; i < 100000; i++)
+		{
+			const XMFLOAT3 p = { boundsMin.x + 8.f * unit(random), 2.f, boundsMin.z + 350.f * unit(random) };
+			std::uint16_t encoded[4];
+			VertexCodec::EncodePosition(p, bounds, encoded);
+			const XMFLOAT3 decoded = VertexCodec::DecodePosition(encoded, bounds);
+			CHECK_NEAR(decoded.x, p.x, toleranceX);
+			CHECK(decoded.y == p.y);
+			CHECK_NEAR(decoded.z, p.z, toleranceZ);
+		}
+
+		// The corners are exact grid points, points outside clamp to the bounds
+		for (const auto& [p, expected] : { std::pair{ boundsMin, boundsMin }, std::pair{ boundsMax, boundsMax },
+			std::pair{ XMFLOAT3{ -10.f, 2.f, 300.f }, XMFLOAT3{ -3.f, 2.f, 250.f } } })
+		{
+			std::uint16_t encoded[4];
+			VertexCodec::EncodePosition(p, bounds, encoded);
+			const XMFLOAT3 decoded = VertexCodec::DecodePosition(encoded, bounds);
+			CHECK_NEAR(decoded.x, expected.x, 2.f * ulp(5.f));
+			CHECK(decoded.y == expected.y);
+			CHECK_NEAR(decoded.z, expected.z, 2.f * ulp(250.f));
+		}
+	}
+
+	double AngleBetween(const XMFLOAT3& a, const XMFLOAT3& b)
+	{
+		const double cx = static_cast<double>(a.y) * b.z - static_cast<double>(a.z) * b.y;
+		const double cy = static_cast<double>(a.z) * b.x - static_cast<double>(a.x) * b.z;
+		const double cz = static_cast<double>(a.x) * b.y - static_cast<double>(a.y) * b.x;
+		const double dot = static_cast<double>(a.x) * b.x + static_cast<double>(a.y) * b.y + static_cast<double>(a.z) * b.z;
+		return std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), dot);
+	}
+
+	void TestNormals()
+	{
+		std::mt19937 random(5u);
+		std::normal_distribution<float> gaussian;
+		double maxAngle = 0.0;
+		for (int i = 0; i < 200000; i++)
+		{
+			XMFLOAT3 n = { gaussian(random), gaussian(random), gaussian(random) };
+			const float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+			if (length < 1e-3f)
+				continue;
+			n = { n.x / length, n.y / length, n.z / length };
+
+			std::int16_t encoded[2];
+			VertexCodec::EncodeNormal(n, encoded);
+			const XMFLOAT3 decoded = VertexCodec::DecodeNormal(encoded);
+			CHECK_NEAR(std::sqrt(decoded.x * decoded.x + decoded.y * decoded.y + decoded.z * decoded.z), 1.f, 1e-5f);
+			maxAngle = std::max(maxAngle, AngleBetween(n, decoded));
+		}
+		CHECK(maxAngle < 1e-4);
+
+		// Axes sit on octahedron vertices, including the folded lower hemisphere
+		for (const XMFLOAT3& axis : { XMFLOAT3{ 1.f, 0.f, 0.f }, XMFLOAT3{ -1.f, 0.f, 0.f }, XMFLOAT3{ 0.f, 1.f, 0.f },
+			XMFLOAT3{ 0.f, -1.f, 0.f }, XMFLOAT3{ 0.f, 0.f, 1.f }, XMFLOAT3{ 0.f, 0.f, -1.f } })
+		{
+			std::int16_t encoded[2];
+			VertexCodec::EncodeNormal(axis, encoded);
+			const XMFLOAT3 decoded = VertexCodec::DecodeNormal(encoded);
+			CHECK_NEAR(decoded.x, axis.x, 1e-6f);
+			CHECK_NEAR(decoded.y, axis.y, 1e-6f);
+			CHECK_NEAR(decoded.z, axis.z, 1e-6f);
+		}
+	}
+
+	std::uint32_t Bits(float f)
+	{
+		std::uint32_t bits;
+		std::memcpy(&bits, &f, sizeof(bits));
+		return bits;
+	}
+
+	void TestHalf()
+	{
+		// Every finite half decodes and encodes back to itself
+		for (std::uint32_t h = 0; h < 0x10000u; h++)
+		{
+			if ((h & 0x7C00u) == 0x7C00u)
+				continue;
+			CHECK(VertexCodec::EncodeHalf(VertexCodec::DecodeHalf(static_cast<std::uint16_t>(h))) == h);
+		}
+
+		CHECK(VertexCodec::EncodeHalf(1.f) == 0x3C00u);
+		CHECK(VertexCodec::EncodeHalf(-2.f) == 0xC000u);
+		CHECK(VertexCodec::EncodeHalf(65504.f) == 0x7BFFu);
+		CHECK(VertexCodec::EncodeHalf(65520.f) == 0x7C00u);
+		CHECK(VertexCodec::EncodeHalf(std::ldexp(1.f, -24)) == 0x0001u);
+		CHECK(VertexCodec::EncodeHalf(std::ldexp(1.f, -26)) == 0x0000u);
+		CHECK(VertexCodec::EncodeHalf(std::numeric_limits<float>::infinity()) == 0x7C00u);
+		CHECK(std::isnan(VertexCodec::DecodeHalf(VertexCodec::EncodeHalf(std::numeric_limits<float>::quiet_NaN()))));
+		// Ties round to even
+		CHECK(VertexCodec::EncodeHalf(1.f + std::ldexp(1.f, -11)) == 0x3C00u);
+		CHECK(VertexCodec::EncodeHalf(1.f + 3.f * std::ldexp(1.f, -11)) == 0x3C02u);
+
+		// Normal range texcoords keep 2^-11 relative error
+		std::mt19937 random(9u);
+		std::uniform_real_distribution<float> texCoord(-64.f, 64.f);
+		for (int i = 0; i < 100000; i++)
+		{
+			const float f = texCoord(random);
+			if (std::fabs(f) < std::ldexp(1.f, -14))
+				continue;
+			const float decoded = VertexCodec::DecodeHalf(VertexCodec::EncodeHalf(f));
+			CHECK(std::fabs(decoded - f) <= std::ldexp(std::fabs(f), -11));
+			CHECK(Bits(decoded) >> 31 == Bits(f) >> 31);
+		}
+	}
+
+	void TestUnorm16()
+	{
+		for (int i = 0; i <= 10000; i++)
+		{
+			const float f = i / 10000.f;
+			CHECK_NEAR(VertexCodec::DecodeUnorm16(VertexCodec::EncodeUnorm16(f)), f, 0.5 / 65535.0 + 1e-7);
+		}
+		CHECK(VertexCodec::EncodeUnorm16(0.f) == 0u);
+		CHECK(VertexCodec::EncodeUnorm16(1.f) == 0xFFFFu);
+		CHECK(VertexCodec::EncodeUnorm16(-0.5f) == 0u);
+		CHECK(VertexCodec::EncodeUnorm16(1.5f) == 0xFFFFu);
+	}
+
+	void TestVertex()
+	{
+		const auto bounds = QuantizationBounds::FromMinMax({ -1.f, -1.f, -1.f }, { 1.f, 1.f, 1.f });
+		const XMFLOAT3 position = { 0.25f, -0.5f, 0.75f };
+		const XMFLOAT3 normal = { 0.f, 0.6f, 0.8f };
+		const XMFLOAT2 tex = { 0.3f, 0.9f };
+
+		for (auto encoding : { TexCoordEncoding::Half, TexCoordEncoding::Unorm16 })
+		{
+			const CompactVertex encoded = VertexCodec::Encode(position, normal, tex, bounds, encoding);
+			XMFLOAT3 decodedPosition, decodedNormal;
+			XMFLOAT2 decodedTex;
+			VertexCodec::Decode(encoded, bounds, encoding, decodedPosition, decodedNormal, decodedTex);
+
+			CHECK_NEAR(decodedPosition.x, position.x, 2.f / 131070.f + 1e-6f);
+			CHECK_NEAR(decodedPosition.y, position.y, 2.f / 131070.f + 1e-6f);
+			CHECK_NEAR(decodedPosition.z, position.z, 2.f / 131070.f + 1e-6f);
+			CHECK(AngleBetween(normal, decodedNormal) < 1e-4);
+			const float texTolerance = encoding == TexCoordEncoding::Half ? std::ldexp(1.f, -11) : 0.5f / 65535.f + 1e-7f;
+			CHECK_NEAR(decodedTex.x, tex.x, texTolerance);
+			CHECK_NEAR(decodedTex.y, tex.y, texTolerance);
+		}
+	}
+}
+
+int main()
+{
+	TestPositions();
+	TestNormals();
+	TestHalf();
+	TestUnorm16();
+	TestVertex();
+	return check::Result();
+}
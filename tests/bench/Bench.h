@@ -0,0 +1,43 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Timing for the benchmark executables. Each benchmark prints one line per case, times are the median of the
+// repetitions so a stray context switch doesn't skew them
+
+namespace bench
+{
+	struct Result
+	{
+		double _medianMs = 0.0;
+		double _minMs = 0.0;
+		double _maxMs = 0.0;
+	};
+
+	// Runs fn once to warm caches, then repetitions more times
+	template<typename Fn>
+	Result Measure(int repetitions, Fn&& fn)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		fn();
+		std::vector<double> times;
+		times.reserve(repetitions);
+		for (int i = 0; i < repetitions; i++)
+		{
+			const auto start = Clock::now();
+			fn();
+			times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+		}
+
+		std::sort(times.begin(), times.end());
+		return { times[times.size() / 2u], times.front(), times.back() };
+	}
+
+	inline void Print(const char* name, const Result& result)
+	{
+		std::printf("%-48s median %9.3f ms  min %9.3f ms  max %9.3f ms\n", name, result._medianMs, result._minMs, result._maxMs);
+	}
+}
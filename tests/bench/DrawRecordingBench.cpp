@@ -0,0 +1,54 @@
+#include "Bench.h"
+#include "../CommandTestUtil.h"
+#include "../../include/sasha/utility/Parallel.h"
+#include <string>
+
+// Recording a frame's draws split into 1, 2, 4 and 8 command lists, each recorded on a job like the renderer does.
+// The lists only count calls, so this is the recorder and the split, what a driver spends per call comes on top
+
+namespace
+{
+	using command_test::FakeCommandList;
+
+	void Run(size_t drawCount)
+	{
+		command_test::FrameObjects objects;
+		const DrawListSetup setup = objects.MakeSetup();
+		const auto draws = command_test::MakeDraws(objects, drawCount, 3u);
+
+		for (const size_t listCount : { 1u, 2u, 4u, 8u })
+		{
+			std::array<DrawRange, 8> ranges;
+			const size_t rangeCount = DrawRecording::Partition(draws.size(), 1u, std::span(ranges).first(listCount));
+			std::vector<FakeCommandList> lists(rangeCount);
+			const auto result = bench::Measure(50, [&]()
+				{
+					parallel::ForRange(rangeCount, 1u, [&](size_t begin, size_t end)
+						{
+							for (size_t i = begin; i < end; i++)
+							{
+								lists[i] = {};
+								CommandRecorder<FakeCommandList> recorder(&lists[i]);
+								DrawRecording::Record(recorder, setup, std::span(draws).subspan(ranges[i]._begin, ranges[i]._end - ranges[i]._begin));
+							}
+						});
+				});
+
+			size_t calls = 0u;
+			for (const auto& list : lists)
+				for (const size_t count : list._calls)
+					calls += count;
+
+			const std::string name = std::to_string(drawCount) + " draws, " + std::to_string(rangeCount) + " lists";
+			bench::Print(name.c_str(), result);
+			std::printf("%-48s %.1f ns/draw, %zu binds issued\n", "", result._medianMs * 1e6 / drawCount, calls);
+		}
+	}
+}
+
+// Ranges run on at most parallel::GetWorkerCount() threads, more lists than that only adds the prologues
+int main()
+{
+	Run(5000u);
+	Run(20000u);
+}
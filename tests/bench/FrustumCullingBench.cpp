@@ -0,0 +1,80 @@
+#include "Bench.h"
+#include "../../include/sasha/renderer/scene/FrustumCulling.h"
+#include <random>
+#include <vector>
+
+// FrustumCulling::CullSpheres against a plain per sphere loop over array of structures bounds, which is what
+// DrawFrame did before, on both the structure of arrays and the packed layout the scene's WorldSphere columns use.
+// Spheres are spread through a cube around a camera with a 1000 unit far plane
+
+namespace
+{
+	using namespace DirectX;
+
+	struct Sphere
+	{
+		XMFLOAT3 _center;
+		float _radius;
+	};
+
+	size_t CullScalar(const Frustum& frustum, const std::vector<Sphere>& spheres, std::vector<std::uint32_t>& visible)
+	{
+		size_t count = 0u;
+		for (size_t i = 0; i < spheres.size(); i++)
+		{
+			const Sphere& sphere = spheres[i];
+			bool inside = true;
+			for (const auto& plane : frustum._planes)
+				inside &= plane.x * sphere._center.x + plane.y * sphere._center.y + plane.z * sphere._center.z + plane.w + sphere._radius >= 0.f;
+			if (inside)
+				visible[count++] = static_cast<std::uint32_t>(i);
+		}
+		return count;
+	}
+
+	void Run(const Frustum& frustum, size_t instanceCount)
+	{
+		std::mt19937 random(11u);
+		std::uniform_real_distribution<float> coordinate(-1000.f, 1000.f);
+		std::uniform_real_distribution<float> radius(0.5f, 5.f);
+
+		std::vector<Sphere> aos(instanceCount);
+		CullingSpheres soa;
+		soa.Resize(instanceCount);
+		std::vector<XMFLOAT4> packed(instanceCount);
+		for (size_t i = 0; i < instanceCount; i++)
+		{
+			aos[i] = { { coordinate(random), coordinate(random), coordinate(random) }, radius(random) };
+			soa.Set(i, aos[i]._center, aos[i]._radius);
+			packed[i] = { aos[i]._center.x, aos[i]._center.y, aos[i]._center.z, aos[i]._radius };
+		}
+
+		std::vector<std::uint32_t> visible(instanceCount);
+		size_t scalarVisible = 0u, kernelVisible = 0u, packedVisible = 0u;
+		const auto scalar = bench::Measure(20, [&]() { scalarVisible = CullScalar(frustum, aos, visible); });
+		const auto kernel = bench::Measure(20, [&]() { kernelVisible = FrustumCulling::CullSpheres(frustum, soa, visible); });
+		const auto packedKernel = bench::Measure(20, [&]() { packedVisible = FrustumCulling::CullSpheres(frustum, packed, visible); });
+
+		char label[64];
+		std::snprintf(label, sizeof(label), "%zu instances, scalar", instanceCount);
+		bench::Print(label, scalar);
+		std::snprintf(label, sizeof(label), "%zu instances, CullSpheres", instanceCount);
+		bench::Print(label, kernel);
+		std::snprintf(label, sizeof(label), "%zu instances, CullSpheres packed", instanceCount);
+		bench::Print(label, packedKernel);
+		std::printf("%-48s %.2f ns/instance scalar, %.2f ns/instance CullSpheres, %.2f packed, %.2fx, %zu visible%s\n", "",
+			scalar._medianMs * 1e6 / instanceCount, kernel._medianMs * 1e6 / instanceCount, packedKernel._medianMs * 1e6 / instanceCount,
+			scalar._medianMs / kernel._medianMs, kernelVisible,
+			kernelVisible == scalarVisible && packedVisible == scalarVisible ? "" : " (differs from scalar)");
+	}
+}
+
+int main()
+{
+	const XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(0.f, 0.f, 0.f, 1.f), XMVectorSet(0.f, 0.f, 1.f, 1.f), XMVectorSet(0.f, 1.f, 0.f, 0.f));
+	const XMMATRIX proj = XMMatrixPerspectiveFovLH(0.25f * XM_PI, 16.f / 9.f, 1.f, 1000.f);
+	const Frustum frustum = Frustum::FromViewProj(XMMatrixMultiply(view, proj));
+
+	for (size_t instanceCount : { 100000u, 250000u, 500000u, 1000000u })
+		Run(frustum, instanceCount);
+}
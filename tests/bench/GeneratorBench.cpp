@@ -0,0 +1,91 @@
+#include "Bench.h"
+#include "../../include/sasha/renderer/geometry/GeometryGenerator.h"
+#include "../../include/sasha/utility/Parallel.h"
+#include <cstdlib>
+#include <span>
+#include <vector>
+
+// Procedural generation: time and output size per subdivision level, then how the span overloads scale with threads.
+// Pass a grid size to override the 2048 x 2048 default, the load time terrain is 4096
+
+namespace
+{
+	using Vertex = GeometryGenerator::Vertex;
+
+	double GetMegabytes(size_t vertexCount, size_t indexCount)
+	{
+		return (vertexCount * sizeof(Vertex) + indexCount * sizeof(std::uint32_t)) / (1024.0 * 1024.0);
+	}
+
+	template<typename Fn>
+	void RunLevels(const char* name, std::uint32_t maxLevel, Fn&& create)
+	{
+		for (std::uint32_t level = 0; level <= maxLevel; level++)
+		{
+			size_t vertexCount = 0u, indexCount = 0u;
+			const auto result = bench::Measure(level < 6u ? 20 : 5, [&]()
+				{
+					const auto mesh = create(level);
+					vertexCount = mesh.Vertices.size();
+					indexCount = mesh.Indices32.size();
+				});
+
+			char label[64];
+			std::snprintf(label, sizeof(label), "%s level %u", name, level);
+			bench::Print(label, result);
+			std::printf("%-48s %zu vertices, %zu triangles, %.2f MB\n", "", vertexCount, indexCount / 3u, GetMegabytes(vertexCount, indexCount));
+		}
+	}
+
+	template<typename Fn>
+	void RunScaling(const char* name, GeometryGenerator::MeshSize size, Fn&& create)
+	{
+		std::vector<Vertex> vertices(size.VertexCount);
+		std::vector<std::uint32_t> indices(size.IndexCount);
+		std::printf("%s: %zu vertices, %zu triangles, %.1f MB\n", name, size.VertexCount, size.IndexCount / 3u, GetMegabytes(size.VertexCount, size.IndexCount));
+
+		double serialMs = 0.0;
+		const size_t maxThreads = parallel::GetWorkerCount();
+		for (size_t threads = 1u; ; threads = std::min(threads * 2u, maxThreads))
+		{
+			parallel::SetWorkerLimit(threads);
+			const auto result = bench::Measure(5, [&]() { create(std::span(vertices), std::span(indices)); });
+			if (threads == 1u)
+				serialMs = result._medianMs;
+
+			char label[64];
+			std::snprintf(label, sizeof(label), "  %zu threads", threads);
+			bench::Print(label, result);
+			std::printf("%-48s %.2fx, %.1f M vertices/s\n", "", serialMs / result._medianMs, size.VertexCount / result._medianMs / 1000.0);
+
+			if (threads == maxThreads)
+				break;
+		}
+		parallel::SetWorkerLimit(0u);
+
+		// Keeps the writes observable
+		std::printf("%-48s checksum %.3f %u\n", "", vertices.back().Position.x + vertices.front().Position.z, indices[indices.size() / 2u]);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	GeometryGenerator generator;
+
+	RunLevels("geosphere", 8u, [&](std::uint32_t level) { return generator.CreateGeosphere(1.f, level); });
+	RunLevels("box", 8u, [&](std::uint32_t level) { return generator.CreateBox(1.f, 1.f, 1.f, level); });
+
+	const std::uint32_t gridSize = argc > 1 ? static_cast<std::uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 2048u;
+	RunScaling("grid", GeometryGenerator::GetGridSize(gridSize, gridSize), [&](std::span<Vertex> vertices, std::span<std::uint32_t> indices)
+		{
+			generator.CreateGrid(1000.f, 1000.f, gridSize, gridSize, vertices, indices);
+		});
+	RunScaling("sphere", GeometryGenerator::GetSphereSize(1024u, 1024u), [&](std::span<Vertex> vertices, std::span<std::uint32_t> indices)
+		{
+			generator.CreateSphere(1.f, 1024u, 1024u, vertices, indices);
+		});
+	RunScaling("geosphere 9", GeometryGenerator::GetGeosphereSize(9u), [&](std::span<Vertex> vertices, std::span<std::uint32_t> indices)
+		{
+			generator.CreateGeosphere(1.f, 9u, vertices, indices);
+		});
+}
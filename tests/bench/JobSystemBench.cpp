@@ -0,0 +1,112 @@
+#include "Bench.h"
+#include "../../include/sasha/utility/JobSystem.h"
+#include "../../include/sasha/utility/Parallel.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+// Cost of scheduling one job: Run, the push, the pop or steal and the counter, with jobs that do nothing.
+// Batches stay under kJobPoolSize, except for the overflow case where Run has to work through queued jobs
+
+namespace
+{
+	constexpr size_t kBatchSize = 1000u;
+	constexpr size_t kBatchCount = 100u;
+
+	void Report(const std::string& name, const bench::Result& result, size_t jobCount, size_t ran)
+	{
+		bench::Print(name.c_str(), result);
+		std::printf("%-48s %.1f ns/job, %zu ran\n", "", result._medianMs * 1e6 / jobCount, ran);
+	}
+
+	// One counter per batch, waited on by the main thread which runs jobs meanwhile
+	void RunFlat(size_t workerCount)
+	{
+		JobSystem jobSystem(workerCount);
+		std::atomic<size_t> ran = 0u;
+		const auto result = bench::Measure(20, [&]()
+			{
+				for (size_t b = 0; b < kBatchCount; b++)
+				{
+					JobCounter counter;
+					for (size_t i = 0; i < kBatchSize; i++)
+						jobSystem.Run(counter, [&ran]() { ran.fetch_add(1u, std::memory_order_relaxed); });
+					jobSystem.Wait(counter);
+				}
+			});
+		Report("flat, " + std::to_string(workerCount) + " workers", result, kBatchSize * kBatchCount, ran.load());
+	}
+
+	// Each half of the batch waits on the counter of the other, so every job of the second half goes through the
+	// dependents list before it's queued
+	void RunDependent(size_t workerCount)
+	{
+		JobSystem jobSystem(workerCount);
+		std::atomic<size_t> ran = 0u;
+		const auto result = bench::Measure(20, [&]()
+			{
+				for (size_t b = 0; b < kBatchCount; b++)
+				{
+					JobCounter first, second;
+					for (size_t i = 0; i < kBatchSize / 2u; i++)
+						jobSystem.Run(first, [&ran]() { ran.fetch_add(1u, std::memory_order_relaxed); });
+					for (size_t i = 0; i < kBatchSize / 2u; i++)
+						jobSystem.Run(second, [&ran]() { ran.fetch_add(1u, std::memory_order_relaxed); }, &first);
+					jobSystem.Wait(second);
+				}
+			});
+		Report("dependent, " + std::to_string(workerCount) + " workers", result, kBatchSize * kBatchCount, ran.load());
+	}
+
+	// A single batch four times the ring, every Run past the first kJobPoolSize waits on the slot it wraps onto
+	void RunOverflow(size_t workerCount)
+	{
+		constexpr size_t kJobCount = 4u * JobSystem::kJobPoolSize;
+		JobSystem jobSystem(workerCount);
+		std::atomic<size_t> ran = 0u;
+		const auto result = bench::Measure(20, [&]()
+			{
+				for (size_t b = 0; b < kBatchCount / 10u; b++)
+				{
+					JobCounter counter;
+					for (size_t i = 0; i < kJobCount; i++)
+						jobSystem.Run(counter, [&ran]() { ran.fetch_add(1u, std::memory_order_relaxed); });
+					jobSystem.Wait(counter);
+				}
+			});
+		Report("overflow, " + std::to_string(workerCount) + " workers", result, kJobCount * (kBatchCount / 10u), ran.load());
+	}
+
+	// A ForRange with no work, what every parallel loop pays on top of its ranges
+	void RunForRange()
+	{
+		std::atomic<size_t> ran = 0u;
+		const auto result = bench::Measure(20, [&]()
+			{
+				for (size_t b = 0; b < kBatchCount; b++)
+					parallel::ForRange(parallel::GetWorkerCount(), 1u, [&ran](size_t begin, size_t end)
+						{
+							ran.fetch_add(end - begin, std::memory_order_relaxed);
+						});
+			});
+		bench::Print("ForRange", result);
+		std::printf("%-48s %.1f ns/call with %zu ranges, %zu ran\n", "", result._medianMs * 1e6 / kBatchCount,
+			parallel::GetWorkerCount(), ran.load());
+	}
+}
+
+// The worker count defaults to one per extra hardware thread, pass one to measure stealing on smaller machines
+int main(int argc, char** argv)
+{
+	const size_t workerCount = argc > 1 ? std::stoul(argv[1]) : std::max<size_t>(1u, std::thread::hardware_concurrency()) - 1u;
+	RunFlat(0u);
+	RunDependent(0u);
+	RunOverflow(0u);
+	if (workerCount > 0u)
+	{
+		RunFlat(workerCount);
+		RunDependent(workerCount);
+		RunOverflow(workerCount);
+	}
+	RunForRange();
+}
@@ -0,0 +1,88 @@
+#include "Bench.h"
+#include "../../include/sasha/renderer/scene/LightClusters.h"
+#include "../../include/sasha/utility/Parallel.h"
+#include <random>
+
+// LightClusters::Build with point and spot lights spread through a cube around the camera, of which about one in twenty
+// is in view, and with every light inside the frustum, the worst case for the lists. The grid is the demo camera's lens,
+// 1000 unit far plane
+
+namespace
+{
+	using namespace DirectX;
+
+	ClusterLights MakeLights(const ClusterGrid& grid, size_t count, bool inView)
+	{
+		std::mt19937 random(13u);
+		std::uniform_real_distribution<float> coordinate(-1000.f, 1000.f);
+		std::uniform_real_distribution<float> depth(grid._nearZ, grid._farZ);
+		std::uniform_real_distribution<float> radius(2.f, 20.f);
+
+		ClusterLights lights;
+		lights.Resize(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			XMFLOAT3 center = { coordinate(random), coordinate(random), coordinate(random) };
+			if (inView)
+			{
+				// The view looks down +z from the origin, spread the lights across the frustum's cross section at their depth
+				const float z = depth(random);
+				center = { center.x / 1000.f * z * grid._tanHalfFovX, center.y / 1000.f * z * grid._tanHalfFovY, z };
+			}
+			lights.Set(i, center, radius(random), i % 4u == 0u);
+		}
+		return lights;
+	}
+
+	void Run(const ClusterGrid& grid, const XMFLOAT4X4& view, size_t lightCount, bool inView)
+	{
+		const ClusterLights lights = MakeLights(grid, lightCount, inView);
+		LightClusters clusters;
+		const auto result = bench::Measure(20, [&]() { clusters.Build(grid, view, lights); });
+
+		char label[64];
+		std::snprintf(label, sizeof(label), "%zu lights, %s", lightCount, inView ? "all in view" : "around the camera");
+		bench::Print(label, result);
+		std::printf("%-48s %.1f ns/light, %zu list entries, %.1f KB uploaded\n", "", result._medianMs * 1e6 / lightCount,
+			clusters.GetLightIndexCount(), clusters.GetData().size() * sizeof(std::uint32_t) / 1024.0);
+	}
+
+	// Both phases split across threads: the light boxes by light groups, the lists by slices
+	void RunScaling(const ClusterGrid& grid, const XMFLOAT4X4& view, size_t lightCount)
+	{
+		const ClusterLights lights = MakeLights(grid, lightCount, true);
+		LightClusters clusters;
+		std::printf("%zu lights all in view, by thread count\n", lightCount);
+
+		double serialMs = 0.0;
+		const size_t maxThreads = parallel::GetWorkerCount();
+		for (size_t threads = 1u; ; threads = std::min(threads * 2u, maxThreads))
+		{
+			parallel::SetWorkerLimit(threads);
+			const auto result = bench::Measure(20, [&]() { clusters.Build(grid, view, lights); });
+			if (threads == 1u)
+				serialMs = result._medianMs;
+
+			char label[64];
+			std::snprintf(label, sizeof(label), "  %zu threads", threads);
+			bench::Print(label, result);
+			std::printf("%-48s %.2fx\n", "", serialMs / result._medianMs);
+
+			if (threads == maxThreads)
+				break;
+		}
+		parallel::SetWorkerLimit(0u);
+	}
+}
+
+int main()
+{
+	const ClusterGrid grid = ClusterGrid::FromLens(0.25f * XM_PI, 16.f / 9.f, 1.f, 1000.f);
+	XMFLOAT4X4 view;
+	XMStoreFloat4x4(&view, XMMatrixLookAtLH(XMVectorSet(0.f, 0.f, 0.f, 1.f), XMVectorSet(0.f, 0.f, 1.f, 1.f), XMVectorSet(0.f, 1.f, 0.f, 0.f)));
+
+	for (bool inView : { false, true })
+		for (size_t lightCount : { 1000u, 10000u, 100000u })
+			Run(grid, view, lightCount, inView);
+	RunScaling(grid, view, 10000u);
+}
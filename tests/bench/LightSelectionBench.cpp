@@ -0,0 +1,137 @@
+#include "Bench.h"
+#include "../../include/sasha/renderer/scene/LightSelection.h"
+#include "../../include/sasha/utility/Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// LightSelection::Select against a scalar loop over array of structures lights keeping the top four the same way.
+// Objects and lights share a 2000 unit cube, lights reach 100 to 300 units so an object has a few of them in range
+
+namespace
+{
+	using namespace DirectX;
+
+	struct Light
+	{
+		XMFLOAT3 _center;
+		float _falloffStart;
+		float _falloffEnd;
+		float _intensity;
+	};
+
+	// Same score and tie breaking as the kernel: the lower index wins, lights out of reach are never kept
+	void SelectScalar(const CullingSpheres& objects, const std::vector<Light>& lights, std::vector<std::uint32_t>& selected)
+	{
+		constexpr std::uint32_t k = LightSelection::kMaxLightsPerObject;
+		for (size_t o = 0; o < objects.GetCount(); o++)
+		{
+			float scores[k] = {};
+			std::uint32_t indices[k] = {};
+			std::uint32_t count = 0u;
+			for (std::uint32_t i = 0; i < lights.size(); i++)
+			{
+				const Light& light = lights[i];
+				const float dx = light._center.x - objects._centerX[o];
+				const float dy = light._center.y - objects._centerY[o];
+				const float dz = light._center.z - objects._centerZ[o];
+				const float d = std::max<float>(std::sqrt(dx * dx + dy * dy + dz * dz) - objects._radius[o], 0.f);
+				const float att = (light._falloffEnd - d) / std::max<float>(light._falloffEnd - light._falloffStart, 1e-6f);
+				const float score = std::min<float>(std::max<float>(att, 0.f), 1.f) * light._intensity;
+				if (!(score > (count < k ? 0.f : scores[k - 1u])))
+					continue;
+
+				std::uint32_t p = std::min(count, k - 1u);
+				for (; p > 0u && scores[p - 1u] < score; p--)
+				{
+					scores[p] = scores[p - 1u];
+					indices[p] = indices[p - 1u];
+				}
+				scores[p] = score;
+				indices[p] = i;
+				count = std::min(count + 1u, k);
+			}
+
+			std::fill_n(&selected[o * k], k, ~0u);
+			std::copy_n(indices, count, &selected[o * k]);
+		}
+	}
+
+	bool Matches(const LightSelection& selection, const std::vector<std::uint32_t>& selected, size_t objectCount)
+	{
+		for (size_t o = 0; o < objectCount; o++)
+		{
+			const auto lights = selection.GetLights(o);
+			for (std::uint32_t k = 0; k < LightSelection::kMaxLightsPerObject; k++)
+			{
+				const std::uint32_t light = k < lights.size() ? lights[k] & ~LightSelection::kSpotLightBit : ~0u;
+				if (light != selected[o * LightSelection::kMaxLightsPerObject + k])
+					return false;
+			}
+		}
+		return true;
+	}
+
+	void Run(size_t lightCount, size_t objectCount)
+	{
+		std::mt19937 random(17u);
+		std::uniform_real_distribution<float> coordinate(-1000.f, 1000.f);
+		std::uniform_real_distribution<float> reach(100.f, 300.f);
+		std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+		std::vector<Light> aos(lightCount);
+		SelectionLights soa;
+		soa.Resize(lightCount);
+		for (size_t i = 0; i < lightCount; i++)
+		{
+			const float falloffEnd = reach(random);
+			aos[i] = { { coordinate(random), coordinate(random), coordinate(random) }, 0.2f * falloffEnd, falloffEnd, 0.5f + unit(random) };
+			soa.Set(i, aos[i]._center, aos[i]._falloffStart, aos[i]._falloffEnd, aos[i]._intensity, i % 4u == 0u);
+		}
+
+		CullingSpheres objects;
+		objects.Resize(objectCount);
+		for (size_t o = 0; o < objectCount; o++)
+			objects.Set(o, { coordinate(random), coordinate(random), coordinate(random) }, 0.5f + 4.5f * unit(random));
+
+		std::vector<std::uint32_t> selected(objectCount * LightSelection::kMaxLightsPerObject);
+		LightSelection selection;
+		const auto scalar = bench::Measure(5, [&]() { SelectScalar(objects, aos, selected); });
+		const auto kernel = bench::Measure(20, [&]() { selection.Select(objects, soa); });
+
+		size_t kept = 0u;
+		for (size_t o = 0; o < objectCount; o++)
+			kept += selection.GetLights(o).size();
+
+		char label[64];
+		std::snprintf(label, sizeof(label), "%zu lights x %zu objects, scalar", lightCount, objectCount);
+		bench::Print(label, scalar);
+		std::snprintf(label, sizeof(label), "%zu lights x %zu objects, Select", lightCount, objectCount);
+		bench::Print(label, kernel);
+		const double pairs = static_cast<double>(lightCount) * objectCount;
+		std::printf("%-48s %.2f ns/pair scalar, %.2f ns/pair Select, %.2fx, %.2f lights/object%s\n", "",
+			scalar._medianMs * 1e6 / pairs, kernel._medianMs * 1e6 / pairs, scalar._medianMs / kernel._medianMs,
+			static_cast<double>(kept) / objectCount, Matches(selection, selected, objectCount) ? "" : " (differs from scalar)");
+	}
+}
+
+int main()
+{
+	Run(100u, 10000u);
+	Run(1000u, 10000u);
+	Run(10000u, 1000u);
+
+	// Objects are split across threads, each scores every light against its own range
+	std::printf("1000 lights x 10000 objects by thread count\n");
+	const size_t maxThreads = parallel::GetWorkerCount();
+	for (size_t threads = 1u; ; threads = std::min(threads * 2u, maxThreads))
+	{
+		parallel::SetWorkerLimit(threads);
+		std::printf("  %zu threads\n", threads);
+		Run(1000u, 10000u);
+		if (threads == maxThreads)
+			break;
+	}
+	parallel::SetWorkerLimit(0u);
+}
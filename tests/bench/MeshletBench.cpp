@@ -0,0 +1,34 @@
+#include "Bench.h"
+#include "../../include/sasha/renderer/geometry/GeometryGenerator.h"
+#include "../../include/sasha/renderer/geometry/Meshlet.h"
+#include "../../include/sasha/renderer/geometry/MeshOptimizer.h"
+#include <string>
+
+// MeshletTable::Build throughput, on cache optimized input as GeometryLibrary runs it
+
+namespace
+{
+	void Run(const char* name, GeometryGenerator::MeshData mesh)
+	{
+		MeshOptimizer::OptimizeVertexCacheFifo(mesh.Indices32, mesh.Vertices.size());
+
+		size_t meshletCount = 0u;
+		const auto result = bench::Measure(20, [&]()
+			{
+				meshletCount = MeshletTable::Build(mesh.Indices32, mesh.Vertices).GetCount();
+			});
+
+		const size_t triangleCount = mesh.Indices32.size() / 3u;
+		bench::Print(name, result);
+		std::printf("%-48s %zu triangles, %zu meshlets, %.1f M triangles/s\n", "", triangleCount, meshletCount,
+			triangleCount / result._medianMs / 1000.0);
+	}
+}
+
+int main()
+{
+	GeometryGenerator generator;
+	Run("skull", generator.ReadFile(SASHA_ASSET_DIR "/models/skull.txt"));
+	Run("car", generator.ReadFile(SASHA_ASSET_DIR "/models/car.txt"));
+	Run("geosphere 6", generator.CreateGeosphere(1.f, 6u));
+}
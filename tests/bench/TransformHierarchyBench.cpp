@@ -0,0 +1,87 @@
+#include "Bench.h"
+#include "../../include/sasha/renderer/scene/TransformHierarchy.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Frames of a hierarchy with a steady churn of added and removed subtrees, which keeps the unsorted tail and holes
+// growing past the sort threshold every few frames. A frame is the edits, a thousand moved nodes and Update, the rest
+// of a 60 Hz frame is a sleep. The first frames fill the sort buffers and aren't counted. The worst frame and the
+// frames over half the budget show whether the sort lands on the frame path
+
+namespace
+{
+	constexpr size_t kChildrenPerRoot = 15u;
+
+	// A root with a level of children, removed and added as a whole
+	NodeID AddSubtree(TransformHierarchy& hierarchy, std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> offset(-10.f, 10.f);
+		LocalTransform local;
+		local._translation = { offset(random), offset(random), offset(random) };
+
+		const NodeID root = hierarchy.Add(local);
+		for (size_t c = 0; c < kChildrenPerRoot; c++)
+		{
+			local._translation = { offset(random), offset(random), offset(random) };
+			hierarchy.Add(local, root);
+		}
+		return root;
+	}
+
+	void Run(size_t rootCount, size_t churn)
+	{
+		constexpr auto kRestOfFrame = std::chrono::milliseconds(16);
+		using Clock = std::chrono::steady_clock;
+
+		TransformHierarchy hierarchy;
+		std::mt19937 random(5u);
+		std::vector<NodeID> roots;
+		for (size_t r = 0; r < rootCount; r++)
+			roots.push_back(AddSubtree(hierarchy, random));
+		hierarchy.Update();
+		std::this_thread::sleep_for(kRestOfFrame);
+
+		std::vector<NodeID> removed;
+		std::vector<double> times;
+		for (int frame = 0; frame < 160; frame++)
+		{
+			const auto start = Clock::now();
+			for (size_t i = 0; i < churn; i++)
+			{
+				const size_t r = random() % roots.size();
+				removed.clear();
+				hierarchy.Remove(roots[r], removed);
+				roots[r] = AddSubtree(hierarchy, random);
+			}
+			for (size_t i = 0; i < 1000u; i++)
+			{
+				const NodeID root = roots[random() % roots.size()];
+				LocalTransform local = hierarchy.GetLocal(root);
+				local._translation.y += 0.01f;
+				hierarchy.SetLocal(root, local);
+			}
+			hierarchy.Update();
+			if (frame >= 40)
+				times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+			std::this_thread::sleep_for(kRestOfFrame);
+		}
+
+		std::sort(times.begin(), times.end());
+		const auto slow = std::count_if(times.begin(), times.end(), [](double ms) { return ms > 8.0; });
+
+		char label[64];
+		std::snprintf(label, sizeof(label), "%zu nodes, %zu subtrees replaced per frame", hierarchy.GetNodeCount(), churn);
+		bench::Print(label, { times[times.size() / 2u], times.front(), times.back() });
+		std::printf("%-48s %zd of %zu frames over 8 ms\n", "", slow, times.size());
+	}
+}
+
+int main()
+{
+	Run(16384u, 64u);
+	Run(65536u, 256u);
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// The D3D12 types CommandRecorder and DrawRecording use, picked up by tests/CMakeLists.txt when DirectX-Headers
+// isn't installed. Interfaces are opaque, the tests only compare their addresses
+
+typedef int INT;
+typedef unsigned int UINT;
+typedef std::uint64_t UINT64;
+typedef UINT64 D3D12_GPU_VIRTUAL_ADDRESS;
+
+enum DXGI_FORMAT
+{
+	DXGI_FORMAT_UNKNOWN = 0,
+	DXGI_FORMAT_R32_UINT = 42,
+	DXGI_FORMAT_R16_UINT = 57,
+};
+
+enum D3D_PRIMITIVE_TOPOLOGY
+{
+	D3D_PRIMITIVE_TOPOLOGY_UNDEFINED = 0,
+	D3D_PRIMITIVE_TOPOLOGY_POINTLIST = 1,
+	D3D_PRIMITIVE_TOPOLOGY_LINELIST = 2,
+	D3D_PRIMITIVE_TOPOLOGY_LINESTRIP = 3,
+	D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST = 4,
+	D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP = 5,
+};
+typedef D3D_PRIMITIVE_TOPOLOGY D3D12_PRIMITIVE_TOPOLOGY;
+
+#define D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT 32
+
+struct D3D12_GPU_DESCRIPTOR_HANDLE
+{
+	UINT64 ptr;
+};
+
+struct D3D12_CPU_DESCRIPTOR_HANDLE
+{
+	std::size_t ptr;
+};
+
+struct D3D12_VERTEX_BUFFER_VIEW
+{
+	D3D12_GPU_VIRTUAL_ADDRESS BufferLocation;
+	UINT SizeInBytes;
+	UINT StrideInBytes;
+};
+
+struct D3D12_INDEX_BUFFER_VIEW
+{
+	D3D12_GPU_VIRTUAL_ADDRESS BufferLocation;
+	UINT SizeInBytes;
+	DXGI_FORMAT Format;
+};
+
+struct D3D12_VIEWPORT
+{
+	float TopLeftX;
+	float TopLeftY;
+	float Width;
+	float Height;
+	float MinDepth;
+	float MaxDepth;
+};
+
+struct D3D12_RECT
+{
+	long left;
+	long top;
+	long right;
+	long bottom;
+};
+
+struct ID3D12PipelineState {};
+struct ID3D12RootSignature {};
+struct ID3D12DescriptorHeap {};
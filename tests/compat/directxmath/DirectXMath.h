@@ -0,0 +1,328 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Scalar stand-in for the part of DirectXMath the tested modules use, picked up by tests/CMakeLists.txt when the
+// real header isn't installed. Layouts and semantics follow DirectXMath: row vectors, row major matrices, comparison
+// results as all-ones masks
+
+#define XM_CALLCONV
+
+namespace DirectX
+{
+	constexpr float XM_PI = 3.141592654f;
+	constexpr float XM_2PI = 6.283185307f;
+	constexpr float XM_PIDIV2 = 1.570796327f;
+	constexpr float XM_PIDIV4 = 0.785398163f;
+
+	struct XMFLOAT2
+	{
+		float x, y;
+
+		XMFLOAT2() = default;
+		constexpr XMFLOAT2(float _x, float _y) : x(_x), y(_y) {}
+	};
+
+	struct XMFLOAT3
+	{
+		float x, y, z;
+
+		XMFLOAT3() = default;
+		constexpr XMFLOAT3(float _x, float _y, float _z) : x(_x), y(_y), z(_z) {}
+	};
+
+	struct XMFLOAT4
+	{
+		float x, y, z, w;
+
+		XMFLOAT4() = default;
+		constexpr XMFLOAT4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+	};
+
+	struct XMFLOAT3A : XMFLOAT3
+	{
+		using XMFLOAT3::XMFLOAT3;
+	};
+
+	struct XMFLOAT4A : XMFLOAT4
+	{
+		using XMFLOAT4::XMFLOAT4;
+	};
+
+	struct XMUINT4
+	{
+		std::uint32_t x, y, z, w;
+	};
+
+	struct XMFLOAT4X4
+	{
+		float m[4][4];
+
+		XMFLOAT4X4() = default;
+		constexpr XMFLOAT4X4(float m00, float m01, float m02, float m03, float m10, float m11, float m12, float m13,
+			float m20, float m21, float m22, float m23, float m30, float m31, float m32, float m33)
+			: m{ { m00, m01, m02, m03 }, { m10, m11, m12, m13 }, { m20, m21, m22, m23 }, { m30, m31, m32, m33 } }
+		{
+		}
+	};
+
+	struct XMVECTOR
+	{
+		float v[4];
+	};
+
+	struct XMMATRIX
+	{
+		XMVECTOR r[4];
+	};
+
+	using FXMVECTOR = const XMVECTOR&;
+	using GXMVECTOR = const XMVECTOR&;
+	using HXMVECTOR = const XMVECTOR&;
+	using CXMVECTOR = const XMVECTOR&;
+	using FXMMATRIX = const XMMATRIX&;
+	using CXMMATRIX = const XMMATRIX&;
+
+	namespace Internal
+	{
+		inline float Mask(bool set) noexcept
+		{
+			const std::uint32_t bits = set ? 0xFFFFFFFFu : 0u;
+			float mask;
+			std::memcpy(&mask, &bits, sizeof(mask));
+			return mask;
+		}
+
+		inline bool IsSet(float mask) noexcept
+		{
+			std::uint32_t bits;
+			std::memcpy(&bits, &mask, sizeof(bits));
+			return bits != 0u;
+		}
+
+		template<typename Fn>
+		XMVECTOR PerComponent(FXMVECTOR a, FXMVECTOR b, Fn&& fn) noexcept
+		{
+			return { { fn(a.v[0], b.v[0]), fn(a.v[1], b.v[1]), fn(a.v[2], b.v[2]), fn(a.v[3], b.v[3]) } };
+		}
+	}
+
+	inline XMVECTOR XMVectorSet(float x, float y, float z, float w) noexcept { return { { x, y, z, w } }; }
+	inline XMVECTOR XMVectorZero() noexcept { return { { 0.f, 0.f, 0.f, 0.f } }; }
+	inline XMVECTOR XMVectorReplicate(float value) noexcept { return { { value, value, value, value } }; }
+	inline XMVECTOR XMVectorSplatX(FXMVECTOR v) noexcept { return XMVectorReplicate(v.v[0]); }
+	inline XMVECTOR XMVectorSplatY(FXMVECTOR v) noexcept { return XMVectorReplicate(v.v[1]); }
+	inline XMVECTOR XMVectorSplatZ(FXMVECTOR v) noexcept { return XMVectorReplicate(v.v[2]); }
+
+	inline float XMVectorGetX(FXMVECTOR v) noexcept { return v.v[0]; }
+	inline float XMVectorGetY(FXMVECTOR v) noexcept { return v.v[1]; }
+	inline float XMVectorGetZ(FXMVECTOR v) noexcept { return v.v[2]; }
+	inline float XMVectorGetW(FXMVECTOR v) noexcept { return v.v[3]; }
+	inline XMVECTOR XMVectorSetW(FXMVECTOR v, float w) noexcept { return { { v.v[0], v.v[1], v.v[2], w } }; }
+
+	inline XMVECTOR XMLoadFloat2(const XMFLOAT2* source) noexcept { return { { source->x, source->y, 0.f, 0.f } }; }
+	inline XMVECTOR XMLoadFloat3(const XMFLOAT3* source) noexcept { return { { source->x, source->y, source->z, 0.f } }; }
+	inline XMVECTOR XMLoadFloat4(const XMFLOAT4* source) noexcept { return { { source->x, source->y, source->z, source->w } }; }
+	inline void XMStoreFloat2(XMFLOAT2* destination, FXMVECTOR v) noexcept { *destination = { v.v[0], v.v[1] }; }
+	inline void XMStoreFloat3(XMFLOAT3* destination, FXMVECTOR v) noexcept { *destination = { v.v[0], v.v[1], v.v[2] }; }
+	inline void XMStoreFloat4(XMFLOAT4* destination, FXMVECTOR v) noexcept { *destination = { v.v[0], v.v[1], v.v[2], v.v[3] }; }
+
+	inline XMVECTOR XMVectorAdd(FXMVECTOR a, FXMVECTOR b) noexcept { return Internal::PerComponent(a, b, [](float x, float y) { return x + y; }); }
+	inline XMVECTOR XMVectorSubtract(FXMVECTOR a, FXMVECTOR b) noexcept { return Internal::PerComponent(a, b, [](float x, float y) { return x - y; }); }
+	inline XMVECTOR XMVectorMultiply(FXMVECTOR a, FXMVECTOR b) noexcept { return Internal::PerComponent(a, b, [](float x, float y) { return x * y; }); }
+	inline XMVECTOR XMVectorMin(FXMVECTOR a, FXMVECTOR b) noexcept { return Internal::PerComponent(a, b, [](float x, float y) { return std::fmin(x, y); }); }
+	inline XMVECTOR XMVectorMax(FXMVECTOR a, FXMVECTOR b) noexcept { return Internal::PerComponent(a, b, [](float x, float y) { return std::fmax(x, y); }); }
+	inline XMVECTOR XMVectorScale(FXMVECTOR v, float scale) noexcept { return XMVectorMultiply(v, XMVectorReplicate(scale)); }
+	inline XMVECTOR XMVectorLess(FXMVECTOR a, FXMVECTOR b) noexcept { return Internal::PerComponent(a, b, [](float x, float y) { return Internal::Mask(x < y); }); }
+	inline XMVECTOR XMVectorGreater(FXMVECTOR a, FXMVECTOR b) noexcept { return Internal::PerComponent(a, b, [](float x, float y) { return Internal::Mask(x > y); }); }
+
+	// Takes b where control is set, a elsewhere
+	inline XMVECTOR XMVectorSelect(FXMVECTOR a, FXMVECTOR b, FXMVECTOR control) noexcept
+	{
+		XMVECTOR result;
+		for (int i = 0; i < 4; i++)
+			result.v[i] = Internal::IsSet(control.v[i]) ? b.v[i] : a.v[i];
+		return result;
+	}
+
+	inline XMVECTOR operator+(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorAdd(a, b); }
+	inline XMVECTOR operator-(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorSubtract(a, b); }
+	inline XMVECTOR operator-(FXMVECTOR v) noexcept { return XMVectorSubtract(XMVectorZero(), v); }
+	inline XMVECTOR operator*(float scale, FXMVECTOR v) noexcept { return XMVectorScale(v, scale); }
+	inline XMVECTOR operator*(FXMVECTOR v, float scale) noexcept { return XMVectorScale(v, scale); }
+
+	inline XMVECTOR XMVector3Dot(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorReplicate(a.v[0] * b.v[0] + a.v[1] * b.v[1] + a.v[2] * b.v[2]); }
+	inline XMVECTOR XMVector3LengthSq(FXMVECTOR v) noexcept { return XMVector3Dot(v, v); }
+	inline XMVECTOR XMVector3Length(FXMVECTOR v) noexcept { return XMVectorReplicate(std::sqrt(XMVectorGetX(XMVector3Dot(v, v)))); }
+
+	inline XMVECTOR XMVector3Normalize(FXMVECTOR v) noexcept
+	{
+		const float length = XMVectorGetX(XMVector3Length(v));
+		return length > 0.f ? XMVectorScale(v, 1.f / length) : v;
+	}
+
+	inline XMVECTOR XMVector3Cross(FXMVECTOR a, FXMVECTOR b) noexcept
+	{
+		return { { a.v[1] * b.v[2] - a.v[2] * b.v[1], a.v[2] * b.v[0] - a.v[0] * b.v[2], a.v[0] * b.v[1] - a.v[1] * b.v[0], 0.f } };
+	}
+
+	inline XMMATRIX XMMatrixIdentity() noexcept
+	{
+		return { { { { 1.f, 0.f, 0.f, 0.f } }, { { 0.f, 1.f, 0.f, 0.f } }, { { 0.f, 0.f, 1.f, 0.f } }, { { 0.f, 0.f, 0.f, 1.f } } } };
+	}
+
+	inline XMMATRIX XMLoadFloat4x4(const XMFLOAT4X4* source) noexcept
+	{
+		XMMATRIX result;
+		for (int i = 0; i < 4; i++)
+			for (int j = 0; j < 4; j++)
+				result.r[i].v[j] = source->m[i][j];
+		return result;
+	}
+
+	inline void XMStoreFloat4x4(XMFLOAT4X4* destination, FXMMATRIX m) noexcept
+	{
+		for (int i = 0; i < 4; i++)
+			for (int j = 0; j < 4; j++)
+				destination->m[i][j] = m.r[i].v[j];
+	}
+
+	inline XMMATRIX XMMatrixMultiply(FXMMATRIX a, CXMMATRIX b) noexcept
+	{
+		XMMATRIX result;
+		for (int i = 0; i < 4; i++)
+			for (int j = 0; j < 4; j++)
+				result.r[i].v[j] = a.r[i].v[0] * b.r[0].v[j] + a.r[i].v[1] * b.r[1].v[j] + a.r[i].v[2] * b.r[2].v[j] + a.r[i].v[3] * b.r[3].v[j];
+		return result;
+	}
+
+	inline XMMATRIX XMMatrixTranspose(FXMMATRIX m) noexcept
+	{
+		XMMATRIX result;
+		for (int i = 0; i < 4; i++)
+			for (int j = 0; j < 4; j++)
+				result.r[i].v[j] = m.r[j].v[i];
+		return result;
+	}
+
+	inline XMMATRIX XMMatrixTranslation(float x, float y, float z) noexcept
+	{
+		XMMATRIX result = XMMatrixIdentity();
+		result.r[3] = { { x, y, z, 1.f } };
+		return result;
+	}
+
+	inline XMMATRIX XMMatrixScaling(float x, float y, float z) noexcept
+	{
+		XMMATRIX result = XMMatrixIdentity();
+		result.r[0].v[0] = x;
+		result.r[1].v[1] = y;
+		result.r[2].v[2] = z;
+		return result;
+	}
+
+	inline XMMATRIX XMMatrixLookAtLH(FXMVECTOR eye, FXMVECTOR focus, FXMVECTOR up) noexcept
+	{
+		const XMVECTOR forward = XMVector3Normalize(XMVectorSubtract(focus, eye));
+		const XMVECTOR right = XMVector3Normalize(XMVector3Cross(up, forward));
+		const XMVECTOR newUp = XMVector3Cross(forward, right);
+		const XMVECTOR negEye = XMVectorSubtract(XMVectorZero(), eye);
+		return { { { { right.v[0], newUp.v[0], forward.v[0], 0.f } }, { { right.v[1], newUp.v[1], forward.v[1], 0.f } },
+			{ { right.v[2], newUp.v[2], forward.v[2], 0.f } },
+			{ { XMVectorGetX(XMVector3Dot(right, negEye)), XMVectorGetX(XMVector3Dot(newUp, negEye)), XMVectorGetX(XMVector3Dot(forward, negEye)), 1.f } } } };
+	}
+
+	inline XMMATRIX XMMatrixPerspectiveFovLH(float fovAngleY, float aspectRatio, float nearZ, float farZ) noexcept
+	{
+		const float height = std::cos(0.5f * fovAngleY) / std::sin(0.5f * fovAngleY);
+		const float width = height / aspectRatio;
+		const float range = farZ / (farZ - nearZ);
+		return { { { { width, 0.f, 0.f, 0.f } }, { { 0.f, height, 0.f, 0.f } }, { { 0.f, 0.f, range, 1.f } }, { { 0.f, 0.f, -range * nearZ, 0.f } } } };
+	}
+
+	inline XMMATRIX XMMatrixRotationQuaternion(FXMVECTOR q) noexcept
+	{
+		const float x = q.v[0], y = q.v[1], z = q.v[2], w = q.v[3];
+		return { {
+			{ { 1.f - 2.f * (y * y + z * z), 2.f * (x * y + z * w), 2.f * (x * z - y * w), 0.f } },
+			{ { 2.f * (x * y - z * w), 1.f - 2.f * (x * x + z * z), 2.f * (y * z + x * w), 0.f } },
+			{ { 2.f * (x * z + y * w), 2.f * (y * z - x * w), 1.f - 2.f * (x * x + y * y), 0.f } },
+			{ { 0.f, 0.f, 0.f, 1.f } },
+		} };
+	}
+
+	// Fails on a degenerate axis, like DirectXMath. Assumes no shear or reflection
+	inline bool XMMatrixDecompose(XMVECTOR* scale, XMVECTOR* rotation, XMVECTOR* translation, FXMMATRIX m) noexcept
+	{
+		float axisScale[3];
+		for (int i = 0; i < 3; i++)
+		{
+			axisScale[i] = XMVectorGetX(XMVector3Length(m.r[i]));
+			if (axisScale[i] < 1e-6f)
+				return false;
+		}
+
+		float a[3][3];
+		for (int i = 0; i < 3; i++)
+			for (int j = 0; j < 3; j++)
+				a[i][j] = m.r[i].v[j] / axisScale[i];
+
+		// Shepperd's method, branching on the largest diagonal term for stability
+		float x, y, z, w;
+		const float trace = a[0][0] + a[1][1] + a[2][2];
+		if (trace > 0.f)
+		{
+			const float s = std::sqrt(trace + 1.f) * 2.f;
+			w = 0.25f * s;
+			x = (a[1][2] - a[2][1]) / s;
+			y = (a[2][0] - a[0][2]) / s;
+			z = (a[0][1] - a[1][0]) / s;
+		}
+		else if (a[0][0] > a[1][1] && a[0][0] > a[2][2])
+		{
+			const float s = std::sqrt(1.f + a[0][0] - a[1][1] - a[2][2]) * 2.f;
+			w = (a[1][2] - a[2][1]) / s;
+			x = 0.25f * s;
+			y = (a[0][1] + a[1][0]) / s;
+			z = (a[2][0] + a[0][2]) / s;
+		}
+		else if (a[1][1] > a[2][2])
+		{
+			const float s = std::sqrt(1.f + a[1][1] - a[0][0] - a[2][2]) * 2.f;
+			w = (a[2][0] - a[0][2]) / s;
+			x = (a[0][1] + a[1][0]) / s;
+			y = 0.25f * s;
+			z = (a[1][2] + a[2][1]) / s;
+		}
+		else
+		{
+			const float s = std::sqrt(1.f + a[2][2] - a[0][0] - a[1][1]) * 2.f;
+			w = (a[0][1] - a[1][0]) / s;
+			x = (a[2][0] + a[0][2]) / s;
+			y = (a[1][2] + a[2][1]) / s;
+			z = 0.25f * s;
+		}
+
+		*scale = { { axisScale[0], axisScale[1], axisScale[2], 0.f } };
+		*rotation = { { x, y, z, w } };
+		*translation = m.r[3];
+		return true;
+	}
+
+	inline XMVECTOR XMVector3TransformCoord(FXMVECTOR v, FXMMATRIX m) noexcept
+	{
+		float result[4];
+		for (int j = 0; j < 4; j++)
+			result[j] = v.v[0] * m.r[0].v[j] + v.v[1] * m.r[1].v[j] + v.v[2] * m.r[2].v[j] + m.r[3].v[j];
+		return { { result[0] / result[3], result[1] / result[3], result[2] / result[3], 1.f } };
+	}
+
+	inline XMVECTOR XMVector4Transform(FXMVECTOR v, FXMMATRIX m) noexcept
+	{
+		XMVECTOR result;
+		for (int j = 0; j < 4; j++)
+			result.v[j] = v.v[0] * m.r[0].v[j] + v.v[1] * m.r[1].v[j] + v.v[2] * m.r[2].v[j] + v.v[3] * m.r[3].v[j];
+		return result;
+	}
+}